@@ -0,0 +1,85 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#include <simpletest.h>
+
+#include <QThread>
+
+#include "kis_color_conversion_benchmark.h"
+#include "kis_benchmark_values.h"
+
+#include <KoColor.h>
+#include <KoColorSpaceRegistry.h>
+
+#include <kis_paint_layer.h>
+#include <kis_paint_device.h>
+#include <kis_image.h>
+
+void KisColorConversionBenchmark::benchmarkConvertImageScaling_data()
+{
+    QTest::addColumn<int>("numThreads");
+    QTest::addColumn<int>("numLayers");
+
+    for (int numLayers : {1, 4}) {
+        for (int numThreads : {1, 2, 4, 8, 16, 32, 64}) {
+            if (numThreads > 1 && numThreads > 2 * QThread::idealThreadCount()) break;
+            QTest::addRow("%d layers, %d threads", numLayers, numThreads) << numThreads << numLayers;
+        }
+    }
+}
+
+void KisColorConversionBenchmark::benchmarkConvertImageScaling()
+{
+    QFETCH(int, numThreads);
+    QFETCH(int, numLayers);
+
+    const KoColorSpace *srcCS = KoColorSpaceRegistry::instance()->rgb8();
+    const KoColorSpace *dstCS = KoColorSpaceRegistry::instance()->lab16();
+    const QRect imageRect(0, 0, TEST_IMAGE_WIDTH, TEST_IMAGE_HEIGHT);
+
+    KisImageSP image = new KisImage(0, imageRect.width(), imageRect.height(), srcCS, "conversion test");
+
+    for (int i = 0; i < numLayers; i++) {
+        KisPaintLayerSP layer = new KisPaintLayer(image, QString("layer %1").arg(i), OPACITY_OPAQUE_U8);
+
+        // a few differently colored stripes, so that the conversion cache
+        // of LCMS doesn't get too lucky
+        const int stripeHeight = imageRect.height() / 16;
+        for (int j = 0; j < 16; j++) {
+            layer->paintDevice()->fill(QRect(0, j * stripeHeight, imageRect.width(), stripeHeight),
+                                       KoColor(QColor(j * 16, 255 - j * 16, i * 50), srcCS));
+        }
+
+        image->addNode(layer, image->root());
+    }
+
+    image->setWorkingThreadsLimit(numThreads);
+    image->initialRefreshGraph();
+    image->resetWorkingThreadsStatistics();
+
+    QBENCHMARK {
+        image->convertImageColorSpace(dstCS,
+                                      KoColorConversionTransformation::internalRenderingIntent(),
+                                      KoColorConversionTransformation::internalConversionFlags());
+        image->waitForDone();
+
+        image->convertImageColorSpace(srcCS,
+                                      KoColorConversionTransformation::internalRenderingIntent(),
+                                      KoColorConversionTransformation::internalConversionFlags());
+        image->waitForDone();
+    }
+
+    const QVector<KisUpdaterWorkerStatistics> stats = image->workingThreadsStatistics();
+
+    qreal totalUtilization = 0.0;
+    for (int i = 0; i < stats.size(); i++) {
+        totalUtilization += stats[i].utilization();
+    }
+
+    qDebug() << "Average utilization:"
+             << QString::number(100.0 * totalUtilization / qMax(1, stats.size()), 'f', 1) << "%";
+}
+
+SIMPLE_TEST_MAIN(KisColorConversionBenchmark)
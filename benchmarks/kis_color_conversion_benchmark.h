@@ -0,0 +1,23 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KIS_COLOR_CONVERSION_BENCHMARK_H
+#define KIS_COLOR_CONVERSION_BENCHMARK_H
+
+#include <simpletest.h>
+
+/// measures how the conversion of the image color space scales with
+/// the number of the working threads
+class KisColorConversionBenchmark : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void benchmarkConvertImageScaling_data();
+    void benchmarkConvertImageScaling();
+};
+
+#endif
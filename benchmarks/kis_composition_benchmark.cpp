@@ -28,6 +28,10 @@
 #include <KoCompositeOpAlphaDarken.h>
 #include <KoCompositeOpOver.h>
 #include <KoCompositeOpCopy2.h>
+#include <KoCompositeOpGeneric.h>
+#include <KoCompositeOpFunctions.h>
+#include <KoColorSpaceBlendingPolicy.h>
+#include <KoCompositeOpRegistry.h>
 #include <KoOptimizedCompositeOpFactory.h>
 #include <KoAlphaDarkenParamsWrapper.h>
 
@@ -885,6 +889,109 @@ void KisCompositionBenchmark::compareRgbF32CopyOps()
     delete opAct;
 }
 
+template<class Traits>
+KoCompositeOp* createLegacyGenericSCOp(const KoColorSpace *cs, const QString &id)
+{
+    using Arg = typename Traits::channels_type;
+    using Policy = KoAdditiveBlendingPolicy<Traits>;
+
+    const QString category = KoCompositeOp::categoryMix();
+
+    if (id == COMPOSITE_MULT) {
+        return new KoCompositeOpGenericSC<Traits, &cfMultiply<Arg>, Policy>(cs, id, category);
+    } else if (id == COMPOSITE_SCREEN) {
+        return new KoCompositeOpGenericSC<Traits, &cfScreen<Arg>, Policy>(cs, id, category);
+    } else if (id == COMPOSITE_OVERLAY) {
+        return new KoCompositeOpGenericSCFunctor<Traits, CFOverlay<Arg>, Policy>(cs, id, category);
+    } else if (id == COMPOSITE_HARD_LIGHT) {
+        return new KoCompositeOpGenericSCFunctor<Traits, CFHardLight<Arg>, Policy>(cs, id, category);
+    } else if (id == COMPOSITE_SOFT_LIGHT_PHOTOSHOP) {
+        return new KoCompositeOpGenericSCFunctor<Traits, CFSoftLight<Arg>, Policy>(cs, id, category);
+    } else if (id == COMPOSITE_DARKEN) {
+        return new KoCompositeOpGenericSC<Traits, &cfDarkenOnly<Arg>, Policy>(cs, id, category);
+    } else if (id == COMPOSITE_LIGHTEN) {
+        return new KoCompositeOpGenericSC<Traits, &cfLightenOnly<Arg>, Policy>(cs, id, category);
+    } else if (id == COMPOSITE_ADD) {
+        return new KoCompositeOpGenericSC<Traits, &cfAddition<Arg>, Policy>(cs, id, category);
+    } else if (id == COMPOSITE_SUBTRACT) {
+        return new KoCompositeOpGenericSC<Traits, &cfSubtract<Arg>, Policy>(cs, id, category);
+    } else if (id == COMPOSITE_DIFF) {
+        return new KoCompositeOpGenericSC<Traits, &cfDifference<Arg>, Policy>(cs, id, category);
+    }
+
+    qFatal("Composite op %s is not implemented", qPrintable(id));
+    return 0;
+}
+
+const KoColorSpace* colorSpaceForDepth(const QString &depth)
+{
+    return
+        depth == "U8" ? KoColorSpaceRegistry::instance()->rgb8() :
+        depth == "U16" ? KoColorSpaceRegistry::instance()->rgb16() :
+        KoColorSpaceRegistry::instance()->colorSpace("RGBA", "F32", "");
+}
+
+KoCompositeOp* createLegacyGenericSCOp(const QString &depth, const QString &id)
+{
+    const KoColorSpace *cs = colorSpaceForDepth(depth);
+
+    return
+        depth == "U8" ? createLegacyGenericSCOp<KoBgrU8Traits>(cs, id) :
+        depth == "U16" ? createLegacyGenericSCOp<KoBgrU16Traits>(cs, id) :
+        createLegacyGenericSCOp<KoRgbF32Traits>(cs, id);
+}
+
+KoCompositeOp* createOptimizedGenericSCOp(const QString &depth, const QString &id)
+{
+    const KoColorSpace *cs = colorSpaceForDepth(depth);
+    const QString category = KoCompositeOp::categoryMix();
+
+    return
+        depth == "U8" ? KoOptimizedCompositeOpFactory::createGenericSCOp32(cs, id, category) :
+        depth == "U16" ? KoOptimizedCompositeOpFactory::createGenericSCOpU64(cs, id, category) :
+        KoOptimizedCompositeOpFactory::createGenericSCOp128(cs, id, category);
+}
+
+void addGenericSCOpsData()
+{
+    QTest::addColumn<QString>("depth");
+    QTest::addColumn<QString>("id");
+
+    const QStringList ids({COMPOSITE_MULT, COMPOSITE_SCREEN, COMPOSITE_OVERLAY,
+                           COMPOSITE_HARD_LIGHT, COMPOSITE_SOFT_LIGHT_PHOTOSHOP,
+                           COMPOSITE_DARKEN, COMPOSITE_LIGHTEN, COMPOSITE_ADD,
+                           COMPOSITE_SUBTRACT, COMPOSITE_DIFF});
+
+    Q_FOREACH (const QString &depth, QStringList({"U8", "U16", "F32"})) {
+        Q_FOREACH (const QString &id, ids) {
+            QTest::addRow("%s-%s", qPrintable(depth), qPrintable(id)) << depth << id;
+        }
+    }
+}
+
+void KisCompositionBenchmark::compareGenericSCOps_data()
+{
+    addGenericSCOpsData();
+}
+
+void KisCompositionBenchmark::compareGenericSCOps()
+{
+    QFETCH(QString, depth);
+    QFETCH(QString, id);
+
+    QScopedPointer<KoCompositeOp> opAct(createOptimizedGenericSCOp(depth, id));
+    QScopedPointer<KoCompositeOp> opExp(createLegacyGenericSCOp(depth, id));
+
+    if (!opAct) {
+        QSKIP("No vectorized version of the composite op is available");
+    }
+
+    // the optimized version does all the math in normalized floats,
+    // so compare the pixels in premultiplied form
+    QVERIFY(compareTwoOps<PixelEqualPremultiplied>(true, opAct.data(), opExp.data()));
+    QVERIFY(compareTwoOps<PixelEqualPremultiplied>(false, opAct.data(), opExp.data()));
+}
+
 void KisCompositionBenchmark::testRgb8CompositeAlphaDarkenLegacy()
 {
     const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
@@ -1043,6 +1150,43 @@ void KisCompositionBenchmark::testRgb8CompositeCopyOptimized()
     delete op;
 }
 
+void KisCompositionBenchmark::testCompositeGenericSCLegacy_data()
+{
+    addGenericSCOpsData();
+}
+
+void KisCompositionBenchmark::testCompositeGenericSCLegacy()
+{
+    QFETCH(QString, depth);
+    QFETCH(QString, id);
+
+    QScopedPointer<KoCompositeOp> op(createLegacyGenericSCOp(depth, id));
+    benchmarkCompositeOp(op.data(), true, 0.5, 0.3, 0, 0, ALPHA_RANDOM, ALPHA_RANDOM);
+    benchmarkCompositeOp(op.data(), false, 1.0, 1.0, 0, 0, ALPHA_RANDOM, ALPHA_RANDOM);
+    benchmarkCompositeOp(op.data(), false, 1.0, 1.0, 0, 0, ALPHA_UNIT, ALPHA_UNIT);
+}
+
+void KisCompositionBenchmark::testCompositeGenericSCOptimized_data()
+{
+    addGenericSCOpsData();
+}
+
+void KisCompositionBenchmark::testCompositeGenericSCOptimized()
+{
+    QFETCH(QString, depth);
+    QFETCH(QString, id);
+
+    QScopedPointer<KoCompositeOp> op(createOptimizedGenericSCOp(depth, id));
+
+    if (!op) {
+        QSKIP("No vectorized version of the composite op is available");
+    }
+
+    benchmarkCompositeOp(op.data(), true, 0.5, 0.3, 0, 0, ALPHA_RANDOM, ALPHA_RANDOM);
+    benchmarkCompositeOp(op.data(), false, 1.0, 1.0, 0, 0, ALPHA_RANDOM, ALPHA_RANDOM);
+    benchmarkCompositeOp(op.data(), false, 1.0, 1.0, 0, 0, ALPHA_UNIT, ALPHA_UNIT);
+}
+
 void KisCompositionBenchmark::benchmarkMemcpy()
 {
     QVector<Tile> tiles =
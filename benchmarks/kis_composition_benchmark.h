@@ -47,6 +47,9 @@ private Q_SLOTS:
     void compareRgbU16CopyOps();
     void compareRgbF32CopyOps();
 
+    void compareGenericSCOps_data();
+    void compareGenericSCOps();
+
     void testRgb8CompositeAlphaDarkenLegacy();
     void testRgb8CompositeAlphaDarkenOptimized();
 
@@ -77,6 +80,11 @@ private Q_SLOTS:
     void testRgb8CompositeCopyLegacy();
     void testRgb8CompositeCopyOptimized();
 
+    void testCompositeGenericSCLegacy_data();
+    void testCompositeGenericSCLegacy();
+    void testCompositeGenericSCOptimized_data();
+    void testCompositeGenericSCOptimized();
+
     void benchmarkMemcpy();
 
     void benchmarkUintFloat();
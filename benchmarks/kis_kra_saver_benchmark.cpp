@@ -0,0 +1,103 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#include <simpletest.h>
+
+#include "kis_kra_saver_benchmark.h"
+#include "kis_benchmark_values.h"
+
+#include <testutil.h>
+
+#include <kis_image.h>
+#include <KisDocument.h>
+#include <KisPart.h>
+#include <kis_config.h>
+
+#include <QFileInfo>
+
+void KisKraSaverBenchmark::createRowsColumns()
+{
+    QTest::addColumn<int>("numLayers");
+    QTest::addColumn<int>("layerSize");
+    QTest::addColumn<bool>("compressLayers");
+
+    QTest::addRow("400 layers, 512px, stored") << 400 << 512 << false;
+    QTest::addRow("400 layers, 512px, deflated") << 400 << 512 << true;
+    QTest::addRow("64 layers, 2048px, stored") << 64 << 2048 << false;
+    QTest::addRow("64 layers, 2048px, deflated") << 64 << 2048 << true;
+    QTest::addRow("4 layers, 4096px, stored") << 4 << 4096 << false;
+    QTest::addRow("4 layers, 4096px, deflated") << 4 << 4096 << true;
+}
+
+KisDocument* KisKraSaverBenchmark::createDocument(int numLayers, int layerSize)
+{
+    KisDocument *doc = KisPart::instance()->createDocument();
+    doc->setCurrentImage(TestUtil::createNoiseImage(QSize(TEST_IMAGE_WIDTH, TEST_IMAGE_HEIGHT), numLayers, layerSize));
+    return doc;
+}
+
+void KisKraSaverBenchmark::benchmarkSaveManyLayers_data()
+{
+    createRowsColumns();
+}
+
+void KisKraSaverBenchmark::benchmarkSaveManyLayers()
+{
+    QFETCH(int, numLayers);
+    QFETCH(int, layerSize);
+    QFETCH(bool, compressLayers);
+
+    QScopedPointer<KisDocument> doc(createDocument(numLayers, layerSize));
+
+    KisConfig cfg(false);
+    const bool oldCompressLayers = cfg.compressKra();
+    cfg.setCompressKra(compressLayers);
+
+    const QString fileName = QString(FILES_OUTPUT_DIR) + '/' + "save_many_layers_test.kra";
+
+    QBENCHMARK_ONCE {
+        QVERIFY(doc->exportDocumentSync(fileName, doc->mimeType()));
+    }
+
+    cfg.setCompressKra(oldCompressLayers);
+
+    qDebug() << "File size:" << QFileInfo(fileName).size() / 1024 << "KiB";
+}
+
+void KisKraSaverBenchmark::benchmarkLoadManyLayers_data()
+{
+    createRowsColumns();
+}
+
+void KisKraSaverBenchmark::benchmarkLoadManyLayers()
+{
+    QFETCH(int, numLayers);
+    QFETCH(int, layerSize);
+    QFETCH(bool, compressLayers);
+
+    const QString fileName = QString(FILES_OUTPUT_DIR) + '/' + "load_many_layers_test.kra";
+
+    {
+        QScopedPointer<KisDocument> doc(createDocument(numLayers, layerSize));
+
+        KisConfig cfg(false);
+        const bool oldCompressLayers = cfg.compressKra();
+        cfg.setCompressKra(compressLayers);
+        QVERIFY(doc->exportDocumentSync(fileName, doc->mimeType()));
+        cfg.setCompressKra(oldCompressLayers);
+    }
+
+    qDebug() << "File size:" << QFileInfo(fileName).size() / 1024 << "KiB";
+
+    QScopedPointer<KisDocument> doc(KisPart::instance()->createDocument());
+
+    QBENCHMARK_ONCE {
+        QVERIFY(doc->loadNativeFormat(fileName));
+    }
+
+    QCOMPARE(doc->image()->root()->childCount(), quint32(numLayers));
+}
+
+SIMPLE_TEST_MAIN(KisKraSaverBenchmark)
@@ -0,0 +1,33 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KIS_KRA_SAVER_BENCHMARK_H
+#define KIS_KRA_SAVER_BENCHMARK_H
+
+#include <simpletest.h>
+
+class KisDocument;
+
+/// measures the time of saving a synthetic document with many layers
+/// into .kra and loading it back, with the layers' pixel data stored
+/// either as it is or deflated
+class KisKraSaverBenchmark : public QObject
+{
+    Q_OBJECT
+
+private:
+    void createRowsColumns();
+    KisDocument* createDocument(int numLayers, int layerSize);
+
+private Q_SLOTS:
+    void benchmarkSaveManyLayers_data();
+    void benchmarkSaveManyLayers();
+
+    void benchmarkLoadManyLayers_data();
+    void benchmarkLoadManyLayers();
+};
+
+#endif
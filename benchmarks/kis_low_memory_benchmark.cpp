@@ -27,7 +27,15 @@
 #include "KisGlobalResourcesInterface.h"
 #include <KisPortingUtils.h>
 
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+
+#include <thread>
+#include <vector>
+
+#include "tiles3/kis_tile_data.h"
 #include "tiles3/kis_tile_data_store.h"
+#include "tiles3/swap/kis_swapped_data_store.h"
 #include "kis_surrogate_undo_adapter.h"
 #include "kis_image_config.h"
 
@@ -221,4 +229,89 @@ void KisLowMemoryBenchmark::memory2000History100Pool500HugeBrush()
                       2000, 600, 500, 0);
 }
 
+void KisLowMemoryBenchmark::benchmarkSwapInThroughput_data()
+{
+    QTest::addColumn<int>("numThreads");
+
+    for (int numThreads = 1; numThreads <= 16; numThreads *= 2) {
+        QTest::addRow("threads-%d", numThreads) << numThreads;
+    }
+}
+
+/**
+ * Measures how fast the tiles can be faulted in from the swap when
+ * several threads are accessing it at the same time. The swap is
+ * split into the same number of stripes as the number of threads.
+ */
+void KisLowMemoryBenchmark::benchmarkSwapInThroughput()
+{
+    QFETCH(int, numThreads);
+
+    const qint32 pixelSize = 4;
+    const quint32 defaultPixel = 0;
+    const int numTiles = 16384; // 256 MiB of uncompressed data
+
+    KisImageConfig config(false);
+    const int oldStripesCount = config.swapStripesCount();
+    config.setSwapStripesCount(numThreads);
+
+    KisSwappedDataStore store;
+
+    QRandomGenerator rng(1);
+    QVector<KisTileData*> tileDataList;
+
+    for (int i = 0; i < numTiles; i++) {
+        KisTileData *td = new KisTileData(pixelSize, (const quint8*)&defaultPixel, KisTileDataStore::instance());
+
+        /**
+         * Fill the tile with semi-compressible data: smooth
+         * gradient in color channels and a bit of noise
+         */
+        quint8 *ptr = td->data();
+        for (int j = 0; j < KisTileData::WIDTH * KisTileData::HEIGHT; j++) {
+            ptr[0] = j & 0xff;
+            ptr[1] = (j >> 6) & 0xff;
+            ptr[2] = rng.bounded(4);
+            ptr[3] = 0xff;
+            ptr += pixelSize;
+        }
+
+        if (!store.trySwapOutTileData(td)) {
+            qWarning() << "Failed to swap out a tile, aborting the benchmark";
+            delete td;
+            break;
+        }
+
+        tileDataList.append(td);
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < numThreads; t++) {
+        threads.emplace_back([&, t] () {
+            for (int i = t; i < tileDataList.size(); i += numThreads) {
+                store.swapInTileData(tileDataList[i]);
+            }
+        });
+    }
+
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+    const qint64 elapsed = timer.nsecsElapsed();
+    const qreal totalMiB = qreal(tileDataList.size()) * KisTileData::WIDTH * KisTileData::HEIGHT * pixelSize / (1 << 20);
+
+    qDebug() << "Swap-in:" << numThreads << "threads,"
+             << tileDataList.size() << "tiles,"
+             << totalMiB / (elapsed * 1e-9) << "MiB/s";
+
+    config.setSwapStripesCount(oldStripesCount);
+
+    qDeleteAll(tileDataList);
+}
+
 SIMPLE_TEST_MAIN(KisLowMemoryBenchmark)
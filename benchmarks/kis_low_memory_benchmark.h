@@ -19,6 +19,9 @@ private Q_SLOTS:
 
     void memory2000History100Pool500HugeBrush();
 
+    void benchmarkSwapInThroughput_data();
+    void benchmarkSwapInThroughput();
+
 private:
     void benchmarkWideArea(const QString presetFileName,
                            const QRectF &rect, qreal vstep,
@@ -11,6 +11,13 @@
 #include "kis_circle_mask_generator.h"
 #include "kis_rect_mask_generator.h"
 
+#include <QPainter>
+#include <QRadialGradient>
+#include <QRandomGenerator>
+#include <KoColor.h>
+#include <brushengine/kis_paint_information.h>
+#include "kis_gbr_brush.h"
+
 void KisMaskGeneratorBenchmark::benchmarkCircle()
 {
     KisCircleMaskGenerator gen(1000, 0.5, 0.5, 0.5, 3, true);
@@ -81,4 +88,54 @@ void KisMaskGeneratorBenchmark::benchmarkSquare()
     }
 }
 
+namespace {
+
+QImage predefinedBrushTip()
+{
+    QImage image(400, 400, QImage::Format_ARGB32);
+    image.fill(Qt::white);
+
+    QRadialGradient gradient(QPointF(200, 200), 190);
+    gradient.setColorAt(0.0, Qt::black);
+    gradient.setColorAt(0.7, Qt::gray);
+    gradient.setColorAt(1.0, Qt::white);
+
+    QPainter gc(&image);
+    gc.setRenderHint(QPainter::Antialiasing);
+    gc.setPen(Qt::NoPen);
+    gc.setBrush(gradient);
+    gc.drawEllipse(QPointF(200, 200), 190, 120);
+    gc.end();
+
+    return image;
+}
+
+}
+
+/**
+ * A predefined tip with rotation and size jitter, which is the case
+ * when every dab needs to be resampled
+ */
+void KisMaskGeneratorBenchmark::benchmarkPredefinedBrushMask()
+{
+    KisGbrBrush brush(predefinedBrushTip());
+    brush.makeMaskImage(false);
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisPaintInformation info(QPointF(100.0, 100.0), 0.5);
+    KisFixedPaintDeviceSP dab = new KisFixedPaintDevice(cs);
+    KoColor color(Qt::black, cs);
+
+    QRandomGenerator rng(1);
+
+    QBENCHMARK {
+        for (int i = 0; i < 100; i++) {
+            const qreal scale = 0.4 + rng.bounded(0.6);
+            const qreal rotation = rng.bounded(2 * M_PI);
+            brush.mask(dab, color, KisDabShape(scale, 1.0, rotation), info,
+                       rng.bounded(1.0), rng.bounded(1.0), 1.0);
+        }
+    }
+}
+
 SIMPLE_TEST_MAIN(KisMaskGeneratorBenchmark)
@@ -17,6 +17,7 @@ private Q_SLOTS:
     void benchmarkSIMD_SharpBrush();
     void benchmarkSIMD_FadedBrush();
     void benchmarkSquare();
+    void benchmarkPredefinedBrushMask();
 
 };
 
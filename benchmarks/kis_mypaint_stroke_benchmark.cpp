@@ -0,0 +1,123 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kis_mypaint_stroke_benchmark.h"
+
+#include <simpletest.h>
+#include <QtMath>
+
+#include "kis_benchmark_values.h"
+
+#include <KoColor.h>
+#include <KoColorSpace.h>
+#include <KoColorSpaceRegistry.h>
+
+#include <kis_paint_device.h>
+#include <kis_painter.h>
+
+#include "MyPaintSurface.h"
+
+/**
+ * The number of dabs libmypaint generates for a single stroke_to() call
+ * of a dense brush; the batch is closed after each of such segments,
+ * exactly as the paintop does
+ */
+static const int DABS_PER_SEGMENT = 8;
+
+/**
+ * A smudging brush samples the color once in a while, not for every
+ * dab: libmypaint skips the update of the smudge color while the
+ * smudge length keeps the previous one. Every get_color() call flushes
+ * the pending dabs, so this is also what lets the batches grow.
+ */
+static const int SMUDGE_SAMPLE_INTERVAL = DABS_PER_SEGMENT;
+
+void KisMyPaintStrokeBenchmark::initTestCase()
+{
+    m_colorSpace = KoColorSpaceRegistry::instance()->rgb8();
+    m_device = new KisPaintDevice(m_colorSpace);
+
+    // a sine wave across the image with the dabs spaced by 2 px
+    const int numPoints = TEST_IMAGE_WIDTH / 2;
+    for (int i = 0; i < numPoints; i++) {
+        const qreal x = 2.0 * i;
+        const qreal y = 0.5 * TEST_IMAGE_HEIGHT + 0.3 * TEST_IMAGE_HEIGHT * qSin(x / TEST_IMAGE_WIDTH * 4 * M_PI);
+        m_strokePoints.append(QPointF(x, y));
+    }
+}
+
+void KisMyPaintStrokeBenchmark::init()
+{
+    m_device->clear();
+    m_device->fill(QRect(0, 0, TEST_IMAGE_WIDTH, TEST_IMAGE_HEIGHT), KoColor(Qt::white, m_colorSpace));
+}
+
+void KisMyPaintStrokeBenchmark::benchmarkStroke(qreal radius, bool useBatches, int colorSampleInterval)
+{
+    KisPainter painter(m_device);
+    KisMyPaintSurface surface(&painter, m_device);
+
+    float r = 0.2f;
+    float g = 0.3f;
+    float b = 0.8f;
+    float a = 1.0f;
+
+    QBENCHMARK_ONCE {
+        for (int i = 0; i < m_strokePoints.size(); i++) {
+            const QPointF &pt = m_strokePoints[i];
+
+            if (useBatches && i % DABS_PER_SEGMENT == 0) {
+                surface.beginDabsBatch();
+            }
+
+            if (colorSampleInterval > 0 && i % colorSampleInterval == 0) {
+                surface.get_color(surface.surface(), pt.x(), pt.y(), radius, &r, &g, &b, &a);
+            }
+
+            surface.draw_dab(surface.surface(), pt.x(), pt.y(), radius, r, g, b, 0.8f, 0.7f, 1.0f, 1.0f, 0.0f, 0.0f, 0.0f);
+
+            if (useBatches && i % DABS_PER_SEGMENT == DABS_PER_SEGMENT - 1) {
+                surface.endDabsBatch();
+            }
+        }
+
+        if (useBatches) {
+            surface.endDabsBatch();
+        }
+    }
+}
+
+void KisMyPaintStrokeBenchmark::benchmarkSmallDabs()
+{
+    benchmarkStroke(10, false, 0);
+}
+
+void KisMyPaintStrokeBenchmark::benchmarkSmallDabsBatched()
+{
+    benchmarkStroke(10, true, 0);
+}
+
+void KisMyPaintStrokeBenchmark::benchmarkBigDabs()
+{
+    benchmarkStroke(150, false, 0);
+}
+
+void KisMyPaintStrokeBenchmark::benchmarkBigDabsBatched()
+{
+    benchmarkStroke(150, true, 0);
+}
+
+void KisMyPaintStrokeBenchmark::benchmarkSmudgeDabs()
+{
+    benchmarkStroke(50, false, SMUDGE_SAMPLE_INTERVAL);
+}
+
+void KisMyPaintStrokeBenchmark::benchmarkSmudgeDabsBatched()
+{
+    benchmarkStroke(50, true, SMUDGE_SAMPLE_INTERVAL);
+}
+
+SIMPLE_TEST_MAIN(KisMyPaintStrokeBenchmark)
@@ -0,0 +1,42 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KIS_MYPAINT_STROKE_BENCHMARK_H
+#define KIS_MYPAINT_STROKE_BENCHMARK_H
+
+#include <QObject>
+#include <QVector>
+#include <QPointF>
+
+#include <kis_types.h>
+
+class KoColorSpace;
+
+class KisMyPaintStrokeBenchmark : public QObject
+{
+    Q_OBJECT
+
+private:
+    void benchmarkStroke(qreal radius, bool useBatches, int colorSampleInterval);
+
+private Q_SLOTS:
+    void initTestCase();
+    void init();
+
+    void benchmarkSmallDabs();
+    void benchmarkSmallDabsBatched();
+    void benchmarkBigDabs();
+    void benchmarkBigDabsBatched();
+    void benchmarkSmudgeDabs();
+    void benchmarkSmudgeDabsBatched();
+
+private:
+    const KoColorSpace *m_colorSpace {nullptr};
+    KisPaintDeviceSP m_device;
+    QVector<QPointF> m_strokePoints;
+};
+
+#endif // KIS_MYPAINT_STROKE_BENCHMARK_H
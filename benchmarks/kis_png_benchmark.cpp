@@ -0,0 +1,99 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#include <simpletest.h>
+
+#include "kis_png_benchmark.h"
+#include "kis_benchmark_values.h"
+
+#include <testutil.h>
+
+#include <KoColorSpace.h>
+#include <KoColorSpaceRegistry.h>
+
+#include <kis_paint_device.h>
+#include <kis_sequential_iterator.h>
+#include <kis_png_converter.h>
+
+#include <QBuffer>
+
+KisPaintDeviceSP KisPngBenchmark::createDevice(bool is16Bit)
+{
+    const KoColorSpace *cs = is16Bit ?
+        KoColorSpaceRegistry::instance()->rgb16() :
+        KoColorSpaceRegistry::instance()->rgb8();
+
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+
+    const QRect rc(0, 0, TEST_IMAGE_WIDTH, TEST_IMAGE_HEIGHT);
+
+    /**
+     * A mix of smooth gradients (compress well after filtering) and
+     * noise (mostly literals)
+     */
+    KisSequentialIterator it(dev, rc);
+    while (it.nextPixel()) {
+        quint8 *dst = it.rawData();
+
+        for (quint32 i = 0; i < cs->pixelSize(); i++) {
+            dst[i] = quint8((it.x() * (i + 1) + it.y()) / 16);
+        }
+    }
+
+    TestUtil::fillCellsWithNoise(dev, rc, 256, 4);
+
+    return dev;
+}
+
+void KisPngBenchmark::benchmarkSave_data()
+{
+    QTest::addColumn<bool>("is16Bit");
+    QTest::addColumn<int>("compression");
+    QTest::addColumn<bool>("parallelEncoding");
+
+    for (int compression : {3, 9}) {
+        for (bool is16Bit : {false, true}) {
+            for (bool parallelEncoding : {false, true}) {
+                QTest::addRow("%s, level %d, %s",
+                              is16Bit ? "16 bit" : "8 bit",
+                              compression,
+                              parallelEncoding ? "strips" : "libpng")
+                    << is16Bit << compression << parallelEncoding;
+            }
+        }
+    }
+}
+
+void KisPngBenchmark::benchmarkSave()
+{
+    QFETCH(bool, is16Bit);
+    QFETCH(int, compression);
+    QFETCH(bool, parallelEncoding);
+
+    KisPaintDeviceSP dev = createDevice(is16Bit);
+    const QRect rc(0, 0, TEST_IMAGE_WIDTH, TEST_IMAGE_HEIGHT);
+
+    KisPNGOptions options;
+    options.compression = compression;
+    options.tryToSaveAsIndexed = false;
+    options.parallelEncoding = parallelEncoding;
+
+    vKisAnnotationSP annotations;
+    qint64 fileSize = 0;
+
+    QBENCHMARK_ONCE {
+        QBuffer buffer;
+        buffer.open(QIODevice::WriteOnly);
+
+        KisPNGConverter converter(0, true);
+        QVERIFY(converter.buildFile(&buffer, rc, 72, 72, dev, annotations.begin(), annotations.end(), options, 0).isOk());
+
+        fileSize = buffer.size();
+    }
+
+    qDebug() << "File size:" << fileSize / 1024 << "KiB";
+}
+
+SIMPLE_TEST_MAIN(KisPngBenchmark)
@@ -0,0 +1,28 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KIS_PNG_BENCHMARK_H
+#define KIS_PNG_BENCHMARK_H
+
+#include <simpletest.h>
+
+#include <kis_types.h>
+
+/// compares the time of saving a big image into PNG with libpng's
+/// single deflate stream and with the multithreaded strip encoder
+class KisPngBenchmark : public QObject
+{
+    Q_OBJECT
+
+private:
+    KisPaintDeviceSP createDevice(bool is16Bit);
+
+private Q_SLOTS:
+    void benchmarkSave_data();
+    void benchmarkSave();
+};
+
+#endif
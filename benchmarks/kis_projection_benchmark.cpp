@@ -5,12 +5,17 @@
  */
 #include <simpletest.h>
 
+#include <QThread>
+
 #include "kis_projection_benchmark.h"
 #include "kis_benchmark_values.h"
 
 #include <KoColor.h>
+#include <KoColorSpaceRegistry.h>
+#include <KoCompositeOpRegistry.h>
 
 #include <kis_group_layer.h>
+#include <kis_paint_layer.h>
 #include <kis_paint_device.h>
 #include <KisDocument.h>
 #include <kis_image.h>
@@ -46,5 +51,56 @@ void KisProjectionBenchmark::benchmarkLoading()
     }
 }
 
+void KisProjectionBenchmark::benchmarkRefreshScaling_data()
+{
+    QTest::addColumn<int>("numThreads");
+
+    for (int numThreads : {1, 2, 4, 8, 16, 32, 64}) {
+        if (numThreads > 1 && numThreads > 2 * QThread::idealThreadCount()) break;
+        QTest::addRow("%d threads", numThreads) << numThreads;
+    }
+}
+
+void KisProjectionBenchmark::benchmarkRefreshScaling()
+{
+    QFETCH(int, numThreads);
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    const QRect imageRect(0, 0, TEST_IMAGE_WIDTH, TEST_IMAGE_HEIGHT);
+
+    KisImageSP image = new KisImage(0, imageRect.width(), imageRect.height(), cs, "scaling test");
+
+    const QStringList compositeOps = {COMPOSITE_OVER, COMPOSITE_MULT, COMPOSITE_SCREEN, COMPOSITE_OVERLAY};
+
+    for (int i = 0; i < 8; i++) {
+        KisPaintLayerSP layer = new KisPaintLayer(image, QString("layer %1").arg(i), OPACITY_OPAQUE_U8 / 2);
+        layer->setCompositeOpId(compositeOps[i % compositeOps.size()]);
+        layer->paintDevice()->fill(imageRect.adjusted(i * 16, i * 16, -i * 16, -i * 16),
+                                   KoColor(QColor(i * 30, 255 - i * 30, 128), cs));
+        image->addNode(layer, image->root());
+    }
+
+    image->setWorkingThreadsLimit(numThreads);
+    image->waitForDone();
+    image->resetWorkingThreadsStatistics();
+
+    QBENCHMARK {
+        image->refreshGraphAsync();
+        image->waitForDone();
+    }
+
+    const QVector<KisUpdaterWorkerStatistics> stats = image->workingThreadsStatistics();
+
+    qreal totalUtilization = 0.0;
+    for (int i = 0; i < stats.size(); i++) {
+        qDebug() << "    worker" << i
+                 << "jobs:" << stats[i].numJobs
+                 << "utilization:" << QString::number(100.0 * stats[i].utilization(), 'f', 1) << "%";
+        totalUtilization += stats[i].utilization();
+    }
+
+    qDebug() << "Average utilization:"
+             << QString::number(100.0 * totalUtilization / qMax(1, stats.size()), 'f', 1) << "%";
+}
 
 SIMPLE_TEST_MAIN(KisProjectionBenchmark)
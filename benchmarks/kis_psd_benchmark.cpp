@@ -0,0 +1,127 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#include <simpletest.h>
+
+#include "kis_psd_benchmark.h"
+#include "kis_benchmark_values.h"
+
+#include <testutil.h>
+
+#include <kis_image.h>
+#include <KisDocument.h>
+#include <KisImportExportManager.h>
+#include <KisImportExportErrorCode.h>
+#include <KisPart.h>
+
+#include <QDir>
+#include <QFileInfo>
+
+#ifndef PSD_FILES_DATA_DIR
+#error "PSD_FILES_DATA_DIR not set. A directory with the PSD files used by the PSD plugin tests"
+#endif
+
+namespace {
+const QString PSDMimetype = "image/vnd.adobe.photoshop";
+
+bool importPsdDocument(KisDocument *doc, const QString &fileName)
+{
+    KisImportExportManager manager(doc);
+    doc->setFileBatchMode(true);
+
+    return manager.importDocument(fileName, QString()).isOk();
+}
+}
+
+KisDocument* KisPsdBenchmark::createDocument(int numLayers, int layerSize)
+{
+    KisDocument *doc = KisPart::instance()->createDocument();
+    doc->setCurrentImage(TestUtil::createNoiseImage(QSize(TEST_IMAGE_WIDTH, TEST_IMAGE_HEIGHT), numLayers, layerSize));
+    return doc;
+}
+
+void KisPsdBenchmark::benchmarkLoadTestFiles_data()
+{
+    QTest::addColumn<QString>("fileName");
+
+    const QStringList dirs = {QString(PSD_FILES_DATA_DIR), QString(PSD_FILES_DATA_DIR) + "/sources"};
+
+    Q_FOREACH (const QString &dirName, dirs) {
+        QDir dir(dirName);
+        Q_FOREACH (const QFileInfo &info, dir.entryInfoList(QStringList() << "*.psd", QDir::Files, QDir::Name)) {
+            QTest::newRow(info.fileName().toLatin1()) << info.absoluteFilePath();
+        }
+    }
+}
+
+void KisPsdBenchmark::benchmarkLoadTestFiles()
+{
+    QFETCH(QString, fileName);
+
+    {
+        QScopedPointer<KisDocument> doc(KisPart::instance()->createDocument());
+        if (!importPsdDocument(doc.data(), fileName)) {
+            QSKIP("The file is not supported by the PSD importer");
+        }
+    }
+
+    QBENCHMARK {
+        QScopedPointer<KisDocument> doc(KisPart::instance()->createDocument());
+        importPsdDocument(doc.data(), fileName);
+    }
+}
+
+void KisPsdBenchmark::benchmarkSaveBigLayers_data()
+{
+    QTest::addColumn<int>("numLayers");
+    QTest::addColumn<int>("layerSize");
+
+    QTest::addRow("64 layers, 1024px") << 64 << 1024;
+    QTest::addRow("8 layers, 4096px") << 8 << 4096;
+}
+
+void KisPsdBenchmark::benchmarkSaveBigLayers()
+{
+    QFETCH(int, numLayers);
+    QFETCH(int, layerSize);
+
+    QScopedPointer<KisDocument> doc(createDocument(numLayers, layerSize));
+
+    const QString fileName = QString(FILES_OUTPUT_DIR) + '/' + "psd_save_big_layers_test.psd";
+
+    QBENCHMARK_ONCE {
+        QVERIFY(doc->exportDocumentSync(fileName, PSDMimetype.toLatin1()));
+    }
+
+    qDebug() << "File size:" << QFileInfo(fileName).size() / 1024 << "KiB";
+}
+
+void KisPsdBenchmark::benchmarkLoadBigLayers_data()
+{
+    benchmarkSaveBigLayers_data();
+}
+
+void KisPsdBenchmark::benchmarkLoadBigLayers()
+{
+    QFETCH(int, numLayers);
+    QFETCH(int, layerSize);
+
+    const QString fileName = QString(FILES_OUTPUT_DIR) + '/' + "psd_load_big_layers_test.psd";
+
+    {
+        QScopedPointer<KisDocument> doc(createDocument(numLayers, layerSize));
+        QVERIFY(doc->exportDocumentSync(fileName, PSDMimetype.toLatin1()));
+    }
+
+    QScopedPointer<KisDocument> doc(KisPart::instance()->createDocument());
+
+    QBENCHMARK_ONCE {
+        QVERIFY(importPsdDocument(doc.data(), fileName));
+    }
+
+    QCOMPARE(doc->image()->root()->childCount(), quint32(numLayers));
+}
+
+SIMPLE_TEST_MAIN(KisPsdBenchmark)
@@ -0,0 +1,35 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KIS_PSD_BENCHMARK_H
+#define KIS_PSD_BENCHMARK_H
+
+#include <simpletest.h>
+
+class KisDocument;
+
+/// measures the time of loading the PSD files used by the PSD plugin
+/// tests and of saving/loading a synthetic document with big layers
+/// into PSD
+class KisPsdBenchmark : public QObject
+{
+    Q_OBJECT
+
+private:
+    KisDocument* createDocument(int numLayers, int layerSize);
+
+private Q_SLOTS:
+    void benchmarkLoadTestFiles_data();
+    void benchmarkLoadTestFiles();
+
+    void benchmarkSaveBigLayers_data();
+    void benchmarkSaveBigLayers();
+
+    void benchmarkLoadBigLayers_data();
+    void benchmarkLoadBigLayers();
+};
+
+#endif
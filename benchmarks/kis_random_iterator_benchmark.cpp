@@ -16,6 +16,10 @@
 #include <simpletest.h>
 #include <kis_random_accessor_ng.h>
 
+#include <random>
+#include <thread>
+#include <vector>
+
 
 void KisRandomIteratorBenchmark::initTestCase()
 {
@@ -223,4 +227,48 @@ void KisRandomIteratorBenchmark::benchmarkTwoIteratorsNoMemCpy()
 }
 
 
+void KisRandomIteratorBenchmark::benchmarkConcurrentTotalRandomConst_data()
+{
+    QTest::addColumn<int>("numThreads");
+
+    QTest::addRow("1 thread") << 1;
+    QTest::addRow("8 threads") << 8;
+    QTest::addRow("32 threads") << 32;
+}
+
+/**
+ * Every thread has its own accessor, so the only shared objects are
+ * the tile hash table of the device and the tiles themselves. The
+ * total amount of work doesn't depend on the number of threads.
+ */
+void KisRandomIteratorBenchmark::benchmarkConcurrentTotalRandomConst()
+{
+    QFETCH(int, numThreads);
+
+    const int numPixels = TEST_IMAGE_WIDTH * TEST_IMAGE_HEIGHT;
+    const int pixelSize = m_colorSpace->pixelSize();
+
+    QBENCHMARK {
+        std::vector<std::thread> threads;
+
+        for (int t = 0; t < numThreads; t++) {
+            threads.emplace_back([this, t, numThreads, numPixels, pixelSize] () {
+                KisRandomConstAccessorSP it = m_device->createRandomConstAccessorNG();
+                std::mt19937 rng(123456 + t);
+                quint8 pixel[16];
+
+                for (int i = t; i < numPixels; i += numThreads) {
+                    it->moveTo(rng() % TEST_IMAGE_WIDTH,
+                               rng() % TEST_IMAGE_HEIGHT);
+                    memcpy(pixel, it->oldRawData(), pixelSize);
+                }
+            });
+        }
+
+        for (std::thread &thread : threads) {
+            thread.join();
+        }
+    }
+}
+
 SIMPLE_TEST_MAIN(KisRandomIteratorBenchmark)
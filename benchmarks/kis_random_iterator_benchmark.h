@@ -46,6 +46,10 @@ private Q_SLOTS:
     void benchmarkNoMemCpy();
     void benchmarkConstNoMemCpy();
     void benchmarkTwoIteratorsNoMemCpy();
+
+    // randomly read data from several threads at once
+    void benchmarkConcurrentTotalRandomConst_data();
+    void benchmarkConcurrentTotalRandomConst();
 };
 
 #endif
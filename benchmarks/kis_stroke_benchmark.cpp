@@ -216,6 +216,30 @@ void KisStrokeBenchmark::sprayPencilRL()
     benchmarkRandomLines(presetFileName);
 }
 
+void KisStrokeBenchmark::sketchBrush()
+{
+    QString presetFileName = "sketchbrush.kpp";
+    benchmarkStroke(presetFileName);
+}
+
+void KisStrokeBenchmark::sketchBrushRL()
+{
+    QString presetFileName = "sketchbrush.kpp";
+    benchmarkRandomLines(presetFileName);
+}
+
+void KisStrokeBenchmark::particleBrush()
+{
+    QString presetFileName = "particlebrush.kpp";
+    benchmarkStroke(presetFileName);
+}
+
+void KisStrokeBenchmark::particleBrushRL()
+{
+    QString presetFileName = "particlebrush.kpp";
+    benchmarkRandomLines(presetFileName);
+}
+
 void KisStrokeBenchmark::softbrushDefault30()
 {
     QString presetFileName = "softbrush_30px.kpp";
@@ -347,6 +371,19 @@ void KisStrokeBenchmark::colorsmudgeRL()
     benchmarkStroke(presetFileName);
 }
 
+void KisStrokeBenchmark::colorsmudgeBig()
+{
+    // big smudge dabs are blended in bands of rows on several threads
+    QString presetFileName = "slow-smudge.kpp";
+    benchmarkStroke(presetFileName);
+}
+
+void KisStrokeBenchmark::colorsmudgeBigRL()
+{
+    QString presetFileName = "slow-smudge.kpp";
+    benchmarkRandomLines(presetFileName);
+}
+
 
 void KisStrokeBenchmark::roundMarker()
 {
@@ -103,6 +103,12 @@ private Q_SLOTS:
     void sprayTexture();
     void sprayTextureRL();
 
+    void sketchBrush();
+    void sketchBrushRL();
+
+    void particleBrush();
+    void particleBrushRL();
+
     void dynabrush();
     void dynabrushRL();
 
@@ -114,6 +120,8 @@ private Q_SLOTS:
 
     void colorsmudge();
     void colorsmudgeRL();
+    void colorsmudgeBig();
+    void colorsmudgeBigRL();
 
     void roundMarker();
     void roundMarkerRandomLines();
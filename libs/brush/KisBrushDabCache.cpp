@@ -0,0 +1,168 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisBrushDabCache.h"
+
+#include <QCache>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QGlobalStatic>
+
+#include <atomic>
+
+#include <KoColorSpace.h>
+#include <kis_fixed_paint_device.h>
+
+namespace {
+
+/**
+ * QCache counts the cost in ints, so we measure the memory in KiB
+ * to be safe with big dabs
+ */
+int memoryCost(KisFixedPaintDeviceSP dab)
+{
+    const qint64 size = qint64(dab->bounds().width()) * dab->bounds().height() * dab->pixelSize();
+    return int(qMax(qint64(1), size / 1024));
+}
+
+void copyDab(KisFixedPaintDeviceSP src, KisFixedPaintDeviceSP dst)
+{
+    dst->setColorSpace(src->colorSpace());
+    dst->setRect(src->bounds());
+    dst->lazyGrowBufferWithoutInitialization();
+
+    memcpy(dst->data(), src->constData(),
+           src->bounds().width() * src->bounds().height() * src->pixelSize());
+}
+
+struct CachedDab {
+    KisFixedPaintDeviceSP dab;
+};
+
+std::atomic<quint64> s_lastBrushId {0};
+
+}
+
+Q_GLOBAL_STATIC(KisBrushDabCache, s_instance)
+
+bool KisBrushDabCache::Key::operator==(const Key &rhs) const
+{
+    return brushId == rhs.brushId &&
+        colorSpace == rhs.colorSpace &&
+        color == rhs.color &&
+        width == rhs.width &&
+        height == rhs.height &&
+        index == rhs.index &&
+        angle == rhs.angle &&
+        ratio == rhs.ratio &&
+        subPixelX == rhs.subPixelX &&
+        subPixelY == rhs.subPixelY &&
+        softnessFactor == rhs.softnessFactor &&
+        lightnessStrength == rhs.lightnessStrength &&
+        precisionLevel == rhs.precisionLevel &&
+        horizontalMirror == rhs.horizontalMirror &&
+        verticalMirror == rhs.verticalMirror;
+}
+
+uint qHash(const KisBrushDabCache::Key &key, uint seed)
+{
+    uint hash = qHash(key.color, seed);
+    hash ^= qHash(quintptr(key.colorSpace));
+    hash ^= qHash(key.brushId);
+    hash = 31 * hash + uint(key.width);
+    hash = 31 * hash + uint(key.height);
+    hash = 31 * hash + uint(key.index);
+    hash = 31 * hash + uint(key.angle);
+    hash = 31 * hash + uint(key.ratio);
+    hash = 31 * hash + uint(key.subPixelX);
+    hash = 31 * hash + uint(key.subPixelY);
+    hash = 31 * hash + uint(key.softnessFactor);
+    hash = 31 * hash + uint(key.lightnessStrength);
+    hash = 31 * hash + uint(key.precisionLevel);
+    hash = 31 * hash + (uint(key.horizontalMirror) << 1 | uint(key.verticalMirror));
+    return hash;
+}
+
+struct KisBrushDabCache::Private
+{
+    Private(qint64 maxMemorySize)
+        : dabs(int(qMax(qint64(1), maxMemorySize / 1024)))
+    {
+    }
+
+    mutable QMutex mutex;
+    QCache<Key, CachedDab> dabs;
+
+    qint64 hits = 0;
+    qint64 misses = 0;
+};
+
+KisBrushDabCache::KisBrushDabCache(qint64 maxMemorySize)
+    : m_d(new Private(maxMemorySize))
+{
+}
+
+KisBrushDabCache::~KisBrushDabCache()
+{
+}
+
+KisBrushDabCache* KisBrushDabCache::instance()
+{
+    return s_instance;
+}
+
+quint64 KisBrushDabCache::createBrushId()
+{
+    return ++s_lastBrushId;
+}
+
+bool KisBrushDabCache::fetch(const Key &key, KisFixedPaintDeviceSP dab)
+{
+    QMutexLocker l(&m_d->mutex);
+
+    CachedDab *cachedDab = m_d->dabs.object(key);
+
+    if (!cachedDab) {
+        m_d->misses++;
+        return false;
+    }
+
+    m_d->hits++;
+    copyDab(cachedDab->dab, dab);
+
+    return true;
+}
+
+void KisBrushDabCache::insert(const Key &key, KisFixedPaintDeviceSP dab)
+{
+    KisFixedPaintDeviceSP copy = new KisFixedPaintDevice(dab->colorSpace());
+    copyDab(dab, copy);
+
+    QMutexLocker l(&m_d->mutex);
+    m_d->dabs.insert(key, new CachedDab{copy}, memoryCost(copy));
+}
+
+void KisBrushDabCache::clear()
+{
+    QMutexLocker l(&m_d->mutex);
+    m_d->dabs.clear();
+    m_d->hits = 0;
+    m_d->misses = 0;
+}
+
+KisBrushDabCache::Statistics KisBrushDabCache::statistics() const
+{
+    QMutexLocker l(&m_d->mutex);
+
+    Statistics stats;
+    stats.hits = m_d->hits;
+    stats.misses = m_d->misses;
+    stats.numDabs = int(m_d->dabs.count());
+    stats.memorySize = qint64(m_d->dabs.totalCost()) * 1024;
+
+    return stats;
+}
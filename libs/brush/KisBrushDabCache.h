@@ -0,0 +1,114 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISBRUSHDABCACHE_H
+#define KISBRUSHDABCACHE_H
+
+#include <QByteArray>
+#include <QScopedPointer>
+
+#include "kis_types.h"
+#include "kritabrush_export.h"
+
+class KoColorSpace;
+
+/**
+ * A bounded cache of the rendered dabs of the brush tips.
+ *
+ * All the brushes share a single global cache (see instance()), so the
+ * memory budget doesn't grow with the number of loaded presets. The dabs
+ * of different brushes are told apart by Key::brushId, which is shared
+ * between all the clones of a brush object, that is, between all the
+ * threads and all the strokes painted with the same preset. The brush
+ * gets a new id when any of its properties that affect the rendered dabs
+ * changes, the dabs of the old id are just left to be dropped.
+ *
+ * The dabs are looked up by a quantized key, the quantization steps are
+ * decided by the user of the cache (usually, KisDabCacheBase uses the
+ * precision level of the preset). When the cache overgrows its memory
+ * limit, the least recently used dabs are dropped.
+ *
+ * The cache is thread-safe.
+ */
+class BRUSH_EXPORT KisBrushDabCache
+{
+public:
+    struct BRUSH_EXPORT Key {
+        quint64 brushId = 0;
+
+        const KoColorSpace *colorSpace = nullptr;
+        QByteArray color;
+
+        int width = 0;
+        int height = 0;
+        int index = 0;
+
+        int angle = 0;
+        int ratio = 0;
+        int subPixelX = 0;
+        int subPixelY = 0;
+        int softnessFactor = 0;
+        int lightnessStrength = 0;
+        int precisionLevel = 0;
+
+        bool horizontalMirror = false;
+        bool verticalMirror = false;
+
+        bool operator==(const Key &rhs) const;
+    };
+
+    struct Statistics {
+        qint64 hits = 0;
+        qint64 misses = 0;
+
+        int numDabs = 0;
+
+        /// the memory occupied by the cached dabs
+        qint64 memorySize = 0;
+
+        qreal hitRate() const {
+            return hits + misses > 0 ? qreal(hits) / (hits + misses) : 0.0;
+        }
+    };
+
+public:
+    KisBrushDabCache(qint64 maxMemorySize = 16 * 1024 * 1024);
+    ~KisBrushDabCache();
+
+    /**
+     * The cache shared by all the brushes. It is cleared when the user
+     * switches to another preset.
+     */
+    static KisBrushDabCache* instance();
+
+    /**
+     * Returns a new unique brush id for Key::brushId, never zero
+     */
+    static quint64 createBrushId();
+
+    /**
+     * Copies the cached dab for \p key into \p dab. Returns false if
+     * there is no such dab in the cache.
+     */
+    bool fetch(const Key &key, KisFixedPaintDeviceSP dab);
+
+    /**
+     * Saves a copy of \p dab in the cache
+     */
+    void insert(const Key &key, KisFixedPaintDeviceSP dab);
+
+    void clear();
+
+    Statistics statistics() const;
+
+private:
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+BRUSH_EXPORT uint qHash(const KisBrushDabCache::Key &key, uint seed = 0);
+
+#endif // KISBRUSHDABCACHE_H
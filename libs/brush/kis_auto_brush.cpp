@@ -462,3 +462,13 @@ bool KisAutoBrush::supportsCaching() const
 {
     return qFuzzyCompare(density(), 1.0) && qFuzzyCompare(randomness(), 0.0);
 }
+
+quint64 KisAutoBrush::persistentDabCacheId() const
+{
+    /**
+     * The masks are generated by the vectorized applicators, which is
+     * about as fast as copying a cached dab, so it is not worth wasting
+     * the memory for that
+     */
+    return 0;
+}
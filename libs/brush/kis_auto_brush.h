@@ -79,6 +79,8 @@ public:
     void lodLimitations(KisPaintopLodLimitations *l) const override;
 
     bool supportsCaching() const override;
+
+    quint64 persistentDabCacheId() const override;
 private:
 
     QImage createBrushPreview(int maxSize = -1);
@@ -43,6 +43,7 @@
 #include <KisLazySharedCacheStorage.h>
 #include <KisOptimizedBrushOutline.h>
 #include <KisStaticInitializer.h>
+#include <KisBrushDabCache.h>
 
 
 KIS_DECLARE_STATIC_INITIALIZER {
@@ -162,7 +163,18 @@ struct KisBrush::Private {
            * the objects calls cache.reset().
            */
           brushPyramid(rhs.brushPyramid),
-          brushOutline(rhs.brushOutline)
+          brushOutline(rhs.brushOutline),
+          /**
+           * The dab cache id is shared between the clones the same way as
+           * the pyramid, the brush op clones the brush for every stroke
+           * and every rendering thread. Any change of the brush
+           * generates a new id instead of invalidating the shared dabs.
+           *
+           * The resource server brushes never use the cache, it is
+           * enabled by the brush factory for the copy it creates for
+           * the preset (see enablePersistentDabCache()).
+           */
+          dabCacheId(rhs.dabCacheId)
     {
         gradient = rhs.gradient;
         if (rhs.cachedGradient) {
@@ -194,6 +206,13 @@ struct KisBrush::Private {
     QImage brushTipImage;
     mutable KisLazySharedCacheStorageLinked<KisQImagePyramid, const KisBrush*> brushPyramid;
     mutable KisLazySharedCacheStorageLinked<KisOptimizedBrushOutline, const KisBrush*> brushOutline;
+    quint64 dabCacheId = 0;
+
+    void resetDabCache() {
+        if (dabCacheId) {
+            dabCacheId = KisBrushDabCache::createBrushId();
+        }
+    }
 };
 
 KisBrush::KisBrush()
@@ -320,6 +339,8 @@ void KisBrush::setGradient(KoAbstractGradientSP gradient) {
         } else {
             d->cachedGradient->setGradient(d->gradient, 256, d->gradient->colorSpace());
         }
+
+        d->resetDabCache();
     }
 }
 
@@ -564,6 +585,7 @@ void KisBrush::prepareForSeqNo(const KisPaintInformation &info, int seqNo)
 void KisBrush::clearBrushPyramid()
 {
     d->brushPyramid.reset();
+    d->resetDabCache();
 }
 
 void KisBrush::mask(KisFixedPaintDeviceSP dst, const KoColor& color, KisDabShape const& shape, const KisPaintInformation& info, double subPixelX, double subPixelY, qreal softnessFactor, qreal lightnessStrength) const
@@ -635,6 +657,8 @@ void KisBrush::generateMaskAndApplyMaskOrCreateDab(KisFixedPaintDeviceSP dst,
         }
     }
 
+    QScopedArrayPointer<quint8> alphaArray(!color ? new quint8[maskWidth] : nullptr);
+
     KoColor gradientcolor(Qt::blue, cs);
     for (int y = 0; y < maskHeight; y++) {
         const quint8* maskPointer = outputImage.constScanLine(y);
@@ -674,7 +698,6 @@ void KisBrush::generateMaskAndApplyMaskOrCreateDab(KisFixedPaintDeviceSP dst,
                 }
             }
 
-            QScopedArrayPointer<quint8> alphaArray(new quint8[maskWidth]);
             fetchPremultipliedRed(reinterpret_cast<const QRgb*>(maskPointer), alphaArray.data(), maskWidth);
             cs->applyAlphaU8Mask(rowPointer, alphaArray.data(), maskWidth);
         }
@@ -726,7 +749,10 @@ bool KisBrush::outlineCacheIsValid() const
 
 void KisBrush::setScale(qreal _scale)
 {
-    d->scale = _scale;
+    if (!qFuzzyCompare(d->scale, _scale)) {
+        d->scale = _scale;
+        d->resetDabCache();
+    }
 }
 
 qreal KisBrush::scale() const
@@ -736,7 +762,10 @@ qreal KisBrush::scale() const
 
 void KisBrush::setAngle(qreal _rotation)
 {
-    d->angle = _rotation;
+    if (!qFuzzyCompare(d->angle, _rotation)) {
+        d->angle = _rotation;
+        d->resetDabCache();
+    }
 }
 
 qreal KisBrush::angle() const
@@ -763,6 +792,16 @@ bool KisBrush::supportsCaching() const
     return true;
 }
 
+void KisBrush::enablePersistentDabCache()
+{
+    d->dabCacheId = KisBrushDabCache::createBrushId();
+}
+
+quint64 KisBrush::persistentDabCacheId() const
+{
+    return d->brushType == MASK || d->brushType == IMAGE ? d->dabCacheId : 0;
+}
+
 void KisBrush::coldInitBrush()
 {
     d->brushPyramid.initialize(this);
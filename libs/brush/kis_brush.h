@@ -338,6 +338,23 @@ public:
 
     virtual bool supportsCaching() const;
 
+    /**
+     * Assigns a new id in the global dab cache (KisBrushDabCache::instance())
+     * to the brush. The id is not shared with any existing brush, only with
+     * the clones created from this brush afterwards. The brush factories
+     * call it for every brush they create, the brushes stored in the
+     * resource server never use the cache.
+     */
+    void enablePersistentDabCache();
+
+    /**
+     * Returns the id of the brush in the global dab cache, which is shared
+     * between all the clones of this brush and, therefore, lives across the
+     * strokes painted with the same preset. Returns zero if the brush
+     * doesn't use the cache or its dabs should not be cached this way.
+     */
+    virtual quint64 persistentDabCacheId() const;
+
     virtual void coldInitBrush();
 
     static const QString brushTypeMetaDataKey;
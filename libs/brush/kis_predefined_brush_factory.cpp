@@ -56,6 +56,14 @@ KoResourceLoadResult KisPredefinedBrushFactory::createBrush(const KisBrushModel:
 
     brush->setBrushApplication(brushData.predefinedBrush.application);
 
+    /**
+     * The resource server brush is shared by all the presets using this
+     * tip, so it never uses the dab cache. Every preset gets its own id
+     * in the global cache, which is then shared by the clones the paintop
+     * makes for the strokes.
+     */
+    brush->enablePersistentDabCache();
+
     return brush;
 }
 
@@ -39,6 +39,7 @@ KoResourceLoadResult KisTextBrushFactory::createBrush(const KisBrushModel::Brush
     brush->setPipeMode(data.textBrush.usePipeMode);
     brush->setSpacing(data.common.spacing);
     brush->updateBrush();
+    brush->enablePersistentDabCache();
 
     return brush;
 }
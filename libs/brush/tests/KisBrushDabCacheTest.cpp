@@ -0,0 +1,203 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisBrushDabCacheTest.h"
+
+#include <simpletest.h>
+
+#include <KoColor.h>
+#include <KoColorSpace.h>
+#include <KoColorSpaceRegistry.h>
+#include <kis_fixed_paint_device.h>
+#include <kis_paint_device.h>
+
+#include <KisLocalStrokeResources.h>
+#include <KisResourceTypes.h>
+
+#include "KisBrushDabCache.h"
+#include "kis_gbr_brush.h"
+#include "kis_predefined_brush_factory.h"
+
+namespace {
+
+KisFixedPaintDeviceSP createDab(const QSize &size, const QColor &color)
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+
+    KisFixedPaintDeviceSP dab = new KisFixedPaintDevice(cs);
+    dab->setRect(QRect(QPoint(), size));
+    dab->initialize();
+    dab->fill(dab->bounds(), KoColor(color, cs));
+
+    return dab;
+}
+
+KisBrushDabCache::Key createKey(int angle)
+{
+    KisBrushDabCache::Key key;
+    key.colorSpace = KoColorSpaceRegistry::instance()->rgb8();
+    key.color = QByteArray(4, '\xff');
+    key.width = 10;
+    key.height = 10;
+    key.angle = angle;
+
+    return key;
+}
+
+KisGbrBrushSP createBrush()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+
+    // the brush made from a QImage has no type, so it never uses the cache
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+    dev->fill(QRect(0, 0, 32, 32), KoColor(Qt::black, cs));
+
+    KisGbrBrushSP brush(new KisGbrBrush(dev, 0, 0, 32, 32));
+    brush->setName("test");
+    brush->setFilename("test.gbr");
+    brush->makeMaskImage(false);
+
+    return brush;
+}
+
+bool dabsEqual(KisFixedPaintDeviceSP lhs, KisFixedPaintDeviceSP rhs)
+{
+    return lhs->bounds() == rhs->bounds() &&
+        *lhs->colorSpace() == *rhs->colorSpace() &&
+        !memcmp(lhs->constData(), rhs->constData(),
+                lhs->bounds().width() * lhs->bounds().height() * lhs->pixelSize());
+}
+
+}
+
+void KisBrushDabCacheTest::testFetchAndInsert()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+
+    KisBrushDabCache cache;
+    KisFixedPaintDeviceSP dab = createDab(QSize(10, 10), Qt::red);
+    KisFixedPaintDeviceSP result = new KisFixedPaintDevice(cs);
+
+    QVERIFY(!cache.fetch(createKey(1), result));
+
+    cache.insert(createKey(1), dab);
+
+    QVERIFY(!cache.fetch(createKey(2), result));
+
+    // the dabs of different brushes never mix
+    KisBrushDabCache::Key otherBrushKey = createKey(1);
+    otherBrushKey.brushId = KisBrushDabCache::createBrushId();
+    QVERIFY(!cache.fetch(otherBrushKey, result));
+
+    QVERIFY(cache.fetch(createKey(1), result));
+    QVERIFY(dabsEqual(result, dab));
+
+    // the cache keeps its own copy of the dab
+    dab->fill(dab->bounds(), KoColor(Qt::blue, cs));
+    QVERIFY(cache.fetch(createKey(1), result));
+    QVERIFY(dabsEqual(result, createDab(QSize(10, 10), Qt::red)));
+
+    KisBrushDabCache::Statistics stats = cache.statistics();
+    QCOMPARE(stats.hits, qint64(2));
+    QCOMPARE(stats.misses, qint64(3));
+    QCOMPARE(stats.numDabs, 1);
+    QCOMPARE(stats.hitRate(), 0.4);
+
+    cache.clear();
+    stats = cache.statistics();
+    QCOMPARE(stats.hits, qint64(0));
+    QCOMPARE(stats.numDabs, 0);
+    QVERIFY(!cache.fetch(createKey(1), result));
+}
+
+void KisBrushDabCacheTest::testMemoryLimit()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+
+    // every dab takes about 39 KiB, so only one of them fits
+    const qint64 maxMemorySize = 64 * 1024;
+    KisBrushDabCache cache(maxMemorySize);
+    KisFixedPaintDeviceSP result = new KisFixedPaintDevice(cs);
+
+    for (int i = 0; i < 3; i++) {
+        cache.insert(createKey(i), createDab(QSize(100, 100), Qt::red));
+    }
+
+    const KisBrushDabCache::Statistics stats = cache.statistics();
+    QCOMPARE(stats.numDabs, 1);
+    QVERIFY(stats.memorySize <= maxMemorySize);
+
+    QVERIFY(!cache.fetch(createKey(0), result));
+    QVERIFY(cache.fetch(createKey(2), result));
+}
+
+void KisBrushDabCacheTest::testSharingBetweenClones()
+{
+    KisGbrBrushSP brush = createBrush();
+
+    // the brushes get their cache id only from the brush factory
+    QVERIFY(!brush->persistentDabCacheId());
+    brush->setAngle(0.5);
+    QVERIFY(!brush->persistentDabCacheId());
+
+    brush->enablePersistentDabCache();
+    const quint64 cacheId = brush->persistentDabCacheId();
+    QVERIFY(cacheId);
+
+    KisBrushSP clone = brush->clone().dynamicCast<KisBrush>();
+    QCOMPARE(clone->persistentDabCacheId(), cacheId);
+
+    // changing the clone detaches its cache id, but keeps the source one
+    clone->setAngle(1.0);
+    QVERIFY(clone->persistentDabCacheId());
+    QVERIFY(clone->persistentDabCacheId() != cacheId);
+    QCOMPARE(brush->persistentDabCacheId(), cacheId);
+
+    // regenerating the tip drops the cached dabs
+    brush->makeMaskImage(false);
+    QVERIFY(brush->persistentDabCacheId());
+    QVERIFY(brush->persistentDabCacheId() != cacheId);
+}
+
+void KisBrushDabCacheTest::testFactoryBrushGetsOwnCacheId()
+{
+    KisResourcesInterfaceSP resourcesInterface(new KisLocalStrokeResources({createBrush()}));
+    auto resourceSourceAdapter = resourcesInterface->source<KisBrush>(ResourceType::Brushes);
+
+    KisBrushSP sourceBrush = resourceSourceAdapter.fallbackResource();
+    QVERIFY(sourceBrush);
+
+    // the default scale and angle don't detach anything from the source
+    KisBrushModel::BrushData data;
+    data.type = KisBrushModel::Predefined;
+    KisPredefinedBrushFactory::loadFromBrushResource(data.common, data.predefinedBrush, sourceBrush);
+
+    KisPredefinedBrushFactory factory("gbr_brush");
+
+    KisBrushSP brush1 = factory.createBrush(data, resourcesInterface).resource<KisBrush>();
+    KisBrushSP brush2 = factory.createBrush(data, resourcesInterface).resource<KisBrush>();
+    QVERIFY(brush1);
+    QVERIFY(brush2);
+
+    KisBrushSP masterBrush =
+        resourceSourceAdapter.bestMatch(data.predefinedBrush.resourceSignature.md5sum,
+                                        data.predefinedBrush.resourceSignature.filename, "");
+    QCOMPARE(masterBrush, sourceBrush);
+
+    // the resource server brush never uses the cache...
+    QVERIFY(!masterBrush->persistentDabCacheId());
+
+    // ...and every preset gets its own id in the global one
+    QVERIFY(brush1->persistentDabCacheId());
+    QVERIFY(brush2->persistentDabCacheId());
+    QVERIFY(brush1->persistentDabCacheId() != brush2->persistentDabCacheId());
+
+    // the clones made for the strokes still share it
+    KisBrushSP strokeClone = brush1->clone().dynamicCast<KisBrush>();
+    QCOMPARE(strokeClone->persistentDabCacheId(), brush1->persistentDabCacheId());
+}
+
+SIMPLE_TEST_MAIN(KisBrushDabCacheTest)
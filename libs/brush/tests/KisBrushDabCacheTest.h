@@ -0,0 +1,23 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISBRUSHDABCACHETEST_H
+#define KISBRUSHDABCACHETEST_H
+
+#include <QObject>
+
+class KisBrushDabCacheTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testFetchAndInsert();
+    void testMemoryLimit();
+    void testSharingBetweenClones();
+    void testFactoryBrushGetsOwnCacheId();
+};
+
+#endif // KISBRUSHDABCACHETEST_H
@@ -16,6 +16,8 @@
 #include <QMutexLocker>
 #include <kis_lockless_stack.h>
 
+#include <atomic>
+
 #define CALL_MEMBER(obj, pmf) ((obj).*(pmf))
 
 class QSBR
@@ -39,24 +41,62 @@ private:
         }
     };
 
-    QAtomicInt m_rawPointerUsers;
+    /**
+     * The raw pointer users are counted in several slots, each on
+     * its own cache line. Every thread always uses the same slot, so
+     * the readers running in different threads do not bounce the
+     * same cache line on every access to the map. The reclaimer
+     * just checks that all the slots are zero.
+     *
+     * Every paint device owns a few maps, so the number of slots is
+     * kept small: four cache lines already split the readers of the
+     * usual thread pool well enough, and the cost stays at 256 bytes
+     * per map.
+     */
+    static const int NumRawPointerSlots = 4;
+
+    struct alignas(64) RawPointerUsersSlot {
+        QAtomicInt counter;
+    };
+
+    RawPointerUsersSlot m_rawPointerUsers[NumRawPointerSlots];
     KisLocklessStack<Action> m_pendingActions;
     KisLocklessStack<Action> m_migrationReclaimActions;
 
+    static int currentThreadSlot() {
+        static std::atomic<int> nextSlot(0);
+        static thread_local int slot = nextSlot.fetch_add(1, std::memory_order_relaxed) % NumRawPointerSlots;
+        return slot;
+    }
+
+    bool hasRawPointerUsers() const {
+        for (int i = 0; i < NumRawPointerSlots; i++) {
+            if (m_rawPointerUsers[i].counter.loadAcquire()) return true;
+        }
+        return false;
+    }
+
     void releasePoolSafely(KisLocklessStack<Action> *pool, bool force = false) {
+        /**
+         * Check the size first: it is only a read of an atomic, while
+         * mergeFrom() would write to the shared cache line of the pool
+         * on every call, even when the pool is empty.
+         */
+        if (pool->isEmpty()) return;
+
         KisLocklessStack<Action> tmp;
         tmp.mergeFrom(*pool);
         if (tmp.isEmpty()) return;
 
         if (force || tmp.size() > 4096) {
-            while (m_rawPointerUsers.loadAcquire());
+            while (hasRawPointerUsers());
 
             Action action;
             while (tmp.pop(action)) {
                 action();
             }
         } else {
-            if (!m_rawPointerUsers.loadAcquire()) {
+            if (!hasRawPointerUsers()) {
                 Action action;
                 while (tmp.pop(action)) {
                     action();
@@ -107,16 +147,16 @@ public:
 
     void lockRawPointerAccess()
     {
-        m_rawPointerUsers.ref();
+        m_rawPointerUsers[currentThreadSlot()].counter.ref();
     }
 
     void unlockRawPointerAccess()
     {
-        m_rawPointerUsers.deref();
+        m_rawPointerUsers[currentThreadSlot()].counter.deref();
     }
 
     bool sanityRawPointerAccessLocked() const {
-        return m_rawPointerUsers.loadAcquire();
+        return m_rawPointerUsers[currentThreadSlot()].counter.loadAcquire();
     }
 };
 
@@ -0,0 +1,141 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisRowBandReader.h"
+
+#include <KoColor.h>
+#include <KoColorSpace.h>
+
+#include "kis_paint_device.h"
+#include "kis_painter.h"
+#include "kis_algebra_2d.h"
+
+
+struct KisRowBandReader::Private
+{
+    KisPaintDeviceSP source;
+    QRect rect;
+    const KoColorSpace *dstColorSpace = nullptr;
+    KoColorConversionTransformation::Intent renderingIntent;
+    KoColorConversionTransformation::ConversionFlags conversionFlags;
+    int bandHeight = DefaultBandHeight;
+
+    bool hasBackgroundColor = false;
+    KoColor backgroundColor;
+
+    KisPaintDeviceSP flattenedBand;
+    KisPaintDeviceSP convertedBand;
+    QRect currentBand;
+
+    QVector<quint8> srcBuffer;
+    QVector<quint8> dstBuffer;
+
+    bool needsConversion() const {
+        return *dstColorSpace != *source->colorSpace();
+    }
+
+    void loadBand(const QRect &band);
+};
+
+KisRowBandReader::KisRowBandReader(KisPaintDeviceSP source,
+                                   const QRect &rect,
+                                   const KoColorSpace *dstColorSpace,
+                                   KoColorConversionTransformation::Intent renderingIntent,
+                                   KoColorConversionTransformation::ConversionFlags conversionFlags,
+                                   int bandHeight)
+    : m_d(new Private)
+{
+    KIS_SAFE_ASSERT_RECOVER_NOOP(source);
+    KIS_SAFE_ASSERT_RECOVER_NOOP(bandHeight > 0);
+
+    m_d->source = source;
+    m_d->rect = rect;
+    m_d->dstColorSpace = dstColorSpace ? dstColorSpace : source->colorSpace();
+    m_d->renderingIntent = renderingIntent;
+    m_d->conversionFlags = conversionFlags;
+    m_d->bandHeight = qMax(1, bandHeight);
+}
+
+KisRowBandReader::~KisRowBandReader()
+{
+}
+
+void KisRowBandReader::setBackgroundColor(const KoColor &color)
+{
+    m_d->hasBackgroundColor = true;
+    m_d->backgroundColor = color.convertedTo(m_d->source->colorSpace());
+    m_d->currentBand = QRect();
+}
+
+const KoColorSpace *KisRowBandReader::colorSpace() const
+{
+    return m_d->dstColorSpace;
+}
+
+QRect KisRowBandReader::rect() const
+{
+    return m_d->rect;
+}
+
+KisPaintDeviceSP KisRowBandReader::deviceForRow(int y)
+{
+    KIS_SAFE_ASSERT_RECOVER_NOOP(y >= m_d->rect.top() && y <= m_d->rect.bottom());
+
+    if (!m_d->hasBackgroundColor && !m_d->needsConversion()) {
+        return m_d->source;
+    }
+
+    if (y < m_d->currentBand.top() || y > m_d->currentBand.bottom()) {
+        const int top = y - KisAlgebra2D::wrapValue(y - m_d->rect.top(), m_d->bandHeight);
+        const int bottom = qMin(top + m_d->bandHeight - 1, m_d->rect.bottom());
+
+        m_d->loadBand(QRect(m_d->rect.left(), top, m_d->rect.width(), bottom - top + 1));
+    }
+
+    return m_d->needsConversion() ? m_d->convertedBand : m_d->flattenedBand;
+}
+
+void KisRowBandReader::Private::loadBand(const QRect &band)
+{
+    KisPaintDeviceSP bandSource = source;
+
+    if (hasBackgroundColor) {
+        if (!flattenedBand) {
+            flattenedBand = new KisPaintDevice(source->colorSpace());
+        }
+
+        // drop the tiles of the previous band
+        flattenedBand->clear();
+        flattenedBand->fill(band, backgroundColor);
+
+        KisPainter gc(flattenedBand);
+        gc.bitBlt(band.topLeft(), source, band);
+        gc.end();
+
+        bandSource = flattenedBand;
+    }
+
+    if (needsConversion()) {
+        if (!convertedBand) {
+            convertedBand = new KisPaintDevice(dstColorSpace);
+        }
+
+        const int numPixels = band.width() * band.height();
+
+        srcBuffer.resize(numPixels * bandSource->pixelSize());
+        dstBuffer.resize(numPixels * dstColorSpace->pixelSize());
+
+        bandSource->readBytes(srcBuffer.data(), band);
+        bandSource->colorSpace()->convertPixelsTo(srcBuffer.data(), dstBuffer.data(),
+                                                  dstColorSpace, numPixels,
+                                                  renderingIntent, conversionFlags);
+
+        convertedBand->clear();
+        convertedBand->writeBytes(dstBuffer.data(), band);
+    }
+
+    currentBand = band;
+}
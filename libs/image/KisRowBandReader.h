@@ -0,0 +1,100 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISROWBANDREADER_H
+#define KISROWBANDREADER_H
+
+#include <QScopedPointer>
+
+#include <kis_types.h>
+#include <KoColorConversionTransformation.h>
+#include "kritaimage_export.h"
+
+class KoColor;
+class KoColorSpace;
+
+
+/**
+ * A helper class for the export filters that need the pixels of a paint
+ * device (usually, the projection of the image) in a different color
+ * space or flattened onto an opaque background color.
+ *
+ * Instead of creating a converted copy of the whole device, the reader
+ * prepares the pixels in bands of rows on request, so the memory
+ * consumption doesn't depend on the size of the image. The band is
+ * stored in a temporary device at the same coordinates as in the source
+ * device, so the existing code that iterates over the device line by
+ * line needs only to request the device for every row it reads:
+ *
+ * \code{.cpp}
+ * KisRowBandReader reader(image->projection(), image->bounds(), dstColorSpace);
+ *
+ * for (int y = rc.top(); y <= rc.bottom(); y++) {
+ *     KisHLineConstIteratorSP it =
+ *         reader.deviceForRow(y)->createHLineConstIteratorNG(rc.x(), y, rc.width());
+ *
+ *     // ... read the converted pixels ...
+ * }
+ * \endcode
+ *
+ * The band is regenerated each time a row outside of it is requested, so
+ * the rows should be read in (mostly) sequential order.
+ *
+ * When no conversion and no flattening is needed, the reader returns
+ * the source device itself.
+ */
+class KRITAIMAGE_EXPORT KisRowBandReader
+{
+public:
+    static const int DefaultBandHeight = 64;
+
+public:
+    /**
+     * @param source the device to read the pixels from
+     * @param rect the area of the \p source that will be read
+     * @param dstColorSpace the color space the pixels are converted into,
+     *        if null, the pixels are kept in the color space of \p source
+     */
+    KisRowBandReader(KisPaintDeviceSP source,
+                     const QRect &rect,
+                     const KoColorSpace *dstColorSpace = nullptr,
+                     KoColorConversionTransformation::Intent renderingIntent = KoColorConversionTransformation::internalRenderingIntent(),
+                     KoColorConversionTransformation::ConversionFlags conversionFlags = KoColorConversionTransformation::internalConversionFlags(),
+                     int bandHeight = DefaultBandHeight);
+    ~KisRowBandReader();
+
+    /**
+     * Composes the source pixels over an opaque \p color before the
+     * conversion (the color should be in the color space of the source
+     * device). The result is the same as filling a copy of the source
+     * with the color and bitBlt'ing the source over it.
+     */
+    void setBackgroundColor(const KoColor &color);
+
+    /**
+     * The color space of the devices returned by deviceForRow()
+     */
+    const KoColorSpace* colorSpace() const;
+
+    /**
+     * The rect passed to the constructor
+     */
+    QRect rect() const;
+
+    /**
+     * @return a device that has valid pixels at least in the band
+     * containing the row \p y. Other areas of the device are
+     * undefined. The returned device is valid until the next call
+     * to deviceForRow().
+     */
+    KisPaintDeviceSP deviceForRow(int y);
+
+private:
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+#endif // KISROWBANDREADER_H
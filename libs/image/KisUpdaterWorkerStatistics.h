@@ -0,0 +1,44 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISUPDATERWORKERSTATISTICS_H
+#define KISUPDATERWORKERSTATISTICS_H
+
+#include <QtGlobal>
+
+/**
+ * Per-worker statistics of the updater context. Each worker
+ * accumulates the time it has spent executing jobs since the
+ * last reset of the statistics, so one can estimate how well
+ * the work is spread between the available threads.
+ */
+struct KisUpdaterWorkerStatistics
+{
+    /**
+     * The number of jobs (merge, stroke or spontaneous) the
+     * worker has completed
+     */
+    int numJobs = 0;
+
+    /**
+     * The time the worker has spent running jobs
+     */
+    qint64 busyTimeNSecs = 0;
+
+    /**
+     * The time elapsed since the statistics was reset
+     */
+    qint64 wallTimeNSecs = 0;
+
+    /**
+     * The fraction of wall time the worker was busy, [0.0...1.0]
+     */
+    qreal utilization() const {
+        return wallTimeNSecs > 0 ? qMin(1.0, qreal(busyTimeNSecs) / wallTimeNSecs) : 0.0;
+    }
+};
+
+#endif // KISUPDATERWORKERSTATISTICS_H
@@ -109,12 +109,29 @@ public:
      * Reads and writes the tiles
      *
      */
-    inline bool write(KisPaintDeviceWriter &writer) {
-        return ACTUAL_DATAMGR::write(writer);
+    inline bool write(KisPaintDeviceWriter &writer, const KisTilesStreamOptions &options = KisTilesStreamOptions()) {
+        return ACTUAL_DATAMGR::write(writer, options);
     }
 
-    inline bool read(QIODevice *io) {
-        return ACTUAL_DATAMGR::read(io);
+    inline bool read(QIODevice *io, const KisTilesStreamOptions &options = KisTilesStreamOptions()) {
+        return ACTUAL_DATAMGR::read(io, options);
+    }
+
+    /**
+     * Reads and writes only the tiles that differ from some base,
+     * see KisTiledDataManager::writeDelta()
+     */
+    inline KisTiledDataManagerDelta collectDifferentTiles(KisDataManager *base) {
+        return ACTUAL_DATAMGR::collectDifferentTiles(base);
+    }
+
+    inline bool writeDelta(KisPaintDeviceWriter &writer, const KisTiledDataManagerDelta &delta,
+                           const KisTilesStreamOptions &options = KisTilesStreamOptions()) {
+        return ACTUAL_DATAMGR::writeDelta(writer, delta, options);
+    }
+
+    inline bool readDelta(QIODevice *io, const KisTilesStreamOptions &options = KisTilesStreamOptions()) {
+        return ACTUAL_DATAMGR::readDelta(io, options);
     }
 
     inline void purge(const QRect& area) {
@@ -2321,6 +2321,16 @@ int KisImage::workingThreadsLimit() const
     return m_d->scheduler.threadsLimit();
 }
 
+QVector<KisUpdaterWorkerStatistics> KisImage::workingThreadsStatistics() const
+{
+    return m_d->scheduler.workerStatistics();
+}
+
+void KisImage::resetWorkingThreadsStatistics()
+{
+    m_d->scheduler.resetWorkerStatistics();
+}
+
 void KisImage::notifySelectionChanged()
 {
     /**
@@ -23,6 +23,7 @@
 #include "kis_strokes_queue_undo_result.h"
 #include "KisLodPreferences.h"
 #include "KisWraparoundAxis.h"
+#include "KisUpdaterWorkerStatistics.h"
 
 #include <kritaimage_export.h>
 
@@ -105,6 +106,17 @@ public:
      */
     int workingThreadsLimit() const;
 
+    /**
+     * Return per-thread utilization statistics of the image's working
+     * threads since the last call to resetWorkingThreadsStatistics()
+     */
+    QVector<KisUpdaterWorkerStatistics> workingThreadsStatistics() const;
+
+    /**
+     * Reset per-thread utilization statistics of the image's working threads
+     */
+    void resetWorkingThreadsStatistics();
+
     /**
      * Makes a copy of the image with all the layers. If possible, shallow
      * copies of the layers are made.
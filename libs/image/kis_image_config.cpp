@@ -109,6 +109,13 @@ void KisImageConfig::setUpdatePatchWidth(int value)
     m_config.writeEntry("updatePatchWidth", value);
 }
 
+int KisImageConfig::updatePatchMinSize() const
+{
+    int patchSize = m_config.readEntry("updatePatchMinSize", 128);
+    if (patchSize <= 0) return 128;
+    return patchSize;
+}
+
 qreal KisImageConfig::maxCollectAlpha() const
 {
     return m_config.readEntry("maxCollectAlpha", 2.5);
@@ -168,6 +175,74 @@ void KisImageConfig::setSwapWindowSize(int value)
     m_config.writeEntry("swapWindowSize", value);
 }
 
+int KisImageConfig::swapStripesCount(bool requestDefault) const
+{
+    const int defaultStripesCount = qBound(1, QThread::idealThreadCount(), 8);
+
+    return !requestDefault ?
+        qMax(1, m_config.readEntry("swapStripesCount", defaultStripesCount)) : defaultStripesCount;
+}
+
+void KisImageConfig::setSwapStripesCount(int value)
+{
+    m_config.writeEntry("swapStripesCount", value);
+}
+
+QString KisImageConfig::swapCompressionAlgorithm(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("swapCompressionAlgorithm", "LZ4") : "LZ4";
+}
+
+void KisImageConfig::setSwapCompressionAlgorithm(const QString &value)
+{
+    m_config.writeEntry("swapCompressionAlgorithm", value);
+}
+
+QString KisImageConfig::fileTilesCompressionAlgorithm(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("fileTilesCompressionAlgorithm", "LZF") : "LZF";
+}
+
+void KisImageConfig::setFileTilesCompressionAlgorithm(const QString &value)
+{
+    m_config.writeEntry("fileTilesCompressionAlgorithm", value);
+}
+
+bool KisImageConfig::compactUniformTiles(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("compactUniformTiles", true) : true;
+}
+
+void KisImageConfig::setCompactUniformTiles(bool value)
+{
+    m_config.writeEntry("compactUniformTiles", value);
+}
+
+bool KisImageConfig::lazyTilesDecompression(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("lazyTilesDecompression", false) : false;
+}
+
+void KisImageConfig::setLazyTilesDecompression(bool value)
+{
+    m_config.writeEntry("lazyTilesDecompression", value);
+}
+
+int KisImageConfig::tilesHugePagesMode(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("tilesHugePagesMode", 0) : 0;
+}
+
+void KisImageConfig::setTilesHugePagesMode(int value)
+{
+    m_config.writeEntry("tilesHugePagesMode", value);
+}
+
 int KisImageConfig::tilesHardLimit() const
 {
     qreal hp = qreal(memoryHardLimitPercent()) / 100.0;
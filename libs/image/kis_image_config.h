@@ -30,6 +30,7 @@ public:
     void setUpdatePatchHeight(int value);
     int updatePatchWidth() const;
     void setUpdatePatchWidth(int value);
+    int updatePatchMinSize() const;
 
     qreal maxCollectAlpha() const;
     qreal maxMergeAlpha() const;
@@ -46,6 +47,54 @@ public:
     int swapWindowSize() const;
     void setSwapWindowSize(int value);
 
+    /**
+     * The number of independent stripes of the swap. Each stripe has its
+     * own lock, allocator and swap file segment, so tiles belonging to
+     * different stripes can be swapped in concurrently.
+     */
+    int swapStripesCount(bool requestDefault = false) const;
+    void setSwapStripesCount(int value);
+
+    /**
+     * Compression algorithms used for the tiles data: "LZF", "LZ4" or "ZLIB",
+     * \see KisCompressionFactory
+     *
+     * swapCompressionAlgorithm() is used for the tiles swapped out to disk,
+     * fileTilesCompressionAlgorithm() is used for the pixel data of the layers
+     * saved into .kra files. Please take into account that older versions of
+     * Krita can read only LZF-compressed tiles.
+     */
+    QString swapCompressionAlgorithm(bool requestDefault = false) const;
+    void setSwapCompressionAlgorithm(const QString &value);
+
+    QString fileTilesCompressionAlgorithm(bool requestDefault = false) const;
+    void setFileTilesCompressionAlgorithm(const QString &value);
+
+    /**
+     * When enabled, the tile data pooler frees the memory of the tiles
+     * that have all their pixels equal and keeps only a single pixel
+     * for them until the next access.
+     */
+    bool compactUniformTiles(bool requestDefault = false) const;
+    void setCompactUniformTiles(bool value);
+
+    /**
+     * When enabled, the tiles read from files are not decompressed on
+     * loading. Their compressed data is moved into the swap directly
+     * and decompressed on the first access to the tile only.
+     */
+    bool lazyTilesDecompression(bool requestDefault = false) const;
+    void setLazyTilesDecompression(bool value);
+
+    /**
+     * Whether the memory of the tiles should be backed by huge pages,
+     * \see KisTileDataArenaAllocator::HugePagesMode. The value is read
+     * only once on the first allocation of a tile, so the change is
+     * applied after the restart of the application only.
+     */
+    int tilesHugePagesMode(bool requestDefault = false) const;
+    void setTilesHugePagesMode(int value);
+
     int tilesHardLimit() const; // MiB
     int tilesSoftLimit() const; // MiB
     int poolLimit() const; // MiB
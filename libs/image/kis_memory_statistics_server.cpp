@@ -14,6 +14,7 @@
 #include "kis_signal_compressor.h"
 
 #include "tiles3/kis_tile_data_store.h"
+#include "tiles3/KisTileDataArenaAllocator.h"
 
 Q_GLOBAL_STATIC(KisMemoryStatisticsServer, s_instance)
 
@@ -144,6 +145,17 @@ KisMemoryStatisticsServer::fetchMemoryStatistics(KisImageSP image) const
     stats.poolSize = tileStats.poolSize;
 
     stats.swapSize = tileStats.swapSize;
+    stats.compactedSize = tileStats.compactedSize;
+
+    KisTileDataArenaAllocator::Statistics arenaStats =
+        KisTileDataArenaAllocator::instance()->statistics();
+
+    stats.tilesArenasSize = arenaStats.reservedSize;
+    stats.tilesArenasUsedSize = arenaStats.usedSize;
+    stats.tilesHugePageArenas = arenaStats.numHugePageArenas;
+
+    stats.swapPrefetchHits = tileStats.swapPrefetchHits;
+    stats.swapPrefetchMisses = tileStats.swapPrefetchMisses;
 
     KisImageConfig cfg(true);
 
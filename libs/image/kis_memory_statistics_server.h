@@ -33,6 +33,12 @@ public:
               poolSize(0),
 
               swapSize(0),
+              compactedSize(0),
+              tilesArenasSize(0),
+              tilesArenasUsedSize(0),
+              tilesHugePageArenas(0),
+              swapPrefetchHits(0),
+              swapPrefetchMisses(0),
 
               totalMemoryLimit(0),
               tilesHardLimit(0),
@@ -52,6 +58,12 @@ public:
         qint64 poolSize;
 
         qint64 swapSize;
+        qint64 compactedSize;
+        qint64 tilesArenasSize;
+        qint64 tilesArenasUsedSize;
+        qint64 tilesHugePageArenas;
+        qint64 swapPrefetchHits;
+        qint64 swapPrefetchMisses;
 
         qint64 totalMemoryLimit;
         qint64 tilesHardLimit;
@@ -57,6 +57,7 @@
 #include "kis_transform_worker.h"
 #include "kis_filter_strategy.h"
 #include "krita_utils.h"
+#include "KisRunnableStrokeJobsInterface.h"
 #include <KisStaticInitializer.h>
 
 KIS_DECLARE_STATIC_INITIALIZER {
@@ -101,7 +102,8 @@ public:
                            KoColorConversionTransformation::Intent renderingIntent,
                            KoColorConversionTransformation::ConversionFlags conversionFlags,
                            KUndo2Command *parentCommand,
-                           KoUpdater *progressUpdater);
+                           KoUpdater *progressUpdater,
+                           KisRunnableStrokeJobsInterface *jobsInterface);
     bool assignProfile(const KoColorProfile * profile, KUndo2Command *parentCommand);
 
     KUndo2Command* reincarnateWithDetachedHistory(bool copyContent);
@@ -378,19 +380,69 @@ public:
         return m_frames.keys();
     }
 
-    bool readFrame(QIODevice *stream, int frameId)
+    bool readFrame(QIODevice *stream, int frameId, const KisTilesStreamOptions &options)
     {
         bool retval = false;
+
+        // the frames may be read concurrently, so don't use
+        // the non-const accessor of the map
+        DataSP data = m_frames.value(frameId);
+        KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(data, false);
+
+        retval = data->dataManager()->read(stream, options);
+        data->cache()->invalidate();
+        return retval;
+    }
+
+    bool writeFrame(KisPaintDeviceWriter &store, int frameId, const KisTilesStreamOptions &options)
+    {
         DataSP data = m_frames[frameId];
-        retval = data->dataManager()->read(stream);
+        return data->dataManager()->write(store, options);
+    }
+
+    KisTiledDataManagerDelta frameDelta(int frameId, int baseFrameId)
+    {
+        DataSP data = m_frames[frameId];
+        DataSP baseData = m_frames[baseFrameId];
+        return data->dataManager()->collectDifferentTiles(baseData->dataManager().data());
+    }
+
+    bool writeFrameDelta(KisPaintDeviceWriter &store, int frameId, const KisTiledDataManagerDelta &delta,
+                         const KisTilesStreamOptions &options)
+    {
+        DataSP data = m_frames[frameId];
+        return data->dataManager()->writeDelta(store, delta, options);
+    }
+
+    bool readFrameDelta(QIODevice *stream, int frameId, int baseFrameId, const KisTilesStreamOptions &options)
+    {
+        DataSP data = m_frames.value(frameId);
+        DataSP baseData = m_frames.value(baseFrameId);
+        KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(data && baseData, false);
+
+        /**
+         * The tiles coordinates in the stream are relative to the data
+         * manager, so the frame offset is kept as it is. The default
+         * pixel of the frame is restored after copying the base tiles,
+         * the tiles absent in the frame are listed in the delta.
+         */
+        const QByteArray defaultPixel((const char*)data->dataManager()->defaultPixel(),
+                                      data->dataManager()->pixelSize());
+
+        data->dataManager()->setDefaultPixel(baseData->dataManager()->defaultPixel());
+        data->dataManager()->clear();
+        data->dataManager()->bitBltRough(baseData->dataManager(), baseData->dataManager()->extent());
+        data->dataManager()->setDefaultPixel((const quint8*)defaultPixel.constData());
+
+        const bool retval = data->dataManager()->readDelta(stream, options);
         data->cache()->invalidate();
         return retval;
     }
 
-    bool writeFrame(KisPaintDeviceWriter &store, int frameId)
+    int frameNumTiles(int frameId)
     {
         DataSP data = m_frames[frameId];
-        return data->dataManager()->write(store);
+        return data->dataManager()->numTiles();
     }
 
     void setFrameDefaultPixel(const KoColor &defPixel, int frameId)
@@ -409,6 +461,12 @@ public:
                        data->colorSpace());
     }
 
+    quint64 frameContentVersion(int frameId) const
+    {
+        DataSP data = m_frames[frameId];
+        return data->cache()->contentVersion();
+    }
+
     void writeFrameToDevice(int frameId, KisPaintDeviceSP targetDevice);
     void uploadFrame(int srcFrameId, int dstFrameId, KisPaintDeviceSP srcDevice);
     void uploadFrame(int dstFrameId, KisPaintDeviceSP srcDevice);
@@ -981,7 +1039,8 @@ void KisPaintDevice::Private::convertColorSpace(const KoColorSpace *dstColorSpac
                                                 KoColorConversionTransformation::Intent renderingIntent,
                                                 KoColorConversionTransformation::ConversionFlags conversionFlags,
                                                 KUndo2Command *parentCommand,
-                                                KoUpdater *progressUpdater)
+                                                KoUpdater *progressUpdater,
+                                                KisRunnableStrokeJobsInterface *jobsInterface)
 {
     QList<Data*> dataObjects = allDataObjects();
     if (dataObjects.isEmpty()) return;
@@ -989,10 +1048,22 @@ void KisPaintDevice::Private::convertColorSpace(const KoColorSpace *dstColorSpac
     KUndo2Command *mainCommand =
         parentCommand ? new DeviceChangeColorSpaceCommand(q, parentCommand) : 0;
 
+    /**
+     * Without a parent command the device cannot be guaranteed to
+     * outlive the conversion jobs, so convert synchronously
+     */
+    QVector<KisRunnableStrokeJobData*> jobs;
+    QVector<KisRunnableStrokeJobData*> *conversionJobs =
+        jobsInterface && mainCommand ? &jobs : nullptr;
+
     Q_FOREACH (Data *data, dataObjects) {
         if (!data) continue;
 
-        data->convertDataColorSpace(dstColorSpace, renderingIntent, conversionFlags, mainCommand, progressUpdater);
+        data->convertDataColorSpace(dstColorSpace, renderingIntent, conversionFlags, mainCommand, progressUpdater, conversionJobs);
+    }
+
+    if (!jobs.isEmpty()) {
+        jobsInterface->addRunnableJobs(jobs);
     }
 
     q->emitColorSpaceChanged();
@@ -1185,6 +1256,11 @@ int KisPaintDevice::sequenceNumber() const
     return m_d->cache()->sequenceNumber();
 }
 
+quint64 KisPaintDevice::contentVersion() const
+{
+    return m_d->cache()->contentVersion();
+}
+
 void KisPaintDevice::estimateMemoryStats(qint64 &imageData, qint64 &temporaryData, qint64 &lodData) const
 {
     m_d->estimateMemoryStats(imageData, temporaryData, lodData);
@@ -1544,14 +1620,24 @@ void KisPaintDevice::fill(qint32 x, qint32 y, qint32 w, qint32 h, const quint8 *
 
 bool KisPaintDevice::write(KisPaintDeviceWriter &store)
 {
-    return m_d->dataManager()->write(store);
+    return write(store, KisTilesStreamOptions());
+}
+
+bool KisPaintDevice::write(KisPaintDeviceWriter &store, const KisTilesStreamOptions &options)
+{
+    return m_d->dataManager()->write(store, options);
 }
 
 bool KisPaintDevice::read(QIODevice *stream)
+{
+    return read(stream, KisTilesStreamOptions());
+}
+
+bool KisPaintDevice::read(QIODevice *stream, const KisTilesStreamOptions &options)
 {
     bool retval;
 
-    retval = m_d->dataManager()->read(stream);
+    retval = m_d->dataManager()->read(stream, options);
     m_d->cache()->invalidate();
 
     return retval;
@@ -1571,9 +1657,10 @@ void KisPaintDevice::convertTo(const KoColorSpace *dstColorSpace,
                                KoColorConversionTransformation::Intent renderingIntent,
                                KoColorConversionTransformation::ConversionFlags conversionFlags,
                                KUndo2Command *parentCommand,
-                               KoUpdater *progressUpdater)
+                               KoUpdater *progressUpdater,
+                               KisRunnableStrokeJobsInterface *jobsInterface)
 {
-    m_d->convertColorSpace(dstColorSpace, renderingIntent, conversionFlags, parentCommand, progressUpdater);
+    m_d->convertColorSpace(dstColorSpace, renderingIntent, conversionFlags, parentCommand, progressUpdater, jobsInterface);
 }
 
 bool KisPaintDevice::setProfile(const KoColorProfile * profile, KUndo2Command *parentCommand)
@@ -2276,20 +2363,61 @@ KoColor KisPaintDeviceFramesInterface::frameDefaultPixel(int frameId) const
     return q->m_d->frameDefaultPixel(frameId);
 }
 
-bool KisPaintDeviceFramesInterface::writeFrame(KisPaintDeviceWriter &store, int frameId)
+quint64 KisPaintDeviceFramesInterface::frameContentVersion(int frameId) const
+{
+    KIS_ASSERT_RECOVER(frameId >= 0) {
+        return 0;
+    }
+    return q->m_d->frameContentVersion(frameId);
+}
+
+bool KisPaintDeviceFramesInterface::writeFrame(KisPaintDeviceWriter &store, int frameId, const KisTilesStreamOptions &options)
 {
     KIS_ASSERT_RECOVER(frameId >= 0) {
         return false;
     }
-    return q->m_d->writeFrame(store, frameId);
+    return q->m_d->writeFrame(store, frameId, options);
 }
 
-bool KisPaintDeviceFramesInterface::readFrame(QIODevice *stream, int frameId)
+bool KisPaintDeviceFramesInterface::readFrame(QIODevice *stream, int frameId, const KisTilesStreamOptions &options)
 {
     KIS_ASSERT_RECOVER(frameId >= 0) {
         return false;
     }
-    return q->m_d->readFrame(stream, frameId);
+    return q->m_d->readFrame(stream, frameId, options);
+}
+
+KisTiledDataManagerDelta KisPaintDeviceFramesInterface::frameDelta(int frameId, int baseFrameId)
+{
+    KIS_ASSERT_RECOVER(frameId >= 0 && baseFrameId >= 0) {
+        return KisTiledDataManagerDelta();
+    }
+    return q->m_d->frameDelta(frameId, baseFrameId);
+}
+
+bool KisPaintDeviceFramesInterface::writeFrameDelta(KisPaintDeviceWriter &store, int frameId, const KisTiledDataManagerDelta &delta,
+                                                    const KisTilesStreamOptions &options)
+{
+    KIS_ASSERT_RECOVER(frameId >= 0) {
+        return false;
+    }
+    return q->m_d->writeFrameDelta(store, frameId, delta, options);
+}
+
+bool KisPaintDeviceFramesInterface::readFrameDelta(QIODevice *stream, int frameId, int baseFrameId, const KisTilesStreamOptions &options)
+{
+    KIS_ASSERT_RECOVER(frameId >= 0 && baseFrameId >= 0) {
+        return false;
+    }
+    return q->m_d->readFrameDelta(stream, frameId, baseFrameId, options);
+}
+
+int KisPaintDeviceFramesInterface::frameNumTiles(int frameId)
+{
+    KIS_ASSERT_RECOVER(frameId >= 0) {
+        return 0;
+    }
+    return q->m_d->frameNumTiles(frameId);
 }
 
 int KisPaintDeviceFramesInterface::currentFrameId() const
@@ -37,12 +37,14 @@ class KoColorProfile;
 class KisRegion;
 class KisDataManager;
 class KisPaintDeviceWriter;
+struct KisTilesStreamOptions;
 class KisKeyframe;
 class KisRasterKeyframeChannel;
 
 class KisPaintDeviceFramesInterface;
 
 class KisInterstrokeData;
+class KisRunnableStrokeJobsInterface;
 using KisInterstrokeDataSP = QSharedPointer<KisInterstrokeData>;
 
 typedef KisSharedPtr<KisDataManager> KisDataManagerSP;
@@ -121,11 +123,13 @@ public:
      * Write the pixels of this paint device into the specified file store.
      */
     bool write(KisPaintDeviceWriter &store);
+    bool write(KisPaintDeviceWriter &store, const KisTilesStreamOptions &options);
 
     /**
      * Fill this paint device with the pixels from the specified file store.
      */
     bool read(QIODevice *stream);
+    bool read(QIODevice *stream, const KisTilesStreamOptions &options);
 
 public:
 
@@ -475,12 +479,22 @@ public:
 
     /**
      * Converts the paint device to a different colorspace
+     *
+     * If \p jobsInterface is passed together with \p parentCommand, the
+     * pixels are converted by concurrent stroke jobs, one job per patch
+     * of tiles, which are added to the current stroke. The color space of
+     * the device is switched immediately, but the pixel data is valid only
+     * after all these jobs have been completed, i.e. in the next
+     * sequential or barrier job of the stroke. \p progressUpdater is not
+     * used in this mode, the caller may report the progress of the jobs
+     * itself (see KisConvertColorSpaceProcessingVisitor).
      */
     void convertTo(const KoColorSpace *dstColorSpace,
                    KoColorConversionTransformation::Intent renderingIntent = KoColorConversionTransformation::internalRenderingIntent(),
                    KoColorConversionTransformation::ConversionFlags conversionFlags = KoColorConversionTransformation::internalConversionFlags(),
                    KUndo2Command *parentCommand = nullptr,
-                   KoUpdater *progressUpdater = nullptr);
+                   KoUpdater *progressUpdater = nullptr,
+                   KisRunnableStrokeJobsInterface *jobsInterface = nullptr);
 
     /**
      * Changes the profile of the colorspace of this paint device to the given
@@ -824,6 +838,16 @@ public:
      */
     int sequenceNumber() const;
 
+    /**
+     * \return a number identifying the pixel data of the paint device.
+     *         The number changes every time the device is changed and,
+     *         unlike sequenceNumber(), it is unique among all the devices
+     *         of the process and is kept by the clones of the device. So
+     *         if two devices have the same content version, their data
+     *         managers contain the same tiles.
+     */
+    quint64 contentVersion() const;
+
 
     void estimateMemoryStats(qint64 &imageData, qint64 &temporaryData, qint64 &lodData) const;
 
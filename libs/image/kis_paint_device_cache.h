@@ -8,6 +8,7 @@
 #define __KIS_PAINT_DEVICE_CACHE_H
 
 #include "kis_lock_free_cache.h"
+#include <atomic>
 #include <QElapsedTimer>
 #include <QReadWriteLock>
 #include <QReadLocker>
@@ -44,6 +45,16 @@ public:
         m_nonDefaultPixelAreaCache.invalidate();
         m_regionCache.invalidate();
         m_sequenceNumber++;
+        m_contentVersion = ++s_lastContentVersion;
+    }
+
+    /**
+     * Marks the cache as belonging to a device whose data is an exact
+     * copy of the data \p rhs cache belongs to (e.g. a cloned data
+     * manager that shares the tiles with the source).
+     */
+    void inheritContentVersion(const KisPaintDeviceCache &rhs) {
+        m_contentVersion = rhs.m_contentVersion.load();
     }
 
     QRect exactBounds() {
@@ -113,6 +124,10 @@ public:
         return m_sequenceNumber;
     }
 
+    quint64 contentVersion() const {
+        return m_contentVersion;
+    }
+
 private:
     KisPaintDevice *m_paintDevice {nullptr};
 
@@ -155,6 +170,14 @@ private:
     QMap<int, QMap<int, QMap<qreal,QImage> > > m_thumbnails;
 
     QAtomicInt m_sequenceNumber;
+
+    /**
+     * Unlike the sequence number, the content version is unique among
+     * all the devices in the process and survives cloning, so two data
+     * objects with equal versions are guaranteed to have the same pixels
+     */
+    std::atomic<quint64> m_contentVersion {0};
+    inline static std::atomic<quint64> s_lastContentVersion {0};
 };
 
 #endif /* __KIS_PAINT_DEVICE_CACHE_H */
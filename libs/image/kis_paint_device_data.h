@@ -8,10 +8,16 @@
 #ifndef __KIS_PAINT_DEVICE_DATA_H
 #define __KIS_PAINT_DEVICE_DATA_H
 
+#include <map>
+
 #include "KisInterstrokeData.h"
 #include "KisSequentialIteratorProgress.h"
+#include "KisRunnableStrokeJobData.h"
+#include "KisRunnableStrokeJobUtils.h"
 #include "KoAlwaysInline.h"
+#include "kis_algebra_2d.h"
 #include "kis_command_utils.h"
+#include "krita_utils.h"
 #include "kundo2command.h"
 
 struct DirectDataAccessPolicy {
@@ -66,6 +72,10 @@ public:
           m_cacheInvalidator(this)
         {
             m_cache.setupCache();
+
+            if (cloneContent) {
+                m_cache.inheritContentVersion(rhs->m_cache);
+            }
             // WARNING: interstroke data is **not** copied while cloning, that is expected behavior!
         }
 
@@ -158,23 +168,29 @@ public:
         }
     }
 
+    /**
+     * Converts the data into \p dstColorSpace. When \p conversionJobs is
+     * not null, the pixels are not converted right away. Instead, the data
+     * is switched to a new (empty) data manager and the conversion of every
+     * patch of tiles is appended to \p conversionJobs as a concurrent stroke
+     * job. The caller must guarantee that the jobs are completed before
+     * anyone reads the pixels of the device.
+     *
+     * The jobs only write into the newly created data manager, the old one
+     * is kept untouched by the undo command, so undo works the same way
+     * for both modes.
+     */
     void convertDataColorSpace(const KoColorSpace *dstColorSpace,
                                KoColorConversionTransformation::Intent renderingIntent,
                                KoColorConversionTransformation::ConversionFlags conversionFlags,
                                KUndo2Command *parentCommand,
-                               KoUpdater *updater = nullptr)
+                               KoUpdater *updater = nullptr,
+                               QVector<KisRunnableStrokeJobData*> *conversionJobs = nullptr)
     {
-        using InternalSequentialConstIterator =
-            KisSequentialIteratorBase<ReadOnlyIteratorPolicy<DirectDataAccessPolicy>, DirectDataAccessPolicy, ProxyBasedProgressPolicy>;
-        using InternalSequentialIterator =
-            KisSequentialIteratorBase<WritableIteratorPolicy<DirectDataAccessPolicy>, DirectDataAccessPolicy, ProxyBasedProgressPolicy>;
-
         if (m_colorSpace == dstColorSpace || *m_colorSpace == *dstColorSpace) {
             return;
         }
 
-        QRect rc = m_dataManager->region().boundingRect();
-
         const int dstPixelSize = dstColorSpace->pixelSize();
         QScopedArrayPointer<quint8> dstDefaultPixel(new quint8[dstPixelSize]);
         memset(dstDefaultPixel.data(), 0, dstPixelSize);
@@ -182,28 +198,19 @@ public:
 
         KisDataManagerSP dstDataManager = new KisDataManager(dstPixelSize, dstDefaultPixel.data());
 
+        if (conversionJobs) {
+            addConversionJobs(m_dataManager, dstDataManager,
+                              m_colorSpace, dstColorSpace,
+                              renderingIntent, conversionFlags,
+                              *conversionJobs);
+        } else {
+            QRect rc = m_dataManager->region().boundingRect();
 
-        if (!rc.isEmpty()) {
-            InternalSequentialConstIterator srcIt(DirectDataAccessPolicy(m_dataManager.data(), cacheInvalidator()), rc, updater);
-            InternalSequentialIterator dstIt(DirectDataAccessPolicy(dstDataManager.data(), cacheInvalidator()), rc, updater);
-
-            int nConseqPixels = srcIt.nConseqPixels();
-
-            // since we are accessing data managers directly, the columns are always aligned
-            KIS_SAFE_ASSERT_RECOVER_NOOP(srcIt.nConseqPixels() == dstIt.nConseqPixels());
-
-            while(srcIt.nextPixels(nConseqPixels) &&
-                  dstIt.nextPixels(nConseqPixels)) {
-
-                nConseqPixels = srcIt.nConseqPixels();
-
-                const quint8 *srcData = srcIt.rawDataConst();
-                quint8 *dstData = dstIt.rawData();
-
-                m_colorSpace->convertPixelsTo(srcData, dstData,
-                                              dstColorSpace,
-                                              nConseqPixels,
-                                              renderingIntent, conversionFlags);
+            if (!rc.isEmpty()) {
+                convertDataRect(m_dataManager.data(), dstDataManager.data(), rc,
+                                m_colorSpace, dstColorSpace,
+                                renderingIntent, conversionFlags,
+                                cacheInvalidator(), updater);
             }
         }
 
@@ -292,6 +299,10 @@ public:
         m_levelOfDetail = srcData->levelOfDetail();
         m_colorSpace = srcData->colorSpace();
         m_cache.invalidate();
+
+        if (copyContent) {
+            m_cache.inheritContentVersion(srcData->m_cache);
+        }
     }
 
     ALWAYS_INLINE KisDataManagerSP dataManager() const {
@@ -361,6 +372,95 @@ public:
     }
 
 
+private:
+    static void convertDataRect(KisDataManager *srcDataManager,
+                                KisDataManager *dstDataManager,
+                                const QRect &rc,
+                                const KoColorSpace *srcColorSpace,
+                                const KoColorSpace *dstColorSpace,
+                                KoColorConversionTransformation::Intent renderingIntent,
+                                KoColorConversionTransformation::ConversionFlags conversionFlags,
+                                KisIteratorCompleteListener *completionListener,
+                                KoUpdater *updater)
+    {
+        using InternalSequentialConstIterator =
+            KisSequentialIteratorBase<ReadOnlyIteratorPolicy<DirectDataAccessPolicy>, DirectDataAccessPolicy, ProxyBasedProgressPolicy>;
+        using InternalSequentialIterator =
+            KisSequentialIteratorBase<WritableIteratorPolicy<DirectDataAccessPolicy>, DirectDataAccessPolicy, ProxyBasedProgressPolicy>;
+
+        InternalSequentialConstIterator srcIt(DirectDataAccessPolicy(srcDataManager, completionListener), rc, updater);
+        InternalSequentialIterator dstIt(DirectDataAccessPolicy(dstDataManager, completionListener), rc, updater);
+
+        int nConseqPixels = srcIt.nConseqPixels();
+
+        // since we are accessing data managers directly, the columns are always aligned
+        KIS_SAFE_ASSERT_RECOVER_NOOP(srcIt.nConseqPixels() == dstIt.nConseqPixels());
+
+        while(srcIt.nextPixels(nConseqPixels) &&
+              dstIt.nextPixels(nConseqPixels)) {
+
+            nConseqPixels = srcIt.nConseqPixels();
+
+            const quint8 *srcData = srcIt.rawDataConst();
+            quint8 *dstData = dstIt.rawData();
+
+            srcColorSpace->convertPixelsTo(srcData, dstData,
+                                           dstColorSpace,
+                                           nConseqPixels,
+                                           renderingIntent, conversionFlags);
+        }
+    }
+
+    void addConversionJobs(KisDataManagerSP srcDataManager,
+                           KisDataManagerSP dstDataManager,
+                           const KoColorSpace *srcColorSpace,
+                           const KoColorSpace *dstColorSpace,
+                           KoColorConversionTransformation::Intent renderingIntent,
+                           KoColorConversionTransformation::ConversionFlags conversionFlags,
+                           QVector<KisRunnableStrokeJobData*> &jobs)
+    {
+        /**
+         * Group the existing tiles into patches. Every tile belongs to
+         * exactly one patch (the one containing its top-left corner),
+         * so the concurrent jobs never write into the same tile. The
+         * area not covered by tiles is represented by the default pixel
+         * and needs no conversion at all.
+         */
+        const QSize patchSize = KritaUtils::optimalPatchSize();
+        std::map<std::pair<int, int>, QVector<QRect>> patches;
+
+        Q_FOREACH (const QRect &tileRect, srcDataManager->region().rects()) {
+            const std::pair<int, int> patchIndex(
+                KisAlgebra2D::divideFloor(tileRect.y(), patchSize.height()),
+                KisAlgebra2D::divideFloor(tileRect.x(), patchSize.width()));
+            patches[patchIndex].append(tileRect);
+        }
+
+        /**
+         * NOTE: the data is kept alive by the device, which is owned by
+         *       the conversion command, which, in its turn, lives in the
+         *       stroke until all its jobs are completed.
+         */
+        KisIteratorCompleteListener *completionListener = cacheInvalidator();
+
+        for (auto it = patches.begin(); it != patches.end(); ++it) {
+            const QVector<QRect> tileRects = it->second;
+
+            KritaUtils::addJobConcurrent(jobs,
+                [srcDataManager, dstDataManager, tileRects,
+                 srcColorSpace, dstColorSpace,
+                 renderingIntent, conversionFlags, completionListener] () {
+
+                Q_FOREACH (const QRect &rc, tileRects) {
+                    convertDataRect(srcDataManager.data(), dstDataManager.data(), rc,
+                                    srcColorSpace, dstColorSpace,
+                                    renderingIntent, conversionFlags,
+                                    completionListener, nullptr);
+                }
+            });
+        }
+    }
+
 private:
     struct CacheInvalidator : public KisIteratorCompleteListener {
         CacheInvalidator(KisPaintDeviceData *_q) : q(_q) {}
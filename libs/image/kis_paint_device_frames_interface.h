@@ -14,6 +14,8 @@ class KisPaintDeviceData;
 class KisPaintDeviceWriter;
 class KisDataManager;
 typedef KisSharedPtr<KisDataManager> KisDataManagerSP;
+struct KisTiledDataManagerDelta;
+struct KisTilesStreamOptions;
 
 class KisInterstrokeData;
 using KisInterstrokeDataSP = QSharedPointer<KisInterstrokeData>;
@@ -85,10 +87,16 @@ public:
      */
     KoColor frameDefaultPixel(int frameId) const;
 
+    /**
+     * @return content version of \p frameId, see
+     *         KisPaintDevice::contentVersion()
+     */
+    quint64 frameContentVersion(int frameId) const;
+
     /**
      * Write a \p frameId onto \p store
      */
-    bool writeFrame(KisPaintDeviceWriter &store, int frameId);
+    bool writeFrame(KisPaintDeviceWriter &store, int frameId, const KisTilesStreamOptions &options);
 
     /**
      * Loads content of a \p frameId from \p stream.
@@ -96,7 +104,35 @@ public:
      * NOTE: the frame must be created manually with createFrame()
      *       beforehand!
      */
-    bool readFrame(QIODevice *stream, int frameId);
+    bool readFrame(QIODevice *stream, int frameId, const KisTilesStreamOptions &options);
+
+    /**
+     * @return the tiles of \p frameId that differ from the tiles
+     *         of \p baseFrameId
+     */
+    KisTiledDataManagerDelta frameDelta(int frameId, int baseFrameId);
+
+    /**
+     * Write only the tiles of \p frameId listed in \p delta onto
+     * \p store. The \p delta must be collected with frameDelta()
+     * for the same frame.
+     */
+    bool writeFrameDelta(KisPaintDeviceWriter &store, int frameId, const KisTiledDataManagerDelta &delta,
+                         const KisTilesStreamOptions &options);
+
+    /**
+     * Loads content of a \p frameId from a \p stream written by
+     * writeFrameDelta(). The frame is initialized with a copy-on-write
+     * copy of \p baseFrameId first, so the unchanged tiles stay shared.
+     *
+     * NOTE: the base frame must be fully loaded beforehand!
+     */
+    bool readFrameDelta(QIODevice *stream, int frameId, int baseFrameId, const KisTilesStreamOptions &options);
+
+    /**
+     * @return the number of tiles allocated by \p frameId
+     */
+    int frameNumTiles(int frameId);
 
 
     /**
@@ -1652,6 +1652,10 @@ inline void KisPainter::compositeOnePixel(quint8 *dst, const KoColor &color)
 
 /**/
 void KisPainter::drawLine(const QPointF& start, const QPointF& end, qreal width, bool antialias){
+    drawLine(start, end, width, antialias, QRect());
+}
+
+void KisPainter::drawLine(const QPointF& start, const QPointF& end, qreal width, bool antialias, const QRect &requestedRect){
     int x1 = qFloor(start.x());
     int y1 = qFloor(start.y());
     int x2 = qFloor(end.x());
@@ -1697,8 +1701,13 @@ void KisPainter::drawLine(const QPointF& start, const QPointF& end, qreal width,
         selectionAccessor = d->selection->projection()->createRandomConstAccessorNG();
     }
 
-    for (int y = y1-W_; y < y2+W_ ; y++){
-        for (int x = x1-W_; x < x2+W_; x++){
+    QRect scanRect(QPoint(x1 - W_, y1 - W_), QPoint(x2 + W_ - 1, y2 + W_ - 1));
+    if (requestedRect.isValid()) {
+        scanRect &= requestedRect;
+    }
+
+    for (int y = scanRect.top(); y <= scanRect.bottom(); y++){
+        for (int x = scanRect.left(); x <= scanRect.right(); x++){
 
             projection = ( (x-X1_)* dstX + (y-Y1_)*dstY ) * projectionDenominator;
             scanX = X1_ + projection * dstX;
@@ -570,6 +570,12 @@ public:
      */
     void drawLine(const QPointF &start, const QPointF &end, qreal width, bool antialias);
 
+    /**
+     * Same as above, but only the pixels inside \p requestedRect are painted.
+     * If \p requestedRect is null, the entire line is painted.
+     */
+    void drawLine(const QPointF &start, const QPointF &end, qreal width, bool antialias, const QRect &requestedRect);
+
 
     /**
      * paints an unstroked, aliased one-pixel line using the DDA algorithm from specified start position to the
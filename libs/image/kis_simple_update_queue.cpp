@@ -64,12 +64,19 @@ void KisSimpleUpdateQueue::updateSettings()
 
     m_patchWidth = config.updatePatchWidth();
     m_patchHeight = config.updatePatchHeight();
+    m_minPatchSize = config.updatePatchMinSize();
 
     m_maxCollectAlpha = config.maxCollectAlpha();
     m_maxMergeAlpha = config.maxMergeAlpha();
     m_maxMergeCollectAlpha = config.maxMergeCollectAlpha();
 }
 
+void KisSimpleUpdateQueue::setThreadsLimitHint(int value)
+{
+    QMutexLocker locker(&m_lock);
+    m_threadsLimitHint = qMax(1, value);
+}
+
 int KisSimpleUpdateQueue::overrideLevelOfDetail() const
 {
     return m_overrideLevelOfDetail;
@@ -280,24 +287,36 @@ bool KisSimpleUpdateQueue::trySplitJob(KisNodeSP node, const QRect& rc,
                                        KisBaseRectsWalker::UpdateType type,
                                        bool dontInvalidateFrames)
 {
-    if(rc.width() <= m_patchWidth || rc.height() <= m_patchHeight)
+    /**
+     * NOTE: we split the rect even when only one of its dimensions
+     * exceeds the patch size, otherwise long strips (e.g. a wide
+     * gradient or a line of the brush) will be processed by a single
+     * worker only.
+     */
+    if(rc.width() <= m_patchWidth && rc.height() <= m_patchHeight)
         return false;
 
     // a bit of recursive splitting...
 
-    qint32 firstCol = rc.x() / m_patchWidth;
-    qint32 firstRow = rc.y() / m_patchHeight;
+    const QSize patchSize = calculateSplitPatchSize(rc);
+    const qint32 patchWidth = patchSize.width();
+    const qint32 patchHeight = patchSize.height();
+
+    qint32 firstCol = rc.x() / patchWidth;
+    qint32 firstRow = rc.y() / patchHeight;
 
-    qint32 lastCol = (rc.x() + rc.width()) / m_patchWidth;
-    qint32 lastRow = (rc.y() + rc.height()) / m_patchHeight;
+    qint32 lastCol = (rc.x() + rc.width()) / patchWidth;
+    qint32 lastRow = (rc.y() + rc.height()) / patchHeight;
 
     QVector<QRect> splitRects;
 
     for(qint32 i = firstRow; i <= lastRow; i++) {
         for(qint32 j = firstCol; j <= lastCol; j++) {
-            QRect maxPatchRect(j * m_patchWidth, i * m_patchHeight,
-                               m_patchWidth, m_patchHeight);
+            QRect maxPatchRect(j * patchWidth, i * patchHeight,
+                               patchWidth, patchHeight);
             QRect patchRect = rc & maxPatchRect;
+            if (patchRect.isEmpty()) continue;
+
             splitRects.append(patchRect);
         }
     }
@@ -308,6 +327,37 @@ bool KisSimpleUpdateQueue::trySplitJob(KisNodeSP node, const QRect& rc,
     return true;
 }
 
+QSize KisSimpleUpdateQueue::calculateSplitPatchSize(const QRect &rc) const
+{
+    qint32 patchWidth = m_patchWidth;
+    qint32 patchHeight = m_patchHeight;
+
+    auto numPatches = [&rc] (qint32 width, qint32 height) {
+        const qint64 numCols = rc.right() / width - rc.left() / width + 1;
+        const qint64 numRows = rc.bottom() / height - rc.top() / height + 1;
+        return numCols * numRows;
+    };
+
+    /**
+     * The patches are expected to be aligned to the tiles grid (64px),
+     * so that two workers would not fight for the same tiles in the
+     * source devices. Shrink the biggest dimension of the patch
+     * until every worker has something to do.
+     */
+    const qint32 tileAlignment = 64;
+    const qint32 minPatchSize = qMax(tileAlignment, m_minPatchSize);
+
+    while (numPatches(patchWidth, patchHeight) < m_threadsLimitHint) {
+        qint32 &biggestDimension = patchWidth >= patchHeight ? patchWidth : patchHeight;
+        const qint32 newSize = (biggestDimension / 2) / tileAlignment * tileAlignment;
+
+        if (newSize < minPatchSize) break;
+        biggestDimension = newSize;
+    }
+
+    return QSize(patchWidth, patchHeight);
+}
+
 bool KisSimpleUpdateQueue::tryMergeJob(KisNodeSP node, const QRect& rc,
                                        const QRect& cropRect,
                                        int levelOfDetail,
@@ -47,6 +47,15 @@ public:
 
     void updateSettings();
 
+    /**
+     * Sets the number of workers the queue should try to feed with
+     * patches of a big update. When a split rect would produce fewer
+     * patches than there are workers, the patch size is reduced
+     * (keeping it tile-aligned) so that idle workers can pick up the
+     * remaining parts of the rect.
+     */
+    void setThreadsLimitHint(int value);
+
     int overrideLevelOfDetail() const;
 
 protected:
@@ -61,6 +70,8 @@ protected:
                      const qreal maxAlpha);
     bool joinRects(QRect& baseRect, const QRect& newRect, qreal maxAlpha);
 
+    QSize calculateSplitPatchSize(const QRect &rc) const;
+
 protected:
 
     mutable QMutex m_lock;
@@ -80,6 +91,18 @@ protected:
     qint32 m_patchWidth;
     qint32 m_patchHeight;
 
+    /**
+     * The minimal size of a patch the queue is allowed to
+     * produce when splitting a big update for many workers
+     */
+    qint32 m_minPatchSize;
+
+    /**
+     * The number of workers we try to keep busy with
+     * patches of a single big update
+     */
+    qint32 m_threadsLimitHint = 1;
+
     /**
      * Maximum coefficient of work while regular optimization()
      */
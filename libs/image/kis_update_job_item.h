@@ -11,6 +11,7 @@
 
 #include <QRunnable>
 #include <QReadWriteLock>
+#include <QElapsedTimer>
 
 #include "kis_stroke_job.h"
 #include "kis_spontaneous_job.h"
@@ -80,6 +81,9 @@ private:
                 m_updaterContext->m_exclusiveJobLock.lockForRead();
             }
 
+            QElapsedTimer jobTimer;
+            jobTimer.start();
+
             if(m_atomicType == Type::MERGE) {
                 runMergeJob();
             } else {
@@ -101,6 +105,9 @@ private:
                 }
             }
 
+            m_busyTimeNSecs.fetch_add(jobTimer.nsecsElapsed(), std::memory_order_relaxed);
+            m_numJobsDone.fetch_add(1, std::memory_order_relaxed);
+
             setDone();
 
             m_updaterContext->doSomeUsefulWork();
@@ -209,6 +216,19 @@ public:
         return m_strokeJobSequentiality;
     }
 
+    inline qint64 busyTimeNSecs() const {
+        return m_busyTimeNSecs.load(std::memory_order_relaxed);
+    }
+
+    inline int numJobsDone() const {
+        return m_numJobsDone.load(std::memory_order_relaxed);
+    }
+
+    inline void resetStatistics() {
+        m_busyTimeNSecs.store(0, std::memory_order_relaxed);
+        m_numJobsDone.store(0, std::memory_order_relaxed);
+    }
+
 private:
     /**
      * Open walker and stroke job for the testing suite.
@@ -259,6 +279,12 @@ private:
      */
     QRect m_accessRect;
     QRect m_changeRect;
+
+    /**
+     * Utilization statistics, see KisUpdaterWorkerStatistics
+     */
+    std::atomic<qint64> m_busyTimeNSecs {0};
+    std::atomic<int> m_numJobsDone {0};
 };
 
 
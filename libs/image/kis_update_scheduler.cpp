@@ -94,6 +94,7 @@ void KisUpdateScheduler::setThreadsLimit(int value)
     m_d->updaterContext.lock();
     m_d->updaterContext.setThreadsLimit(value);
     m_d->updaterContext.unlock();
+    m_d->updatesQueue.setThreadsLimitHint(value);
     unlock(false);
 }
 
@@ -103,6 +104,16 @@ int KisUpdateScheduler::threadsLimit() const
     return m_d->updaterContext.threadsLimit();
 }
 
+QVector<KisUpdaterWorkerStatistics> KisUpdateScheduler::workerStatistics() const
+{
+    return m_d->updaterContext.workerStatistics();
+}
+
+void KisUpdateScheduler::resetWorkerStatistics()
+{
+    m_d->updaterContext.resetWorkerStatistics();
+}
+
 void KisUpdateScheduler::connectSignals()
 {
     connect(KisImageConfigNotifier::instance(), SIGNAL(configChanged()),
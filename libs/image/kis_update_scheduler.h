@@ -16,6 +16,7 @@
 #include "kis_strokes_queue_undo_result.h"
 #include "KisLodPreferences.h"
 #include "KisProjectionUpdateFlags.h"
+#include "KisUpdaterWorkerStatistics.h"
 
 class QRect;
 class KoProgressProxy;
@@ -42,6 +43,17 @@ public:
      */
     int threadsLimit() const;
 
+    /**
+     * Return per-worker utilization statistics of the updater
+     * context since the last call to resetWorkerStatistics()
+     */
+    QVector<KisUpdaterWorkerStatistics> workerStatistics() const;
+
+    /**
+     * Reset per-worker utilization statistics
+     */
+    void resetWorkerStatistics();
+
     /**
      * Sets the proxy that is going to be notified about the progress
      * of processing of the queues. If you want to switch the proxy
@@ -263,6 +263,8 @@ void KisUpdaterContext::setThreadsLimit(int value)
     for(qint32 i = 0; i < m_jobs.size(); i++) {
         m_jobs[i] = new KisUpdateJobItem(this);
     }
+
+    m_statisticsTimer.start();
 }
 
 int KisUpdaterContext::threadsLimit() const
@@ -271,6 +273,33 @@ int KisUpdaterContext::threadsLimit() const
     return m_jobs.size();
 }
 
+QVector<KisUpdaterWorkerStatistics> KisUpdaterContext::workerStatistics() const
+{
+    QVector<KisUpdaterWorkerStatistics> result;
+    result.reserve(m_jobs.size());
+
+    const qint64 wallTime = m_statisticsTimer.nsecsElapsed();
+
+    for (const KisUpdateJobItem *item : std::as_const(m_jobs)) {
+        KisUpdaterWorkerStatistics stats;
+        stats.numJobs = item->numJobsDone();
+        stats.busyTimeNSecs = item->busyTimeNSecs();
+        stats.wallTimeNSecs = wallTime;
+        result.append(stats);
+    }
+
+    return result;
+}
+
+void KisUpdaterContext::resetWorkerStatistics()
+{
+    for (KisUpdateJobItem *item : std::as_const(m_jobs)) {
+        item->resetStatistics();
+    }
+
+    m_statisticsTimer.restart();
+}
+
 void KisUpdaterContext::continueUpdate(const QRect& rc)
 {
     if (m_scheduler) m_scheduler->continueUpdate(rc);
@@ -7,6 +7,7 @@
 #ifndef __KIS_UPDATER_CONTEXT_H
 #define __KIS_UPDATER_CONTEXT_H
 
+#include <QElapsedTimer>
 #include <QMutex>
 #include <QReadWriteLock>
 #include <QThreadPool>
@@ -17,6 +18,7 @@
 #include "kis_lock_free_lod_counter.h"
 
 #include "KisUpdaterContextSnapshotEx.h"
+#include "KisUpdaterWorkerStatistics.h"
 #include "kis_update_scheduler.h"
 
 class KisUpdateJobItem;
@@ -127,6 +129,20 @@ public:
      */
     int threadsLimit() const;
 
+    /**
+     * Returns the utilization statistics of every worker of the
+     * context since the last call to resetWorkerStatistics() (or
+     * since the last change of the threads limit). The statistics
+     * is updated lock-free by the workers, so the function may be
+     * called without locking the context.
+     */
+    QVector<KisUpdaterWorkerStatistics> workerStatistics() const;
+
+    /**
+     * Resets the utilization statistics of all the workers
+     */
+    void resetWorkerStatistics();
+
     void continueUpdate(const QRect& rc);
     void doSomeUsefulWork();
     void jobFinished();
@@ -154,6 +170,7 @@ protected:
     QWaitCondition m_waitForDoneCondition;
     QVector<KisUpdateJobItem*> m_jobs;
     QThreadPool m_threadPool;
+    QElapsedTimer m_statisticsTimer;
     KisLockFreeLodCounter m_lodCounter;
     KisUpdateScheduler *m_scheduler;
     bool m_testingMode = false;
@@ -28,6 +28,60 @@
 #include <commands_new/KisChangeChannelLockFlagsCommand.h>
 #include <commands_new/KisResetGroupLayerCacheCommand.h>
 #include <kis_do_something_command.h>
+#include <kis_stroke_strategy_undo_command_based.h>
+#include <KisRunnableStrokeJobsInterface.h>
+#include <KisRunnableStrokeJobUtils.h>
+
+#include <QMutex>
+
+namespace {
+
+/**
+ * Collects the conversion jobs of all the devices of a layer, so that
+ * they could be submitted to the stroke together with the progress
+ * reporting
+ */
+struct ConversionJobsCollector : public KisRunnableStrokeJobsInterface
+{
+    void addRunnableJobs(const QVector<KisRunnableStrokeJobDataBase*> &list) override {
+        jobs += list;
+    }
+
+    QVector<KisRunnableStrokeJobDataBase*> jobs;
+};
+
+/**
+ * Shared by the conversion jobs of a layer. The progress updater is
+ * destroyed together with the last job, so it stays valid while the
+ * jobs are running after the visitor has already returned.
+ */
+struct ConversionProgress
+{
+    ConversionProgress(KisNode *node, int numJobs)
+        : helper(node),
+          updater(helper.updater()),
+          numJobs(numJobs)
+    {
+    }
+
+    void jobCompleted() {
+        QMutexLocker l(&lock);
+        numCompletedJobs++;
+
+        if (updater) {
+            updater->setProgress(100 * numCompletedJobs / numJobs);
+        }
+    }
+
+    KisProcessingVisitor::ProgressHelper helper;
+    KoUpdater *updater;
+
+    QMutex lock;
+    int numCompletedJobs {0};
+    const int numJobs;
+};
+
+}
 
 KisConvertColorSpaceProcessingVisitor::KisConvertColorSpaceProcessingVisitor(const KoColorSpace *srcColorSpace,
                                                                              const KoColorSpace *dstColorSpace,
@@ -40,6 +94,36 @@ KisConvertColorSpaceProcessingVisitor::KisConvertColorSpaceProcessingVisitor(con
 {
 }
 
+struct KisConvertColorSpaceProcessingVisitor::FetchJobsInterfaceCommand
+    : public KUndo2Command,
+      public KisStrokeStrategyUndoCommandBased::MutatedCommandInterface
+{
+    FetchJobsInterfaceCommand(KisConvertColorSpaceProcessingVisitor *visitor)
+        : m_visitor(visitor)
+    {
+    }
+
+    void redo() override {
+        // the visitor is used only once, undo/redo of the stroke
+        // doesn't visit the nodes anymore
+        if (m_visitor) {
+            m_visitor->m_jobsInterface = runnableJobsInterface();
+            m_visitor.clear();
+        }
+    }
+
+    void undo() override {
+    }
+
+private:
+    KisSharedPtr<KisConvertColorSpaceProcessingVisitor> m_visitor;
+};
+
+KUndo2Command *KisConvertColorSpaceProcessingVisitor::createInitCommand()
+{
+    return new FetchJobsInterfaceCommand(this);
+}
+
 void KisConvertColorSpaceProcessingVisitor::visitExternalLayer(KisExternalLayer *layer, KisUndoAdapter *undoAdapter)
 {
     KisProcessingVisitor::ProgressHelper helper(layer);
@@ -83,8 +167,6 @@ void KisConvertColorSpaceProcessingVisitor::visitNodeWithPaintDevice(KisNode *no
     KisLayer *layer = dynamic_cast<KisLayer*>(node);
     KIS_SAFE_ASSERT_RECOVER_RETURN(layer);
 
-    KisProcessingVisitor::ProgressHelper helper(layer);
-
     KisPaintLayer *paintLayer = 0;
 
     KUndo2Command *parentConversionCommand = new KUndo2Command();
@@ -98,16 +180,56 @@ void KisConvertColorSpaceProcessingVisitor::visitNodeWithPaintDevice(KisNode *no
         }
     }
 
-    if (layer->original()) {
-        layer->original()->convertTo(m_dstColorSpace, m_renderingIntent, m_conversionFlags, parentConversionCommand, helper.updater());
-    }
+    /**
+     * The original, the paint device and the projection of a layer are
+     * often the same device. When the conversion is done by stroke jobs,
+     * the device switches its color space before its pixels are converted,
+     * so we should make sure every device is converted only once.
+     */
+    KisPaintDeviceList devices;
+
+    auto addDevice = [&devices] (KisPaintDeviceSP device) {
+        if (device && !devices.contains(device)) {
+            devices << device;
+        }
+    };
+
+    addDevice(layer->original());
 
     if (layer->paintDevice() && layer->paintDevice()->colorSpace()->colorModelId() != AlphaColorModelID) {
-        layer->paintDevice()->convertTo(m_dstColorSpace, m_renderingIntent, m_conversionFlags, parentConversionCommand, helper.updater());
+        addDevice(layer->paintDevice());
     }
 
-    if (layer->projection()) {
-        layer->projection()->convertTo(m_dstColorSpace, m_renderingIntent, m_conversionFlags, parentConversionCommand, helper.updater());
+    addDevice(layer->projection());
+
+    if (m_jobsInterface) {
+        ConversionJobsCollector collector;
+
+        Q_FOREACH (KisPaintDeviceSP device, devices) {
+            device->convertTo(m_dstColorSpace, m_renderingIntent, m_conversionFlags, parentConversionCommand, nullptr, &collector);
+        }
+
+        if (!collector.jobs.isEmpty()) {
+            QSharedPointer<ConversionProgress> progress(new ConversionProgress(layer, collector.jobs.size()));
+            QVector<KisRunnableStrokeJobData*> jobs;
+
+            Q_FOREACH (KisRunnableStrokeJobDataBase *job, collector.jobs) {
+                QSharedPointer<KisRunnableStrokeJobDataBase> conversionJob(job);
+
+                KritaUtils::addJobConcurrent(jobs, [conversionJob, progress] () {
+                    conversionJob->run();
+                    progress->jobCompleted();
+                });
+            }
+
+            m_jobsInterface->addRunnableJobs(jobs);
+        }
+    } else {
+        KisProcessingVisitor::ProgressHelper helper(layer);
+
+        Q_FOREACH (KisPaintDeviceSP device, devices) {
+            device->convertTo(m_dstColorSpace, m_renderingIntent, m_conversionFlags, parentConversionCommand, helper.updater());
+        }
     }
 
     if (alphaDisabled) {
@@ -13,6 +13,7 @@
 #include <KoColorConversionTransformation.h>
 
 class KoColorSpace;
+class KisRunnableStrokeJobsInterface;
 
 class KRITAIMAGE_EXPORT  KisConvertColorSpaceProcessingVisitor : public KisSimpleProcessingVisitor
 {
@@ -36,11 +37,22 @@ public:
     void visitColorizeMask(KisColorizeMask *mask, KisUndoAdapter *undoAdapter) override;
     using KisSimpleProcessingVisitor::visit;
 
+    /**
+     * The init command fetches the jobs interface of the processing stroke,
+     * which is later used for splitting the conversion of every paint
+     * device into concurrent tile-patch jobs.
+     */
+    KUndo2Command* createInitCommand() override;
+
+private:
+    struct FetchJobsInterfaceCommand;
+
 private:
     const KoColorSpace *m_srcColorSpace;
     const KoColorSpace *m_dstColorSpace;
     KoColorConversionTransformation::Intent m_renderingIntent;
     KoColorConversionTransformation::ConversionFlags m_conversionFlags;
+    KisRunnableStrokeJobsInterface *m_jobsInterface {nullptr};
 };
 
 #endif /* __KIS_CONVERT_COLORSPACE_PROCESSING_VISITOR_H */
@@ -0,0 +1,114 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisRowBandReaderTest.h"
+
+#include "KisRowBandReader.h"
+#include <KoColorSpaceRegistry.h>
+#include <KoColor.h>
+#include <kis_paint_device.h>
+#include <kis_painter.h>
+#include "kistest.h"
+#include "testutil.h"
+
+namespace {
+
+KisPaintDeviceSP createNoiseDevice(const QRect &rc)
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+
+    TestUtil::fillWithNoise(dev, rc);
+
+    return dev;
+}
+
+}
+
+void KisRowBandReaderTest::testNoConversion()
+{
+    const QRect rc(3, 5, 301, 203);
+    KisPaintDeviceSP dev = createNoiseDevice(rc);
+
+    KisRowBandReader reader(dev, rc);
+
+    QCOMPARE(reader.colorSpace(), dev->colorSpace());
+    QCOMPARE(reader.deviceForRow(rc.top()), dev);
+    QCOMPARE(reader.deviceForRow(rc.bottom()), dev);
+}
+
+void KisRowBandReaderTest::testConversion_data()
+{
+    QTest::addColumn<bool>("convert");
+    QTest::addColumn<bool>("useBackground");
+
+    QTest::addRow("convert") << true << false;
+    QTest::addRow("background") << false << true;
+    QTest::addRow("convert-background") << true << true;
+}
+
+void KisRowBandReaderTest::testConversion()
+{
+    QFETCH(bool, convert);
+    QFETCH(bool, useBackground);
+
+    // neither the rect nor the bands are aligned to the tiles
+    const QRect rc(3, 5, 301, 203);
+    const int bandHeight = 50;
+
+    KisPaintDeviceSP dev = createNoiseDevice(rc);
+
+    const KoColorSpace *dstCs = convert ?
+        KoColorSpaceRegistry::instance()->rgb16() :
+        dev->colorSpace();
+
+    const KoColor background(Qt::yellow, dev->colorSpace());
+
+    // the reference is done the old way, by converting the whole device
+    KisPaintDeviceSP reference = new KisPaintDevice(*dev);
+    if (useBackground) {
+        reference = new KisPaintDevice(dev->colorSpace());
+        reference->fill(rc, background);
+        KisPainter gc(reference);
+        gc.bitBlt(rc.topLeft(), dev, rc);
+        gc.end();
+    }
+    reference->convertTo(dstCs);
+
+    KisRowBandReader reader(dev, rc, dstCs,
+                            KoColorConversionTransformation::internalRenderingIntent(),
+                            KoColorConversionTransformation::internalConversionFlags(),
+                            bandHeight);
+    if (useBackground) {
+        reader.setBackgroundColor(background);
+    }
+
+    QCOMPARE(*reader.colorSpace(), *dstCs);
+
+    const int rowSize = rc.width() * dstCs->pixelSize();
+    QVector<quint8> expectedRow(rowSize);
+    QVector<quint8> row(rowSize);
+
+    // read the rows sequentially and then once more in the reverse order
+    for (int pass = 0; pass < 2; pass++) {
+        for (int i = 0; i < rc.height(); i++) {
+            const int y = pass == 0 ? rc.top() + i : rc.bottom() - i;
+
+            KisPaintDeviceSP band = reader.deviceForRow(y);
+            QVERIFY(band != dev);
+            QCOMPARE(*band->colorSpace(), *dstCs);
+
+            band->readBytes(row.data(), rc.left(), y, rc.width(), 1);
+            reference->readBytes(expectedRow.data(), rc.left(), y, rc.width(), 1);
+
+            if (row != expectedRow) {
+                QFAIL(QString("Row %1 differs from the reference").arg(y).toLatin1());
+            }
+        }
+    }
+}
+
+KISTEST_MAIN(KisRowBandReaderTest)
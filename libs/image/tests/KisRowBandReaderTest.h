@@ -0,0 +1,23 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISROWBANDREADERTEST_H
+#define KISROWBANDREADERTEST_H
+
+#include <QtTest>
+#include <QObject>
+
+class KisRowBandReaderTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testNoConversion();
+    void testConversion_data();
+    void testConversion();
+};
+
+#endif // KISROWBANDREADERTEST_H
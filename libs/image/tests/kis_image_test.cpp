@@ -207,6 +207,53 @@ void KisImageTest::testConvertImageColorSpace()
     image->waitForDone();
 }
 
+void KisImageTest::testConvertImageColorSpaceConcurrentPatches()
+{
+    const KoColorSpace *cs8 = KoColorSpaceRegistry::instance()->rgb8();
+    const KoColorSpace *cs16 = KoColorSpaceRegistry::instance()->rgb16();
+
+    KisSurrogateUndoStore *undoStore = new KisSurrogateUndoStore();
+    KisImageSP image = new KisImage(undoStore, 2000, 1500, cs8, "stest");
+
+    KisPaintDeviceSP device1 = new KisPaintDevice(cs8);
+
+    // the device should be split into multiple patches
+    const QRect fillRect(13, 7, 1700, 1300);
+    TestUtil::fillWithNoise(device1, fillRect);
+
+    KisPaintDeviceSP originalDevice = new KisPaintDevice(*device1);
+    KisPaintDeviceSP referenceDevice = new KisPaintDevice(*device1);
+    referenceDevice->convertTo(cs16);
+
+    KisPaintLayerSP paint1 = new KisPaintLayer(image, "paint1", OPACITY_OPAQUE_U8, device1);
+    image->addNode(paint1, image->root());
+    image->initialRefreshGraph();
+
+    image->convertImageColorSpace(cs16,
+                                  KoColorConversionTransformation::internalRenderingIntent(),
+                                  KoColorConversionTransformation::internalConversionFlags());
+    image->waitForDone();
+
+    QVERIFY(*cs16 == *paint1->paintDevice()->colorSpace());
+    QCOMPARE(paint1->paintDevice()->exactBounds(), referenceDevice->exactBounds());
+
+    QPoint errorPoint;
+    QVERIFY(TestUtil::comparePaintDevices(errorPoint, paint1->paintDevice(), referenceDevice));
+
+    undoStore->undo();
+    image->waitForDone();
+
+    QVERIFY(*cs8 == *paint1->paintDevice()->colorSpace());
+    QCOMPARE(paint1->paintDevice()->exactBounds(), originalDevice->exactBounds());
+    QVERIFY(TestUtil::comparePaintDevices(errorPoint, paint1->paintDevice(), originalDevice));
+
+    undoStore->redo();
+    image->waitForDone();
+
+    QVERIFY(*cs16 == *paint1->paintDevice()->colorSpace());
+    QVERIFY(TestUtil::comparePaintDevices(errorPoint, paint1->paintDevice(), referenceDevice));
+}
+
 void KisImageTest::testAssignImageProfile()
 {
     const KoColorSpace *rgb8 = KoColorSpaceRegistry::instance()->rgb8();
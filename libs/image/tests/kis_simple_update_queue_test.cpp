@@ -140,6 +140,72 @@ void KisSimpleUpdateQueueTest::testSplit(bool useFullRefresh)
     QVERIFY(checkWalker(walkersList[3], QRect(512,512,488,488)));
 }
 
+void KisSimpleUpdateQueueTest::testSplitStrip()
+{
+    QRect imageRect(0,0,2048,2048);
+
+    const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, imageRect.width(), imageRect.height(), cs, "merge test");
+
+    KisPaintLayerSP paintLayer = new KisPaintLayer(image, "test", OPACITY_OPAQUE_U8);
+
+    image->barrierLock();
+    image->addNode(paintLayer);
+    image->unlock();
+
+    QRect dirtyRect1(0,100,1200,100);
+
+    KisTestableSimpleUpdateQueue queue;
+    KisWalkersList& walkersList = queue.getWalkersList();
+
+    queue.addUpdateJob(paintLayer, dirtyRect1, imageRect, 0);
+
+    QCOMPARE(walkersList.size(), 3);
+
+    QVERIFY(checkWalker(walkersList[0], QRect(0,100,512,100)));
+    QVERIFY(checkWalker(walkersList[1], QRect(512,100,512,100)));
+    QVERIFY(checkWalker(walkersList[2], QRect(1024,100,176,100)));
+}
+
+void KisSimpleUpdateQueueTest::testSplitForManyThreads()
+{
+    QRect imageRect(0,0,1024,1024);
+
+    const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, imageRect.width(), imageRect.height(), cs, "merge test");
+
+    KisPaintLayerSP paintLayer = new KisPaintLayer(image, "test", OPACITY_OPAQUE_U8);
+
+    image->barrierLock();
+    image->addNode(paintLayer);
+    image->unlock();
+
+    QRect dirtyRect1(0,0,1024,1024);
+
+    KisTestableSimpleUpdateQueue queue;
+    queue.setThreadsLimitHint(16);
+
+    KisWalkersList& walkersList = queue.getWalkersList();
+
+    queue.addUpdateJob(paintLayer, dirtyRect1, imageRect, 0);
+
+    QCOMPARE(walkersList.size(), 16);
+
+    Q_FOREACH (KisBaseRectsWalkerSP walker, walkersList) {
+        const QRect rc = walker->requestedRect();
+        QCOMPARE(rc.size(), QSize(256, 256));
+        QCOMPARE(rc.x() % 64, 0);
+        QCOMPARE(rc.y() % 64, 0);
+    }
+
+    // the patches are never smaller than the minimal patch size
+    queue.getWalkersList().clear();
+    queue.setThreadsLimitHint(1024);
+    queue.addUpdateJob(paintLayer, dirtyRect1, imageRect, 0);
+
+    QCOMPARE(walkersList.size(), 64);
+}
+
 void KisSimpleUpdateQueueTest::testChecksum()
 {
     QRect imageRect(0,0,512,512);
@@ -21,6 +21,8 @@ private Q_SLOTS:
     void testJobProcessing();
     void testSplitUpdate();
     void testSplitFullRefresh();
+    void testSplitStrip();
+    void testSplitForManyThreads();
     void testChecksum();
     void testMixingTypes();
     void testSpontaneousJobsCompression();
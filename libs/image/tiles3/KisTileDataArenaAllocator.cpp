@@ -0,0 +1,499 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisTileDataArenaAllocator.h"
+
+#include <atomic>
+#include <map>
+
+#include <QMutex>
+
+#include "kis_debug.h"
+#include "kis_image_config.h"
+#include "kis_tile_data_interface.h"
+
+#ifdef Q_OS_UNIX
+#include <sys/mman.h>
+#endif
+
+namespace {
+
+/**
+ * The arenas are aligned and sized by the size of a huge page on
+ * x86 and arm64 systems with the default configuration
+ */
+const size_t HugePageSize = 2 * 1024 * 1024;
+
+/**
+ * The pixel sizes of all color spaces we have fit into this limit;
+ * buffers for bigger pixels are allocated with malloc()
+ */
+const qint32 MaxPooledPixelSize = 64;
+
+/**
+ * The number of the freed chunks each size class keeps for reuse
+ * without taking the lock
+ */
+const int NumCachedChunks = 16;
+
+/**
+ * Every thread starts scanning the chunks cache from its own slot,
+ * so the threads allocating at the same time rarely race for the
+ * same chunk
+ */
+int currentThreadCacheSlot()
+{
+    static std::atomic<int> nextSlot(0);
+    static thread_local int slot = nextSlot.fetch_add(1, std::memory_order_relaxed) % NumCachedChunks;
+    return slot;
+}
+
+quint8* allocateArenaMemory(size_t size,
+                            KisTileDataArenaAllocator::HugePagesMode mode,
+                            bool *isHuge)
+{
+    *isHuge = false;
+
+#ifdef Q_OS_UNIX
+#ifdef MAP_HUGETLB
+    if (mode == KisTileDataArenaAllocator::ExplicitHugePages) {
+        void *ptr = mmap(0, size, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+
+        if (ptr != MAP_FAILED) {
+            *isHuge = true;
+            return static_cast<quint8*>(ptr);
+        }
+
+        // the system has no reserved huge pages, try transparent ones
+        mode = KisTileDataArenaAllocator::TransparentHugePages;
+    }
+#endif
+
+    if (mode != KisTileDataArenaAllocator::NoHugePages) {
+        /**
+         * Transparent huge pages can only be used for the regions
+         * aligned to the huge page size, so allocate a bit more and
+         * unmap the unaligned head and tail
+         */
+        const size_t paddedSize = size + HugePageSize;
+
+        void *ptr = mmap(0, paddedSize, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (ptr == MAP_FAILED) return 0;
+
+        const quintptr start = reinterpret_cast<quintptr>(ptr);
+        const quintptr alignedStart = (start + HugePageSize - 1) & ~quintptr(HugePageSize - 1);
+        const quintptr end = start + paddedSize;
+        const quintptr alignedEnd = alignedStart + size;
+
+        if (alignedStart > start) {
+            munmap(ptr, alignedStart - start);
+        }
+
+        if (end > alignedEnd) {
+            munmap(reinterpret_cast<void*>(alignedEnd), end - alignedEnd);
+        }
+
+#ifdef MADV_HUGEPAGE
+        *isHuge = !madvise(reinterpret_cast<void*>(alignedStart), size, MADV_HUGEPAGE);
+#endif
+
+        return reinterpret_cast<quint8*>(alignedStart);
+    }
+
+    void *ptr = mmap(0, size, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    return ptr != MAP_FAILED ? static_cast<quint8*>(ptr) : 0;
+#else
+    Q_UNUSED(mode);
+    return static_cast<quint8*>(::malloc(size));
+#endif
+}
+
+void freeArenaMemory(quint8 *ptr, size_t size)
+{
+#ifdef Q_OS_UNIX
+    munmap(ptr, size);
+#else
+    Q_UNUSED(size);
+    ::free(ptr);
+#endif
+}
+
+}
+
+struct KisTileDataArenaAllocator::Arena
+{
+    quint8 *memory = 0;
+
+    /**
+     * The free chunks are linked into a list, the pointer
+     * to the next chunk is stored in the chunk itself
+     */
+    quint8 *freeList = 0;
+
+    /**
+     * The chunks at the end of the arena that have never been
+     * allocated. They are not linked into the free list to avoid
+     * touching (and committing) the memory of the whole arena.
+     */
+    qint32 numUntouched = 0;
+
+    qint32 numFree = 0;
+    bool isHuge = false;
+
+    // the list of the arenas with free chunks
+    Arena *prev = 0;
+    Arena *next = 0;
+};
+
+struct KisTileDataArenaAllocator::SizeClass
+{
+    /**
+     * The recently freed chunks are kept here and reused without
+     * taking the lock, so the threads allocating and freeing tiles
+     * concurrently (e.g. the workers of a stroke) don't fight over
+     * the arenas. The cache is a fixed array, so it needs no memory
+     * allocations and pins at most NumCachedChunks chunks in their
+     * arenas. When the last chunk of the size class is freed, the
+     * cache is drained to let the arenas go.
+     */
+    std::atomic<quint8*> cachedChunks[NumCachedChunks];
+    std::atomic<qint32> numUsedChunks {0};
+
+    SizeClass() {
+        for (int i = 0; i < NumCachedChunks; i++) {
+            cachedChunks[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    bool popCachedChunk(quint8 *&ptr) {
+        const int start = currentThreadCacheSlot();
+
+        for (int i = 0; i < NumCachedChunks; i++) {
+            std::atomic<quint8*> &slot = cachedChunks[(start + i) % NumCachedChunks];
+
+            if (slot.load(std::memory_order_relaxed)) {
+                ptr = slot.exchange(0, std::memory_order_acquire);
+                if (ptr) return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool pushCachedChunk(quint8 *ptr) {
+        const int start = currentThreadCacheSlot();
+
+        for (int i = 0; i < NumCachedChunks; i++) {
+            std::atomic<quint8*> &slot = cachedChunks[(start + i) % NumCachedChunks];
+
+            quint8 *expected = 0;
+            if (!slot.load(std::memory_order_relaxed) &&
+                slot.compare_exchange_strong(expected, ptr, std::memory_order_release)) {
+
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    QMutex lock;
+
+    qint32 chunkSize = 0;
+    qint32 chunksPerArena = 0;
+    size_t arenaSize = 0;
+
+    std::map<quintptr, Arena*> arenas;
+    Arena *availableArenas = 0;
+    Arena *spareArena = 0;
+
+    void linkAvailable(Arena *arena) {
+        arena->prev = 0;
+        arena->next = availableArenas;
+        if (availableArenas) {
+            availableArenas->prev = arena;
+        }
+        availableArenas = arena;
+    }
+
+    void unlinkAvailable(Arena *arena) {
+        if (arena->prev) {
+            arena->prev->next = arena->next;
+        } else {
+            availableArenas = arena->next;
+        }
+
+        if (arena->next) {
+            arena->next->prev = arena->prev;
+        }
+
+        arena->prev = 0;
+        arena->next = 0;
+    }
+};
+
+struct KisTileDataArenaAllocator::Private
+{
+    HugePagesMode hugePagesMode = NoHugePages;
+    qint32 pixelsPerTile = 0;
+
+    QMutex sizeClassesLock;
+    std::atomic<SizeClass*> sizeClasses[MaxPooledPixelSize + 1];
+
+    std::atomic<qint64> numArenas {0};
+    std::atomic<qint64> numHugePageArenas {0};
+    std::atomic<qint64> reservedSize {0};
+    std::atomic<qint64> usedSize {0};
+};
+
+KisTileDataArenaAllocator::KisTileDataArenaAllocator(HugePagesMode hugePagesMode, qint32 pixelsPerTile)
+    : m_d(new Private)
+{
+    m_d->hugePagesMode = hugePagesMode;
+    m_d->pixelsPerTile = pixelsPerTile;
+
+    for (int i = 0; i <= MaxPooledPixelSize; i++) {
+        m_d->sizeClasses[i] = 0;
+    }
+}
+
+KisTileDataArenaAllocator::~KisTileDataArenaAllocator()
+{
+    for (int i = 0; i <= MaxPooledPixelSize; i++) {
+        SizeClass *sc = m_d->sizeClasses[i];
+        if (!sc) continue;
+
+        for (auto it = sc->arenas.begin(); it != sc->arenas.end(); ++it) {
+            freeArenaMemory(it->second->memory, sc->arenaSize);
+            delete it->second;
+        }
+
+        delete sc;
+    }
+}
+
+KisTileDataArenaAllocator* KisTileDataArenaAllocator::instance()
+{
+    /**
+     * The allocator is never destroyed, because the tiles may be
+     * freed by other static objects on the application exit
+     */
+    static KisTileDataArenaAllocator *s_instance =
+        new KisTileDataArenaAllocator(
+            HugePagesMode(KisImageConfig(true).tilesHugePagesMode()),
+            __TILE_DATA_WIDTH * __TILE_DATA_HEIGHT);
+
+    return s_instance;
+}
+
+KisTileDataArenaAllocator::SizeClass* KisTileDataArenaAllocator::sizeClass(qint32 pixelSize)
+{
+    SizeClass *sc = m_d->sizeClasses[pixelSize].load(std::memory_order_acquire);
+
+    if (!sc) {
+        QMutexLocker l(&m_d->sizeClassesLock);
+
+        sc = m_d->sizeClasses[pixelSize].load(std::memory_order_acquire);
+        if (!sc) {
+            sc = new SizeClass();
+            sc->chunkSize = pixelSize * m_d->pixelsPerTile;
+            sc->arenaSize = (size_t(sc->chunkSize) + HugePageSize - 1) / HugePageSize * HugePageSize;
+            sc->chunksPerArena = sc->arenaSize / sc->chunkSize;
+
+            m_d->sizeClasses[pixelSize].store(sc, std::memory_order_release);
+        }
+    }
+
+    return sc;
+}
+
+KisTileDataArenaAllocator::Arena* KisTileDataArenaAllocator::createArena(SizeClass *sc)
+{
+    bool isHuge = false;
+    quint8 *memory = allocateArenaMemory(sc->arenaSize, m_d->hugePagesMode, &isHuge);
+
+    if (!memory) {
+        warnKrita << "WARNING: failed to allocate an arena for tiles data of size" << sc->arenaSize;
+        return 0;
+    }
+
+    Arena *arena = new Arena();
+    arena->memory = memory;
+    arena->numUntouched = sc->chunksPerArena;
+    arena->numFree = sc->chunksPerArena;
+    arena->isHuge = isHuge;
+
+    sc->arenas.insert(std::make_pair(reinterpret_cast<quintptr>(memory), arena));
+
+    m_d->numArenas++;
+    m_d->reservedSize += sc->arenaSize;
+    if (isHuge) {
+        m_d->numHugePageArenas++;
+    }
+
+    return arena;
+}
+
+void KisTileDataArenaAllocator::destroyArena(SizeClass *sc, Arena *arena)
+{
+    sc->arenas.erase(reinterpret_cast<quintptr>(arena->memory));
+
+    m_d->numArenas--;
+    m_d->reservedSize -= sc->arenaSize;
+    if (arena->isHuge) {
+        m_d->numHugePageArenas--;
+    }
+
+    freeArenaMemory(arena->memory, sc->arenaSize);
+    delete arena;
+}
+
+quint8* KisTileDataArenaAllocator::allocate(qint32 pixelSize)
+{
+    if (pixelSize > MaxPooledPixelSize) {
+        return static_cast<quint8*>(::malloc(pixelSize * m_d->pixelsPerTile));
+    }
+
+    SizeClass *sc = sizeClass(pixelSize);
+    quint8 *ptr = 0;
+
+    sc->numUsedChunks++;
+    m_d->usedSize += sc->chunkSize;
+
+    if (sc->popCachedChunk(ptr)) {
+        return ptr;
+    }
+
+    QMutexLocker l(&sc->lock);
+
+    Arena *arena = sc->availableArenas;
+
+    if (!arena) {
+        if (sc->spareArena) {
+            arena = sc->spareArena;
+            sc->spareArena = 0;
+        } else {
+            arena = createArena(sc);
+            if (!arena) {
+                sc->numUsedChunks--;
+                m_d->usedSize -= sc->chunkSize;
+                return 0;
+            }
+        }
+
+        sc->linkAvailable(arena);
+    }
+
+    if (arena->freeList) {
+        ptr = arena->freeList;
+        arena->freeList = *reinterpret_cast<quint8**>(ptr);
+    } else {
+        ptr = arena->memory + (sc->chunksPerArena - arena->numUntouched) * sc->chunkSize;
+        arena->numUntouched--;
+    }
+
+    if (!--arena->numFree) {
+        sc->unlinkAvailable(arena);
+    }
+
+    return ptr;
+}
+
+void KisTileDataArenaAllocator::free(quint8 *ptr, qint32 pixelSize)
+{
+    if (pixelSize > MaxPooledPixelSize) {
+        ::free(ptr);
+        return;
+    }
+
+    SizeClass *sc = sizeClass(pixelSize);
+    m_d->usedSize -= sc->chunkSize;
+
+    const bool isLastChunk = !--sc->numUsedChunks;
+
+    if (!isLastChunk && sc->pushCachedChunk(ptr)) {
+        return;
+    }
+
+    QMutexLocker l(&sc->lock);
+    returnToArena(sc, ptr);
+
+    if (isLastChunk) {
+        drainCachedChunks(sc);
+    }
+}
+
+void KisTileDataArenaAllocator::drainCachedChunks(SizeClass *sc)
+{
+    quint8 *ptr = 0;
+    while (sc->popCachedChunk(ptr)) {
+        returnToArena(sc, ptr);
+    }
+}
+
+void KisTileDataArenaAllocator::returnToArena(SizeClass *sc, quint8 *ptr)
+{
+    auto it = sc->arenas.upper_bound(reinterpret_cast<quintptr>(ptr));
+    KIS_SAFE_ASSERT_RECOVER_RETURN(it != sc->arenas.begin());
+    --it;
+
+    Arena *arena = it->second;
+    KIS_SAFE_ASSERT_RECOVER_RETURN(ptr < arena->memory + sc->arenaSize);
+
+    *reinterpret_cast<quint8**>(ptr) = arena->freeList;
+    arena->freeList = ptr;
+
+    if (!arena->numFree++) {
+        sc->linkAvailable(arena);
+    }
+
+    if (arena->numFree == sc->chunksPerArena) {
+        sc->unlinkAvailable(arena);
+
+        if (!sc->spareArena) {
+            sc->spareArena = arena;
+        } else {
+            destroyArena(sc, arena);
+        }
+    }
+}
+
+void KisTileDataArenaAllocator::releaseSpareArenas()
+{
+    for (int i = 0; i <= MaxPooledPixelSize; i++) {
+        SizeClass *sc = m_d->sizeClasses[i].load(std::memory_order_acquire);
+        if (!sc) continue;
+
+        QMutexLocker l(&sc->lock);
+
+        drainCachedChunks(sc);
+
+        if (sc->spareArena) {
+            destroyArena(sc, sc->spareArena);
+            sc->spareArena = 0;
+        }
+    }
+}
+
+KisTileDataArenaAllocator::Statistics KisTileDataArenaAllocator::statistics() const
+{
+    Statistics stats;
+
+    stats.numArenas = m_d->numArenas;
+    stats.numHugePageArenas = m_d->numHugePageArenas;
+    stats.reservedSize = m_d->reservedSize;
+    stats.usedSize = m_d->usedSize;
+
+    return stats;
+}
+
+KisTileDataArenaAllocator::HugePagesMode KisTileDataArenaAllocator::hugePagesMode() const
+{
+    return m_d->hugePagesMode;
+}
@@ -0,0 +1,98 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISTILEDATAARENAALLOCATOR_H
+#define KISTILEDATAARENAALLOCATOR_H
+
+#include <QtGlobal>
+#include <QScopedPointer>
+
+#include "kritaimage_export.h"
+
+/**
+ * Allocates pixel buffers of KisTileData objects.
+ *
+ * The buffers are cut from big arenas (2 MiB or more), each arena
+ * keeps the buffers of a single pixel size. Allocating big regions
+ * instead of separate buffers reduces fragmentation of the heap and
+ * the TLB pressure, especially when the arenas are backed by huge
+ * pages. When all the buffers of an arena are freed, the arena is
+ * returned back to the operating system (one spare arena per pixel
+ * size is kept to avoid thrashing).
+ *
+ * A few recently freed buffers of every pixel size are cached in a
+ * lock-free array and reused first, so the usual tile churn rarely
+ * takes a lock.
+ *
+ * The allocator is thread-safe.
+ */
+class KRITAIMAGE_EXPORT KisTileDataArenaAllocator
+{
+public:
+    enum HugePagesMode {
+        NoHugePages = 0,
+        TransparentHugePages, ///< madvise(MADV_HUGEPAGE) on the arenas
+        ExplicitHugePages ///< mmap(MAP_HUGETLB), falls back to the transparent ones
+    };
+
+    struct Statistics {
+        qint64 numArenas = 0;
+        qint64 numHugePageArenas = 0;
+
+        /// the memory reserved from the system for the arenas
+        qint64 reservedSize = 0;
+
+        /// the memory actually occupied by tile data buffers
+        qint64 usedSize = 0;
+    };
+
+public:
+    KisTileDataArenaAllocator(HugePagesMode hugePagesMode, qint32 pixelsPerTile);
+    ~KisTileDataArenaAllocator();
+
+    static KisTileDataArenaAllocator* instance();
+
+    /**
+     * Allocates a buffer for a tile with \p pixelSize bytes per pixel
+     */
+    quint8* allocate(qint32 pixelSize);
+
+    /**
+     * Returns the buffer allocated with allocate() back to its arena
+     */
+    void free(quint8 *ptr, qint32 pixelSize);
+
+    /**
+     * Returns the cached chunks back to their arenas and the spare
+     * arenas back to the operating system
+     */
+    void releaseSpareArenas();
+
+    Statistics statistics() const;
+
+    HugePagesMode hugePagesMode() const;
+
+private:
+    struct Arena;
+    struct SizeClass;
+
+    SizeClass* sizeClass(qint32 pixelSize);
+
+    Arena* createArena(SizeClass *sc);
+    void destroyArena(SizeClass *sc, Arena *arena);
+
+    /// the lock of \p sc must be held by the caller
+    void returnToArena(SizeClass *sc, quint8 *ptr);
+
+    /// the lock of \p sc must be held by the caller
+    void drainCachedChunks(SizeClass *sc);
+
+private:
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+#endif // KISTILEDATAARENAALLOCATOR_H
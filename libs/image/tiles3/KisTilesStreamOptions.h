@@ -0,0 +1,29 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISTILESSTREAMOPTIONS_H
+#define KISTILESSTREAMOPTIONS_H
+
+#include "tiles3/swap/kis_compression_factory.h"
+
+/**
+ * The options of writing and reading the tiles of a data manager
+ * into/from a file stream.
+ *
+ * The devices are written and read on the worker threads, so the
+ * options should be fetched from KisImageConfig by the caller once,
+ * before the work is started.
+ */
+struct KisTilesStreamOptions
+{
+    /// the algorithm used for compressing the written tiles
+    KisCompressionFactory::Algorithm compressionAlgorithm = KisCompressionFactory::LZF;
+
+    /// \see KisImageConfig::lazyTilesDecompression()
+    bool lazyDecompression = false;
+};
+
+#endif // KISTILESSTREAMOPTIONS_H
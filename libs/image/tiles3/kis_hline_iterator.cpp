@@ -37,6 +37,7 @@ KisHLineIterator2::KisHLineIterator2(KisDataManager *dataManager, qint32 x, qint
 
     m_row = yToRow(m_y);
     m_yInTile = calcYInTile(m_y, m_row);
+    m_prefetchedRow = m_row;
 
     m_leftInLeftmostTile = m_left - m_leftCol * KisTileData::WIDTH;
 
@@ -108,6 +109,17 @@ void KisHLineIterator2::nextRow()
         m_yInTile = 0;
         preallocateTiles();
     }
+
+    /**
+     * The iterator is walking over several rows, so it is likely to
+     * reach the next row of tiles. Ask the store to load it from swap
+     * while we are processing the current one.
+     */
+    if (m_row >= m_prefetchedRow) {
+        m_prefetchedRow = m_row + 1;
+        m_dataManager->prefetchTiles(m_leftCol, m_prefetchedRow, m_rightCol, m_prefetchedRow);
+    }
+
     m_index = 0;
     switchToTile(m_leftInLeftmostTile);
 
@@ -59,6 +59,7 @@ private:
     qint32 m_top {0};
     qint32 m_leftCol {0};
     qint32 m_rightCol {0};
+    qint32 m_prefetchedRow {0}; // the last tile row requested from the prefetcher
 
     qint32 m_rightmostInTile {0}; // limited by the current tile border only
 
@@ -282,6 +282,17 @@ void KisTile::unlockForRead() const
 #endif
 }
 
+void KisTile::prefetch()
+{
+    /**
+     * COW can replace and release the tile data at any moment,
+     * so take the mutex to make sure it stays alive until the
+     * prefetcher takes its own reference
+     */
+    QMutexLocker locker(&m_COWMutex);
+    m_tileData->m_store->prefetchTileData(m_tileData);
+}
+
 
 #include <stdio.h>
 void KisTile::debugPrintInfo()
@@ -80,6 +80,12 @@ public:
     void unlockForWrite();
     void unlockForRead() const;
 
+    /**
+     * Ask the tile data store to load the data of this tile from
+     * swap in background. Does nothing if the data is in memory.
+     */
+    void prefetch();
+
 
     /* this allows us work directly on tile's data */
     inline quint8 *data() const {
@@ -11,49 +11,19 @@
 
 #include <kis_debug.h>
 
-#include <boost/pool/singleton_pool.hpp>
 #include "kis_tile_data_store_iterators.h"
-
-// BPP == bytes per pixel
-#define TILE_SIZE_4BPP (4 * __TILE_DATA_WIDTH * __TILE_DATA_HEIGHT)
-#define TILE_SIZE_8BPP (8 * __TILE_DATA_WIDTH * __TILE_DATA_HEIGHT)
-
-typedef boost::singleton_pool<KisTileData, TILE_SIZE_4BPP, boost::default_user_allocator_new_delete, boost::details::pool::default_mutex, 256, 4096> BoostPool4BPP;
-typedef boost::singleton_pool<KisTileData, TILE_SIZE_8BPP, boost::default_user_allocator_new_delete, boost::details::pool::default_mutex, 128, 2048> BoostPool8BPP;
+#include "KisTileDataArenaAllocator.h"
 
 const qint32 KisTileData::WIDTH = __TILE_DATA_WIDTH;
 const qint32 KisTileData::HEIGHT = __TILE_DATA_HEIGHT;
 
-SimpleCache KisTileData::m_cache;
-
-SimpleCache::~SimpleCache()
-{
-    clear();
-}
-
-void SimpleCache::clear()
-{
-    QWriteLocker l(&m_cacheLock);
-    quint8 *ptr = 0;
-
-    while (m_4Pool.pop(ptr)) {
-        BoostPool4BPP::free(ptr);
-    }
-
-    while (m_8Pool.pop(ptr)) {
-        BoostPool8BPP::free(ptr);
-    }
-
-    while (m_16Pool.pop(ptr)) {
-        free(ptr);
-    }
-}
-
-
 KisTileData::KisTileData(qint32 pixelSize, const quint8 *defPixel, KisTileDataStore *store, bool checkFreeMemory)
     : m_state(NORMAL),
       m_mementoFlag(0),
       m_age(0),
+      m_uniformityCheckAge(0),
+      m_isDefaultTileData(false),
+      m_uniformPixel(0),
       m_usersCount(0),
       m_refCount(0),
       m_pixelSize(pixelSize),
@@ -83,6 +53,9 @@ KisTileData::KisTileData(const KisTileData& rhs, bool checkFreeMemory)
     : m_state(NORMAL),
       m_mementoFlag(0),
       m_age(0),
+      m_uniformityCheckAge(0),
+      m_isDefaultTileData(false),
+      m_uniformPixel(0),
       m_usersCount(0),
       m_refCount(0),
       m_pixelSize(rhs.m_pixelSize),
@@ -100,6 +73,7 @@ KisTileData::KisTileData(const KisTileData& rhs, bool checkFreeMemory)
 KisTileData::~KisTileData()
 {
     releaseMemory();
+    delete[] m_uniformPixel;
 }
 
 void KisTileData::fillWithPixel(const quint8 *defPixel)
@@ -111,6 +85,45 @@ void KisTileData::fillWithPixel(const quint8 *defPixel)
     }
 }
 
+bool KisTileData::isUniform() const
+{
+    Q_ASSERT(m_data);
+
+    /**
+     * All the pixels are equal if and only if the data is equal to
+     * itself shifted by one pixel. memcmp() is vectorized by the C
+     * library for every architecture and stops on the first
+     * difference, which comes very early for non-uniform tiles.
+     */
+    const int dataSize = m_pixelSize * WIDTH * HEIGHT;
+    return !memcmp(m_data, m_data + m_pixelSize, dataSize - m_pixelSize);
+}
+
+void KisTileData::compactUniformData()
+{
+    Q_ASSERT(m_data);
+    Q_ASSERT(!m_uniformPixel);
+
+    m_uniformPixel = new quint8[m_pixelSize];
+    memcpy(m_uniformPixel, m_data, m_pixelSize);
+
+    releaseMemory();
+    m_state = COMPRESSED;
+}
+
+void KisTileData::expandUniformData()
+{
+    Q_ASSERT(!m_data);
+    Q_ASSERT(m_uniformPixel);
+
+    allocateMemory();
+    fillWithPixel(m_uniformPixel);
+
+    delete[] m_uniformPixel;
+    m_uniformPixel = 0;
+    m_state = NORMAL;
+}
+
 void KisTileData::releaseMemory()
 {
     if (m_data) {
@@ -134,40 +147,12 @@ void KisTileData::allocateMemory()
 
 quint8* KisTileData::allocateData(const qint32 pixelSize)
 {
-    quint8 *ptr = 0;
-
-    if (!m_cache.pop(pixelSize, ptr)) {
-        switch (pixelSize) {
-        case 4:
-            ptr = (quint8*)BoostPool4BPP::malloc();
-            break;
-        case 8:
-            ptr = (quint8*)BoostPool8BPP::malloc();
-            break;
-        default:
-            ptr = (quint8*) malloc(pixelSize * WIDTH * HEIGHT);
-            break;
-        }
-    }
-
-    return ptr;
+    return KisTileDataArenaAllocator::instance()->allocate(pixelSize);
 }
 
 void KisTileData::freeData(quint8* ptr, const qint32 pixelSize)
 {
-    if (!m_cache.push(pixelSize, ptr)) {
-        switch (pixelSize) {
-        case 4:
-            BoostPool4BPP::free(ptr);
-            break;
-        case 8:
-            BoostPool8BPP::free(ptr);
-            break;
-        default:
-            free(ptr);
-            break;
-        }
-    }
+    KisTileDataArenaAllocator::instance()->free(ptr, pixelSize);
 }
 
 //#define DEBUG_POOL_RELEASE
@@ -197,14 +182,6 @@ void KisTileData::releaseInternalPools()
                 delete clone;
             }
 
-            // check if the tile data has actually been pooled
-            if (item->m_pixelSize != 4 &&
-                item->m_pixelSize != 8 &&
-                item->m_pixelSize != 16) {
-
-                continue;
-            }
-
             // check if the tile has been swapped out
             if (item->m_data) {
                 const bool locked = item->m_swapLock.tryLockForWrite();
@@ -221,10 +198,12 @@ void KisTileData::releaseInternalPools()
         }
 
         if (!failedToLock) {
-            // purge the pools memory
-            m_cache.clear();
-            BoostPool4BPP::purge_memory();
-            BoostPool8BPP::purge_memory();
+            // free all the buffers, so the arenas would be released
+            Q_FOREACH (KisTileData *item, dataObjects) {
+                freeData(item->m_data, item->m_pixelSize);
+                item->m_data = 0;
+            }
+            KisTileDataArenaAllocator::instance()->releaseSpareArenas();
 
             auto it = dataObjects.begin();
             auto chunkIt = memoryChunks.constBegin();
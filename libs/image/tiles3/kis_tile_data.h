@@ -112,11 +112,16 @@ inline int KisTileData::age() const {
 }
 inline void KisTileData::resetAge() {
     m_age = 0;
+    m_uniformityCheckAge = 0;
 }
 inline void KisTileData::markOld() {
     m_age++;
 }
 
+inline bool KisTileData::isCompacted() const {
+    return m_state == COMPRESSED;
+}
+
 inline qint32 KisTileData::numUsers() const {
     return m_usersCount;
 }
@@ -31,57 +31,6 @@ typedef KisTileDataList::iterator KisTileDataListIterator;
 typedef KisTileDataList::const_iterator KisTileDataListConstIterator;
 
 
-class SimpleCache
-{
-public:
-    SimpleCache() = default;
-    ~SimpleCache();
-
-    bool push(int pixelSize, quint8 *&ptr)
-    {
-        QReadLocker l(&m_cacheLock);
-        switch (pixelSize) {
-        case 4:
-            m_4Pool.push(ptr);
-            break;
-        case 8:
-            m_8Pool.push(ptr);
-            break;
-        case 16:
-            m_16Pool.push(ptr);
-            break;
-        default:
-            return false;
-        }
-
-        return true;
-    }
-
-    bool pop(int pixelSize, quint8 *&ptr)
-    {
-        QReadLocker l(&m_cacheLock);
-        switch (pixelSize) {
-        case 4:
-            return m_4Pool.pop(ptr);
-        case 8:
-            return m_8Pool.pop(ptr);
-        case 16:
-            return m_16Pool.pop(ptr);
-        default:
-            return false;
-        }
-    }
-
-    void clear();
-
-private:
-    QReadWriteLock m_cacheLock;
-    KisLocklessStack<quint8*> m_4Pool;
-    KisLocklessStack<quint8*> m_8Pool;
-    KisLocklessStack<quint8*> m_16Pool;
-};
-
-
 /**
  * Stores actual tile's data
  */
@@ -201,21 +150,50 @@ public:
     /**
      * Releases internal pools, which keep blobs where the tiles are
      * stored.  The point is that we don't allocate the tiles from
-     * glibc directly, but use pools (implemented via boost) to
-     * allocate bigger chunks. This method should be called when one
-     * knows that we have just free'd quite a lot of memory and we
-     * won't need it anymore. E.g. when a document has been closed.
+     * glibc directly, but use arenas (KisTileDataArenaAllocator) to
+     * allocate bigger chunks. The remaining tiles are moved into as
+     * few arenas as possible, so that the rest could be returned to
+     * the system. This method should be called when one knows that
+     * we have just free'd quite a lot of memory and we won't need it
+     * anymore. E.g. when a document has been closed.
      */
     static void releaseInternalPools();
 
 private:
     void fillWithPixel(const quint8 *defPixel);
 
+    /**
+     * Used by KisTileDataStore only.
+     * Returns true if all the pixels of the tile data are equal.
+     * The data should be present in memory.
+     */
+    bool isUniform() const;
+
+    /**
+     * Used by KisTileDataStore only.
+     * Frees the memory occupied by the tile data and keeps a copy
+     * of its only pixel instead. The data must be uniform.
+     */
+    void compactUniformData();
+
+    /**
+     * Used by KisTileDataStore only.
+     * Restores the data compacted by compactUniformData()
+     */
+    void expandUniformData();
+
+    /**
+     * Returns true if the data has been compacted
+     * by compactUniformData()
+     */
+    inline bool isCompacted() const;
+
     static quint8* allocateData(const qint32 pixelSize);
     static void freeData(quint8 *ptr, const qint32 pixelSize);
 private:
     friend class KisTileDataPooler;
     friend class KisTileDataPoolerTest;
+    friend class KisTileDataStoreTest;
     /**
      * A list of pre-duplicated tiledatas.
      * To make a COW faster, KisTileDataPooler thread duplicates
@@ -270,6 +248,28 @@ private:
     //FIXME: make memory aligned
     int m_age;
 
+    /**
+     * Counts the cycles of the pooler passed after last access
+     * to the tile data. The pooler checks the tile data for
+     * uniformity only when it has not been accessed for a while.
+     * 0 - recently accessed
+     * 1 - not accessed during the last pooler cycle
+     * 2 - checked for uniformity
+     */
+    int m_uniformityCheckAge;
+
+    /**
+     * Set for the default tile data of the data managers. It is always
+     * uniform and is read all the time, so the pooler never compacts it.
+     */
+    bool m_isDefaultTileData;
+
+    /**
+     * The color of the compacted tile data.
+     * \see compactUniformData()
+     */
+    quint8 *m_uniformPixel;
+
 
     /**
      * The primitive for controlling swapping of the tile.
@@ -305,7 +305,6 @@ private:
     //qint32 m_timeStamp;
 
     KisTileDataStore *m_store;
-    static SimpleCache m_cache;
 
 public:
     static const qint32 WIDTH;
@@ -19,6 +19,12 @@ const qint32 KisTileDataPooler::MAX_TIMEOUT = 60000; // 01m00s
 const qint32 KisTileDataPooler::MIN_TIMEOUT = 100; // 00m00.100s
 const qint32 KisTileDataPooler::TIMEOUT_FACTOR = 2;
 
+/**
+ * The uniformity checks are spread over several cycles, so that
+ * the pooler doesn't hold the store's lock for too long
+ */
+const qint32 KisTileDataPooler::MAX_UNIFORMITY_CHECKS = 256;
+
 //#define DEBUG_POOLER
 
 #ifdef DEBUG_POOLER
@@ -88,11 +94,18 @@ KisTileDataPooler::KisTileDataPooler(KisTileDataStore *store, qint32 memoryLimit
     m_lastRealMemoryMetric = 0;
     m_lastHistoricalMemoryMetric = 0;
 
+    /**
+     * Custom memory limit is used in unittests for testing
+     * the pooling only, so don't touch the tiles in that case
+     */
     if(memoryLimit >= 0) {
         m_memoryLimit = memoryLimit;
+        m_compactUniformTiles = false;
     }
     else {
-        m_memoryLimit = MiB_TO_METRIC(KisImageConfig(true).poolLimit());
+        KisImageConfig config(true);
+        m_memoryLimit = MiB_TO_METRIC(config.poolLimit());
+        m_compactUniformTiles = config.compactUniformTiles();
     }
 }
 
@@ -193,15 +206,21 @@ void KisTileDataPooler::run()
         qint32 statRealMemory;
         qint32 statHistoricalMemory;
 
+        UniformityCheck uniformityCheck;
 
         getLists(iter, beggars, donors,
                  memoryOccupied,
                  statRealMemory,
-                 statHistoricalMemory);
+                 statHistoricalMemory,
+                 m_compactUniformTiles ? &uniformityCheck : nullptr);
 
         m_lastCycleHadWork =
             processLists(beggars, donors, memoryOccupied);
 
+        if (m_compactUniformTiles) {
+            m_lastCycleHadWork |= compactUniformTiles(uniformityCheck);
+        }
+
         m_lastPoolMemoryMetric = memoryOccupied;
         m_lastRealMemoryMetric = statRealMemory;
         m_lastHistoricalMemoryMetric = statHistoricalMemory;
@@ -287,7 +306,8 @@ void KisTileDataPooler::getLists(Iter *iter,
                                  QList<KisTileData*> &donors,
                                  qint32 &memoryOccupied,
                                  qint32 &statRealMemory,
-                                 qint32 &statHistoricalMemory)
+                                 qint32 &statHistoricalMemory,
+                                 UniformityCheck *uniformityCheck)
 {
     memoryOccupied = 0;
     statRealMemory = 0;
@@ -306,6 +326,10 @@ void KisTileDataPooler::getLists(Iter *iter,
 
         tryFreeOrphanedClones(item);
 
+        if (uniformityCheck) {
+            updateUniformityCheck(item, *uniformityCheck);
+        }
+
         if((neededMemory = needMemory(item))) {
             needMemoryTotal += neededMemory;
             beggars.append(item);
@@ -385,6 +409,48 @@ bool KisTileDataPooler::processLists(QList<KisTileData*> &beggars,
     return hadWork;
 }
 
+/**
+ * The tile data is checked for uniformity only after it has not been
+ * accessed for the whole cycle of the pooler, so the tiles being
+ * painted on are not compacted and expanded back over and over again.
+ * At most MAX_UNIFORMITY_CHECKS tiles are picked in a cycle, the rest
+ * stay in the queue till the next one. The default tile data of the
+ * data managers is skipped, it would be expanded back on the next read.
+ */
+inline void KisTileDataPooler::updateUniformityCheck(KisTileData *td, UniformityCheck &check)
+{
+    if (td->m_isDefaultTileData) return;
+
+    if (td->m_uniformityCheckAge == 0) {
+        td->m_uniformityCheckAge = 1;
+        check.hasPendingTiles = true;
+    } else if (td->m_uniformityCheckAge == 1) {
+        if (check.candidates.size() < MAX_UNIFORMITY_CHECKS) {
+            td->m_uniformityCheckAge = 2;
+            check.candidates.append(td);
+        } else {
+            check.hasPendingTiles = true;
+        }
+    }
+}
+
+/**
+ * Frees the memory of the candidate tiles that have all the pixels
+ * equal, e.g. the tiles that have been erased or filled. Should be
+ * called before the iteration started for getLists() is finished.
+ *
+ * Returns true if there are tiles waiting for the check in the
+ * next cycle.
+ */
+bool KisTileDataPooler::compactUniformTiles(const UniformityCheck &check)
+{
+    Q_FOREACH (KisTileData *td, check.candidates) {
+        m_store->tryCompactUniformTileData(td);
+    }
+
+    return check.hasPendingTiles;
+}
+
 void KisTileDataPooler::debugTileStatistics()
 {
     /**
@@ -409,5 +475,7 @@ void KisTileDataPooler::debugTileStatistics()
 
 void KisTileDataPooler::testingRereadConfig()
 {
-    m_memoryLimit = MiB_TO_METRIC(KisImageConfig(true).poolLimit());
+    KisImageConfig config(true);
+    m_memoryLimit = MiB_TO_METRIC(config.poolLimit());
+    m_compactUniformTiles = config.compactUniformTiles();
 }
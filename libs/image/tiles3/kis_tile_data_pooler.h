@@ -9,6 +9,7 @@
 #include <QObject>
 #include <QThread>
 #include <QSemaphore>
+#include <QList>
 
 #include "kritaimage_export.h"
 
@@ -46,6 +47,16 @@ protected:
     static const qint32 MAX_TIMEOUT;
     static const qint32 MIN_TIMEOUT;
     static const qint32 TIMEOUT_FACTOR;
+    static const qint32 MAX_UNIFORMITY_CHECKS;
+
+    /**
+     * The tile data that should be checked for uniformity in the
+     * current cycle, collected by getLists()
+     */
+    struct UniformityCheck {
+        QList<KisTileData*> candidates;
+        bool hasPendingTiles = false;
+    };
 
     void waitForWork();
     qint32 numClonesNeeded(KisTileData *td) const;
@@ -60,12 +71,16 @@ protected:
     inline qint32 canDonorMemory(KisTileData *td);
     qint32 tryGetMemory(QList<KisTileData*> &donors, qint32 memoryMetric);
 
+    inline void updateUniformityCheck(KisTileData *td, UniformityCheck &check);
+    bool compactUniformTiles(const UniformityCheck &check);
+
     template<class Iter>
         void getLists(Iter *iter, QList<KisTileData*> &beggars,
                       QList<KisTileData*> &donors,
                       qint32 &memoryOccupied,
                       qint32 &statRealMemory,
-                      qint32 &statHistoricalMemory);
+                      qint32 &statHistoricalMemory,
+                      UniformityCheck *uniformityCheck = nullptr);
 
     bool processLists(QList<KisTileData*> &beggars,
                       QList<KisTileData*> &donors,
@@ -80,6 +95,7 @@ protected:
     qint32 m_timeout;
     bool m_lastCycleHadWork;
     qint32 m_memoryLimit;
+    bool m_compactUniformTiles;
     qint32 m_lastPoolMemoryMetric;
     qint32 m_lastRealMemoryMetric;
     qint32 m_lastHistoricalMemoryMetric;
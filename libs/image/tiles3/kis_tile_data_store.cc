@@ -58,17 +58,24 @@ qint64 __preclone_miss_age = 0;
 KisTileDataStore::KisTileDataStore()
     : m_pooler(this),
       m_swapper(this),
+      m_prefetcher(this),
       m_numTiles(0),
       m_memoryMetric(0),
       m_counter(1),
-      m_clockIndex(1)
+      m_clockIndex(1),
+      m_numPrefetchHits(0),
+      m_numPrefetchMisses(0),
+      m_numCompactedTiles(0),
+      m_compactedMemoryMetric(0)
 {
     m_pooler.start();
     m_swapper.start();
+    m_prefetcher.start();
 }
 
 KisTileDataStore::~KisTileDataStore()
 {
+    m_prefetcher.terminatePrefetcher();
     m_pooler.terminatePooler();
     m_swapper.terminateSwapper();
 
@@ -100,6 +107,11 @@ KisTileDataStore::MemoryStatistics KisTileDataStore::memoryStatistics()
 
     stats.swapSize = m_swappedStore.totalSwapMemoryUsed();
 
+    stats.compactedSize = m_compactedMemoryMetric.loadAcquire() * metricCoeff;
+
+    stats.swapPrefetchHits = m_numPrefetchHits.loadAcquire();
+    stats.swapPrefetchMisses = m_numPrefetchMisses.loadAcquire();
+
     return stats;
 }
 
@@ -158,6 +170,30 @@ inline void KisTileDataStore::unregisterTileDataImp(KisTileData *td)
     m_tileDataMap.getGC().update();
 }
 
+/**
+ * Loads the data of the compacted or swapped out tile data into
+ * memory. Returns true if the data has been read from swap.
+ * Should be called with m_iteratorLock and td->m_swapLock
+ * locked for writing.
+ */
+inline bool KisTileDataStore::loadTileDataImp(KisTileData *td)
+{
+    bool fromSwap = false;
+
+    if (td->isCompacted()) {
+        td->expandUniformData();
+        m_numCompactedTiles.deref();
+        m_compactedMemoryMetric -= td->pixelSize();
+    } else {
+        m_swappedStore.swapInTileData(td);
+        fromSwap = true;
+    }
+
+    registerTileDataImp(td);
+
+    return fromSwap;
+}
+
 void KisTileDataStore::unregisterTileData(KisTileData *td)
 {
     QReadLocker lock(&m_iteratorLock);
@@ -199,7 +235,10 @@ void KisTileDataStore::freeTileData(KisTileData *td)
     m_iteratorLock.lockForRead();
     td->m_swapLock.lockForWrite();
 
-    if (!td->data()) {
+    if (td->isCompacted()) {
+        m_numCompactedTiles.deref();
+        m_compactedMemoryMetric -= td->pixelSize();
+    } else if (!td->data()) {
         m_swappedStore.forgetTileData(td);
     } else {
         unregisterTileDataImp(td);
@@ -243,8 +282,9 @@ void KisTileDataStore::ensureTileDataLoaded(KisTileData *td)
         if (!td->data()) {
             td->m_swapLock.lockForWrite();
 
-            m_swappedStore.swapInTileData(td);
-            registerTileDataImp(td);
+            if (loadTileDataImp(td)) {
+                m_numPrefetchMisses.ref();
+            }
 
             td->m_swapLock.unlock();
         }
@@ -259,6 +299,43 @@ void KisTileDataStore::ensureTileDataLoaded(KisTileData *td)
     }
 }
 
+void KisTileDataStore::prefetchTileData(KisTileData *td)
+{
+    /**
+     * We check the data without any locks, so the tile might be
+     * swapped in or out in the meantime. That is not a problem,
+     * since the prefetcher rechecks it under the lock and the
+     * tile is always loaded on access anyway.
+     */
+    if (td->data()) return;
+
+    td->ref();
+    m_prefetcher.addRequest(td);
+}
+
+void KisTileDataStore::prefetchSwapIn(KisTileData *td)
+{
+    if (td->data()) return;
+
+    checkFreeMemory();
+
+    /**
+     * The locking order is the same as in ensureTileDataLoaded()
+     */
+    QWriteLocker locker(&m_iteratorLock);
+
+    if (!td->data()) {
+        td->m_swapLock.lockForWrite();
+
+        if (loadTileDataImp(td)) {
+            m_numPrefetchHits.ref();
+        }
+        td->resetAge();
+
+        td->m_swapLock.unlock();
+    }
+}
+
 bool KisTileDataStore::trySwapTileData(KisTileData *td)
 {
     /**
@@ -279,6 +356,46 @@ bool KisTileDataStore::trySwapTileData(KisTileData *td)
     return result;
 }
 
+bool KisTileDataStore::trySwapOutCompressedTileData(KisTileData *td, const quint8 *buffer, qint32 bufferSize)
+{
+    QReadLocker lock(&m_iteratorLock);
+
+    bool result = false;
+    if (!td->m_swapLock.tryLockForWrite()) return result;
+
+    if (td->data()) {
+        if (m_swappedStore.trySwapOutCompressedTileData(td, buffer, bufferSize)) {
+            unregisterTileDataImp(td);
+            result = true;
+        }
+    }
+    td->m_swapLock.unlock();
+
+    return result;
+}
+
+bool KisTileDataStore::tryCompactUniformTileData(KisTileData *td)
+{
+    /**
+     * This function is called with m_listLock acquired
+     */
+
+    bool result = false;
+    if (!td->m_swapLock.tryLockForWrite()) return result;
+
+    if (td->data() && td->isUniform()) {
+        unregisterTileDataImp(td);
+        td->compactUniformData();
+
+        m_numCompactedTiles.ref();
+        m_compactedMemoryMetric += td->pixelSize();
+        result = true;
+    }
+    td->m_swapLock.unlock();
+
+    return result;
+}
+
 KisTileDataStoreIterator* KisTileDataStore::beginIteration()
 {
     m_iteratorLock.lockForWrite();
@@ -15,6 +15,7 @@
 
 #include "kis_tile_data_pooler.h"
 #include "swap/kis_tile_data_swapper.h"
+#include "swap/kis_tile_data_prefetcher.h"
 #include "swap/kis_swapped_data_store.h"
 #include "3rdparty/lock_free_map/concurrent_map.h"
 
@@ -42,6 +43,24 @@ public:
         qint64 poolSize;
 
         qint64 swapSize;
+
+        /**
+         * The size of the uniform tiles that have been compacted
+         * to a single pixel, that is, the memory saved by compaction
+         */
+        qint64 compactedSize;
+
+        /**
+         * The number of swapped out tiles that have been loaded back
+         * by the prefetcher before anyone tried to access them
+         */
+        qint64 swapPrefetchHits;
+
+        /**
+         * The number of swapped out tiles that have been loaded
+         * synchronously on access
+         */
+        qint64 swapPrefetchMisses;
     };
 
     MemoryStatistics memoryStatistics();
@@ -53,11 +72,13 @@ public:
      */
     inline qint32 numTiles() const
     {
-        return m_numTiles.loadAcquire() + m_swappedStore.numTiles();
+        return m_numTiles.loadAcquire() + m_swappedStore.numTiles() +
+            m_numCompactedTiles.loadAcquire();
     }
 
     /**
      * Returns the number of tiles present in memory only
+     * (not counting the compacted ones)
      */
     inline qint32 numTilesInMemory() const
     {
@@ -88,7 +109,9 @@ public:
 
     inline KisTileData* createDefaultTileData(qint32 pixelSize, const quint8 *defPixel)
     {
-        return allocTileData(pixelSize, defPixel);
+        KisTileData *td = allocTileData(pixelSize, defPixel);
+        td->m_isDefaultTileData = true;
+        return td;
     }
 
     // Called by The Memento Manager after every commit
@@ -107,6 +130,26 @@ public:
      */
     bool trySwapTileData(KisTileData *td);
 
+    /**
+     * Moves the tile data into the swap in the already compressed
+     * form \p buffer (in the format of KisTileCompressor2). The tile
+     * data is decompressed on the first access only. Used for loading
+     * the tiles from files lazily.
+     *
+     * It may fail in case the tile is being accessed at the same
+     * moment of time or the swap is full. In such a case the data of
+     * \p td is left unchanged.
+     */
+    bool trySwapOutCompressedTileData(KisTileData *td, const quint8 *buffer, qint32 bufferSize);
+
+    /**
+     * Try to free the memory of the tile data if all its pixels
+     * are equal. The data is expanded back on the next access.
+     * It may fail in case the tile is being accessed at the
+     * same moment of time.
+     */
+    bool tryCompactUniformTileData(KisTileData *td);
+
 
     /**
      * WARN: The following three method are only for usage
@@ -129,6 +172,27 @@ public:
      */
     void ensureTileDataLoaded(KisTileData *td);
 
+    /**
+     * Asynchronously load \p td from swap, if it has been swapped
+     * out. Used by the iterators for reading ahead the tiles they are
+     * going to access soon.
+     */
+    void prefetchTileData(KisTileData *td);
+
+    /**
+     * Loads \p td from swap without locking its swap lock for
+     * reading. Used by the prefetcher thread only.
+     */
+    void prefetchSwapIn(KisTileData *td);
+
+    /**
+     * Returns true if there is at least one tile data swapped out
+     */
+    inline bool hasSwappedTiles() const
+    {
+        return m_swappedStore.numTiles() > 0;
+    }
+
     void registerTileData(KisTileData *td);
     void unregisterTileData(KisTileData *td);
 
@@ -137,6 +201,7 @@ private:
 
     inline void registerTileDataImp(KisTileData *td);
     inline void unregisterTileDataImp(KisTileData *td);
+    inline bool loadTileDataImp(KisTileData *td);
     void freeRegisteredTiles();
 
     friend class DeadlockyThread;
@@ -153,6 +218,7 @@ private:
 private:
     KisTileDataPooler m_pooler;
     KisTileDataSwapper m_swapper;
+    KisTileDataPrefetcher m_prefetcher;
 
     friend class KisTileDataStoreTest;
     friend class KisTileDataPoolerTest;
@@ -167,6 +233,10 @@ private:
     QAtomicInt m_memoryMetric;
     QAtomicInt m_counter;
     QAtomicInt m_clockIndex;
+    QAtomicInt m_numPrefetchHits;
+    QAtomicInt m_numPrefetchMisses;
+    QAtomicInt m_numCompactedTiles;
+    QAtomicInt m_compactedMemoryMetric;
     ConcurrentMap<int, KisTileData*> m_tileDataMap;
     QReadWriteLock m_iteratorLock;
 };
@@ -20,6 +20,7 @@
 #include "kis_paint_device_writer.h"
 
 #include "kis_global.h"
+#include "kis_assert.h"
 
 
 /* The data area is divided into tiles each say 64x64 pixels (defined at compiletime)
@@ -97,7 +98,7 @@ void KisTiledDataManager::setDefaultPixelImpl(const quint8 *defaultPixel)
     memcpy(m_defaultPixel, defaultPixel, pixelSize());
 }
 
-bool KisTiledDataManager::write(KisPaintDeviceWriter &store)
+bool KisTiledDataManager::write(KisPaintDeviceWriter &store, const KisTilesStreamOptions &options)
 {
     QReadLocker locker(&m_lock);
 
@@ -117,7 +118,7 @@ bool KisTiledDataManager::write(KisPaintDeviceWriter &store)
     KisTileSP tile;
 
     KisAbstractTileCompressorSP compressor =
-        KisTileCompressorFactory::create(CURRENT_VERSION);
+        KisTileCompressorFactory::create(CURRENT_VERSION, options.compressionAlgorithm);
 
     while ((tile = iter.tile())) {
         retval = compressor->writeTile(tile, store);
@@ -130,9 +131,21 @@ bool KisTiledDataManager::write(KisPaintDeviceWriter &store)
 
     return retval;
 }
-bool KisTiledDataManager::read(QIODevice *stream)
+bool KisTiledDataManager::read(QIODevice *stream, const KisTilesStreamOptions &options)
 {
-    clear();
+    return readImpl(stream, false, options);
+}
+
+bool KisTiledDataManager::readDelta(QIODevice *stream, const KisTilesStreamOptions &options)
+{
+    return readImpl(stream, true, options);
+}
+
+bool KisTiledDataManager::readImpl(QIODevice *stream, bool isDelta, const KisTilesStreamOptions &options)
+{
+    if (!isDelta) {
+        clear();
+    }
 
     QWriteLocker locker(&m_lock);
     KisMementoSP nothing = m_mementoManager->getMemento();
@@ -148,6 +161,7 @@ bool KisTiledDataManager::read(QIODevice *stream)
 
     quint32 numTiles;
     qint32 tilesVersion = LEGACY_VERSION;
+    QVector<QPoint> removedTiles;
 
     if (line[0] == 'V') {
         QList<QByteArray> lineItems = line.split(' ');
@@ -157,15 +171,33 @@ bool KisTiledDataManager::read(QIODevice *stream)
 
         tilesVersion = lineItems.takeFirst().toInt();
 
-        if(!processTilesHeader(stream, numTiles))
+        if(!processTilesHeader(stream, numTiles, isDelta ? &removedTiles : nullptr)) {
+            m_mementoManager->commit();
             return false;
+        }
+    }
+    else if (isDelta) {
+        warnTiles << "Legacy tiles stream cannot contain a delta";
+        m_mementoManager->commit();
+        return false;
     }
     else {
         numTiles = line.toUInt();
     }
 
+    Q_FOREACH (const QPoint &pt, removedTiles) {
+        const qint32 col = xToCol(pt.x());
+        const qint32 row = yToRow(pt.y());
+
+        if (m_hashTable->deleteTile(col, row)) {
+            m_extentManager.notifyTileRemoved(col, row);
+        }
+    }
+
     KisAbstractTileCompressorSP compressor =
-        KisTileCompressorFactory::create(tilesVersion);
+        KisTileCompressorFactory::create(tilesVersion,
+                                         KisCompressionFactory::LZF,
+                                         options.lazyDecompression);
 
     bool readSuccess = true;
     for (quint32 i = 0; i < numTiles; i++) {
@@ -178,20 +210,112 @@ bool KisTiledDataManager::read(QIODevice *stream)
     return readSuccess;
 }
 
-bool KisTiledDataManager::writeTilesHeader(KisPaintDeviceWriter &store, quint32 numTiles)
+KisTiledDataManagerDelta KisTiledDataManager::collectDifferentTiles(KisTiledDataManager *base)
+{
+    KisTiledDataManagerDelta delta;
+
+    KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(base->pixelSize() == pixelSize(), delta);
+
+    QReadLocker locker(&m_lock);
+    QReadLocker baseLocker(&base->m_lock);
+
+    const qint32 tileDataSize = KisTileData::HEIGHT * KisTileData::WIDTH * pixelSize();
+
+    KisTileHashTableConstIterator iter(m_hashTable);
+    KisTileSP tile;
+
+    while ((tile = iter.tile())) {
+        KisTileSP baseTile = base->m_hashTable->getExistingTile(tile->col(), tile->row());
+
+        bool isChanged = !baseTile;
+
+        /**
+         * The tiles shared in copy-on-write manner have the same
+         * tile data, so we compare the pixels of the detached
+         * tiles only
+         */
+        if (baseTile && baseTile->tileData() != tile->tileData()) {
+            tile->lockForRead();
+            baseTile->lockForRead();
+            isChanged = memcmp(tile->data(), baseTile->data(), tileDataSize) != 0;
+            baseTile->unlockForRead();
+            tile->unlockForRead();
+        }
+
+        if (isChanged) {
+            delta.changedTiles.append(tile);
+        }
+
+        iter.next();
+    }
+
+    KisTileHashTableConstIterator baseIter(base->m_hashTable);
+
+    while ((tile = baseIter.tile())) {
+        if (!m_hashTable->getExistingTile(tile->col(), tile->row())) {
+            delta.removedTiles.append(QPoint(tile->col(), tile->row()));
+        }
+        baseIter.next();
+    }
+
+    return delta;
+}
+
+bool KisTiledDataManager::writeDelta(KisPaintDeviceWriter &store, const KisTiledDataManagerDelta &delta,
+                                     const KisTilesStreamOptions &options)
+{
+    QReadLocker locker(&m_lock);
+
+    // the header stores pixel coordinates, the same way the tiles do
+    QVector<QPoint> removedTiles;
+    removedTiles.reserve(delta.removedTiles.size());
+    Q_FOREACH (const QPoint &pt, delta.removedTiles) {
+        removedTiles.append(QPoint(pt.x() * KisTileData::WIDTH, pt.y() * KisTileData::HEIGHT));
+    }
+
+    bool retval = writeTilesHeader(store, delta.changedTiles.size(), &removedTiles);
+
+    KisAbstractTileCompressorSP compressor =
+        KisTileCompressorFactory::create(CURRENT_VERSION, options.compressionAlgorithm);
+
+    for (auto it = delta.changedTiles.begin(); retval && it != delta.changedTiles.end(); ++it) {
+        retval = compressor->writeTile(*it, store);
+        if (!retval) {
+            warnFile << "Failed to write tile";
+        }
+    }
+
+    return retval;
+}
+
+bool KisTiledDataManager::writeTilesHeader(KisPaintDeviceWriter &store, quint32 numTiles,
+                                           const QVector<QPoint> *removedTiles)
 {
     QString buffer;
 
     buffer = QString("VERSION %1\n"
                      "TILEWIDTH %2\n"
                      "TILEHEIGHT %3\n"
-                     "PIXELSIZE %4\n"
-                     "DATA %5\n")
+                     "PIXELSIZE %4\n")
         .arg(CURRENT_VERSION)
         .arg(KisTileData::WIDTH)
         .arg(KisTileData::HEIGHT)
-        .arg(pixelSize())
-        .arg(numTiles);
+        .arg(pixelSize());
+
+    /**
+     * The delta section is placed before the data mark, so that
+     * the versions of Krita not knowing about it would reject the
+     * stream instead of loading an incomplete frame
+     */
+    if (removedTiles) {
+        buffer += QString("DELTA %1\n").arg(removedTiles->size());
+
+        Q_FOREACH (const QPoint &pt, *removedTiles) {
+            buffer += QString("%1,%2\n").arg(pt.x()).arg(pt.y());
+        }
+    }
+
+    buffer += QString("DATA %1\n").arg(numTiles);
 
     return store.write(buffer.toLatin1());
 }
@@ -206,7 +330,8 @@ bool KisTiledDataManager::writeTilesHeader(KisPaintDeviceWriter &store, quint32
     } while(0)                                                  \
 
 
-bool KisTiledDataManager::processTilesHeader(QIODevice *stream, quint32 &numTiles)
+bool KisTiledDataManager::processTilesHeader(QIODevice *stream, quint32 &numTiles,
+                                             QVector<QPoint> *removedTiles)
 {
     /**
      * We assume that there is only one version of this header
@@ -217,6 +342,7 @@ bool KisTiledDataManager::processTilesHeader(QIODevice *stream, quint32 &numTile
     const qint32 maxLineLength = 25;
     const qint32 totalNumTests = 4;
     bool foundDataMark = false;
+    bool foundDeltaMark = false;
     qint32 testsPassed = 0;
 
     QString keyword;
@@ -241,6 +367,21 @@ bool KisTiledDataManager::processTilesHeader(QIODevice *stream, quint32 &numTile
             numTiles = value;
             foundDataMark = true;
         }
+        else if (keyword == "DELTA") {
+            if (!removedTiles || value < 0)
+                goto wrongString;
+
+            for (qint32 i = 0; i < value; i++) {
+                const QList<QByteArray> items = stream->readLine(maxLineLength).trimmed().split(',');
+                if (items.size() != 2)
+                    goto wrongString;
+
+                removedTiles->append(QPoint(items[0].toInt(), items[1].toInt()));
+            }
+
+            foundDeltaMark = true;
+            continue;
+        }
         else {
             goto wrongString;
         }
@@ -253,6 +394,11 @@ bool KisTiledDataManager::processTilesHeader(QIODevice *stream, quint32 &numTile
                   << testsPassed << "of" << totalNumTests;
     }
 
+    if (removedTiles && !foundDeltaMark) {
+        warnTiles << "The tiles stream is not a delta";
+        return false;
+    }
+
     return testsPassed == totalNumTests;
 
 wrongString:
@@ -293,6 +439,26 @@ void KisTiledDataManager::purge(const QRect& area)
     }
 }
 
+void KisTiledDataManager::prefetchTiles(qint32 leftCol, qint32 topRow, qint32 rightCol, qint32 bottomRow)
+{
+    if (!KisTileDataStore::instance()->hasSwappedTiles()) return;
+
+    for (qint32 row = topRow; row <= bottomRow; row++) {
+        for (qint32 col = leftCol; col <= rightCol; col++) {
+            KisTileSP tile = m_hashTable->getExistingTile(col, row);
+            if (tile) {
+                tile->prefetch();
+            }
+
+            bool unused;
+            KisTileSP oldTile = m_mementoManager->getCommittedTile(col, row, unused);
+            if (oldTile && oldTile != tile) {
+                oldTile->prefetch();
+            }
+        }
+    }
+}
+
 quint8* KisTiledDataManager::duplicatePixel(qint32 num, const quint8 *pixel)
 {
     const qint32 pixelSize = this->pixelSize();
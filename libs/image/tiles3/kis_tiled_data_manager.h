@@ -27,6 +27,7 @@
 #include "kis_memento_manager.h"
 #include "kis_memento.h"
 #include "KisTiledExtentManager.h"
+#include "KisTilesStreamOptions.h"
 
 class KisTiledDataManager;
 typedef KisSharedPtr<KisTiledDataManager> KisTiledDataManagerSP;
@@ -36,6 +37,22 @@ class KisTiledRandomAccessor;
 class KisPaintDeviceWriter;
 class QIODevice;
 
+/**
+ * The tiles of a data manager that differ from the tiles of some base
+ * data manager, see KisTiledDataManager::collectDifferentTiles()
+ */
+struct KisTiledDataManagerDelta
+{
+    QVector<KisTileSP> changedTiles;
+
+    /// the tiles existing in the base only, in tile coordinates
+    QVector<QPoint> removedTiles;
+
+    qint32 numTiles() const {
+        return changedTiles.size() + removedTiles.size();
+    }
+};
+
 /**
  * KisTiledDataManager implements the interface that KisDataManager defines
  *
@@ -102,6 +119,14 @@ public:
         }
     }
 
+    /**
+     * Asks the tile data store to load the existing tiles (both, the
+     * current and the committed ones) in the range of columns and
+     * rows from swap in background. Used by the iterators to read
+     * ahead the tiles they are going to access next.
+     */
+    void prefetchTiles(qint32 leftCol, qint32 topRow, qint32 rightCol, qint32 bottomRow);
+
     inline KisTileSP getTile(qint32 col, qint32 row, bool writable) {
         if (writable) {
             bool newTile;
@@ -196,8 +221,36 @@ protected:
     /**
      * Reads and writes the tiles
      */
-    bool write(KisPaintDeviceWriter &store);
-    bool read(QIODevice *stream);
+    bool write(KisPaintDeviceWriter &store, const KisTilesStreamOptions &options = KisTilesStreamOptions());
+    bool read(QIODevice *stream, const KisTilesStreamOptions &options = KisTilesStreamOptions());
+
+    /**
+     * Collects the tiles that differ from the tiles of \p base at the
+     * same positions, plus the positions of the tiles that exist in
+     * \p base, but not in this data manager.
+     *
+     * The tiles shared in copy-on-write manner are skipped without
+     * comparing their pixels.
+     */
+    KisTiledDataManagerDelta collectDifferentTiles(KisTiledDataManager *base);
+
+    /**
+     * Writes the \p delta collected by collectDifferentTiles(). The
+     * delta keeps the changed tiles alive, so the data manager must
+     * not be changed in between.
+     *
+     * readDelta() expects the data manager to contain a copy of the
+     * base data already (e.g. created with bitBltRough()), it applies
+     * the difference on top of it, so the unchanged tiles stay shared
+     * with the base.
+     */
+    bool writeDelta(KisPaintDeviceWriter &store, const KisTiledDataManagerDelta &delta,
+                    const KisTilesStreamOptions &options = KisTilesStreamOptions());
+    bool readDelta(QIODevice *stream, const KisTilesStreamOptions &options = KisTilesStreamOptions());
+
+    qint32 numTiles() const {
+        return m_hashTable->numTiles();
+    }
 
     void purge(const QRect& area);
 
@@ -357,8 +410,12 @@ private:
 private:
     void setDefaultPixelImpl(const quint8 *defPixel);
 
-    bool writeTilesHeader(KisPaintDeviceWriter &store, quint32 numTiles);
-    bool processTilesHeader(QIODevice *stream, quint32 &numTiles);
+    bool writeTilesHeader(KisPaintDeviceWriter &store, quint32 numTiles,
+                          const QVector<QPoint> *removedTiles = nullptr);
+    bool processTilesHeader(QIODevice *stream, quint32 &numTiles,
+                            QVector<QPoint> *removedTiles = nullptr);
+
+    bool readImpl(QIODevice *stream, bool isDelta, const KisTilesStreamOptions &options);
 
     inline qint32 divideRoundDown(qint32 x, const qint32 y) const
     {
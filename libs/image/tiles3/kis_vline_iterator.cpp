@@ -42,6 +42,7 @@ KisVLineIterator2::KisVLineIterator2(KisDataManager *dataManager, qint32 x, qint
 
     m_column = xToCol(m_x);
     m_xInTile = calcXInTile(m_x, m_column);
+    m_prefetchedColumn = m_column;
 
     m_topInTopmostTile = m_top - m_topRow * KisTileData::WIDTH;
 
@@ -113,6 +114,15 @@ void KisVLineIterator2::nextColumn()
         m_xInTile = 0;
         preallocateTiles();
     }
+
+    /**
+     * See a comment in KisHLineIterator2::nextRow()
+     */
+    if (m_column >= m_prefetchedColumn) {
+        m_prefetchedColumn = m_column + 1;
+        m_dataManager->prefetchTiles(m_prefetchedColumn, m_topRow, m_prefetchedColumn, m_bottomRow);
+    }
+
     m_index = 0;
     switchToTile(m_topInTopmostTile);
 
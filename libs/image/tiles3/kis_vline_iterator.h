@@ -61,6 +61,7 @@ private:
     qint32 m_left {0};
     qint32 m_topRow {0};
     qint32 m_bottomRow {0};
+    qint32 m_prefetchedColumn {0}; // the last tile column requested from the prefetcher
 
     qint32 m_topInTopmostTile {0};
     qint32 m_xInTile {0};
@@ -0,0 +1,74 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __KIS_COMPRESSION_FACTORY_H
+#define __KIS_COMPRESSION_FACTORY_H
+
+#include <QString>
+
+#include "tiles3/swap/kis_lzf_compression.h"
+#include "tiles3/swap/kis_lz4_compression.h"
+#include "tiles3/swap/kis_zlib_compression.h"
+
+class KRITAIMAGE_EXPORT KisCompressionFactory
+{
+public:
+    /**
+     * The values of the enum are stored in the first byte of every
+     * compressed tile buffer (see KisTileCompressor2), so they must
+     * never be changed. LZF has the same value as the legacy
+     * "compressed data" flag, which keeps the old files loadable.
+     */
+    enum Algorithm : quint8 {
+        LZF = 1,
+        LZ4 = 2,
+        ZLIB = 3
+    };
+
+    static bool isValid(quint8 algorithm) {
+        return algorithm >= LZF && algorithm <= ZLIB;
+    }
+
+    static KisAbstractCompression* create(Algorithm algorithm) {
+        switch(algorithm) {
+        case LZF:
+            return new KisLzfCompression();
+        case LZ4:
+            return new KisLz4Compression();
+        case ZLIB:
+            return new KisZlibCompression();
+        };
+
+        return 0;
+    }
+
+    static QString name(Algorithm algorithm) {
+        switch(algorithm) {
+        case LZF:
+            return "LZF";
+        case LZ4:
+            return "LZ4";
+        case ZLIB:
+            return "ZLIB";
+        };
+
+        return QString();
+    }
+
+    static Algorithm fromName(const QString &name, Algorithm defaultAlgorithm = LZF) {
+        const QString upperName = name.toUpper();
+
+        return upperName == "LZF" ? LZF :
+               upperName == "LZ4" ? LZ4 :
+               upperName == "ZLIB" ? ZLIB :
+               defaultAlgorithm;
+    }
+
+private:
+    KisCompressionFactory();
+};
+
+#endif /* __KIS_COMPRESSION_FACTORY_H */
@@ -0,0 +1,231 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kis_lz4_compression.h"
+
+#include <cstring>
+
+
+#define HASH_LOG  12
+#define HASH_SIZE (1 << HASH_LOG)
+
+#define MIN_MATCH      4
+#define LAST_LITERALS  5   /* the last 5 bytes of a block are always literals */
+#define MF_LIMIT      12   /* the last match must start at least 12 bytes before the end */
+#define MAX_DISTANCE  65535
+#define SKIP_TRIGGER   6   /* speed up the scan of incompressible data */
+
+
+namespace {
+
+inline quint32 read32(const quint8 *p)
+{
+    quint32 value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+inline quint32 hash32(quint32 sequence)
+{
+    return (sequence * 2654435761U) >> (32 - HASH_LOG);
+}
+
+inline quint8* writeLength(quint8 *op, qint32 length)
+{
+    while (length >= 255) {
+        *op++ = 255;
+        length -= 255;
+    }
+    *op++ = quint8(length);
+    return op;
+}
+
+inline quint8* writeLiterals(quint8 *op, const quint8 *literals, qint32 length, quint8 matchNibble)
+{
+    quint8 *token = op++;
+
+    if (length >= 15) {
+        *token = (15 << 4) | matchNibble;
+        op = writeLength(op, length - 15);
+    } else {
+        *token = quint8(length << 4) | matchNibble;
+    }
+
+    memcpy(op, literals, length);
+    return op + length;
+}
+
+inline bool readLength(const quint8 *&ip, const quint8 *inputEnd, qint32 &length)
+{
+    quint8 s;
+    do {
+        if (ip >= inputEnd) return false;
+        s = *ip++;
+        length += s;
+    } while (s == 255);
+
+    return true;
+}
+
+}
+
+qint32 lz4_compress(const quint8 *input, qint32 length, quint8 *output)
+{
+    const quint8 *ip = input;
+    const quint8 *anchor = input;
+    const quint8 *inputEnd = input + length;
+    const quint8 *mfLimit = inputEnd - MF_LIMIT;
+    const quint8 *matchLimit = inputEnd - LAST_LITERALS;
+
+    quint8 *op = output;
+
+    if (length > MF_LIMIT) {
+        qint32 htab[HASH_SIZE];
+        std::fill(htab, htab + HASH_SIZE, -1);
+
+        qint32 searchCount = 1 << SKIP_TRIGGER;
+
+        while (ip <= mfLimit) {
+            const quint32 sequence = read32(ip);
+            const quint32 h = hash32(sequence);
+            const qint32 refPos = htab[h];
+            htab[h] = ip - input;
+
+            const quint8 *ref = input + refPos;
+
+            if (refPos < 0 ||
+                ip - ref > MAX_DISTANCE ||
+                read32(ref) != sequence) {
+
+                ip += searchCount++ >> SKIP_TRIGGER;
+                continue;
+            }
+
+            searchCount = 1 << SKIP_TRIGGER;
+
+            /* extend the match backwards */
+            while (ip > anchor && ref > input && ip[-1] == ref[-1]) {
+                ip--;
+                ref--;
+            }
+
+            /* and forward */
+            const quint8 *matchEnd = ip + MIN_MATCH;
+            const quint8 *refEnd = ref + MIN_MATCH;
+            while (matchEnd < matchLimit && *matchEnd == *refEnd) {
+                matchEnd++;
+                refEnd++;
+            }
+
+            const qint32 matchLength = matchEnd - ip - MIN_MATCH;
+            const quint8 matchNibble = matchLength >= 15 ? 15 : matchLength;
+
+            op = writeLiterals(op, anchor, ip - anchor, matchNibble);
+
+            const quint16 offset = quint16(ip - ref);
+            *op++ = offset & 0xff;
+            *op++ = offset >> 8;
+
+            if (matchLength >= 15) {
+                op = writeLength(op, matchLength - 15);
+            }
+
+            ip = anchor = matchEnd;
+        }
+    }
+
+    /* encode the last literals */
+    op = writeLiterals(op, anchor, inputEnd - anchor, 0);
+
+    return op - output;
+}
+
+qint32 lz4_decompress(const quint8 *input, qint32 length, quint8 *output, qint32 maxout)
+{
+    const quint8 *ip = input;
+    const quint8 *inputEnd = input + length;
+    quint8 *op = output;
+    quint8 *outputEnd = output + maxout;
+
+    while (ip < inputEnd) {
+        const quint8 token = *ip++;
+
+        qint32 literalLength = token >> 4;
+        if (literalLength == 15 && !readLength(ip, inputEnd, literalLength)) {
+            return 0;
+        }
+
+        if (literalLength > inputEnd - ip || literalLength > outputEnd - op) {
+            return 0;
+        }
+
+        memcpy(op, ip, literalLength);
+        op += literalLength;
+        ip += literalLength;
+
+        /* the last sequence has no match part */
+        if (ip >= inputEnd) break;
+
+        if (inputEnd - ip < 2) return 0;
+
+        const qint32 offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+
+        if (offset == 0 || offset > op - output) {
+            return 0;
+        }
+
+        qint32 matchLength = token & 0x0f;
+        if (matchLength == 15 && !readLength(ip, inputEnd, matchLength)) {
+            return 0;
+        }
+        matchLength += MIN_MATCH;
+
+        if (matchLength > outputEnd - op) {
+            return 0;
+        }
+
+        const quint8 *ref = op - offset;
+
+        if (offset >= matchLength) {
+            memcpy(op, ref, matchLength);
+            op += matchLength;
+        } else {
+            /* overlapping copy, e.g. a run of the same byte */
+            for (; matchLength; --matchLength) {
+                *op++ = *ref++;
+            }
+        }
+    }
+
+    return op - output;
+}
+
+
+KisLz4Compression::KisLz4Compression()
+{
+}
+
+KisLz4Compression::~KisLz4Compression()
+{
+}
+
+qint32 KisLz4Compression::compress(const quint8* input, qint32 inputLength, quint8* output, qint32 outputLength)
+{
+    Q_UNUSED(outputLength);
+    return lz4_compress(input, inputLength, output);
+}
+
+qint32 KisLz4Compression::decompress(const quint8* input, qint32 inputLength, quint8* output, qint32 outputLength)
+{
+    return lz4_decompress(input, inputLength, output, outputLength);
+}
+
+qint32 KisLz4Compression::outputBufferSize(qint32 dataSize)
+{
+    // the worst case of LZ4 block format: all the data is stored as literals
+    return dataSize + dataSize / 255 + 16;
+}
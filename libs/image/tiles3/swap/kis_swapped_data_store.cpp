@@ -13,26 +13,73 @@
 
 //#define COMPRESSOR_VERSION 2
 
+struct KisSwappedDataStore::Stripe
+{
+    Stripe(const QString &swapDir,
+           quint64 slabSize, quint64 maxSwapSize, quint64 windowSize,
+           KisCompressionFactory::Algorithm algorithm)
+        : allocator(slabSize, maxSwapSize),
+          swapSpace(swapDir, windowSize),
+          compressor(algorithm)
+    {
+    }
+
+    QMutex lock;
+    QByteArray buffer;
+
+    KisChunkAllocator allocator;
+    KisMemoryWindow swapSpace;
+    KisTileCompressor2 compressor;
+};
+
 KisSwappedDataStore::KisSwappedDataStore()
     : m_totalSwapMemoryUsed(0)
 {
     KisImageConfig config(true);
-    const quint64 maxSwapSize = config.maxSwapSize() * MiB;
+    const int numStripes = config.swapStripesCount();
     const quint64 swapSlabSize = config.swapSlabSize() * MiB;
     const quint64 swapWindowSize = config.swapWindowSize() * MiB;
 
-    m_allocator = new KisChunkAllocator(swapSlabSize, maxSwapSize);
-    m_swapSpace = new KisMemoryWindow(config.swapDir(), swapWindowSize);
+    /**
+     * The limit of the swap is split evenly between the stripes, but
+     * every stripe should be able to allocate at least one slab
+     */
+    const quint64 maxSwapSize =
+        qMax(swapSlabSize, config.maxSwapSize() * MiB / numStripes);
+
+    /**
+     * The swap file lives only within the current session, so
+     * there are no compatibility issues in using any algorithm
+     */
+    const KisCompressionFactory::Algorithm algorithm =
+        KisCompressionFactory::fromName(config.swapCompressionAlgorithm(),
+                                        KisCompressionFactory::LZ4);
+
+    const QString swapDir = config.swapDir();
 
-    // FIXME: use a factory after the patch is committed
-    m_compressor = new KisTileCompressor2();
+    for (int i = 0; i < numStripes; i++) {
+        m_stripes.emplace_back(
+            new Stripe(swapDir, swapSlabSize, maxSwapSize, swapWindowSize, algorithm));
+    }
 }
 
 KisSwappedDataStore::~KisSwappedDataStore()
 {
-    delete m_compressor;
-    delete m_swapSpace;
-    delete m_allocator;
+}
+
+KisSwappedDataStore::Stripe* KisSwappedDataStore::stripeForTileData(KisTileData *td) const
+{
+    /**
+     * The stripe is defined by the address of the tile data, so
+     * the data is always swapped in from the same stripe it was
+     * swapped out to, without storing any extra information.
+     *
+     * The lower bits of the pointer are always the same due to the
+     * alignment, so the address is mixed before taking the modulo.
+     */
+    const quint64 key = reinterpret_cast<quintptr>(td);
+    const quint64 hash = (key * 0x9E3779B97F4A7C15ULL) >> 32;
+    return m_stripes[hash % m_stripes.size()].get();
 }
 
 quint64 KisSwappedDataStore::numTiles() const
@@ -40,13 +87,21 @@ quint64 KisSwappedDataStore::numTiles() const
     // We are not acquiring the lock here...
     // Hope QLinkedList will ensure atomic access to it's size...
 
-    return m_allocator->numChunks();
+    quint64 result = 0;
+
+    for (const std::unique_ptr<Stripe> &stripe : m_stripes) {
+        result += stripe->allocator.numChunks();
+    }
+
+    return result;
 }
 
 bool KisSwappedDataStore::trySwapOutTileData(KisTileData *td)
 {
     Q_ASSERT(td->data());
-    QMutexLocker locker(&m_lock);
+
+    Stripe *stripe = stripeForTileData(td);
+    QMutexLocker locker(&stripe->lock);
 
     /**
      * We are expecting that the lock of KisTileData
@@ -54,20 +109,44 @@ bool KisSwappedDataStore::trySwapOutTileData(KisTileData *td)
      * So we can modify the tile data freely.
      */
 
-    const qint32 expectedBufferSize = m_compressor->tileDataBufferSize(td);
-    if(m_buffer.size() < expectedBufferSize)
-        m_buffer.resize(expectedBufferSize);
+    const qint32 expectedBufferSize = stripe->compressor.tileDataBufferSize(td);
+    if(stripe->buffer.size() < expectedBufferSize)
+        stripe->buffer.resize(expectedBufferSize);
 
     qint32 bytesWritten;
-    m_compressor->compressTileData(td, (quint8*) m_buffer.data(), m_buffer.size(), bytesWritten);
+    stripe->compressor.compressTileData(td, (quint8*) stripe->buffer.data(), stripe->buffer.size(), bytesWritten);
 
-    KisChunk chunk = m_allocator->getChunk(bytesWritten);
-    quint8 *ptr = m_swapSpace->getWriteChunkPtr(chunk);
+    KisChunk chunk = stripe->allocator.getChunk(bytesWritten);
+    quint8 *ptr = stripe->swapSpace.getWriteChunkPtr(chunk);
     if (!ptr) {
         qWarning() << "swap out of tile failed";
         return false;
     }
-    memcpy(ptr, m_buffer.data(), bytesWritten);
+    memcpy(ptr, stripe->buffer.data(), bytesWritten);
+
+    td->releaseMemory();
+    td->setSwapChunk(chunk);
+
+    m_totalSwapMemoryUsed += chunk.size();
+
+    return true;
+}
+
+bool KisSwappedDataStore::trySwapOutCompressedTileData(KisTileData *td, const quint8 *buffer, qint32 bufferSize)
+{
+    Q_ASSERT(td->data());
+
+    Stripe *stripe = stripeForTileData(td);
+    QMutexLocker locker(&stripe->lock);
+
+    KisChunk chunk = stripe->allocator.getChunk(bufferSize);
+    quint8 *ptr = stripe->swapSpace.getWriteChunkPtr(chunk);
+    if (!ptr) {
+        qWarning() << "swap out of compressed tile failed";
+        stripe->allocator.freeChunk(chunk);
+        return false;
+    }
+    memcpy(ptr, buffer, bufferSize);
 
     td->releaseMemory();
     td->setSwapChunk(chunk);
@@ -80,7 +159,9 @@ bool KisSwappedDataStore::trySwapOutTileData(KisTileData *td)
 void KisSwappedDataStore::swapInTileData(KisTileData *td)
 {
     Q_ASSERT(!td->data());
-    QMutexLocker locker(&m_lock);
+
+    Stripe *stripe = stripeForTileData(td);
+    QMutexLocker locker(&stripe->lock);
 
     // see comment in swapOutTileData()
 
@@ -90,19 +171,20 @@ void KisSwappedDataStore::swapInTileData(KisTileData *td)
     td->allocateMemory();
     td->setSwapChunk(KisChunk());
 
-    quint8 *ptr = m_swapSpace->getReadChunkPtr(chunk);
+    quint8 *ptr = stripe->swapSpace.getReadChunkPtr(chunk);
     Q_ASSERT(ptr);
-    m_compressor->decompressTileData(ptr, chunk.size(), td);
-    m_allocator->freeChunk(chunk);
+    stripe->compressor.decompressTileData(ptr, chunk.size(), td);
+    stripe->allocator.freeChunk(chunk);
 }
 
 void KisSwappedDataStore::forgetTileData(KisTileData *td)
 {
-    QMutexLocker locker(&m_lock);
+    Stripe *stripe = stripeForTileData(td);
+    QMutexLocker locker(&stripe->lock);
 
     m_totalSwapMemoryUsed -= td->swapChunk().size();
 
-    m_allocator->freeChunk(td->swapChunk());
+    stripe->allocator.freeChunk(td->swapChunk());
     td->setSwapChunk(KisChunk());
 }
 
@@ -111,8 +193,17 @@ qint64 KisSwappedDataStore::totalSwapMemoryUsed() const
     return m_totalSwapMemoryUsed;
 }
 
+int KisSwappedDataStore::numStripes() const
+{
+    return m_stripes.size();
+}
+
 void KisSwappedDataStore::debugStatistics()
 {
-    m_allocator->sanityCheck();
-    m_allocator->debugFragmentation();
+    for (std::unique_ptr<Stripe> &stripe : m_stripes) {
+        QMutexLocker locker(&stripe->lock);
+
+        stripe->allocator.sanityCheck();
+        stripe->allocator.debugFragmentation();
+    }
 }
@@ -9,16 +9,24 @@
 
 #include "kritaimage_export.h"
 
+#include <atomic>
+#include <memory>
+#include <vector>
+
 #include <QMutex>
 #include <QByteArray>
 
 
-class QMutex;
 class KisTileData;
-class KisAbstractTileCompressor;
-class KisChunkAllocator;
-class KisMemoryWindow;
 
+/**
+ * The swap is split into several independent stripes. Every stripe
+ * owns its own lock, chunk allocator, compressor and a segment of the
+ * swap (a separate file mapped with its own memory window). A tile
+ * data is always assigned to the same stripe, so the threads faulting
+ * in tiles of different stripes do not wait for each other and can
+ * decompress the data in parallel.
+ */
 class KRITAIMAGE_EXPORT KisSwappedDataStore
 {
 public:
@@ -38,6 +46,17 @@ public:
      */
     bool trySwapOutTileData(KisTileData *td);
 
+    /**
+     * The same as trySwapOutTileData(), but the data of \a td is
+     * not compressed. Instead, the swap receives the \a buffer that
+     * already contains the data of the tile compressed in the format
+     * of KisTileCompressor2 (e.g. read from a file). The data will be
+     * decompressed on the first access to the tile.
+     * LOCKING: the lock on the tile data should be taken
+     *          by the caller before making a call.
+     */
+    bool trySwapOutCompressedTileData(KisTileData *td, const quint8 *buffer, qint32 bufferSize);
+
     /**
      * Restore the data of a \a td basing on information
      * stored in the swap file.
@@ -59,22 +78,23 @@ public:
      */
     qint64 totalSwapMemoryUsed() const;
 
+    /**
+     * Returns the number of stripes the swap is split into
+     */
+    int numStripes() const;
+
     /**
      * Some debugging output
      */
     void debugStatistics();
 
 private:
-    QByteArray m_buffer;
-    KisAbstractTileCompressor *m_compressor;
-
-    KisChunkAllocator *m_allocator;
-    KisMemoryWindow *m_swapSpace;
+    struct Stripe;
+    Stripe* stripeForTileData(KisTileData *td) const;
 
-    QMutex m_lock;
-
-    qint64 m_totalSwapMemoryUsed;
+private:
+    std::vector<std::unique_ptr<Stripe>> m_stripes;
+    std::atomic<qint64> m_totalSwapMemoryUsed;
 };
 
 #endif /* __KIS_SWAPPED_DATA_STORE_H */
-
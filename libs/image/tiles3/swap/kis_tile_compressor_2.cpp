@@ -5,22 +5,45 @@
  */
 
 #include "kis_tile_compressor_2.h"
-#include "kis_lzf_compression.h"
 #include <QIODevice>
 #include "kis_paint_device_writer.h"
 #define TILE_DATA_SIZE(pixelSize) ((pixelSize) * KisTileData::WIDTH * KisTileData::HEIGHT)
 
-const QString KisTileCompressor2::m_compressionName = "LZF";
 
-
-KisTileCompressor2::KisTileCompressor2()
+KisTileCompressor2::KisTileCompressor2(KisCompressionFactory::Algorithm algorithm,
+                                       bool lazyDecompression)
+    : m_algorithm(algorithm),
+      m_compressionName(KisCompressionFactory::name(algorithm)),
+      m_lazyDecompression(lazyDecompression)
 {
-    m_compression = new KisLzfCompression();
+    m_compressions[algorithm].reset(KisCompressionFactory::create(algorithm));
+    m_compression = m_compressions[algorithm].get();
 }
 
 KisTileCompressor2::~KisTileCompressor2()
 {
-    delete m_compression;
+}
+
+KisAbstractCompression* KisTileCompressor2::decompressorForFlag(quint8 flag)
+{
+    if (!KisCompressionFactory::isValid(flag)) return 0;
+
+    std::unique_ptr<KisAbstractCompression> &compression = m_compressions[flag];
+
+    if (!compression) {
+        compression.reset(KisCompressionFactory::create(KisCompressionFactory::Algorithm(flag)));
+    }
+
+    return compression.get();
+}
+
+bool KisTileCompressor2::isValidCompressedData(const quint8 *buffer, qint32 bufferSize, qint32 tileDataSize) const
+{
+    if (bufferSize < 1) return false;
+
+    return buffer[0] == RAW_DATA_FLAG ?
+        bufferSize == tileDataSize + 1 :
+        KisCompressionFactory::isValid(buffer[0]);
 }
 
 bool KisTileCompressor2::writeTile(KisTileSP tile, KisPaintDeviceWriter &store)
@@ -63,7 +86,14 @@ bool KisTileCompressor2::readTile(QIODevice *stream, KisTiledDataManager *dm)
         qint32 dataSize = headerItems.takeFirst().toInt();
 
         Q_ASSERT(headerItems.isEmpty());
-        Q_ASSERT(compressionName == m_compressionName);
+
+        /**
+         * The actual algorithm is defined by the flag stored in the
+         * data itself, the name in the header is informational only
+         */
+        if (KisCompressionFactory::name(KisCompressionFactory::fromName(compressionName)) != compressionName) {
+            warnFile << "Unknown tile compression algorithm:" << compressionName;
+        }
 
         qint32 row = yToRow(dm, y);
         qint32 col = xToCol(dm, x);
@@ -72,6 +102,24 @@ bool KisTileCompressor2::readTile(QIODevice *stream, KisTiledDataManager *dm)
 
         stream->read(m_streamingBuffer.data(), dataSize);
 
+        if (m_lazyDecompression &&
+            isValidCompressedData((quint8*)m_streamingBuffer.data(), dataSize, tileDataSize)) {
+
+            /**
+             * Detach the tile from the default tile data first, then
+             * put its own tile data into the swap as it is. If the swap
+             * refuses the data, just decompress it in place.
+             */
+            tile->lockForWrite();
+            tile->unlockForWrite();
+
+            if (KisTileDataStore::instance()->trySwapOutCompressedTileData(tile->tileData(),
+                                                                           (quint8*)m_streamingBuffer.data(),
+                                                                           dataSize)) {
+                return true;
+            }
+        }
+
         tile->lockForWrite();
         bool res = decompressTileData((quint8*)m_streamingBuffer.data(), dataSize, tile->tileData());
         tile->unlockForWrite();
@@ -122,8 +170,8 @@ void KisTileCompressor2::compressTileData(KisTileData *tileData,
     compressedBytes = m_compression->compress((quint8*)m_linearizationBuffer.data(), tileDataSize,
                                               (quint8*)m_compressionBuffer.data(), m_compressionBuffer.size());
 
-    if(compressedBytes < tileDataSize) {
-        buffer[0] = COMPRESSED_DATA_FLAG;
+    if(compressedBytes > 0 && compressedBytes < tileDataSize) {
+        buffer[0] = m_algorithm;
         memcpy(buffer + 1, m_compressionBuffer.data(), compressedBytes);
         bytesWritten = compressedBytes + 1;
     }
@@ -141,12 +189,18 @@ bool KisTileCompressor2::decompressTileData(quint8 *buffer,
     const qint32 pixelSize = tileData->pixelSize();
     const qint32 tileDataSize = TILE_DATA_SIZE(pixelSize);
 
-    if(buffer[0] == COMPRESSED_DATA_FLAG) {
+    if(buffer[0] != RAW_DATA_FLAG) {
+        KisAbstractCompression *compression = decompressorForFlag(buffer[0]);
+        if (!compression) {
+            warnFile << "Unknown tile compression flag:" << buffer[0];
+            return false;
+        }
+
         prepareWorkBuffers(tileDataSize);
 
         qint32 bytesWritten;
-        bytesWritten = m_compression->decompress(buffer + 1, bufferSize - 1,
-                                                 (quint8*)m_linearizationBuffer.data(), tileDataSize);
+        bytesWritten = compression->decompress(buffer + 1, bufferSize - 1,
+                                               (quint8*)m_linearizationBuffer.data(), tileDataSize);
         if (bytesWritten == tileDataSize) {
             KisAbstractCompression::delinearizeColors((quint8*)m_linearizationBuffer.data(),
                                                       tileData->data(),
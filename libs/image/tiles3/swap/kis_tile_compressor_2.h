@@ -8,13 +8,31 @@
 #define __KIS_TILE_COMPRESSOR_2_H
 
 #include "kis_abstract_tile_compressor.h"
+#include "kis_compression_factory.h"
+
+#include <array>
+#include <memory>
 
 class KisAbstractCompression;
 
+/**
+ * Tile compressor of version 2. The compression algorithm used for
+ * writing the tiles is selected on construction. The algorithm is
+ * recorded in the first byte of every compressed buffer (and in the
+ * textual header of the tiles written with writeTile()), so the
+ * compressor can read tiles written with any supported algorithm,
+ * including the files written by the older versions of Krita, which
+ * know only about LZF.
+ *
+ * When \p lazyDecompression is enabled, readTile() doesn't decompress
+ * the tiles. The compressed data is moved into the swap as it is and
+ * is decompressed on the first access to the tile only.
+ */
 class KRITAIMAGE_EXPORT KisTileCompressor2 : public KisAbstractTileCompressor
 {
 public:
-    KisTileCompressor2();
+    KisTileCompressor2(KisCompressionFactory::Algorithm algorithm = KisCompressionFactory::LZF,
+                       bool lazyDecompression = false);
     ~KisTileCompressor2() override;
 
     bool writeTile(KisTileSP tile, KisPaintDeviceWriter &store) override;
@@ -37,16 +55,30 @@ private:
     void prepareWorkBuffers(qint32 tileDataSize);
     void prepareStreamingBuffer(qint32 tileDataSize);
 
+    KisAbstractCompression* decompressorForFlag(quint8 flag);
+
+    bool isValidCompressedData(const quint8 *buffer, qint32 bufferSize, qint32 tileDataSize) const;
+
 private:
     static const qint8 RAW_DATA_FLAG = 0;
-    static const qint8 COMPRESSED_DATA_FLAG = 1;
 
 private:
     QByteArray m_linearizationBuffer;
     QByteArray m_compressionBuffer;
     QByteArray m_streamingBuffer;
+
+    KisCompressionFactory::Algorithm m_algorithm;
+    QString m_compressionName;
+
+    /**
+     * Compressions are indexed by the value of the algorithm flag;
+     * the one used for writing is created on construction, the
+     * others are created lazily when a tile needs them
+     */
+    std::array<std::unique_ptr<KisAbstractCompression>, KisCompressionFactory::ZLIB + 1> m_compressions;
     KisAbstractCompression *m_compression;
-    static const QString m_compressionName;
+
+    bool m_lazyDecompression;
 };
 
 #endif /* __KIS_TILE_COMPRESSOR_2_H */
@@ -13,13 +13,23 @@
 class KRITAIMAGE_EXPORT KisTileCompressorFactory
 {
 public:
-    static KisAbstractTileCompressorSP create(qint32 version) {
+    /**
+     * Creates a compressor for the tiles of version \p version. The
+     * \p algorithm is used only for writing the tiles, reading works
+     * for any of the algorithms supported by the compressor.
+     *
+     * \p lazyDecompression is supported by the version 2 only,
+     * \see KisTileCompressor2
+     */
+    static KisAbstractTileCompressorSP create(qint32 version,
+                                              KisCompressionFactory::Algorithm algorithm = KisCompressionFactory::LZF,
+                                              bool lazyDecompression = false) {
         switch(version) {
         case 1:
             return KisAbstractTileCompressorSP(new KisLegacyTileCompressor());
             break;
         case 2:
-            return KisAbstractTileCompressorSP(new KisTileCompressor2());
+            return KisAbstractTileCompressorSP(new KisTileCompressor2(algorithm, lazyDecompression));
             break;
         default:
             qFatal("Unknown version of the tiles");
@@ -0,0 +1,125 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <QMutex>
+#include <QQueue>
+#include <QSemaphore>
+
+#include "tiles3/swap/kis_tile_data_prefetcher.h"
+#include "tiles3/kis_tile_data.h"
+#include "tiles3/kis_tile_data_store.h"
+#include "kis_debug.h"
+
+/**
+ * The iterators may request the whole image to be prefetched. We
+ * should not try to load more data than the swapper will allow to
+ * keep in memory, so the requests exceeding this limit are just
+ * dropped. The tiles will be loaded on demand in such a case.
+ */
+const int KisTileDataPrefetcher::MAX_QUEUE_SIZE = 1024;
+
+
+struct Q_DECL_HIDDEN KisTileDataPrefetcher::Private
+{
+public:
+    QSemaphore semaphore;
+    QAtomicInt shouldExitFlag;
+    KisTileDataStore *store;
+
+    QMutex queueLock;
+    QQueue<KisTileData*> queue;
+};
+
+KisTileDataPrefetcher::KisTileDataPrefetcher(KisTileDataStore *store)
+    : QThread(),
+      m_d(new Private())
+{
+    m_d->shouldExitFlag = 0;
+    m_d->store = store;
+}
+
+KisTileDataPrefetcher::~KisTileDataPrefetcher()
+{
+    cancelRequests();
+    delete m_d;
+}
+
+void KisTileDataPrefetcher::addRequest(KisTileData *td)
+{
+    {
+        QMutexLocker locker(&m_d->queueLock);
+
+        if (m_d->queue.size() < MAX_QUEUE_SIZE) {
+            m_d->queue.enqueue(td);
+            td = 0;
+        }
+    }
+
+    if (td) {
+        td->deref();
+    } else {
+        m_d->semaphore.release();
+    }
+}
+
+void KisTileDataPrefetcher::terminatePrefetcher()
+{
+    unsigned long exitTimeout = 100;
+    do {
+        m_d->shouldExitFlag = true;
+        m_d->semaphore.release();
+    } while(!wait(exitTimeout));
+
+    cancelRequests();
+}
+
+void KisTileDataPrefetcher::run()
+{
+    while (1) {
+        m_d->semaphore.acquire();
+
+        if (m_d->shouldExitFlag)
+            return;
+
+        processRequests();
+    }
+}
+
+void KisTileDataPrefetcher::processRequests()
+{
+    while (!m_d->shouldExitFlag) {
+        KisTileData *td = 0;
+
+        {
+            QMutexLocker locker(&m_d->queueLock);
+            if (m_d->queue.isEmpty()) break;
+            td = m_d->queue.dequeue();
+        }
+
+        m_d->store->prefetchSwapIn(td);
+        td->deref();
+
+        /**
+         * Every request has its own semaphore release,
+         * so just eat it up
+         */
+        m_d->semaphore.tryAcquire();
+    }
+}
+
+void KisTileDataPrefetcher::cancelRequests()
+{
+    QQueue<KisTileData*> queue;
+
+    {
+        QMutexLocker locker(&m_d->queueLock);
+        std::swap(queue, m_d->queue);
+    }
+
+    Q_FOREACH (KisTileData *td, queue) {
+        td->deref();
+    }
+}
@@ -0,0 +1,55 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#ifndef KIS_TILE_DATA_PREFETCHER_H_
+#define KIS_TILE_DATA_PREFETCHER_H_
+
+#include <QObject>
+#include <QThread>
+
+#include "kritaimage_export.h"
+
+
+class KisTileDataStore;
+class KisTileData;
+
+/**
+ * A thread that loads swapped-out tile data back into memory
+ * before the painting thread actually accesses it. The requests
+ * are queued by the iterators, which know which tiles they are
+ * going to touch next, so the decompression overlaps with the
+ * processing of the tiles that are already in memory.
+ */
+class KRITAIMAGE_EXPORT KisTileDataPrefetcher : public QThread
+{
+    Q_OBJECT
+
+public:
+    KisTileDataPrefetcher(KisTileDataStore *store);
+    ~KisTileDataPrefetcher() override;
+
+    /**
+     * Queue \p td for swapping in. The tile data should already
+     * be ref'ed by the caller, the prefetcher will deref it when
+     * the request is processed.
+     */
+    void addRequest(KisTileData *td);
+
+    void terminatePrefetcher();
+
+private:
+    void run() override;
+    void processRequests();
+    void cancelRequests();
+
+private:
+    static const int MAX_QUEUE_SIZE;
+
+private:
+    struct Private;
+    Private * const m_d;
+};
+
+#endif /* KIS_TILE_DATA_PREFETCHER_H_ */
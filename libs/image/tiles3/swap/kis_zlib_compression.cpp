@@ -0,0 +1,45 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kis_zlib_compression.h"
+
+#include <zlib.h>
+
+
+KisZlibCompression::KisZlibCompression(int compressionLevel)
+    : m_compressionLevel(compressionLevel)
+{
+}
+
+KisZlibCompression::~KisZlibCompression()
+{
+}
+
+qint32 KisZlibCompression::compress(const quint8* input, qint32 inputLength, quint8* output, qint32 outputLength)
+{
+    uLongf bytesWritten = outputLength;
+
+    const int result = compress2(output, &bytesWritten,
+                                 input, inputLength,
+                                 m_compressionLevel);
+
+    return result == Z_OK ? qint32(bytesWritten) : 0;
+}
+
+qint32 KisZlibCompression::decompress(const quint8* input, qint32 inputLength, quint8* output, qint32 outputLength)
+{
+    uLongf bytesWritten = outputLength;
+
+    const int result = uncompress(output, &bytesWritten,
+                                  input, inputLength);
+
+    return result == Z_OK ? qint32(bytesWritten) : 0;
+}
+
+qint32 KisZlibCompression::outputBufferSize(qint32 dataSize)
+{
+    return compressBound(dataSize);
+}
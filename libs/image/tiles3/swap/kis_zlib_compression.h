@@ -0,0 +1,32 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __KIS_ZLIB_COMPRESSION_H
+#define __KIS_ZLIB_COMPRESSION_H
+
+#include "kis_abstract_compression.h"
+
+/**
+ * A slow, but high-ratio compression based on zlib's deflate. Useful
+ * for the data that is written once and rarely read back, e.g. pixel
+ * data of the layers stored in .kra files.
+ */
+class KRITAIMAGE_EXPORT KisZlibCompression : public KisAbstractCompression
+{
+public:
+    KisZlibCompression(int compressionLevel = 6);
+    ~KisZlibCompression() override;
+
+    qint32 compress(const quint8* input, qint32 inputLength, quint8* output, qint32 outputLength) override;
+    qint32 decompress(const quint8* input, qint32 inputLength, quint8* output, qint32 outputLength) override;
+
+    qint32 outputBufferSize(qint32 dataSize) override;
+
+private:
+    int m_compressionLevel;
+};
+
+#endif /* __KIS_ZLIB_COMPRESSION_H */
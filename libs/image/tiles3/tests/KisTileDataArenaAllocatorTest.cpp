@@ -0,0 +1,171 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisTileDataArenaAllocatorTest.h"
+
+#include <QVector>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QThread>
+
+#include "tiles3/KisTileDataArenaAllocator.h"
+
+static const qint32 PIXELS_PER_TILE = 64 * 64;
+
+void KisTileDataArenaAllocatorTest::testAllocateFree_data()
+{
+    QTest::addColumn<int>("pixelSize");
+    QTest::addColumn<int>("hugePagesMode");
+
+    const QVector<int> pixelSizes({1, 2, 3, 4, 8, 16, 20, 128});
+
+    Q_FOREACH (int pixelSize, pixelSizes) {
+        QTest::addRow("%d-bytes", pixelSize)
+            << pixelSize << int(KisTileDataArenaAllocator::NoHugePages);
+    }
+
+    QTest::addRow("4-bytes-thp") << 4 << int(KisTileDataArenaAllocator::TransparentHugePages);
+    QTest::addRow("4-bytes-hugetlb") << 4 << int(KisTileDataArenaAllocator::ExplicitHugePages);
+}
+
+void KisTileDataArenaAllocatorTest::testAllocateFree()
+{
+    QFETCH(int, pixelSize);
+    QFETCH(int, hugePagesMode);
+
+    KisTileDataArenaAllocator allocator(KisTileDataArenaAllocator::HugePagesMode(hugePagesMode),
+                                        PIXELS_PER_TILE);
+
+    const int chunkSize = pixelSize * PIXELS_PER_TILE;
+
+    // make sure we need more than one arena
+    const int numChunks = 3 * (4 * 1024 * 1024) / chunkSize + 1;
+
+    QVector<quint8*> chunks;
+
+    for (int i = 0; i < numChunks; i++) {
+        quint8 *ptr = allocator.allocate(pixelSize);
+        QVERIFY(ptr);
+
+        memset(ptr, i % 251, chunkSize);
+        chunks << ptr;
+    }
+
+    for (int i = 0; i < numChunks; i++) {
+        QCOMPARE(chunks[i][0], quint8(i % 251));
+        QCOMPARE(chunks[i][chunkSize - 1], quint8(i % 251));
+    }
+
+    KisTileDataArenaAllocator::Statistics stats = allocator.statistics();
+
+    if (pixelSize <= 64) {
+        QCOMPARE(stats.usedSize, qint64(numChunks) * chunkSize);
+        QVERIFY(stats.reservedSize >= stats.usedSize);
+        QVERIFY(stats.numArenas > 1);
+    }
+
+    Q_FOREACH (quint8 *ptr, chunks) {
+        allocator.free(ptr, pixelSize);
+    }
+
+    stats = allocator.statistics();
+    QCOMPARE(stats.usedSize, qint64(0));
+
+    // only one spare arena is kept
+    QVERIFY(stats.numArenas <= 1);
+
+    allocator.releaseSpareArenas();
+
+    stats = allocator.statistics();
+    QCOMPARE(stats.numArenas, qint64(0));
+    QCOMPARE(stats.reservedSize, qint64(0));
+}
+
+void KisTileDataArenaAllocatorTest::testReuseFreedChunks()
+{
+    const int pixelSize = 4;
+    KisTileDataArenaAllocator allocator(KisTileDataArenaAllocator::NoHugePages, PIXELS_PER_TILE);
+
+    quint8 *ptr1 = allocator.allocate(pixelSize);
+    quint8 *ptr2 = allocator.allocate(pixelSize);
+    QVERIFY(ptr1 != ptr2);
+
+    allocator.free(ptr1, pixelSize);
+
+    quint8 *ptr3 = allocator.allocate(pixelSize);
+    QCOMPARE(ptr3, ptr1);
+    QCOMPARE(allocator.statistics().numArenas, qint64(1));
+
+    allocator.free(ptr2, pixelSize);
+    allocator.free(ptr3, pixelSize);
+}
+
+namespace {
+
+class AllocateFreeJob : public QRunnable
+{
+public:
+    AllocateFreeJob(KisTileDataArenaAllocator &allocator, qint32 pixelSize)
+        : m_allocator(allocator),
+          m_pixelSize(pixelSize)
+    {
+    }
+
+    void run() override {
+        // every cycle allocates and frees a few tiles, like a stroke does
+        const int numCycles = 5000;
+        const int tilesPerCycle = 16;
+        quint8 *chunks[tilesPerCycle];
+
+        for (int i = 0; i < numCycles; i++) {
+            for (int j = 0; j < tilesPerCycle; j++) {
+                chunks[j] = m_allocator.allocate(m_pixelSize);
+                *chunks[j] = quint8(j);
+            }
+
+            for (int j = 0; j < tilesPerCycle; j++) {
+                m_allocator.free(chunks[j], m_pixelSize);
+            }
+        }
+    }
+
+private:
+    KisTileDataArenaAllocator &m_allocator;
+    qint32 m_pixelSize;
+};
+
+}
+
+void KisTileDataArenaAllocatorTest::benchmarkConcurrentAllocateFree_data()
+{
+    QTest::addColumn<int>("numThreads");
+
+    QTest::addRow("1 thread") << 1;
+    QTest::addRow("%d threads", QThread::idealThreadCount()) << QThread::idealThreadCount();
+}
+
+void KisTileDataArenaAllocatorTest::benchmarkConcurrentAllocateFree()
+{
+    QFETCH(int, numThreads);
+
+    const int pixelSize = 4;
+    KisTileDataArenaAllocator allocator(KisTileDataArenaAllocator::NoHugePages, PIXELS_PER_TILE);
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(numThreads);
+
+    QBENCHMARK {
+        for (int i = 0; i < numThreads; i++) {
+            pool.start(new AllocateFreeJob(allocator, pixelSize));
+        }
+
+        pool.waitForDone();
+    }
+
+    QCOMPARE(allocator.statistics().usedSize, qint64(0));
+}
+
+SIMPLE_TEST_MAIN(KisTileDataArenaAllocatorTest)
@@ -0,0 +1,24 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#ifndef KISTILEDATAARENAALLOCATORTEST_H
+#define KISTILEDATAARENAALLOCATORTEST_H
+
+#include <simpletest.h>
+
+class KisTileDataArenaAllocatorTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testAllocateFree_data();
+    void testAllocateFree();
+    void testReuseFreedChunks();
+
+    void benchmarkConcurrentAllocateFree_data();
+    void benchmarkConcurrentAllocateFree();
+};
+
+#endif /* KISTILEDATAARENAALLOCATORTEST_H */
@@ -11,6 +11,8 @@
 
 #include "../../../sdk/tests/testutil.h"
 #include "tiles3/swap/kis_lzf_compression.h"
+#include "tiles3/swap/kis_lz4_compression.h"
+#include "tiles3/swap/kis_zlib_compression.h"
 #include <kis_debug.h>
 
 #define TEST_FILE "tile.png"
@@ -209,6 +211,40 @@ void KisCompressionTests::testLzfOverflow()
     delete compression;
 }
 
+void KisCompressionTests::testLz4RoundTrip()
+{
+    KisAbstractCompression *compression = new KisLz4Compression();
+
+    roundTrip(compression);
+    roundTripTwoPass(compression);
+
+    delete compression;
+}
+
+void KisCompressionTests::testLz4Overflow()
+{
+    KisAbstractCompression *compression = new KisLz4Compression();
+    testOverflow(compression);
+    delete compression;
+}
+
+void KisCompressionTests::testZlibRoundTrip()
+{
+    KisAbstractCompression *compression = new KisZlibCompression();
+
+    roundTrip(compression);
+    roundTripTwoPass(compression);
+
+    delete compression;
+}
+
+void KisCompressionTests::testZlibOverflow()
+{
+    KisAbstractCompression *compression = new KisZlibCompression();
+    testOverflow(compression);
+    delete compression;
+}
+
 void KisCompressionTests::benchmarkMemCpy()
 {
     QImage image(QString(FILES_DATA_DIR) + QDir::separator() + TEST_FILE);
@@ -249,6 +285,33 @@ void KisCompressionTests::benchmarkDecompressionLzfTwoPass()
     benchmarkDecompressionTwoPass(compression);
     delete compression;
 }
+void KisCompressionTests::benchmarkCompressionLz4TwoPass()
+{
+    KisAbstractCompression *compression = new KisLz4Compression();
+    benchmarkCompressionTwoPass(compression);
+    delete compression;
+}
+
+void KisCompressionTests::benchmarkDecompressionLz4TwoPass()
+{
+    KisAbstractCompression *compression = new KisLz4Compression();
+    benchmarkDecompressionTwoPass(compression);
+    delete compression;
+}
+
+void KisCompressionTests::benchmarkCompressionZlibTwoPass()
+{
+    KisAbstractCompression *compression = new KisZlibCompression();
+    benchmarkCompressionTwoPass(compression);
+    delete compression;
+}
+
+void KisCompressionTests::benchmarkDecompressionZlibTwoPass()
+{
+    KisAbstractCompression *compression = new KisZlibCompression();
+    benchmarkDecompressionTwoPass(compression);
+    delete compression;
+}
 
 SIMPLE_TEST_MAIN(KisCompressionTests)
 
@@ -29,6 +29,10 @@ private:
 private Q_SLOTS:
     void testLzfRoundTrip();
     void testLzfOverflow();
+    void testLz4RoundTrip();
+    void testLz4Overflow();
+    void testZlibRoundTrip();
+    void testZlibOverflow();
 
     void benchmarkMemCpy();
 
@@ -36,6 +40,11 @@ private Q_SLOTS:
     void benchmarkCompressionLzfTwoPass();
     void benchmarkDecompressionLzf();
     void benchmarkDecompressionLzfTwoPass();
+
+    void benchmarkCompressionLz4TwoPass();
+    void benchmarkDecompressionLz4TwoPass();
+    void benchmarkCompressionZlibTwoPass();
+    void benchmarkDecompressionZlibTwoPass();
 };
 
 #endif /* KIS_COMPRESSION_TESTS_H */
@@ -9,6 +9,10 @@
 
 #include <QRandomGenerator>
 
+#include <atomic>
+#include <thread>
+#include <vector>
+
 #include "kis_debug.h"
 
 #include "kis_image_config.h"
@@ -121,5 +125,63 @@ void KisSwappedDataStoreTest::testRandomAccess()
         delete tileDataList[i];
 }
 
+void KisSwappedDataStoreTest::testConcurrentSwapIn()
+{
+    const qint32 pixelSize = 1;
+    const quint8 defaultPixel = 128;
+    const qint32 NUM_TILES = 8000;
+    const int NUM_THREADS = 4;
+
+    KisImageConfig config(false);
+    config.setMaxSwapSize(40);
+    config.setSwapSlabSize(1);
+    config.setSwapWindowSize(1);
+    config.setSwapStripesCount(NUM_THREADS);
+
+    KisSwappedDataStore store;
+    QCOMPARE(store.numStripes(), NUM_THREADS);
+
+    QList<KisTileData*> tileDataList;
+    for(qint32 i = 0; i < NUM_TILES; i++)
+        tileDataList.append(new KisTileData(pixelSize, &defaultPixel, KisTileDataStore::instance()));
+
+    for(qint32 i = 0; i < NUM_TILES; i++) {
+        KisTileData *td = tileDataList[i];
+        memset(td->data(), COLUMN2COLOR(i), TILESIZE);
+        QVERIFY(store.trySwapOutTileData(td));
+    }
+
+    QCOMPARE(store.numTiles(), quint64(NUM_TILES));
+
+    std::atomic<int> numFailures(0);
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < NUM_THREADS; t++) {
+        threads.emplace_back([&, t] () {
+            for(qint32 i = t; i < NUM_TILES; i += NUM_THREADS) {
+                KisTileData *td = tileDataList[i];
+                store.swapInTileData(td);
+
+                if (!memoryIsFilled(COLUMN2COLOR(i), td->data(), TILESIZE)) {
+                    numFailures++;
+                }
+            }
+        });
+    }
+
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+    QCOMPARE(numFailures.load(), 0);
+    QCOMPARE(store.numTiles(), quint64(0));
+    QCOMPARE(store.totalSwapMemoryUsed(), qint64(0));
+
+    config.setSwapStripesCount(config.swapStripesCount(true));
+
+    for(qint32 i = 0; i < NUM_TILES; i++)
+        delete tileDataList[i];
+}
+
 SIMPLE_TEST_MAIN(KisSwappedDataStoreTest)
 
@@ -167,6 +167,103 @@ void KisTileCompressorsTest::testLowLevelRoundTripIncompressible2()
     delete compressor;
 }
 
+void KisTileCompressorsTest::testRoundTrip2Algorithms_data()
+{
+    QTest::addColumn<int>("algorithm");
+
+    QTest::newRow("lzf") << int(KisCompressionFactory::LZF);
+    QTest::newRow("lz4") << int(KisCompressionFactory::LZ4);
+    QTest::newRow("zlib") << int(KisCompressionFactory::ZLIB);
+}
+
+void KisTileCompressorsTest::testRoundTrip2Algorithms()
+{
+    QFETCH(int, algorithm);
+
+    KisAbstractTileCompressor *compressor =
+        new KisTileCompressor2(KisCompressionFactory::Algorithm(algorithm));
+
+    doRoundTrip(compressor);
+    doLowLevelRoundTrip(compressor);
+    doLowLevelRoundTripIncompressible(compressor);
+
+    delete compressor;
+}
+
+void KisTileCompressorsTest::testCrossAlgorithmDecompression()
+{
+    const qint32 pixelSize = 1;
+    quint8 oddPixel1 = 128;
+    quint8 oddPixel2 = 129;
+
+    KisTiledDataManager dm(pixelSize, &oddPixel1);
+    KisTileSP tile = dm.getTile(0, 0, true);
+    tile->lockForWrite();
+
+    KisTileData *td = tile->tileData();
+
+    // the tile is written with LZ4...
+    KisTileCompressor2 writer(KisCompressionFactory::LZ4);
+
+    qint32 bufferSize = writer.tileDataBufferSize(td);
+    quint8 *buffer = new quint8[bufferSize];
+    qint32 bytesWritten;
+    writer.compressTileData(td, buffer, bufferSize, bytesWritten);
+
+    QCOMPARE(buffer[0], quint8(KisCompressionFactory::LZ4));
+
+    memset(td->data(), oddPixel2, TILESIZE);
+
+    // ... and read by a compressor configured for LZF
+    KisTileCompressor2 reader(KisCompressionFactory::LZF);
+    QVERIFY(reader.decompressTileData(buffer, bytesWritten, td));
+    QVERIFY(memoryIsFilled(oddPixel1, td->data(), TILESIZE));
+
+    // unknown algorithms are rejected
+    buffer[0] = 0x7f;
+    QVERIFY(!reader.decompressTileData(buffer, bytesWritten, td));
+
+    delete[] buffer;
+    tile->unlock();
+}
+
+void KisTileCompressorsTest::testLazyDecompression()
+{
+    quint8 defaultPixel = 0;
+    quint8 oddPixel1 = 128;
+
+    KisTiledDataManager dm(1, &defaultPixel);
+    dm.clear(64, 64, 64, 64, &oddPixel1);
+
+    KisTileCompressor2 writer(KisCompressionFactory::LZF);
+
+    KoStoreFake fakeStore;
+    KisFakePaintDeviceWriter storeWriter(&fakeStore);
+
+    KisTileSP tile11 = dm.getTile(1, 1, false);
+    QVERIFY(writer.writeTile(tile11, storeWriter));
+    tile11 = 0;
+
+    fakeStore.startReading();
+    dm.clear();
+
+    KisTileCompressor2 reader(KisCompressionFactory::LZF, true);
+    QVERIFY(reader.readTile(fakeStore.device(), &dm));
+
+    tile11 = dm.getTile(1, 1, false);
+
+    // the data is not decompressed until the first access...
+    QVERIFY(!tile11->tileData()->data());
+
+    // ... and is decompressed on it
+    tile11->lockForRead();
+    QVERIFY(tile11->tileData()->data());
+    QVERIFY(memoryIsFilled(oddPixel1, tile11->data(), TILESIZE));
+    tile11->unlockForRead();
+
+    tile11 = 0;
+}
+
 
 SIMPLE_TEST_MAIN(KisTileCompressorsTest)
 
@@ -26,6 +26,11 @@ private Q_SLOTS:
     void testRoundTrip2();
     void testLowLevelRoundTrip2();
     void testLowLevelRoundTripIncompressible2();
+
+    void testRoundTrip2Algorithms_data();
+    void testRoundTrip2Algorithms();
+    void testCrossAlgorithmDecompression();
+    void testLazyDecompression();
 };
 
 #endif /* KIS_TILE_COMPRESSORS_TEST_H */
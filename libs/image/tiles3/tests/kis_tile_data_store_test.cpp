@@ -7,6 +7,8 @@
 #include "kis_tile_data_store_test.h"
 #include <simpletest.h>
 
+#include <QElapsedTimer>
+
 #include "kis_debug.h"
 
 #include "kis_image_config.h"
@@ -176,5 +178,111 @@ void KisTileDataStoreTest::testSwapping()
     }
 }
 
+void KisTileDataStoreTest::testPrefetch()
+{
+    KisTileDataStore *store = KisTileDataStore::instance();
+    store->debugClear();
+
+    const qint32 pixelSize = 1;
+    quint8 defaultPixel = 128;
+    KisTiledDataManager dm(pixelSize, &defaultPixel);
+
+    const qint32 numColumns = 8;
+    const qint32 numRows = 8;
+
+    for(qint32 row = 0; row < numRows; row++) {
+        for(qint32 col = 0; col < numColumns; col++) {
+            KisTileSP tile = dm.getTile(col, row, true);
+            tile->lockForWrite();
+            memset(tile->data(), COLUMN2COLOR(col + row * numColumns), TILESIZE);
+            tile->unlockForWrite();
+        }
+    }
+
+    store->debugSwapAll();
+    QVERIFY(store->hasSwappedTiles());
+
+    const qint64 initialHits = store->memoryStatistics().swapPrefetchHits;
+    const qint64 initialMisses = store->memoryStatistics().swapPrefetchMisses;
+
+    dm.prefetchTiles(0, 0, numColumns - 1, numRows - 1);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    while (store->memoryStatistics().swapPrefetchHits - initialHits < numColumns * numRows &&
+           timer.elapsed() < 5000) {
+
+        QTest::qWait(10);
+    }
+
+    QCOMPARE(store->memoryStatistics().swapPrefetchHits - initialHits, qint64(numColumns * numRows));
+
+    for(qint32 row = 0; row < numRows; row++) {
+        for(qint32 col = 0; col < numColumns; col++) {
+            KisTileSP tile = dm.getTile(col, row, false);
+            QVERIFY(tile->tileData()->data());
+
+            tile->lockForRead();
+            QVERIFY(memoryIsFilled(COLUMN2COLOR(col + row * numColumns), tile->data(), TILESIZE));
+            tile->unlockForRead();
+        }
+    }
+
+    QCOMPARE(store->memoryStatistics().swapPrefetchMisses, initialMisses);
+}
+
+void KisTileDataStoreTest::testUniformTileCompaction()
+{
+    KisTileDataStore *store = KisTileDataStore::instance();
+    store->debugClear();
+
+    const qint32 pixelSize = 1;
+    quint8 defaultPixel = 128;
+    KisTiledDataManager dm(pixelSize, &defaultPixel);
+
+    const qint32 numColumns = 8;
+
+    // odd columns are not uniform
+    for(qint32 col = 0; col < numColumns; col++) {
+        KisTileSP tile = dm.getTile(col, 0, true);
+        tile->lockForWrite();
+        memset(tile->data(), COLUMN2COLOR(col), TILESIZE);
+        if (col & 1) {
+            tile->data()[TILESIZE - 1] = 255;
+        }
+        tile->unlockForWrite();
+    }
+
+    const qint32 numTilesBefore = store->numTiles();
+
+    KisTileDataStoreIterator *iter = store->beginIteration();
+    while(iter->hasNext()) {
+        store->tryCompactUniformTileData(iter->next());
+    }
+    store->endIteration(iter);
+
+    QCOMPARE(store->numTiles(), numTilesBefore);
+    QVERIFY(store->memoryStatistics().compactedSize >= numColumns / 2 * TILESIZE);
+
+    for(qint32 col = 0; col < numColumns; col++) {
+        KisTileSP tile = dm.getTile(col, 0, false);
+        QCOMPARE(tile->tileData()->isCompacted(), !(col & 1));
+
+        tile->lockForRead();
+        QVERIFY(!tile->tileData()->isCompacted());
+        QCOMPARE(tile->data()[0], quint8(COLUMN2COLOR(col)));
+        QCOMPARE(tile->data()[TILESIZE - 1], quint8((col & 1) ? 255 : COLUMN2COLOR(col)));
+        tile->unlockForRead();
+    }
+
+    QCOMPARE(store->numTiles(), numTilesBefore);
+
+    // the default tile data is always uniform, the pooler should skip it
+    KisTileSP defaultTile = dm.getTile(numColumns, 1, false);
+    QVERIFY(defaultTile->tileData()->m_isDefaultTileData);
+    QVERIFY(!dm.getTile(0, 0, false)->tileData()->m_isDefaultTileData);
+}
+
 SIMPLE_TEST_MAIN(KisTileDataStoreTest)
 
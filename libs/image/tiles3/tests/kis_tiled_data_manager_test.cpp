@@ -10,6 +10,7 @@
 #include <QRandomGenerator>
 
 #include "tiles3/kis_tiled_data_manager.h"
+#include "kis_datamanager.h"
 
 #include "tiles_test_utils.h"
 #include "config-limit-long-tests.h"
@@ -339,6 +340,68 @@ void KisTiledDataManagerTest::testBitBltRough()
     delete[] buffer;
 }
 
+void KisTiledDataManagerTest::testWriteReadDelta()
+{
+    typedef KisSharedPtr<KisDataManager> KisDataManagerSP;
+
+    quint8 defaultPixel = 0;
+    KisDataManagerSP baseDM = new KisDataManager(1, &defaultPixel);
+    KisDataManagerSP frameDM = new KisDataManager(1, &defaultPixel);
+
+    quint8 oddPixel1 = 128;
+    quint8 oddPixel2 = 129;
+
+    QRect rect(0,0,512,512);
+    QRect checkRect(0,0,576,512);
+
+    baseDM->clear(rect, &oddPixel1);
+    frameDM->bitBltRough(baseDM, rect);
+
+    // one changed, one removed and one added tile
+    frameDM->clear(QRect(64,64,64,64), &oddPixel2);
+    frameDM->clear(QRect(448,448,64,64), &defaultPixel);
+    frameDM->clear(QRect(512,0,64,64), &oddPixel2);
+
+    const KisTiledDataManagerDelta delta = frameDM->collectDifferentTiles(baseDM.data());
+    QCOMPARE(delta.changedTiles.size(), 2);
+    QCOMPARE(delta.removedTiles, QVector<QPoint>({QPoint(7, 7)}));
+
+    KoStoreFake fakeStore;
+    KisFakePaintDeviceWriter writer(&fakeStore);
+    QVERIFY(frameDM->writeDelta(writer, delta));
+
+    KisDataManagerSP loadedDM = new KisDataManager(1, &defaultPixel);
+    loadedDM->bitBltRough(baseDM, baseDM->extent());
+
+    fakeStore.startReading();
+    QVERIFY(loadedDM->readDelta(fakeStore.device()));
+
+    QCOMPARE(loadedDM->extent(), frameDM->extent());
+    QCOMPARE(loadedDM->collectDifferentTiles(frameDM.data()).numTiles(), 0);
+
+    quint8 *frameBuffer = new quint8[checkRect.width()*checkRect.height()];
+    quint8 *loadedBuffer = new quint8[checkRect.width()*checkRect.height()];
+
+    frameDM->readBytes(frameBuffer, checkRect.x(), checkRect.y(), checkRect.width(), checkRect.height());
+    loadedDM->readBytes(loadedBuffer, checkRect.x(), checkRect.y(), checkRect.width(), checkRect.height());
+
+    QVERIFY(!memcmp(frameBuffer, loadedBuffer, checkRect.width()*checkRect.height()));
+
+    // the unchanged tiles are still shared with the base
+    QVERIFY(checkTilesShared(baseDM.data(), loadedDM.data(), false, false, QRect(2,2,4,4)));
+
+    // a full stream cannot be read as a delta
+    KoStoreFake fullStore;
+    KisFakePaintDeviceWriter fullWriter(&fullStore);
+    QVERIFY(frameDM->write(fullWriter));
+
+    fullStore.startReading();
+    QVERIFY(!loadedDM->readDelta(fullStore.device()));
+
+    delete[] frameBuffer;
+    delete[] loadedBuffer;
+}
+
 void KisTiledDataManagerTest::testTransactions()
 {
     quint8 defaultPixel = 0;
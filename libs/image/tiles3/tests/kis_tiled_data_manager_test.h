@@ -37,6 +37,7 @@ private Q_SLOTS:
     void testVersionedBitBlt();
     void testBitBltOldData();
     void testBitBltRough();
+    void testWriteReadDelta();
     void testTransactions();
     void testPurgeHistory();
     void testUndoSetDefaultPixel();
@@ -141,6 +141,24 @@ ALWAYS_INLINE float removeSMPTE_ST_428Curve(float x) noexcept
     return (52.37f / 48.0f) * powf(x, 2.6f);
 }
 
+ALWAYS_INLINE float applySrgbCurve(float x) noexcept
+{
+    if (x <= 0.0031308f) {
+        return 12.92f * x;
+    } else {
+        return 1.055f * powf(x, 1.0f / 2.4f) - 0.055f;
+    }
+}
+
+ALWAYS_INLINE float removeSrgbCurve(float x) noexcept
+{
+    if (x <= 0.04045f) {
+        return x * (1.0f / 12.92f);
+    } else {
+        return powf((x + 0.055f) * (1.0f / 1.055f), 2.4f);
+    }
+}
+
 #include <KoMultiArchBuildSupport.h>
 
 #if defined(HAVE_XSIMD) && !defined(XSIMD_NO_SUPPORTED_ARCHITECTURE)
@@ -182,6 +200,20 @@ struct KoColorTransferFunctions {
     {
         x = (52.37f / 48.0f) * xsimd::pow(x, float_v(2.6f));
     }
+
+    static ALWAYS_INLINE void applySrgbCurve(float_v &x) noexcept
+    {
+        const float_v x1 = x * 12.92f;
+        const float_v x2 = 1.055f * xsimd::pow(x, float_v(1.0f / 2.4f)) - 0.055f;
+        x = xsimd::select(x <= float_v(0.0031308f), x1, x2);
+    }
+
+    static ALWAYS_INLINE void removeSrgbCurve(float_v &x) noexcept
+    {
+        const float_v x1 = x * (1.0f / 12.92f);
+        const float_v x2 = xsimd::pow((x + 0.055f) * (1.0f / 1.055f), float_v(2.4f));
+        x = xsimd::select(x <= float_v(0.04045f), x1, x2);
+    }
 };
 
 #endif // HAVE_XSIMD
@@ -0,0 +1,271 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KoOptimizedRgbPixelDataConverter_H
+#define KoOptimizedRgbPixelDataConverter_H
+
+#include "KoOptimizedRgbPixelDataConverterBase.h"
+
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+#include "KoColorTransferFunctions.h"
+#include "KoMultiArchBuildSupport.h"
+
+/**
+ * Positions of the channels in the pixel and the unit value of the
+ * channel for every supported bit depth. Integer formats are stored as
+ * BGRA, the floating point one as RGBA. Alpha is always the last channel.
+ */
+template<typename channels_type>
+struct KoRgbPixelDataLayout;
+
+template<>
+struct KoRgbPixelDataLayout<quint8> {
+    static constexpr int red = 2;
+    static constexpr int blue = 0;
+    static constexpr float unitValue = 255.0f;
+
+    // PixelWrapper<quint8> returns the channels in R, G, B order
+    static constexpr bool wrapperSwapsRedAndBlue = false;
+
+    static constexpr KoOptimizedRgbPixelDataConverterBase::ChannelType channelType =
+        KoOptimizedRgbPixelDataConverterBase::UInt8Channels;
+};
+
+template<>
+struct KoRgbPixelDataLayout<quint16> {
+    static constexpr int red = 2;
+    static constexpr int blue = 0;
+    static constexpr float unitValue = 65535.0f;
+
+    // PixelWrapper<quint16> returns the channels in memory, i.e. B, G, R, order
+    static constexpr bool wrapperSwapsRedAndBlue = true;
+
+    static constexpr KoOptimizedRgbPixelDataConverterBase::ChannelType channelType =
+        KoOptimizedRgbPixelDataConverterBase::UInt16Channels;
+};
+
+template<>
+struct KoRgbPixelDataLayout<float> {
+    static constexpr int red = 0;
+    static constexpr int blue = 2;
+    static constexpr float unitValue = 1.0f;
+
+    static constexpr bool wrapperSwapsRedAndBlue = false;
+
+    static constexpr KoOptimizedRgbPixelDataConverterBase::ChannelType channelType =
+        KoOptimizedRgbPixelDataConverterBase::Float32Channels;
+};
+
+namespace KoOptimizedRgbPixelDataConverterScalar
+{
+
+template<KoOptimizedRgbPixelDataConverterBase::TransferCurve curve, typename _impl>
+ALWAYS_INLINE float applyCurve(float value)
+{
+    if constexpr (curve == KoOptimizedRgbPixelDataConverterBase::ApplySrgbCurve) {
+        return applySrgbCurve(value);
+    } else if constexpr (curve == KoOptimizedRgbPixelDataConverterBase::RemoveSrgbCurve) {
+        return removeSrgbCurve(value);
+    } else {
+        return value;
+    }
+}
+
+template<typename dst_channel_type, typename _impl>
+ALWAYS_INLINE dst_channel_type fromScaledFloat(float value)
+{
+    using DstLayout = KoRgbPixelDataLayout<dst_channel_type>;
+
+    if constexpr (std::numeric_limits<dst_channel_type>::is_integer) {
+        return static_cast<dst_channel_type>(std::lrintf(qBound(0.0f, value, DstLayout::unitValue)));
+    } else {
+        return value;
+    }
+}
+
+/**
+ * Reference implementation of the conversion. It is used on the
+ * architectures without vector instructions and for the pixels
+ * that don't fit into a full vector.
+ *
+ * NOTE: the function depends on \p _impl to make sure that the copies
+ *       compiled for different architectures are not merged by the linker
+ */
+template<typename src_channel_type,
+         typename dst_channel_type,
+         KoOptimizedRgbPixelDataConverterBase::TransferCurve curve,
+         typename _impl>
+void convertPixels(const quint8 *src, quint8 *dst, int numPixels)
+{
+    using SrcLayout = KoRgbPixelDataLayout<src_channel_type>;
+    using DstLayout = KoRgbPixelDataLayout<dst_channel_type>;
+
+    const src_channel_type *srcPtr = reinterpret_cast<const src_channel_type*>(src);
+    dst_channel_type *dstPtr = reinterpret_cast<dst_channel_type*>(dst);
+
+    const float srcUnitRec = 1.0f / SrcLayout::unitValue;
+    const float dstUnit = DstLayout::unitValue;
+
+    for (int i = 0; i < numPixels; i++) {
+        float r = static_cast<float>(srcPtr[SrcLayout::red]);
+        float g = static_cast<float>(srcPtr[1]);
+        float b = static_cast<float>(srcPtr[SrcLayout::blue]);
+        const float a = static_cast<float>(srcPtr[3]) * srcUnitRec;
+
+        if constexpr (curve == KoOptimizedRgbPixelDataConverterBase::KeepTransferCurve) {
+            const float scale = DstLayout::unitValue / SrcLayout::unitValue;
+            r *= scale;
+            g *= scale;
+            b *= scale;
+        } else {
+            r = applyCurve<curve, _impl>(r * srcUnitRec) * dstUnit;
+            g = applyCurve<curve, _impl>(g * srcUnitRec) * dstUnit;
+            b = applyCurve<curve, _impl>(b * srcUnitRec) * dstUnit;
+        }
+
+        dstPtr[DstLayout::red] = fromScaledFloat<dst_channel_type, _impl>(r);
+        dstPtr[1] = fromScaledFloat<dst_channel_type, _impl>(g);
+        dstPtr[DstLayout::blue] = fromScaledFloat<dst_channel_type, _impl>(b);
+        dstPtr[3] = fromScaledFloat<dst_channel_type, _impl>(a * dstUnit);
+
+        srcPtr += 4;
+        dstPtr += 4;
+    }
+}
+
+} // namespace KoOptimizedRgbPixelDataConverterScalar
+
+template<typename src_channel_type,
+         typename dst_channel_type,
+         KoOptimizedRgbPixelDataConverterBase::TransferCurve curve,
+         typename _impl,
+         typename EnableDummyType = void>
+class KoOptimizedRgbPixelDataConverter : public KoOptimizedRgbPixelDataConverterBase
+{
+public:
+    KoOptimizedRgbPixelDataConverter()
+        : KoOptimizedRgbPixelDataConverterBase(KoRgbPixelDataLayout<src_channel_type>::channelType,
+                                               KoRgbPixelDataLayout<dst_channel_type>::channelType,
+                                               curve)
+    {
+    }
+
+    void convertPixels(const quint8 *src, quint8 *dst, int numPixels) const override
+    {
+        KoOptimizedRgbPixelDataConverterScalar::convertPixels<src_channel_type, dst_channel_type, curve, _impl>(src, dst, numPixels);
+    }
+};
+
+#if defined(HAVE_XSIMD) && !defined(XSIMD_NO_SUPPORTED_ARCHITECTURE)
+
+#include "KoStreamedMath.h"
+
+template<typename src_channel_type,
+         typename dst_channel_type,
+         KoOptimizedRgbPixelDataConverterBase::TransferCurve curve,
+         typename _impl>
+class KoOptimizedRgbPixelDataConverter<
+        src_channel_type, dst_channel_type, curve, _impl,
+        typename std::enable_if<!std::is_same<_impl, xsimd::generic>::value>::type>
+    : public KoOptimizedRgbPixelDataConverterBase
+{
+    using float_v = typename KoStreamedMath<_impl>::float_v;
+    using SrcLayout = KoRgbPixelDataLayout<src_channel_type>;
+    using DstLayout = KoRgbPixelDataLayout<dst_channel_type>;
+
+public:
+    KoOptimizedRgbPixelDataConverter()
+        : KoOptimizedRgbPixelDataConverterBase(SrcLayout::channelType,
+                                               DstLayout::channelType,
+                                               curve)
+    {
+    }
+
+    void convertPixels(const quint8 *src, quint8 *dst, int numPixels) const override
+    {
+        const int vectorSize = static_cast<int>(float_v::size);
+        const int numBlocks = numPixels / vectorSize;
+        const int numRestPixels = numPixels % vectorSize;
+
+        const int srcVectorStride = vectorSize * 4 * static_cast<int>(sizeof(src_channel_type));
+        const int dstVectorStride = vectorSize * 4 * static_cast<int>(sizeof(dst_channel_type));
+
+        PixelWrapper<src_channel_type, _impl> srcWrapper;
+        PixelWrapper<dst_channel_type, _impl> dstWrapper;
+
+        const float_v srcUnitRec(1.0f / SrcLayout::unitValue);
+        const float_v dstUnit(DstLayout::unitValue);
+        const float_v scale(DstLayout::unitValue / SrcLayout::unitValue);
+        const float_v zeroValue(0.0f);
+        const float_v oneValue(1.0f);
+
+        for (int i = 0; i < numBlocks; i++) {
+            float_v r, g, b, a;
+
+            // NOTE: the wrappers return the alpha channel normalized
+            if (SrcLayout::wrapperSwapsRedAndBlue) {
+                srcWrapper.read(src, b, g, r, a);
+            } else {
+                srcWrapper.read(src, r, g, b, a);
+            }
+
+            if constexpr (curve == KoOptimizedRgbPixelDataConverterBase::KeepTransferCurve) {
+                if (SrcLayout::unitValue != DstLayout::unitValue) {
+                    r *= scale;
+                    g *= scale;
+                    b *= scale;
+                }
+            } else {
+                r *= srcUnitRec;
+                g *= srcUnitRec;
+                b *= srcUnitRec;
+
+                applyCurve(r);
+                applyCurve(g);
+                applyCurve(b);
+
+                r *= dstUnit;
+                g *= dstUnit;
+                b *= dstUnit;
+            }
+
+            if constexpr (std::numeric_limits<dst_channel_type>::is_integer) {
+                r = xsimd::max(zeroValue, xsimd::min(r, dstUnit));
+                g = xsimd::max(zeroValue, xsimd::min(g, dstUnit));
+                b = xsimd::max(zeroValue, xsimd::min(b, dstUnit));
+                a = xsimd::max(zeroValue, xsimd::min(a, oneValue));
+            }
+
+            if (DstLayout::wrapperSwapsRedAndBlue) {
+                dstWrapper.write(dst, b, g, r, a);
+            } else {
+                dstWrapper.write(dst, r, g, b, a);
+            }
+
+            src += srcVectorStride;
+            dst += dstVectorStride;
+        }
+
+        KoOptimizedRgbPixelDataConverterScalar::convertPixels<src_channel_type, dst_channel_type, curve, _impl>(src, dst, numRestPixels);
+    }
+
+private:
+    static ALWAYS_INLINE void applyCurve(float_v &value)
+    {
+        if constexpr (curve == KoOptimizedRgbPixelDataConverterBase::ApplySrgbCurve) {
+            KoColorTransferFunctions<_impl>::applySrgbCurve(value);
+        } else if constexpr (curve == KoOptimizedRgbPixelDataConverterBase::RemoveSrgbCurve) {
+            KoColorTransferFunctions<_impl>::removeSrgbCurve(value);
+        }
+    }
+};
+
+#endif /* HAVE_XSIMD */
+
+#endif // KoOptimizedRgbPixelDataConverter_H
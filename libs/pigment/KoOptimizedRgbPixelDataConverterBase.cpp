@@ -0,0 +1,35 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KoOptimizedRgbPixelDataConverterBase.h"
+
+KoOptimizedRgbPixelDataConverterBase::KoOptimizedRgbPixelDataConverterBase(ChannelType srcChannelType,
+                                                                           ChannelType dstChannelType,
+                                                                           TransferCurve transferCurve)
+    : m_srcChannelType(srcChannelType)
+    , m_dstChannelType(dstChannelType)
+    , m_transferCurve(transferCurve)
+{
+}
+
+KoOptimizedRgbPixelDataConverterBase::~KoOptimizedRgbPixelDataConverterBase()
+{
+}
+
+KoOptimizedRgbPixelDataConverterBase::ChannelType KoOptimizedRgbPixelDataConverterBase::srcChannelType() const
+{
+    return m_srcChannelType;
+}
+
+KoOptimizedRgbPixelDataConverterBase::ChannelType KoOptimizedRgbPixelDataConverterBase::dstChannelType() const
+{
+    return m_dstChannelType;
+}
+
+KoOptimizedRgbPixelDataConverterBase::TransferCurve KoOptimizedRgbPixelDataConverterBase::transferCurve() const
+{
+    return m_transferCurve;
+}
@@ -0,0 +1,78 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KoOptimizedRgbPixelDataConverterBase_H
+#define KoOptimizedRgbPixelDataConverterBase_H
+
+#include <QtGlobal>
+#include "kritapigment_export.h"
+
+/**
+ * @brief Converts RGBA pixels between U8, U16 and F32 formats
+ *
+ * The converter handles the conversions that do not change the primaries
+ * of the color space, that is, pure bit depth changes of the same profile
+ * and conversions between a linear profile and its sRGB-TRC counterpart.
+ * Such conversions are used very often (e.g. when converting the image to
+ * another bit depth or when converting a linear projection to the display
+ * color space) and are much cheaper than a generic LCMS transformation.
+ *
+ * The source and destination pixels are expected to be in the native Krita
+ * layout for the corresponding bit depth, i.e. BGRA for the integer formats
+ * and RGBA for the floating point one. When the destination is an integer
+ * format, the values are clamped to the valid range.
+ *
+ * The actual implementation is placed in class
+ * `KoOptimizedRgbPixelDataConverter`.
+ *
+ * To create a converter, just call a factory. It will create a version
+ * of the converter optimized for your CPU architecture.
+ *
+ * \code{.cpp}
+ * QScopedPointer<KoOptimizedRgbPixelDataConverterBase> converter(
+ *     KoOptimizedRgbPixelDataConverterFactory::createConverter(
+ *         KoOptimizedRgbPixelDataConverterBase::UInt8Channels,
+ *         KoOptimizedRgbPixelDataConverterBase::Float32Channels,
+ *         KoOptimizedRgbPixelDataConverterBase::RemoveSrgbCurve));
+ *
+ * converter->convertPixels(src, dst, numPixels);
+ * \endcode
+ */
+class KRITAPIGMENT_EXPORT KoOptimizedRgbPixelDataConverterBase
+{
+public:
+    enum ChannelType {
+        UInt8Channels = 0,
+        UInt16Channels,
+        Float32Channels
+    };
+
+    enum TransferCurve {
+        KeepTransferCurve = 0,
+        ApplySrgbCurve, ///< the source is linear, the destination has sRGB TRC
+        RemoveSrgbCurve ///< the source has sRGB TRC, the destination is linear
+    };
+
+public:
+    KoOptimizedRgbPixelDataConverterBase(ChannelType srcChannelType,
+                                         ChannelType dstChannelType,
+                                         TransferCurve transferCurve);
+
+    virtual ~KoOptimizedRgbPixelDataConverterBase();
+
+    virtual void convertPixels(const quint8 *src, quint8 *dst, int numPixels) const = 0;
+
+    ChannelType srcChannelType() const;
+    ChannelType dstChannelType() const;
+    TransferCurve transferCurve() const;
+
+protected:
+    ChannelType m_srcChannelType;
+    ChannelType m_dstChannelType;
+    TransferCurve m_transferCurve;
+};
+
+#endif // KoOptimizedRgbPixelDataConverterBase_H
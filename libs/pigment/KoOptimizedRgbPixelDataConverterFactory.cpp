@@ -0,0 +1,18 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KoOptimizedRgbPixelDataConverterFactory.h"
+
+#include "KoOptimizedRgbPixelDataConverterFactoryImpl.h"
+
+
+KoOptimizedRgbPixelDataConverterBase *KoOptimizedRgbPixelDataConverterFactory::createConverter(KoOptimizedRgbPixelDataConverterBase::ChannelType srcChannelType,
+                                                                                             KoOptimizedRgbPixelDataConverterBase::ChannelType dstChannelType,
+                                                                                             KoOptimizedRgbPixelDataConverterBase::TransferCurve transferCurve)
+{
+    return createOptimizedClass<
+            KoOptimizedRgbPixelDataConverterFactoryImpl>(srcChannelType, dstChannelType, transferCurve);
+}
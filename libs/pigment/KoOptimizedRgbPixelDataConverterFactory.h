@@ -0,0 +1,24 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KoOptimizedRgbPixelDataConverterFACTORY_H
+#define KoOptimizedRgbPixelDataConverterFACTORY_H
+
+#include "KoOptimizedRgbPixelDataConverterBase.h"
+
+/**
+ * \see KoOptimizedRgbPixelDataConverterBase
+ */
+class KRITAPIGMENT_EXPORT KoOptimizedRgbPixelDataConverterFactory
+{
+public:
+    static KoOptimizedRgbPixelDataConverterBase* createConverter(KoOptimizedRgbPixelDataConverterBase::ChannelType srcChannelType,
+                                                                 KoOptimizedRgbPixelDataConverterBase::ChannelType dstChannelType,
+                                                                 KoOptimizedRgbPixelDataConverterBase::TransferCurve transferCurve);
+};
+
+
+#endif // KoOptimizedRgbPixelDataConverterFACTORY_H
@@ -0,0 +1,71 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KoOptimizedRgbPixelDataConverterFactoryImpl.h"
+
+#if XSIMD_UNIVERSAL_BUILD_PASS
+#include "KoOptimizedRgbPixelDataConverter.h"
+
+namespace {
+
+template<typename _impl, typename src_channel_type, typename dst_channel_type>
+KoOptimizedRgbPixelDataConverterBase *
+createConverterForCurve(KoOptimizedRgbPixelDataConverterBase::TransferCurve transferCurve)
+{
+    switch (transferCurve) {
+    case KoOptimizedRgbPixelDataConverterBase::KeepTransferCurve:
+        return new KoOptimizedRgbPixelDataConverter<src_channel_type, dst_channel_type,
+                KoOptimizedRgbPixelDataConverterBase::KeepTransferCurve, _impl>();
+    case KoOptimizedRgbPixelDataConverterBase::ApplySrgbCurve:
+        return new KoOptimizedRgbPixelDataConverter<src_channel_type, dst_channel_type,
+                KoOptimizedRgbPixelDataConverterBase::ApplySrgbCurve, _impl>();
+    case KoOptimizedRgbPixelDataConverterBase::RemoveSrgbCurve:
+        return new KoOptimizedRgbPixelDataConverter<src_channel_type, dst_channel_type,
+                KoOptimizedRgbPixelDataConverterBase::RemoveSrgbCurve, _impl>();
+    }
+
+    return nullptr;
+}
+
+template<typename _impl, typename src_channel_type>
+KoOptimizedRgbPixelDataConverterBase *
+createConverterForDst(KoOptimizedRgbPixelDataConverterBase::ChannelType dstChannelType,
+                      KoOptimizedRgbPixelDataConverterBase::TransferCurve transferCurve)
+{
+    switch (dstChannelType) {
+    case KoOptimizedRgbPixelDataConverterBase::UInt8Channels:
+        return createConverterForCurve<_impl, src_channel_type, quint8>(transferCurve);
+    case KoOptimizedRgbPixelDataConverterBase::UInt16Channels:
+        return createConverterForCurve<_impl, src_channel_type, quint16>(transferCurve);
+    case KoOptimizedRgbPixelDataConverterBase::Float32Channels:
+        return createConverterForCurve<_impl, src_channel_type, float>(transferCurve);
+    }
+
+    return nullptr;
+}
+
+} // namespace
+
+template<>
+KoOptimizedRgbPixelDataConverterBase *
+KoOptimizedRgbPixelDataConverterFactoryImpl::create<xsimd::current_arch>(
+    KoOptimizedRgbPixelDataConverterBase::ChannelType srcChannelType,
+    KoOptimizedRgbPixelDataConverterBase::ChannelType dstChannelType,
+    KoOptimizedRgbPixelDataConverterBase::TransferCurve transferCurve)
+{
+    switch (srcChannelType) {
+    case KoOptimizedRgbPixelDataConverterBase::UInt8Channels:
+        return createConverterForDst<xsimd::current_arch, quint8>(dstChannelType, transferCurve);
+    case KoOptimizedRgbPixelDataConverterBase::UInt16Channels:
+        return createConverterForDst<xsimd::current_arch, quint16>(dstChannelType, transferCurve);
+    case KoOptimizedRgbPixelDataConverterBase::Float32Channels:
+        return createConverterForDst<xsimd::current_arch, float>(dstChannelType, transferCurve);
+    }
+
+    return nullptr;
+}
+
+#endif // XSIMD_UNIVERSAL_BUILD_PASS
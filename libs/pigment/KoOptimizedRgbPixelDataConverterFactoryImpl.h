@@ -0,0 +1,22 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KoOptimizedRgbPixelDataConverterFACTORYIMPL_H
+#define KoOptimizedRgbPixelDataConverterFACTORYIMPL_H
+
+#include <KoOptimizedRgbPixelDataConverterBase.h>
+#include <KoMultiArchBuildSupport.h>
+
+class KRITAPIGMENT_EXPORT KoOptimizedRgbPixelDataConverterFactoryImpl
+{
+public:
+    template<typename _impl>
+    static KoOptimizedRgbPixelDataConverterBase* create(KoOptimizedRgbPixelDataConverterBase::ChannelType,
+                                                        KoOptimizedRgbPixelDataConverterBase::ChannelType,
+                                                        KoOptimizedRgbPixelDataConverterBase::TransferCurve);
+};
+
+#endif // KoOptimizedRgbPixelDataConverterFACTORYIMPL_H
@@ -0,0 +1,111 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KoColorConversionBenchmark.h"
+
+#include <simpletest.h>
+
+#include <KoColorSpaceRegistry.h>
+#include <KoColorSpaceEngine.h>
+#include <KoColorSpace.h>
+#include <KoColorModelStandardIds.h>
+#include <KoColorConversionTransformation.h>
+
+#define NB_PIXELS 1000000
+
+void KoColorConversionBenchmark::createRowsColumns()
+{
+    QTest::addColumn<QString>("srcDepthId");
+    QTest::addColumn<QString>("srcProfile");
+    QTest::addColumn<QString>("dstDepthId");
+    QTest::addColumn<QString>("dstProfile");
+
+    const QString linear = "sRGB-elle-V2-g10.icc";
+    const QString srgb = "sRGB-elle-V2-srgbtrc.icc";
+
+    QTest::newRow("U8-srgb -> U16-srgb") << Integer8BitsColorDepthID.id() << srgb << Integer16BitsColorDepthID.id() << srgb;
+    QTest::newRow("U16-srgb -> U8-srgb") << Integer16BitsColorDepthID.id() << srgb << Integer8BitsColorDepthID.id() << srgb;
+    QTest::newRow("U8-srgb -> F32-srgb") << Integer8BitsColorDepthID.id() << srgb << Float32BitsColorDepthID.id() << srgb;
+    QTest::newRow("F32-linear -> U16-linear") << Float32BitsColorDepthID.id() << linear << Integer16BitsColorDepthID.id() << linear;
+    QTest::newRow("U8-srgb -> F32-linear") << Integer8BitsColorDepthID.id() << srgb << Float32BitsColorDepthID.id() << linear;
+    QTest::newRow("U16-srgb -> F32-linear") << Integer16BitsColorDepthID.id() << srgb << Float32BitsColorDepthID.id() << linear;
+    QTest::newRow("F32-linear -> U8-srgb") << Float32BitsColorDepthID.id() << linear << Integer8BitsColorDepthID.id() << srgb;
+    QTest::newRow("U16-linear -> U8-srgb") << Integer16BitsColorDepthID.id() << linear << Integer8BitsColorDepthID.id() << srgb;
+}
+
+#define START_BENCHMARK \
+    QFETCH(QString, srcDepthId); \
+    QFETCH(QString, srcProfile); \
+    QFETCH(QString, dstDepthId); \
+    QFETCH(QString, dstProfile); \
+    \
+    const KoColorSpace *srcCS = KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(), srcDepthId, srcProfile); \
+    const KoColorSpace *dstCS = KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(), dstDepthId, dstProfile); \
+    if (!srcCS || !dstCS) { \
+        QSKIP("The bundled profiles are not available"); \
+    } \
+    quint8 *src = new quint8[NB_PIXELS * srcCS->pixelSize()]; \
+    quint8 *dst = new quint8[NB_PIXELS * dstCS->pixelSize()]; \
+    for (int i = 0; i < NB_PIXELS * int(srcCS->pixelSize()); i++) { \
+        src[i] = quint8(i * 7); \
+    } \
+    if (srcDepthId == Float32BitsColorDepthID.id()) { \
+        float *srcF = reinterpret_cast<float*>(src); \
+        for (int i = 0; i < NB_PIXELS * 4; i++) { \
+            srcF[i] = float(i % 1024) / 1023.0f; \
+        } \
+    } \
+    const KoColorConversionTransformation::Intent intent = \
+        KoColorConversionTransformation::internalRenderingIntent(); \
+    const KoColorConversionTransformation::ConversionFlags flags = \
+        KoColorConversionTransformation::internalConversionFlags();
+
+#define END_BENCHMARK \
+    delete[] src; \
+    delete[] dst;
+
+void KoColorConversionBenchmark::benchmarkOptimized_data()
+{
+    createRowsColumns();
+}
+
+void KoColorConversionBenchmark::benchmarkOptimized()
+{
+    START_BENCHMARK
+
+    QScopedPointer<KoColorConversionTransformation> transform(
+        KoColorSpaceRegistry::instance()->createColorConverter(srcCS, dstCS, intent, flags));
+
+    QBENCHMARK {
+        transform->transform(src, dst, NB_PIXELS);
+    }
+
+    END_BENCHMARK
+}
+
+void KoColorConversionBenchmark::benchmarkLcms_data()
+{
+    createRowsColumns();
+}
+
+void KoColorConversionBenchmark::benchmarkLcms()
+{
+    START_BENCHMARK
+
+    KoColorSpaceEngine *engine = KoColorSpaceEngineRegistry::instance()->get("icc");
+    QVERIFY(engine);
+
+    QScopedPointer<KoColorConversionTransformation> transform(
+        engine->createColorTransformation(srcCS, dstCS, intent, flags));
+
+    QBENCHMARK {
+        transform->transform(src, dst, NB_PIXELS);
+    }
+
+    END_BENCHMARK
+}
+
+SIMPLE_TEST_MAIN(KoColorConversionBenchmark)
@@ -0,0 +1,29 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KOCOLORCONVERSIONBENCHMARK_H
+#define KOCOLORCONVERSIONBENCHMARK_H
+
+#include <QObject>
+
+/**
+ * Compares the throughput of the RGB conversions done by the optimized
+ * converters (the path selected by the color conversion system) with
+ * the throughput of the plain LCMS transformations
+ */
+class KoColorConversionBenchmark : public QObject
+{
+    Q_OBJECT
+private:
+    void createRowsColumns();
+private Q_SLOTS:
+    void benchmarkOptimized_data();
+    void benchmarkOptimized();
+    void benchmarkLcms_data();
+    void benchmarkLcms();
+};
+
+#endif // KOCOLORCONVERSIONBENCHMARK_H
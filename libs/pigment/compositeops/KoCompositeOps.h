@@ -56,6 +56,13 @@ struct OptimizedOpsSelector
     static KoCompositeOp* createCopyOp(const KoColorSpace *cs) {
         return new KoCompositeOpCopy2<Traits>(cs);
     }
+
+    static KoCompositeOp* createGenericSCOp(const KoColorSpace *cs, const QString &id, const QString &category) {
+        Q_UNUSED(cs);
+        Q_UNUSED(id);
+        Q_UNUSED(category);
+        return nullptr;
+    }
 };
 
 template<>
@@ -73,6 +80,10 @@ struct OptimizedOpsSelector<KoBgrU8Traits>
     static KoCompositeOp* createCopyOp(const KoColorSpace *cs) {
         return KoOptimizedCompositeOpFactory::createCopyOp32(cs);
     }
+
+    static KoCompositeOp* createGenericSCOp(const KoColorSpace *cs, const QString &id, const QString &category) {
+        return KoOptimizedCompositeOpFactory::createGenericSCOp32(cs, id, category);
+    }
 };
 
 template<>
@@ -89,6 +100,12 @@ struct OptimizedOpsSelector<KoLabU8Traits>
     static KoCompositeOp* createCopyOp(const KoColorSpace *cs) {
         return KoOptimizedCompositeOpFactory::createCopyOp32(cs);
     }
+    static KoCompositeOp* createGenericSCOp(const KoColorSpace *cs, const QString &id, const QString &category) {
+        Q_UNUSED(cs);
+        Q_UNUSED(id);
+        Q_UNUSED(category);
+        return nullptr;
+    }
 };
 
 template<>
@@ -106,6 +123,9 @@ struct OptimizedOpsSelector<KoRgbF32Traits>
     static KoCompositeOp* createCopyOp(const KoColorSpace *cs) {
         return KoOptimizedCompositeOpFactory::createCopyOp128(cs);
     }
+    static KoCompositeOp* createGenericSCOp(const KoColorSpace *cs, const QString &id, const QString &category) {
+        return KoOptimizedCompositeOpFactory::createGenericSCOp128(cs, id, category);
+    }
 };
 
 template<>
@@ -123,6 +143,9 @@ struct OptimizedOpsSelector<KoBgrU16Traits>
     static KoCompositeOp* createCopyOp(const KoColorSpace *cs) {
         return KoOptimizedCompositeOpFactory::createCopyOpU64(cs);
     }
+    static KoCompositeOp* createGenericSCOp(const KoColorSpace *cs, const QString &id, const QString &category) {
+        return KoOptimizedCompositeOpFactory::createGenericSCOpU64(cs, id, category);
+    }
 };
 
 
@@ -143,7 +166,11 @@ struct AddGeneralOps<Traits, true>
                 cs->addCompositeOp(new KoCompositeOpGenericSC<Traits, func, KoAdditiveBlendingPolicy<Traits>>(cs, id, category));
             }
         } else {
-            cs->addCompositeOp(new KoCompositeOpGenericSC<Traits, func, KoAdditiveBlendingPolicy<Traits>>(cs, id, category));
+            KoCompositeOp *op = OptimizedOpsSelector<Traits>::createGenericSCOp(cs, id, category);
+            if (!op) {
+                op = new KoCompositeOpGenericSC<Traits, func, KoAdditiveBlendingPolicy<Traits>>(cs, id, category);
+            }
+            cs->addCompositeOp(op);
         }
      }
 
@@ -156,7 +183,11 @@ struct AddGeneralOps<Traits, true>
                  cs->addCompositeOp(new KoCompositeOpGenericSCFunctor<Traits, Functor, KoAdditiveBlendingPolicy<Traits>>(cs, id, category));
              }
          } else {
-             cs->addCompositeOp(new KoCompositeOpGenericSCFunctor<Traits, Functor, KoAdditiveBlendingPolicy<Traits>>(cs, id, category));
+             KoCompositeOp *op = OptimizedOpsSelector<Traits>::createGenericSCOp(cs, id, category);
+             if (!op) {
+                 op = new KoCompositeOpGenericSCFunctor<Traits, Functor, KoAdditiveBlendingPolicy<Traits>>(cs, id, category);
+             }
+             cs->addCompositeOp(op);
          }
      }
 
@@ -78,3 +78,18 @@ KoCompositeOp* KoOptimizedCompositeOpFactory::createCopyOpU64(const KoColorSpace
 {
     return createOptimizedClass<KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpCopyU64> >(cs);
 }
+
+KoCompositeOp* KoOptimizedCompositeOpFactory::createGenericSCOp32(const KoColorSpace *cs, const QString &id, const QString &category)
+{
+    return createOptimizedClass<KoOptimizedCompositeOpGenericSCFactoryPerArch<quint8>>(cs, id, category);
+}
+
+KoCompositeOp* KoOptimizedCompositeOpFactory::createGenericSCOpU64(const KoColorSpace *cs, const QString &id, const QString &category)
+{
+    return createOptimizedClass<KoOptimizedCompositeOpGenericSCFactoryPerArch<quint16>>(cs, id, category);
+}
+
+KoCompositeOp* KoOptimizedCompositeOpFactory::createGenericSCOp128(const KoColorSpace *cs, const QString &id, const QString &category)
+{
+    return createOptimizedClass<KoOptimizedCompositeOpGenericSCFactoryPerArch<float>>(cs, id, category);
+}
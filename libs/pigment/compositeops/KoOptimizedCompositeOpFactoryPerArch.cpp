@@ -13,6 +13,7 @@
 #include "KoOptimizedCompositeOpOver32.h"
 #include "KoOptimizedCompositeOpOver128.h"
 #include "KoOptimizedCompositeOpCopy128.h"
+#include "KoOptimizedCompositeOpGenericSC.h"
 
 #include <KoCompositeOpRegistry.h>
 
@@ -124,4 +125,61 @@ KoCompositeOp *KoOptimizedCompositeOpFactoryPerArch<
     return new KoOptimizedCompositeOpAlphaDarkenCreamyU64<xsimd::current_arch>(param);
 }
 
+template<typename _impl, typename channels_type>
+KoCompositeOp *createOptimizedGenericSCOp(const KoColorSpace *cs, const QString &id, const QString &category)
+{
+    using namespace KoStreamedBlendFunctions;
+
+    if (id == COMPOSITE_MULT) {
+        return new KoOptimizedCompositeOpGenericSC<_impl, channels_type, Multiply>(cs, id, category);
+    } else if (id == COMPOSITE_SCREEN) {
+        return new KoOptimizedCompositeOpGenericSC<_impl, channels_type, Screen>(cs, id, category);
+    } else if (id == COMPOSITE_OVERLAY) {
+        return new KoOptimizedCompositeOpGenericSC<_impl, channels_type, Overlay>(cs, id, category);
+    } else if (id == COMPOSITE_HARD_LIGHT) {
+        return new KoOptimizedCompositeOpGenericSC<_impl, channels_type, HardLight>(cs, id, category);
+    } else if (id == COMPOSITE_SOFT_LIGHT_PHOTOSHOP) {
+        return new KoOptimizedCompositeOpGenericSC<_impl, channels_type, SoftLight>(cs, id, category);
+    } else if (id == COMPOSITE_DARKEN) {
+        return new KoOptimizedCompositeOpGenericSC<_impl, channels_type, Darken>(cs, id, category);
+    } else if (id == COMPOSITE_LIGHTEN) {
+        return new KoOptimizedCompositeOpGenericSC<_impl, channels_type, Lighten>(cs, id, category);
+    } else if (id == COMPOSITE_ADD || id == COMPOSITE_LINEAR_DODGE) {
+        return new KoOptimizedCompositeOpGenericSC<_impl, channels_type, Addition>(cs, id, category);
+    } else if (id == COMPOSITE_SUBTRACT) {
+        return new KoOptimizedCompositeOpGenericSC<_impl, channels_type, Subtract>(cs, id, category);
+    } else if (id == COMPOSITE_DIFF) {
+        return new KoOptimizedCompositeOpGenericSC<_impl, channels_type, Difference>(cs, id, category);
+    }
+
+    return nullptr;
+}
+
+template<>
+template<>
+KoCompositeOp *
+KoOptimizedCompositeOpGenericSCFactoryPerArch<quint8>::create<
+    xsimd::current_arch>(const KoColorSpace *param, const QString &id, const QString &category)
+{
+    return createOptimizedGenericSCOp<xsimd::current_arch, quint8>(param, id, category);
+}
+
+template<>
+template<>
+KoCompositeOp *
+KoOptimizedCompositeOpGenericSCFactoryPerArch<quint16>::create<
+    xsimd::current_arch>(const KoColorSpace *param, const QString &id, const QString &category)
+{
+    return createOptimizedGenericSCOp<xsimd::current_arch, quint16>(param, id, category);
+}
+
+template<>
+template<>
+KoCompositeOp *
+KoOptimizedCompositeOpGenericSCFactoryPerArch<float>::create<
+    xsimd::current_arch>(const KoColorSpace *param, const QString &id, const QString &category)
+{
+    return createOptimizedGenericSCOp<xsimd::current_arch, float>(param, id, category);
+}
+
 #endif // XSIMD_UNIVERSAL_BUILD_PASS
@@ -121,3 +121,43 @@ KoCompositeOp *KoOptimizedCompositeOpFactoryPerArch<
     return new KoCompositeOpAlphaDarken<KoBgrU16Traits, KoAlphaDarkenParamsWrapperCreamy>(param);
 }
 
+/**
+ * There is no point in having a scalar version of the separable
+ * blend modes: KoCompositeOpGenericSC is used in such a case.
+ */
+
+template<>
+template<>
+KoCompositeOp *
+KoOptimizedCompositeOpGenericSCFactoryPerArch<quint8>::create<
+    xsimd::generic>(const KoColorSpace *param, const QString &id, const QString &category)
+{
+    Q_UNUSED(param);
+    Q_UNUSED(id);
+    Q_UNUSED(category);
+    return nullptr;
+}
+
+template<>
+template<>
+KoCompositeOp *
+KoOptimizedCompositeOpGenericSCFactoryPerArch<quint16>::create<
+    xsimd::generic>(const KoColorSpace *param, const QString &id, const QString &category)
+{
+    Q_UNUSED(param);
+    Q_UNUSED(id);
+    Q_UNUSED(category);
+    return nullptr;
+}
+
+template<>
+template<>
+KoCompositeOp *
+KoOptimizedCompositeOpGenericSCFactoryPerArch<float>::create<
+    xsimd::generic>(const KoColorSpace *param, const QString &id, const QString &category)
+{
+    Q_UNUSED(param);
+    Q_UNUSED(id);
+    Q_UNUSED(category);
+    return nullptr;
+}
@@ -0,0 +1,406 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: LGPL-2.0-or-later
+ */
+
+#ifndef KOOPTIMIZEDCOMPOSITEOPGENERICSC_H_
+#define KOOPTIMIZEDCOMPOSITEOPGENERICSC_H_
+
+#include "KoCompositeOpBase.h"
+#include "KoCompositeOpRegistry.h"
+#include "KoStreamedMath.h"
+
+/**
+ * Helper functions that have the same interface for scalar floats
+ * and float vectors, so that the blend functions could be written
+ * only once and used both for the vectorized and the unaligned
+ * (scalar) parts of the row.
+ *
+ * NOTE: the functions are templated by the architecture on purpose,
+ *       otherwise the linker would be free to merge the scalar versions
+ *       compiled for different instruction sets.
+ */
+template<typename _impl>
+struct KoStreamedBlendMath {
+    using float_v = typename KoStreamedMath<_impl>::float_v;
+    using float_m = typename float_v::batch_bool_type;
+
+    static ALWAYS_INLINE float min(float a, float b) { return std::min(a, b); }
+    static ALWAYS_INLINE float_v min(const float_v &a, const float_v &b) { return xsimd::min(a, b); }
+
+    static ALWAYS_INLINE float max(float a, float b) { return std::max(a, b); }
+    static ALWAYS_INLINE float_v max(const float_v &a, const float_v &b) { return xsimd::max(a, b); }
+
+    static ALWAYS_INLINE float sqrt(float a) { return std::sqrt(a); }
+    static ALWAYS_INLINE float_v sqrt(const float_v &a) { return xsimd::sqrt(a); }
+
+    static ALWAYS_INLINE float select(bool cond, float a, float b) { return cond ? a : b; }
+    static ALWAYS_INLINE float_v select(const float_m &cond, const float_v &a, const float_v &b) { return xsimd::select(cond, a, b); }
+
+    template<typename T>
+    static ALWAYS_INLINE T clampToSDR(const T &a) { return min(max(a, T(0.0f)), T(1.0f)); }
+};
+
+/**
+ * Vectorizable versions of the most popular separable blend functions
+ * from KoCompositeOpFunctions.h. All the values are normalized to
+ * 0.0...1.0 range. The clamping flags repeat the clamping policies of
+ * the original functors (they matter for floating point color spaces
+ * only).
+ */
+namespace KoStreamedBlendFunctions {
+
+struct Multiply {
+    static constexpr bool clampSource = false;
+    static constexpr bool clampDestination = false;
+
+    template<typename _impl, typename T>
+    static ALWAYS_INLINE T composeChannel(const T &src, const T &dst)
+    {
+        return src * dst;
+    }
+};
+
+struct Screen {
+    static constexpr bool clampSource = false;
+    static constexpr bool clampDestination = false;
+
+    template<typename _impl, typename T>
+    static ALWAYS_INLINE T composeChannel(const T &src, const T &dst)
+    {
+        return src + dst - src * dst;
+    }
+};
+
+struct HardLight {
+    static constexpr bool clampSource = true;
+    static constexpr bool clampDestination = false;
+
+    template<typename _impl, typename T>
+    static ALWAYS_INLINE T composeChannel(const T &src, const T &dst)
+    {
+        using M = KoStreamedBlendMath<_impl>;
+
+        const T src2 = src + src;
+        const T screenSrc = src2 - T(1.0f);
+
+        return M::select(src > T(0.5f),
+                         screenSrc + dst - screenSrc * dst,
+                         src2 * dst);
+    }
+};
+
+struct Overlay {
+    static constexpr bool clampSource = true;
+    static constexpr bool clampDestination = false;
+
+    template<typename _impl, typename T>
+    static ALWAYS_INLINE T composeChannel(const T &src, const T &dst)
+    {
+        return HardLight::composeChannel<_impl>(dst, src);
+    }
+};
+
+struct SoftLight {
+    static constexpr bool clampSource = true;
+    static constexpr bool clampDestination = true;
+
+    template<typename _impl, typename T>
+    static ALWAYS_INLINE T composeChannel(const T &src, const T &dst)
+    {
+        using M = KoStreamedBlendMath<_impl>;
+
+        const T src2 = src + src;
+
+        return M::select(src > T(0.5f),
+                         dst + (src2 - T(1.0f)) * (M::sqrt(dst) - dst),
+                         dst - (T(1.0f) - src2) * dst * (T(1.0f) - dst));
+    }
+};
+
+struct Darken {
+    static constexpr bool clampSource = false;
+    static constexpr bool clampDestination = false;
+
+    template<typename _impl, typename T>
+    static ALWAYS_INLINE T composeChannel(const T &src, const T &dst)
+    {
+        return KoStreamedBlendMath<_impl>::min(src, dst);
+    }
+};
+
+struct Lighten {
+    static constexpr bool clampSource = false;
+    static constexpr bool clampDestination = false;
+
+    template<typename _impl, typename T>
+    static ALWAYS_INLINE T composeChannel(const T &src, const T &dst)
+    {
+        return KoStreamedBlendMath<_impl>::max(src, dst);
+    }
+};
+
+struct Addition {
+    static constexpr bool clampSource = false;
+    static constexpr bool clampDestination = false;
+
+    template<typename _impl, typename T>
+    static ALWAYS_INLINE T composeChannel(const T &src, const T &dst)
+    {
+        return src + dst;
+    }
+};
+
+struct Subtract {
+    static constexpr bool clampSource = false;
+    static constexpr bool clampDestination = false;
+
+    template<typename _impl, typename T>
+    static ALWAYS_INLINE T composeChannel(const T &src, const T &dst)
+    {
+        return dst - src;
+    }
+};
+
+struct Difference {
+    static constexpr bool clampSource = false;
+    static constexpr bool clampDestination = false;
+
+    template<typename _impl, typename T>
+    static ALWAYS_INLINE T composeChannel(const T &src, const T &dst)
+    {
+        using M = KoStreamedBlendMath<_impl>;
+        return M::max(src, dst) - M::min(src, dst);
+    }
+};
+
+} // namespace KoStreamedBlendFunctions
+
+/**
+ * A vectorized counterpart of KoCompositeOpGenericSCFunctor with additive
+ * blending policy. The math is done in normalized floating point values,
+ * so the integer results may differ from the legacy version by a rounding
+ * error.
+ */
+template<typename channels_type, typename BlendFunction, bool alphaLocked, bool allChannelsFlag>
+struct GenericSCCompositor128 {
+    struct ParamsWrapper {
+        ParamsWrapper(const KoCompositeOp::ParameterInfo& params)
+            : channelFlags(params.channelFlags)
+        {
+        }
+        const QBitArray &channelFlags;
+    };
+
+    static constexpr bool isIntegerSpace = std::numeric_limits<channels_type>::is_integer;
+    static constexpr float channelUnit = isIntegerSpace ? float(std::numeric_limits<channels_type>::max()) : 1.0f;
+    static constexpr float channelRec = 1.0f / channelUnit;
+
+    template<typename _impl, typename T>
+    static ALWAYS_INLINE T blendChannel(T src, T dst, const T &srcAlpha, const T &dstAlpha, const T &newAlpha)
+    {
+        using M = KoStreamedBlendMath<_impl>;
+
+        if (isIntegerSpace) {
+            src *= T(channelRec);
+            dst *= T(channelRec);
+        }
+
+        if (!isIntegerSpace && BlendFunction::clampSource) {
+            src = M::clampToSDR(src);
+        }
+
+        if (!isIntegerSpace && BlendFunction::clampDestination) {
+            dst = M::clampToSDR(dst);
+        }
+
+        T result = BlendFunction::template composeChannel<_impl>(src, dst);
+
+        if (isIntegerSpace) {
+            result = M::clampToSDR(result);
+        }
+
+        if (alphaLocked) {
+            result = dst + (result - dst) * srcAlpha;
+        } else {
+            const T srcDstAlpha = srcAlpha * dstAlpha;
+
+            result = ((dstAlpha - srcDstAlpha) * dst +
+                      (srcAlpha - srcDstAlpha) * src +
+                      srcDstAlpha * result) / newAlpha;
+        }
+
+        if (isIntegerSpace) {
+            result *= T(channelUnit);
+        }
+
+        return result;
+    }
+
+    template<bool haveMask, bool src_aligned, typename _impl>
+    static ALWAYS_INLINE void compositeVector(const quint8 *src, quint8 *dst, const quint8 *mask, float opacity, const ParamsWrapper &oparams)
+    {
+        Q_UNUSED(oparams);
+
+        using float_v = typename KoStreamedMath<_impl>::float_v;
+        using float_m = typename float_v::batch_bool_type;
+
+        PixelWrapper<channels_type, _impl> dataWrapper;
+
+        float_v src_alpha;
+        float_v src_c1;
+        float_v src_c2;
+        float_v src_c3;
+
+        dataWrapper.read(src, src_c1, src_c2, src_c3, src_alpha);
+
+        src_alpha *= float_v(opacity);
+
+        if (haveMask) {
+            const float_v uint8MaxRec1(1.0f / 255.0f);
+            src_alpha *= KoStreamedMath<_impl>::fetch_mask_8(mask) * uint8MaxRec1;
+        }
+
+        const float_v zeroValue(0.0f);
+
+        float_m keepDstMask = src_alpha == zeroValue;
+
+        if (xsimd::all(keepDstMask)) {
+            return;
+        }
+
+        float_v dst_alpha;
+        float_v dst_c1;
+        float_v dst_c2;
+        float_v dst_c3;
+
+        dataWrapper.read(dst, dst_c1, dst_c2, dst_c3, dst_alpha);
+
+        if (alphaLocked) {
+            keepDstMask = keepDstMask | (dst_alpha == zeroValue);
+
+            if (xsimd::all(keepDstMask)) {
+                return;
+            }
+        }
+
+        const float_v newAlpha = alphaLocked ?
+            dst_alpha : src_alpha + dst_alpha - src_alpha * dst_alpha;
+
+        float_v res_c1 = blendChannel<_impl>(src_c1, dst_c1, src_alpha, dst_alpha, newAlpha);
+        float_v res_c2 = blendChannel<_impl>(src_c2, dst_c2, src_alpha, dst_alpha, newAlpha);
+        float_v res_c3 = blendChannel<_impl>(src_c3, dst_c3, src_alpha, dst_alpha, newAlpha);
+
+        // the division by newAlpha in the lanes we don't touch may
+        // have generated garbage, restore the original pixels there
+        res_c1 = xsimd::select(keepDstMask, dst_c1, res_c1);
+        res_c2 = xsimd::select(keepDstMask, dst_c2, res_c2);
+        res_c3 = xsimd::select(keepDstMask, dst_c3, res_c3);
+        const float_v res_alpha = xsimd::select(keepDstMask, dst_alpha, newAlpha);
+
+        dataWrapper.write(dst, res_c1, res_c2, res_c3, res_alpha);
+    }
+
+    template <bool haveMask, typename _impl = xsimd::current_arch>
+    static ALWAYS_INLINE void compositeOnePixelScalar(const quint8 *src, quint8 *dst, const quint8 *mask, float opacity, const ParamsWrapper &oparams)
+    {
+        const qint32 alpha_pos = 3;
+
+        const auto *s = reinterpret_cast<const channels_type*>(src);
+        auto *d = reinterpret_cast<channels_type*>(dst);
+
+        float srcAlpha = s[alpha_pos];
+        PixelWrapper<channels_type, _impl>::normalizeAlpha(srcAlpha);
+
+        float dstAlpha = d[alpha_pos];
+        PixelWrapper<channels_type, _impl>::normalizeAlpha(dstAlpha);
+
+        if (haveMask) {
+            const float uint8Rec1 = 1.0f / 255.0f;
+            opacity *= float(*mask) * uint8Rec1;
+        }
+
+        srcAlpha *= opacity;
+
+        // the same as KoCompositeOpBase does for partial channel flags
+        if (!allChannelsFlag && dstAlpha == 0.0f) {
+            KoStreamedMathFunctions::clearPixel<4 * sizeof(channels_type)>(dst);
+        }
+
+        if (srcAlpha == 0.0f || (alphaLocked && dstAlpha == 0.0f)) {
+            return;
+        }
+
+        const float newAlpha = alphaLocked ?
+            dstAlpha : srcAlpha + dstAlpha - srcAlpha * dstAlpha;
+
+        for (int i = 0; i < 3; i++) {
+            if (allChannelsFlag || oparams.channelFlags.testBit(i)) {
+                const float result =
+                    blendChannel<_impl, float>(s[i], d[i], srcAlpha, dstAlpha, newAlpha);
+
+                d[i] = PixelWrapper<channels_type, _impl>::roundFloatToUint(result);
+            }
+        }
+
+        if (!alphaLocked) {
+            float alpha = newAlpha;
+            PixelWrapper<channels_type, _impl>::denormalizeAlpha(alpha);
+            d[alpha_pos] = PixelWrapper<channels_type, _impl>::roundFloatToUint(alpha);
+        }
+    }
+};
+
+/**
+ * An optimized version of separable blend modes for RGBA color spaces
+ * with alpha channel placed at the last position of the pixel: C1_C2_C3_A.
+ * Supports 8-bit, 16-bit and 32-bit float channels.
+ */
+template<typename _impl, typename channels_type, typename BlendFunction>
+class KoOptimizedCompositeOpGenericSC : public KoCompositeOp
+{
+    static constexpr int pixelSize = 4 * sizeof(channels_type);
+
+public:
+    KoOptimizedCompositeOpGenericSC(const KoColorSpace* cs, const QString &id, const QString &category)
+        : KoCompositeOp(cs, id, category) {}
+
+    using KoCompositeOp::composite;
+
+    void composite(const KoCompositeOp::ParameterInfo& params) const override
+    {
+        if(params.maskRowStart) {
+            composite<true>(params);
+        } else {
+            composite<false>(params);
+        }
+    }
+
+    template <bool haveMask>
+    inline void composite(const KoCompositeOp::ParameterInfo& params) const {
+        if (params.channelFlags.isEmpty() ||
+            params.channelFlags == QBitArray(4, true)) {
+
+            KoStreamedMath<_impl>::template genericComposite<haveMask, false, GenericSCCompositor128<channels_type, BlendFunction, false, true>, pixelSize>(params);
+        } else {
+            const bool allChannelsFlag =
+                params.channelFlags.at(0) &&
+                params.channelFlags.at(1) &&
+                params.channelFlags.at(2);
+
+            const bool alphaLocked =
+                !params.channelFlags.at(3);
+
+            if (allChannelsFlag && alphaLocked) {
+                KoStreamedMath<_impl>::template genericComposite<haveMask, false, GenericSCCompositor128<channels_type, BlendFunction, true, true>, pixelSize>(params);
+            } else if (!allChannelsFlag && !alphaLocked) {
+                KoStreamedMath<_impl>::template genericComposite_novector<haveMask, false, GenericSCCompositor128<channels_type, BlendFunction, false, false>, pixelSize>(params);
+            } else /*if (!allChannelsFlag && alphaLocked) */{
+                KoStreamedMath<_impl>::template genericComposite_novector<haveMask, false, GenericSCCompositor128<channels_type, BlendFunction, true, false>, pixelSize>(params);
+            }
+        }
+    }
+};
+
+#endif // KOOPTIMIZEDCOMPOSITEOPGENERICSC_H_
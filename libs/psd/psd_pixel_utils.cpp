@@ -9,6 +9,7 @@
 
 #include <QIODevice>
 #include <QMap>
+#include <QtConcurrent>
 #include <QtEndian>
 #include <QtGlobal>
 
@@ -16,6 +17,7 @@
 #include <KoColorSpaceMaths.h>
 #include <KoColorSpaceTraits.h>
 #include <colorspaces/KoAlphaColorSpace.h>
+#include <kis_algebra_2d.h>
 #include <kis_global.h>
 #include <kis_iterator_ng.h>
 
@@ -298,41 +300,56 @@ void readAlphaMaskPixelCommon(int channelSize, const QMap<quint16, QByteArray> &
     }
 }
 
-QMap<quint16, QByteArray> fetchChannelsBytes(QIODevice &io, QVector<ChannelInfo *> channelInfoRecords, int row, int width, int channelSize, bool processMasks)
+using PixelFunc = std::function<void(int, const QMap<quint16, QByteArray> &, int, quint8 *)>;
+
+/**
+ * The height of the stripes the pixels are written in concurrently. It is
+ * equal to the height of a tile, so that the stripes never share a tile.
+ */
+static const int stripeHeight = 64;
+
+/**
+ * Splits \p rc into the stripes aligned to the tiles grid of \p dev and
+ * calls \p stripeFunc for every stripe concurrently
+ */
+void processStripesConcurrently(KisPaintDeviceSP dev, const QRect &rc, std::function<void(const QRect &)> stripeFunc)
 {
-    const int uncompressedLength = width * channelSize;
+    QVector<QRect> stripes;
 
-    QMap<quint16, QByteArray> channelBytes;
+    for (int y = rc.top(); y <= rc.bottom();) {
+        const int stripeBottom = qMin(rc.bottom(), y - KisAlgebra2D::wrapValue(y - dev->y(), stripeHeight) + stripeHeight - 1);
+        stripes.append(QRect(rc.left(), y, rc.width(), stripeBottom - y + 1));
+        y = stripeBottom + 1;
+    }
 
-    Q_FOREACH (ChannelInfo *channelInfo, channelInfoRecords) {
-        // user supplied masks are ignored here
-        if (!processMasks && channelInfo->channelId < -1)
-            continue;
+    QtConcurrent::blockingMap(stripes, stripeFunc);
+}
 
-        io.seek(channelInfo->channelDataStart + channelInfo->channelOffset);
+void writePixelsRows(KisPaintDeviceSP dev,
+                     const QRect &rc,
+                     int channelSize,
+                     PixelFunc pixelFunc,
+                     std::function<const QMap<quint16, QByteArray> &(int)> rowBytesFunc,
+                     std::function<int(int)> rowColumnOffsetFunc)
+{
+    KisHLineIteratorSP it = dev->createHLineIteratorNG(rc.left(), rc.top(), rc.width());
+    for (int y = rc.top(); y <= rc.bottom(); y++) {
+        const QMap<quint16, QByteArray> &channelBytes = rowBytesFunc(y);
+        const int colOffset = rowColumnOffsetFunc(y);
 
-        if (channelInfo->compressionType == psd_compression_type::Uncompressed) {
-            channelBytes[channelInfo->channelId] = io.read(uncompressedLength);
-            channelInfo->channelOffset += uncompressedLength;
-        } else if (channelInfo->compressionType == psd_compression_type::RLE) {
-            int rleLength = channelInfo->rleRowLengths[row];
-            QByteArray compressedBytes = io.read(rleLength);
-            QByteArray uncompressedBytes = Compression::uncompress(uncompressedLength, compressedBytes, channelInfo->compressionType);
-            channelBytes.insert(channelInfo->channelId, uncompressedBytes);
-            channelInfo->channelOffset += rleLength;
-        } else {
-            QString error = QString("Unsupported Compression mode: %1")
-                                .arg(static_cast<std::uint16_t>(channelInfo->compressionType));
-            dbgFile << "ERROR: fetchChannelsBytes:" << error;
-            throw KisAslReaderUtils::ASLParseException(error);
+        for (int col = 0; col < rc.width(); col++) {
+            pixelFunc(channelSize, channelBytes, colOffset + col, it->rawData());
+            it->nextPixel();
         }
-    }
 
-    return channelBytes;
+        /// don't write-access the row right after the
+        /// the end of the read area
+        if (y < rc.bottom()) {
+            it->nextRow();
+        }
+    }
 }
 
-using PixelFunc = std::function<void(int, const QMap<quint16, QByteArray> &, int, quint8 *)>;
-
 void readCommon(KisPaintDeviceSP dev,
                 QIODevice &io,
                 const QRect &layerRect,
@@ -348,19 +365,30 @@ void readCommon(KisPaintDeviceSP dev,
         return;
     }
 
+    const int width = layerRect.width();
+
     if (infoRecords.first()->compressionType == psd_compression_type::ZIP || infoRecords.first()->compressionType == psd_compression_type::ZIPWithPrediction) {
         const int numPixels = channelSize * layerRect.width() * layerRect.height();
+        const psd_compression_type compressionType = infoRecords.first()->compressionType;
 
-        QMap<quint16, QByteArray> channelBytes;
+        QVector<QByteArray> channelData;
 
+        // reading is sequential, inflating is done concurrently
         Q_FOREACH (ChannelInfo *info, infoRecords) {
             io.seek(info->channelDataStart);
-            QByteArray compressedBytes = io.read(info->channelDataLength);
-            QByteArray uncompressedBytes;
+            channelData.append(io.read(info->channelDataLength));
+        }
+
+        QtConcurrent::blockingMap(channelData, [numPixels, compressionType, width, channelSize] (QByteArray &data) {
+            data = Compression::uncompress(numPixels, data, compressionType, width, channelSize * 8);
+        });
+
+        QMap<quint16, QByteArray> channelBytes;
 
-            uncompressedBytes = Compression::uncompress(numPixels, compressedBytes, infoRecords.first()->compressionType, layerRect.width(), channelSize * 8);
+        for (int i = 0; i < infoRecords.size(); i++) {
+            ChannelInfo *info = infoRecords[i];
 
-            if (uncompressedBytes.size() != numPixels) {
+            if (channelData[i].size() != numPixels) {
                 QString error = QString("Failed to unzip channel data: id = %1, compression = %2")
                                     .arg(info->channelId)
                                     .arg(static_cast<std::uint16_t>(info->compressionType));
@@ -372,33 +400,114 @@ void readCommon(KisPaintDeviceSP dev,
                 throw KisAslReaderUtils::ASLParseException(error);
             }
 
-            channelBytes.insert(info->channelId, uncompressedBytes);
+            channelBytes.insert(info->channelId, channelData[i]);
         }
 
-        KisSequentialIterator it(dev, layerRect);
-        int col = 0;
-        while (it.nextPixel()) {
-            pixelFunc(channelSize, channelBytes, col, it.rawData());
-            col++;
-        }
+        processStripesConcurrently(dev, layerRect, [&] (const QRect &stripe) {
+            writePixelsRows(dev, stripe, channelSize, pixelFunc,
+                            [&channelBytes] (int) -> const QMap<quint16, QByteArray> & { return channelBytes; },
+                            [&layerRect, width] (int y) { return (y - layerRect.top()) * width; });
+        });
 
     } else {
-        KisHLineIteratorSP it = dev->createHLineIteratorNG(layerRect.left(), layerRect.top(), layerRect.width());
-        for (int i = 0; i < layerRect.height(); i++) {
-            QMap<quint16, QByteArray> channelBytes;
+        const int uncompressedLength = width * channelSize;
+
+        QVector<ChannelInfo *> channels;
+
+        Q_FOREACH (ChannelInfo *channelInfo, infoRecords) {
+            // user supplied masks are ignored here
+            if (!processMasks && channelInfo->channelId < -1)
+                continue;
+
+            if (channelInfo->compressionType != psd_compression_type::Uncompressed
+                && channelInfo->compressionType != psd_compression_type::RLE) {
+
+                QString error = QString("Unsupported Compression mode: %1")
+                                    .arg(static_cast<std::uint16_t>(channelInfo->compressionType));
+                dbgFile << "ERROR: readCommon:" << error;
+                throw KisAslReaderUtils::ASLParseException(error);
+            }
 
-            channelBytes = fetchChannelsBytes(io, infoRecords, i, layerRect.width(), channelSize, processMasks);
+            if (channelInfo->compressionType == psd_compression_type::RLE
+                && channelInfo->rleRowLengths.size() < layerRect.height()) {
 
-            for (int col = 0; col < layerRect.width(); col++) {
-                pixelFunc(channelSize, channelBytes, col, it->rawData());
-                it->nextPixel();
+                QString error = QString("Not enough RLE row lengths for channel %1: %2 < %3")
+                                    .arg(channelInfo->channelId)
+                                    .arg(channelInfo->rleRowLengths.size())
+                                    .arg(layerRect.height());
+                dbgFile << "ERROR: readCommon:" << error;
+                throw KisAslReaderUtils::ASLParseException(error);
             }
 
-            /// don't write-access the row right after the
-            /// the end of the read area
-            if (i < layerRect.height() - 1) {
-                it->nextRow();
+            channels.append(channelInfo);
+        }
+
+        /**
+         * The rows are read in bands to limit the memory consumption. The
+         * compressed data of a band is read sequentially in one go, then
+         * the rows are decoded and written into the device concurrently.
+         */
+        const int bandMemoryLimit = 16 * 1024 * 1024;
+        const int bandHeight = qMax(1, bandMemoryLimit / qMax(1, uncompressedLength * channels.size()) / stripeHeight) * stripeHeight;
+
+        for (int bandTop = 0; bandTop < layerRect.height();) {
+            const int bandBottom =
+                qMin(layerRect.height(),
+                     bandTop + bandHeight - KisAlgebra2D::wrapValue(layerRect.top() + bandTop - dev->y(), stripeHeight));
+
+            QVector<QByteArray> bandData;
+            QVector<QVector<int>> rowOffsets;
+
+            Q_FOREACH (ChannelInfo *channelInfo, channels) {
+                QVector<int> offsets;
+                int bandSize = 0;
+
+                for (int row = bandTop; row < bandBottom; row++) {
+                    offsets.append(bandSize);
+                    bandSize += channelInfo->compressionType == psd_compression_type::RLE
+                        ? static_cast<int>(channelInfo->rleRowLengths[row])
+                        : uncompressedLength;
+                }
+                offsets.append(bandSize);
+
+                io.seek(channelInfo->channelDataStart + channelInfo->channelOffset);
+                bandData.append(io.read(bandSize));
+                channelInfo->channelOffset += bandSize;
+
+                rowOffsets.append(offsets);
             }
+
+            const QRect bandRect(layerRect.left(), layerRect.top() + bandTop, width, bandBottom - bandTop);
+
+            processStripesConcurrently(dev, bandRect, [&] (const QRect &stripe) {
+                QMap<quint16, QByteArray> channelBytes;
+
+                auto fetchRowBytes = [&] (int y) -> const QMap<quint16, QByteArray> & {
+                    const int row = y - bandRect.top();
+
+                    for (int i = 0; i < channels.size(); i++) {
+                        const ChannelInfo *channelInfo = channels[i];
+                        const QByteArray &data = bandData[i];
+
+                        const int start = qMin(rowOffsets[i][row], data.size());
+                        const int end = qMin(rowOffsets[i][row + 1], data.size());
+                        const QByteArray compressedBytes = QByteArray::fromRawData(data.constData() + start, end - start);
+
+                        if (channelInfo->compressionType == psd_compression_type::Uncompressed) {
+                            // bandData outlives the row, no need to copy
+                            channelBytes[channelInfo->channelId] = compressedBytes;
+                        } else {
+                            channelBytes[channelInfo->channelId] = Compression::uncompress(uncompressedLength, compressedBytes, channelInfo->compressionType);
+                        }
+                    }
+
+                    return channelBytes;
+                };
+
+                writePixelsRows(dev, stripe, channelSize, pixelFunc, fetchRowBytes, [] (int) { return 0; });
+            });
+
+            bandTop = bandBottom;
         }
     }
 }
@@ -473,10 +582,22 @@ void readAlphaMaskChannels(QIODevice &io,
     }
 }
 
+/**
+ * Compresses the rows of \p plane with PackBits, \p numRows rows
+ * starting with \p firstRow are stored into \p compressedRows
+ */
+void compressRowsRLE(const quint8 *plane, const int channelSize, const QRect &rc, int firstRow, int numRows, QVector<QByteArray> &compressedRows)
+{
+    const int stride = channelSize * rc.width();
+    for (int row = firstRow; row < firstRow + numRows; ++row) {
+        QByteArray uncompressed = QByteArray::fromRawData((const char *)plane + row * stride, stride);
+        compressedRows[row] = Compression::compress(uncompressed, psd_compression_type::RLE);
+    }
+}
+
 template<psd_byte_order byteOrder = psd_byte_order::psdBigEndian>
 void writeChannelDataRLEImpl(QIODevice &io,
-                             const quint8 *plane,
-                             const int channelSize,
+                             const QVector<QByteArray> &compressedRows,
                              const QRect &rc,
                              const qint64 sizeFieldOffset,
                              const qint64 rleBlockOffset,
@@ -513,10 +634,10 @@ void writeChannelDataRLEImpl(QIODevice &io,
         }
     }
 
-    const int stride = channelSize * rc.width();
+    KIS_ASSERT_RECOVER_RETURN(compressedRows.size() == rc.height());
+
     for (qint32 row = 0; row < rc.height(); ++row) {
-        QByteArray uncompressed = QByteArray::fromRawData((const char *)plane + row * stride, stride);
-        QByteArray compressed = Compression::compress(uncompressed, psd_compression_type::RLE);
+        const QByteArray &compressed = compressedRows[row];
 
         KisAslWriterUtils::OffsetStreamPusher<quint16, byteOrder> rleExternalTag(io, 0, channelRLESizePos + row * static_cast<qint64>(sizeof(quint16)));
 
@@ -528,9 +649,7 @@ void writeChannelDataRLEImpl(QIODevice &io,
 
 template<psd_byte_order byteOrder = psd_byte_order::psdBigEndian>
 void writeChannelDataZIPImpl(QIODevice &io,
-                             const quint8 *plane,
-                             const int channelSize,
-                             const QRect &rc,
+                             const QByteArray &compressed,
                              const qint64 sizeFieldOffset,
                              const bool writeCompressionType)
 {
@@ -544,9 +663,6 @@ void writeChannelDataZIPImpl(QIODevice &io,
         SAFE_WRITE_EX(byteOrder, io, static_cast<quint16>(psd_compression_type::ZIP));
     }
 
-    QByteArray uncompressed(reinterpret_cast<const char *>(plane), rc.width() * rc.height() * channelSize);
-    QByteArray compressed(Compression::compress(uncompressed, psd_compression_type::ZIP));
-
     if (compressed.size() == 0 || io.write(compressed) != compressed.size()) {
         throw KisAslWriterUtils::ASLWriteException("Failed to write image data");
     }
@@ -561,11 +677,14 @@ void writeChannelDataRLE(QIODevice &io,
                          const bool writeCompressionType,
                          psd_byte_order byteOrder)
 {
+    QVector<QByteArray> compressedRows(rc.height());
+    compressRowsRLE(plane, channelSize, rc, 0, rc.height(), compressedRows);
+
     switch (byteOrder) {
     case psd_byte_order::psdLittleEndian:
-        return writeChannelDataRLEImpl<psd_byte_order::psdLittleEndian>(io, plane, channelSize, rc, sizeFieldOffset, rleBlockOffset, writeCompressionType);
+        return writeChannelDataRLEImpl<psd_byte_order::psdLittleEndian>(io, compressedRows, rc, sizeFieldOffset, rleBlockOffset, writeCompressionType);
     default:
-        return writeChannelDataRLEImpl(io, plane, channelSize, rc, sizeFieldOffset, rleBlockOffset, writeCompressionType);
+        return writeChannelDataRLEImpl(io, compressedRows, rc, sizeFieldOffset, rleBlockOffset, writeCompressionType);
     }
 }
 
@@ -666,28 +785,67 @@ void writePixelDataCommonImpl(QIODevice &io,
 
     // write down the planes
 
+    const bool useZip = compressionType == psd_compression_type::ZIP || compressionType == psd_compression_type::ZIPWithPrediction;
+
+    /**
+     * The channels are prepared and compressed concurrently, only the
+     * writing itself is sequential. RLE rows are compressed in chunks,
+     * so that even a single channel layer is split between the threads.
+     */
+    QVector<QByteArray> zipChannels(writingInfoList.size());
+    QVector<QVector<QByteArray>> rleChannels(writingInfoList.size());
+
+    {
+        QVector<int> channelIndexes;
+        for (int i = 0; i < writingInfoList.size(); i++) {
+            channelIndexes.append(i);
+        }
+
+        QtConcurrent::blockingMap(channelIndexes, [&] (int i) {
+            // WARNING: Pixel data is ALWAYS in big endian!!!
+            preparePixelForWrite<psd_byte_order::psdBigEndian>(planes[i], numPixels, channelSize, writingInfoList[i].channelId, colorMode);
+
+            if (useZip) {
+                const QByteArray uncompressed = QByteArray::fromRawData(reinterpret_cast<const char *>(planes[i]), numPixels * channelSize);
+                zipChannels[i] = Compression::compress(uncompressed, psd_compression_type::ZIP);
+            }
+        });
+
+        if (!useZip) {
+            struct RowsChunk {
+                int channel;
+                int firstRow;
+                int numRows;
+            };
+
+            const int rowsPerChunk = 64;
+            QVector<RowsChunk> chunks;
+
+            for (int i = 0; i < writingInfoList.size(); i++) {
+                rleChannels[i].resize(rc.height());
+
+                for (int row = 0; row < rc.height(); row += rowsPerChunk) {
+                    chunks.append({i, row, qMin(rowsPerChunk, rc.height() - row)});
+                }
+            }
+
+            QtConcurrent::blockingMap(chunks, [&] (const RowsChunk &chunk) {
+                compressRowsRLE(planes[chunk.channel], channelSize, rc, chunk.firstRow, chunk.numRows, rleChannels[chunk.channel]);
+            });
+        }
+    }
+
     try {
         for (int i = 0; i < writingInfoList.size(); i++) {
             const ChannelWritingInfo &info = writingInfoList[i];
 
             dbgFile << "\tWriting channel" << i << "psd channel id" << info.channelId;
-
-            // WARNING: Pixel data is ALWAYS in big endian!!!
-            preparePixelForWrite<psd_byte_order::psdBigEndian>(planes[i], numPixels, channelSize, info.channelId, colorMode);
-
             dbgFile << "\t\tchannel start" << ppVar(io.pos()) << ", compression type" << compressionType;
 
-            switch (compressionType) {
-            case psd_compression_type::ZIP:
-            case psd_compression_type::ZIPWithPrediction: {
-                writeChannelDataZIPImpl<byteOrder>(io, planes[i], channelSize, rc, info.sizeFieldOffset, writeCompressionType);
-                break;
-            }
-            case psd_compression_type::RLE:
-            default: {
-                writeChannelDataRLEImpl<byteOrder>(io, planes[i], channelSize, rc, info.sizeFieldOffset, info.rleBlockOffset, writeCompressionType);
-                break;
-            }
+            if (useZip) {
+                writeChannelDataZIPImpl<byteOrder>(io, zipChannels[i], info.sizeFieldOffset, writeCompressionType);
+            } else {
+                writeChannelDataRLEImpl<byteOrder>(io, rleChannels[i], rc, info.sizeFieldOffset, info.rleBlockOffset, writeCompressionType);
             }
         }
 
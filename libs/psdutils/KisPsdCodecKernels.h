@@ -0,0 +1,249 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISPSDCODECKERNELS_H
+#define KISPSDCODECKERNELS_H
+
+#include "KisPsdCodecKernelsBase.h"
+
+#include <type_traits>
+
+#include <KoAlwaysInline.h>
+#include <KoMultiArchBuildSupport.h>
+
+namespace KisPsdCodecKernelsScalar
+{
+
+/**
+ * Reference implementations of the kernels. They are used on the
+ * architectures without vector instructions and for the tails of
+ * the rows that don't fit into a full vector.
+ *
+ * NOTE: the functions depend on \p _impl to make sure that the copies
+ *       compiled for different architectures are not merged by the linker
+ */
+
+template<typename _impl>
+inline int countRepeatedBytes(const quint8 *src, int start, int maxLength)
+{
+    int i = start;
+    while (i < maxLength && src[i] == src[0]) {
+        i++;
+    }
+    return i;
+}
+
+template<typename _impl>
+inline int findTripleRun(const quint8 *src, int start, int maxLength)
+{
+    int i = start;
+    while (i < maxLength && !(src[i] == src[i + 1] && src[i] == src[i + 2])) {
+        i++;
+    }
+    return i;
+}
+
+template<typename _impl>
+inline void encodeDelta8(quint8 *row, int end)
+{
+    for (int i = end - 1; i > 0; i--) {
+        row[i] -= row[i - 1];
+    }
+}
+
+template<typename _impl>
+inline void decodeDelta8(quint8 *row, int start, int length)
+{
+    for (int i = qMax(1, start); i < length; i++) {
+        row[i] += row[i - 1];
+    }
+}
+
+template<typename _impl>
+inline quint16 readBE16(const quint8 *ptr)
+{
+    return quint16((ptr[0] << 8) | ptr[1]);
+}
+
+template<typename _impl>
+inline void writeBE16(quint8 *ptr, quint16 value)
+{
+    ptr[0] = quint8(value >> 8);
+    ptr[1] = quint8(value & 0xff);
+}
+
+template<typename _impl>
+inline void encodeDelta16(quint8 *row, int end)
+{
+    for (int i = end - 1; i > 0; i--) {
+        writeBE16<_impl>(row + 2 * i,
+                         quint16(readBE16<_impl>(row + 2 * i) - readBE16<_impl>(row + 2 * (i - 1))));
+    }
+}
+
+template<typename _impl>
+inline void decodeDelta16(quint8 *row, int start, int numValues)
+{
+    for (int i = qMax(1, start); i < numValues; i++) {
+        writeBE16<_impl>(row + 2 * i,
+                         quint16(readBE16<_impl>(row + 2 * i) + readBE16<_impl>(row + 2 * (i - 1))));
+    }
+}
+
+} // namespace KisPsdCodecKernelsScalar
+
+template<typename _impl, typename EnableDummyType = void>
+class KisPsdCodecKernels : public KisPsdCodecKernelsBase
+{
+public:
+    int countRepeatedBytes(const quint8 *src, int maxLength) const override
+    {
+        return KisPsdCodecKernelsScalar::countRepeatedBytes<_impl>(src, 0, maxLength);
+    }
+
+    int findTripleRun(const quint8 *src, int maxLength) const override
+    {
+        return KisPsdCodecKernelsScalar::findTripleRun<_impl>(src, 0, maxLength);
+    }
+
+    void encodeDelta8(quint8 *row, int length) const override
+    {
+        KisPsdCodecKernelsScalar::encodeDelta8<_impl>(row, length);
+    }
+
+    void decodeDelta8(quint8 *row, int length) const override
+    {
+        KisPsdCodecKernelsScalar::decodeDelta8<_impl>(row, 1, length);
+    }
+
+    void encodeDelta16(quint8 *row, int numValues) const override
+    {
+        KisPsdCodecKernelsScalar::encodeDelta16<_impl>(row, numValues);
+    }
+
+    void decodeDelta16(quint8 *row, int numValues) const override
+    {
+        KisPsdCodecKernelsScalar::decodeDelta16<_impl>(row, 1, numValues);
+    }
+};
+
+#if defined(HAVE_XSIMD) && !defined(XSIMD_NO_SUPPORTED_ARCHITECTURE)
+
+template<typename _impl>
+class KisPsdCodecKernels<_impl, typename std::enable_if<!std::is_same<_impl, xsimd::generic>::value>::type>
+    : public KisPsdCodecKernelsBase
+{
+    using uint8_v = xsimd::batch<uint8_t, _impl>;
+    using uint16_v = xsimd::batch<uint16_t, _impl>;
+
+    static constexpr int bytesPerVector = static_cast<int>(uint8_v::size);
+    static constexpr int valuesPerVector = static_cast<int>(uint16_v::size);
+
+public:
+    int countRepeatedBytes(const quint8 *src, int maxLength) const override
+    {
+        const uint8_v value(src[0]);
+
+        int i = 0;
+        for (; i + bytesPerVector <= maxLength; i += bytesPerVector) {
+            if (!xsimd::all(uint8_v::load_unaligned(src + i) == value)) break;
+        }
+
+        return KisPsdCodecKernelsScalar::countRepeatedBytes<_impl>(src, i, maxLength);
+    }
+
+    int findTripleRun(const quint8 *src, int maxLength) const override
+    {
+        int i = 0;
+        for (; i + bytesPerVector <= maxLength; i += bytesPerVector) {
+            const uint8_v a = uint8_v::load_unaligned(src + i);
+            const uint8_v b = uint8_v::load_unaligned(src + i + 1);
+            const uint8_v c = uint8_v::load_unaligned(src + i + 2);
+
+            if (xsimd::any((a == b) & (a == c))) break;
+        }
+
+        return KisPsdCodecKernelsScalar::findTripleRun<_impl>(src, i, maxLength);
+    }
+
+    void encodeDelta8(quint8 *row, int length) const override
+    {
+        // go backwards so that every byte is subtracted from its original neighbour
+        int i = length - bytesPerVector;
+        for (; i >= 1; i -= bytesPerVector) {
+            const uint8_v cur = uint8_v::load_unaligned(row + i);
+            const uint8_v prev = uint8_v::load_unaligned(row + i - 1);
+            (cur - prev).store_unaligned(row + i);
+        }
+
+        KisPsdCodecKernelsScalar::encodeDelta8<_impl>(row, i + bytesPerVector);
+    }
+
+    void decodeDelta8(quint8 *row, int length) const override
+    {
+        if (length <= 0) return;
+
+        int i = 1;
+        for (; i + bytesPerVector <= length; i += bytesPerVector) {
+            uint8_v value = uint8_v::load_unaligned(row + i);
+            value = prefixSum<1>(value) + uint8_v(row[i - 1]);
+            value.store_unaligned(row + i);
+        }
+
+        KisPsdCodecKernelsScalar::decodeDelta8<_impl>(row, i, length);
+    }
+
+    void encodeDelta16(quint8 *row, int numValues) const override
+    {
+        int i = numValues - valuesPerVector;
+        for (; i >= 1; i -= valuesPerVector) {
+            const uint16_v cur = swapBytes(uint16_v::load_unaligned(reinterpret_cast<const uint16_t*>(row + 2 * i)));
+            const uint16_v prev = swapBytes(uint16_v::load_unaligned(reinterpret_cast<const uint16_t*>(row + 2 * (i - 1))));
+            swapBytes(cur - prev).store_unaligned(reinterpret_cast<uint16_t*>(row + 2 * i));
+        }
+
+        KisPsdCodecKernelsScalar::encodeDelta16<_impl>(row, i + valuesPerVector);
+    }
+
+    void decodeDelta16(quint8 *row, int numValues) const override
+    {
+        if (numValues <= 0) return;
+
+        int i = 1;
+        for (; i + valuesPerVector <= numValues; i += valuesPerVector) {
+            uint16_v value = swapBytes(uint16_v::load_unaligned(reinterpret_cast<const uint16_t*>(row + 2 * i)));
+            value = prefixSum<2>(value) + uint16_v(KisPsdCodecKernelsScalar::readBE16<_impl>(row + 2 * (i - 1)));
+            swapBytes(value).store_unaligned(reinterpret_cast<uint16_t*>(row + 2 * i));
+        }
+
+        KisPsdCodecKernelsScalar::decodeDelta16<_impl>(row, i, numValues);
+    }
+
+private:
+    /**
+     * In-register inclusive prefix sum (Hillis-Steele scan). The shift
+     * of xsimd::slide_left() is measured in bytes.
+     */
+    template<size_t shift, typename batch_type>
+    static ALWAYS_INLINE batch_type prefixSum(batch_type value)
+    {
+        if constexpr (shift < batch_type::size * sizeof(typename batch_type::value_type)) {
+            value += xsimd::slide_left<shift>(value);
+            return prefixSum<shift * 2>(value);
+        } else {
+            return value;
+        }
+    }
+
+    static ALWAYS_INLINE uint16_v swapBytes(const uint16_v &value)
+    {
+        return (value << 8) | (value >> 8);
+    }
+};
+
+#endif /* HAVE_XSIMD */
+
+#endif // KISPSDCODECKERNELS_H
@@ -0,0 +1,59 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISPSDCODECKERNELSBASE_H
+#define KISPSDCODECKERNELSBASE_H
+
+#include "kritapsdutils_export.h"
+
+#include <QtGlobal>
+
+/**
+ * The inner loops of the PackBits (RLE) codec and of the delta predictor
+ * used by ZIP-with-prediction compression of PSD channels. The loops are
+ * vectorized for every supported architecture, \see KisPsdCodecKernels
+ */
+class KRITAPSDUTILS_EXPORT KisPsdCodecKernelsBase
+{
+public:
+    virtual ~KisPsdCodecKernelsBase();
+
+    /**
+     * @return the number of leading bytes of \p src that are equal
+     *         to src[0], but not more than \p maxLength
+     */
+    virtual int countRepeatedBytes(const quint8 *src, int maxLength) const = 0;
+
+    /**
+     * @return the first position i < \p maxLength, where three equal bytes
+     *         start, i.e. src[i] == src[i + 1] == src[i + 2], or \p maxLength
+     *         if there is no such position. Reads up to src[maxLength + 1].
+     */
+    virtual int findTripleRun(const quint8 *src, int maxLength) const = 0;
+
+    /**
+     * Replaces every byte of the row with the difference between the
+     * byte and the preceding one (the first byte is kept as it is)
+     */
+    virtual void encodeDelta8(quint8 *row, int length) const = 0;
+
+    /**
+     * The reverse of encodeDelta8(), i.e. the running sum of the row
+     */
+    virtual void decodeDelta8(quint8 *row, int length) const = 0;
+
+    /**
+     * The same as encodeDelta8(), but for big endian 16-bit values
+     */
+    virtual void encodeDelta16(quint8 *row, int numValues) const = 0;
+
+    /**
+     * The same as decodeDelta8(), but for big endian 16-bit values
+     */
+    virtual void decodeDelta16(quint8 *row, int numValues) const = 0;
+};
+
+#endif // KISPSDCODECKERNELSBASE_H
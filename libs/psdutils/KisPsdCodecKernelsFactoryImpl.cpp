@@ -0,0 +1,19 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisPsdCodecKernelsFactoryImpl.h"
+
+#if XSIMD_UNIVERSAL_BUILD_PASS
+#include "KisPsdCodecKernels.h"
+
+template<>
+KisPsdCodecKernelsBase *
+KisPsdCodecKernelsFactoryImpl::create<xsimd::current_arch>()
+{
+    return new KisPsdCodecKernels<xsimd::current_arch>();
+}
+
+#endif // XSIMD_UNIVERSAL_BUILD_PASS
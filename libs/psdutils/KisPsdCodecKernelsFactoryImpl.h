@@ -0,0 +1,20 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISPSDCODECKERNELSFACTORYIMPL_H
+#define KISPSDCODECKERNELSFACTORYIMPL_H
+
+#include <KisPsdCodecKernelsBase.h>
+#include <KoMultiArchBuildSupport.h>
+
+class KRITAPSDUTILS_EXPORT KisPsdCodecKernelsFactoryImpl
+{
+public:
+    template<typename _impl>
+    static KisPsdCodecKernelsBase* create();
+};
+
+#endif // KISPSDCODECKERNELSFACTORYIMPL_H
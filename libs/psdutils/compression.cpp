@@ -10,6 +10,7 @@
 #include "compression.h"
 
 #include <QBuffer>
+#include <QScopedPointer>
 #include <QtEndian>
 #include <algorithm>
 #include <zlib.h>
@@ -17,41 +18,60 @@
 #include <kis_debug.h>
 #include <psd_utils.h>
 
+#include "KisPsdCodecKernelsFactoryImpl.h"
+
+namespace
+{
+const KisPsdCodecKernelsBase *codecKernels()
+{
+    static const QScopedPointer<KisPsdCodecKernelsBase> kernels(
+        createOptimizedClass<KisPsdCodecKernelsFactoryImpl>());
+    return kernels.data();
+}
+} // namespace
+
 namespace KisRLE
 {
 // from gimp's psd-save.c
 int compress(const QByteArray &src, QByteArray &dst)
 {
+    const KisPsdCodecKernelsBase *kernels = codecKernels();
+
     int length = src.size();
     dst.resize(length * 2);
-    dst.fill(0, length * 2);
 
     int remaining = length;
-    quint8 i, j;
+    int i, j;
     quint32 dest_ptr = 0;
-    const char *start = src.constData();
+    const quint8 *start = reinterpret_cast<const quint8 *>(src.constData());
+    char *dstPtr = dst.data();
 
     length = 0;
     while (remaining > 0) {
         /* Look for characters matching the first */
-        i = 0;
-        while ((i < 128) && (remaining - i > 0) && (start[0] == start[i]))
-            i++;
+        i = kernels->countRepeatedBytes(start, qMin(128, remaining));
 
         if (i > 1) /* Match found */
         {
-            dst[dest_ptr++] = static_cast<char>(-(i - 1));
-            dst[dest_ptr++] = *start;
+            dstPtr[dest_ptr++] = static_cast<char>(-(i - 1));
+            dstPtr[dest_ptr++] = static_cast<char>(*start);
 
             start += i;
             remaining -= i;
             length += 2;
         } else { /* Look for characters different from the previous */
-            i = 0;
-            while ((i < 128) && (remaining - (i + 1) > 0) && (start[i] != start[(i + 1)] || remaining - (i + 2) <= 0 || start[i] != start[(i + 2)]))
-                i++;
+            /**
+             * Stop right before three equal characters, which are better
+             * encoded as a run. The last two characters can't start a run,
+             * so they are always taken as they are.
+             */
+            const int tripleLimit = qMax(0, qMin(128, remaining - 2));
+            i = kernels->findTripleRun(start, tripleLimit);
+            if (i == tripleLimit) {
+                i = qMin(128, remaining - 1);
+            }
 
-            /* If there's only 1 remaining, the previous WHILE stmt doesn't
+            /* If there's only 1 remaining, the previous statement doesn't
              catch it */
 
             if (remaining == 1) {
@@ -60,9 +80,9 @@ int compress(const QByteArray &src, QByteArray &dst)
 
             if (i > 0) /* Some distinct ones found */
             {
-                dst[dest_ptr++] = static_cast<char>(i - 1U);
+                dstPtr[dest_ptr++] = static_cast<char>(i - 1U);
                 for (j = 0; j < i; j++) {
-                    dst[dest_ptr++] = start[j];
+                    dstPtr[dest_ptr++] = static_cast<char>(start[j]);
                 }
                 start += i;
                 remaining -= i;
@@ -242,43 +262,30 @@ int psd_unzip_without_prediction(const char *src, int packed_len, char *dst, int
     return static_cast<int>(stream.total_out);
 }
 
-template<typename T>
-inline void psd_unzip_with_prediction(QByteArray &dst_buf, int row_size);
-
-template<>
-inline void psd_unzip_with_prediction<uint8_t>(QByteArray &dst_buf, const int row_size)
-{
-    auto *buf = reinterpret_cast<uint8_t *>(dst_buf.data());
-    int len = 0;
-    int dst_len = dst_buf.size();
-
-    while (dst_len > 0) {
-        len = row_size;
-        while (--len) {
-            *(buf + 1) += *buf;
-            buf++;
-        }
-        buf++;
-        dst_len -= row_size;
-    }
-}
-
-template<>
-inline void psd_unzip_with_prediction<uint16_t>(QByteArray &dst_buf, const int row_size)
+/**
+ * Converts the values of every row into the differences with the preceding
+ * value (\p encode == true) or back. The rows are \p row_size values long,
+ * the values are big endian.
+ */
+void applyPrediction(QByteArray &buf, int row_size, int bytesPerValue, bool encode)
 {
-    auto *buf = reinterpret_cast<uint8_t *>(dst_buf.data());
-    int len = 0;
-    int dst_len = dst_buf.size();
-
-    while (dst_len > 0) {
-        len = row_size;
-        while (--len) {
-            buf[2] += buf[0] + ((buf[1] + buf[3]) >> 8);
-            buf[3] += buf[1];
-            buf += 2;
+    const KisPsdCodecKernelsBase *kernels = codecKernels();
+    const int rowBytes = row_size * bytesPerValue;
+    auto *data = reinterpret_cast<quint8 *>(buf.data());
+
+    for (int offset = 0; offset < buf.size(); offset += rowBytes) {
+        const int numValues = qMin(rowBytes, buf.size() - offset) / bytesPerValue;
+        quint8 *row = data + offset;
+
+        if (bytesPerValue == 2 && encode) {
+            kernels->encodeDelta16(row, numValues);
+        } else if (bytesPerValue == 2) {
+            kernels->decodeDelta16(row, numValues);
+        } else if (encode) {
+            kernels->encodeDelta8(row, numValues);
+        } else {
+            kernels->decodeDelta8(row, numValues);
         }
-        buf += 2;
-        dst_len -= row_size * 2;
     }
 }
 
@@ -293,12 +300,13 @@ QByteArray psd_unzip_with_prediction(const QByteArray &src, int dst_len, int row
         // Placeholded for future implementation.
         errKrita << "Unsupported bit depth for prediction";
         return {};
-    } else if (color_depth == 16) {
-        psd_unzip_with_prediction<quint16>(dst_buf, row_size);
-    } else {
-        psd_unzip_with_prediction<quint8>(dst_buf, row_size);
+    } else if (row_size <= 0) {
+        errKrita << "Invalid row size for prediction" << row_size;
+        return {};
     }
 
+    applyPrediction(dst_buf, row_size, color_depth == 16 ? 2 : 1, false);
+
     return dst_buf;
 }
 
@@ -306,46 +314,6 @@ QByteArray psd_unzip_with_prediction(const QByteArray &src, int dst_len, int row
 /* End of third party block                                           */
 /**********************************************************************/
 
-template<typename T>
-inline void psd_zip_with_prediction(QByteArray &dst_buf, int row_size);
-
-template<>
-inline void psd_zip_with_prediction<uint8_t>(QByteArray &dst_buf, const int row_size)
-{
-    auto *buf = reinterpret_cast<uint8_t *>(dst_buf.data());
-    int len = 0;
-    int dst_len = dst_buf.size();
-
-    while (dst_len > 0) {
-        len = row_size;
-        while (--len) {
-            *(buf + 1) -= *buf;
-            buf++;
-        }
-        buf++;
-        dst_len -= row_size;
-    }
-}
-
-template<>
-inline void psd_zip_with_prediction<uint16_t>(QByteArray &dst_buf, const int row_size)
-{
-    auto *buf = reinterpret_cast<uint8_t *>(dst_buf.data());
-    int len = 0;
-    int dst_len = dst_buf.size();
-
-    while (dst_len > 0) {
-        len = row_size;
-        while (--len) {
-            buf[2] -= buf[0] + ((buf[1] + buf[3]) >> 8);
-            buf[3] -= buf[1];
-            buf += 2;
-        }
-        buf += 2;
-        dst_len -= row_size * 2;
-    }
-}
-
 QByteArray psd_zip_with_prediction(const QByteArray &src, int row_size, int color_depth)
 {
     QByteArray dst_buf(src);
@@ -353,12 +321,13 @@ QByteArray psd_zip_with_prediction(const QByteArray &src, int row_size, int colo
         // Placeholded for future implementation.
         errKrita << "Unsupported bit depth for prediction";
         return {};
-    } else if (color_depth == 16) {
-        psd_zip_with_prediction<quint16>(dst_buf, row_size);
-    } else {
-        psd_zip_with_prediction<quint8>(dst_buf, row_size);
+    } else if (row_size <= 0) {
+        errKrita << "Invalid row size for prediction" << row_size;
+        return {};
     }
 
+    applyPrediction(dst_buf, row_size, color_depth == 16 ? 2 : 1, true);
+
     return Compression::compress(dst_buf, psd_compression_type::ZIP);
 }
 
@@ -11,6 +11,7 @@
 #include <QCoreApplication>
 #include <QDataStream>
 #include <cmath>
+#include <random>
 #include <klocalizedstring.h>
 
 #include <compression.h>
@@ -89,4 +90,133 @@ void CompressionTest::testCompressionUncompressed()
     QVERIFY(qstrcmp(ba, uncompressed) == 0);
 }
 
+namespace
+{
+// the original scalar encoder from gimp's psd-save.c
+QByteArray referenceRLECompress(const QByteArray &src)
+{
+    QByteArray dst;
+    int remaining = src.size();
+    const char *start = src.constData();
+
+    while (remaining > 0) {
+        int i = 0;
+        while ((i < 128) && (remaining - i > 0) && (start[0] == start[i]))
+            i++;
+
+        if (i > 1) {
+            dst.append(static_cast<char>(-(i - 1)));
+            dst.append(*start);
+            start += i;
+            remaining -= i;
+        } else {
+            i = 0;
+            while ((i < 128) && (remaining - (i + 1) > 0) && (start[i] != start[(i + 1)] || remaining - (i + 2) <= 0 || start[i] != start[(i + 2)]))
+                i++;
+
+            if (remaining == 1) {
+                i = 1;
+            }
+
+            dst.append(static_cast<char>(i - 1));
+            dst.append(start, i);
+            start += i;
+            remaining -= i;
+        }
+    }
+
+    return dst;
+}
+
+/**
+ * Generates data with runs and literal sequences of all lengths, so
+ * that both the vectorized loops and their tails are covered
+ */
+QByteArray generateRunsData(int size)
+{
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> length(1, 300);
+    std::uniform_int_distribution<int> value(0, 255);
+
+    QByteArray ba;
+    while (ba.size() < size) {
+        const int runLength = length(gen);
+        if (value(gen) < 128) {
+            ba.append(QByteArray(runLength, static_cast<char>(value(gen))));
+        } else {
+            for (int i = 0; i < runLength; i++) {
+                ba.append(static_cast<char>(value(gen)));
+            }
+        }
+    }
+    ba.resize(size);
+    return ba;
+}
+} // namespace
+
+void CompressionTest::testCompressionRLELongRuns()
+{
+    for (int size = 1; size < 100; size++) {
+        const QByteArray ba = generateRunsData(size);
+        const QByteArray compressed = Compression::compress(ba, psd_compression_type::RLE);
+        QCOMPARE(compressed, referenceRLECompress(ba));
+        QCOMPARE(Compression::uncompress(ba.size(), compressed, psd_compression_type::RLE), ba);
+    }
+
+    const QByteArray ba = generateRunsData(100003);
+    const QByteArray compressed = Compression::compress(ba, psd_compression_type::RLE);
+    QCOMPARE(compressed, referenceRLECompress(ba));
+    QCOMPARE(Compression::uncompress(ba.size(), compressed, psd_compression_type::RLE), ba);
+}
+
+void CompressionTest::testCompressionZIPWithPrediction_data()
+{
+    QTest::addColumn<int>("colorDepth");
+    QTest::addColumn<int>("rowSize");
+
+    QTest::newRow("8bit-1") << 8 << 1;
+    QTest::newRow("8bit-1027") << 8 << 1027;
+    QTest::newRow("16bit-1") << 16 << 1;
+    QTest::newRow("16bit-1027") << 16 << 1027;
+}
+
+void CompressionTest::testCompressionZIPWithPrediction()
+{
+    QFETCH(int, colorDepth);
+    QFETCH(int, rowSize);
+
+    const int numRows = 17;
+    const int bytesPerValue = colorDepth / 8;
+    const QByteArray ba = generateRunsData(rowSize * numRows * bytesPerValue);
+
+    const QByteArray compressed = Compression::compress(ba, psd_compression_type::ZIPWithPrediction, rowSize, colorDepth);
+    QVERIFY(compressed.size() > 0);
+
+    // the predicted data must be the difference with the preceding big endian value
+    const QByteArray predicted = Compression::uncompress(ba.size(), compressed, psd_compression_type::ZIP);
+    QCOMPARE(predicted.size(), ba.size());
+
+    for (int row = 0; row < numRows; row++) {
+        const quint8 *src = reinterpret_cast<const quint8 *>(ba.constData()) + row * rowSize * bytesPerValue;
+        const quint8 *dst = reinterpret_cast<const quint8 *>(predicted.constData()) + row * rowSize * bytesPerValue;
+
+        for (int i = 0; i < rowSize; i++) {
+            quint16 value = bytesPerValue == 2 ? quint16((src[2 * i] << 8) | src[2 * i + 1]) : src[i];
+            const quint16 result = bytesPerValue == 2 ? quint16((dst[2 * i] << 8) | dst[2 * i + 1]) : dst[i];
+
+            if (i > 0) {
+                value -= bytesPerValue == 2 ? quint16((src[2 * (i - 1)] << 8) | src[2 * (i - 1) + 1]) : src[i - 1];
+                if (bytesPerValue == 1) {
+                    value &= 0xff;
+                }
+            }
+
+            QCOMPARE(result, value);
+        }
+    }
+
+    const QByteArray uncompressed = Compression::uncompress(ba.size(), compressed, psd_compression_type::ZIPWithPrediction, rowSize, colorDepth);
+    QCOMPARE(uncompressed, ba);
+}
+
 SIMPLE_TEST_MAIN(CompressionTest)
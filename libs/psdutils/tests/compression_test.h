@@ -17,6 +17,9 @@ private Q_SLOTS:
     void testCompressionRLE();
     void testCompressionZIP();
     void testCompressionUncompressed();
+    void testCompressionRLELongRuns();
+    void testCompressionZIPWithPrediction_data();
+    void testCompressionZIPWithPrediction();
 };
 
 #endif
@@ -34,6 +34,8 @@ struct KoQuaZipStore::Private {
     QStringList directoryListCache;
     bool directoryListCached {false};
     int compressionLevel {Z_DEFAULT_COMPRESSION};
+    /// the current entry is STORED and written into the archive directly
+    bool writingStoredEntry {false};
     bool usingSaveFile {false};
     QByteArray cache;
     QBuffer buffer;
@@ -104,7 +106,19 @@ qint64 KoQuaZipStore::write(const char *_data, qint64 _len)
         return 0;
     }
 
-    qint64 nwritten = dd->buffer.write(_data, _len);
+    /**
+     * STORED entries don't need the data to be deflated in one chunk,
+     * so the data goes right into the archive without copying it into
+     * the cache first
+     */
+    qint64 nwritten = dd->writingStoredEntry ?
+        dd->currentFile->write(_data, _len) :
+        dd->buffer.write(_data, _len);
+
+    if (nwritten < 0) {
+        return nwritten;
+    }
+
     d->size += nwritten;
     return nwritten;
 }
@@ -189,7 +203,16 @@ bool KoQuaZipStore::openWrite(const QString &name)
     dd->currentFile = new QuaZipFile(dd->archive);
     QuaZipNewInfo newInfo(fixedPath);
     newInfo.setPermissions(QFileDevice::ReadOwner | QFileDevice::ReadGroup | QFileDevice::ReadOther);
-    bool r = dd->currentFile->open(QIODevice::WriteOnly, newInfo, 0, 0, Z_DEFLATED, dd->compressionLevel);
+
+    /**
+     * When the compression is disabled, the entry is saved with STORED
+     * method instead of deflating it with zero compression level, which
+     * would still pass all the data through zlib
+     */
+    dd->writingStoredEntry = dd->compressionLevel == Z_NO_COMPRESSION;
+    const int method = dd->writingStoredEntry ? 0 : Z_DEFLATED;
+
+    bool r = dd->currentFile->open(QIODevice::WriteOnly, newInfo, 0, 0, method, dd->compressionLevel);
     if (!r) {
         qWarning() << "Could not open" << name << dd->currentFile->getZipError();
     }
@@ -241,7 +264,7 @@ bool KoQuaZipStore::closeWrite()
     Q_D(KoStore);
 
     bool r = true;
-    if (dd->currentFile->write(dd->cache) != dd->cache.size()) {
+    if (!dd->writingStoredEntry && dd->currentFile->write(dd->cache) != dd->cache.size()) {
         // write() returns number of bytes written, or -1 in case of error
         // let's allow write 0 bytes in the cache, when needed
         qWarning() << "Could not write buffer to the file";
@@ -249,6 +272,7 @@ bool KoQuaZipStore::closeWrite()
     }
     dd->buffer.close();
     dd->currentFile->close();
+    dd->writingStoredEntry = false;
     d->stream = 0;
     return (r && dd->currentFile->getZipError() == ZIP_OK);
 }
@@ -213,7 +213,18 @@ public:
 
     /**
      * Allow to enable or disable compression of the files. Only supported by the
-     * ZIP backend.
+     * ZIP backend. The value is applied to the files opened after the call, so
+     * it can be changed for every file separately.
+     *
+     * The ZIP backend saves the files with disabled compression using the
+     * STORED method and passes the data written by the caller into the archive
+     * directly, without copying it into an intermediate buffer of the store.
+     * Use it for the data that is already compressed, e.g. the tiles of the
+     * layers or PNG images.
+     *
+     * NOTE: the store doesn't buffer such files, but the caller still may do
+     *       that, e.g. KisKraSaveVisitor encodes the layers into memory
+     *       before writing them.
      */
     virtual void setCompressionEnabled(bool e);
 
@@ -2089,6 +2089,26 @@ void KisConfig::setTrimKra(bool trim)
     m_cfg.writeEntry("TrimKra", trim);
 }
 
+bool KisConfig::saveKeyframesAsDeltas(bool defaultValue) const
+{
+    return (defaultValue ? false : m_cfg.readEntry("SaveKeyframesAsDeltas", false));
+}
+
+void KisConfig::setSaveKeyframesAsDeltas(bool value)
+{
+    m_cfg.writeEntry("SaveKeyframesAsDeltas", value);
+}
+
+int KisConfig::kraMergedImageCompression(bool defaultValue) const
+{
+    return (defaultValue ? 1 : qBound(0, m_cfg.readEntry("KraMergedImageCompression", 1), 9));
+}
+
+void KisConfig::setKraMergedImageCompression(int level)
+{
+    m_cfg.writeEntry("KraMergedImageCompression", level);
+}
+
 bool KisConfig::trimFramesImport(bool defaultValue) const
 {
     return (defaultValue ? false : m_cfg.readEntry("TrimFramesImport", false));
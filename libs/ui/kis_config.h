@@ -567,6 +567,23 @@ public:
     bool trimKra(bool defaultValue = false) const;
     void setTrimKra(bool trim);
 
+    /**
+     * Save the keyframes of the animated layers into .kra files as
+     * differences with the previous keyframe. Such files cannot be
+     * opened by the versions of Krita that don't support the deltas,
+     * so it is disabled by default.
+     */
+    bool saveKeyframesAsDeltas(bool defaultValue = false) const;
+    void setSaveKeyframesAsDeltas(bool value);
+
+    /**
+     * zlib compression level of the merged image saved into .kra files,
+     * the image is only used by other applications, so a fast level is
+     * used by default
+     */
+    int kraMergedImageCompression(bool defaultValue = false) const;
+    void setKraMergedImageCompression(int level);
+
     bool trimFramesImport(bool defaultValue = false) const;
     void setTrimFramesImport(bool trim);
 
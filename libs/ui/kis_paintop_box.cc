@@ -76,6 +76,7 @@
 #include "kis_action_manager.h"
 #include "KisHighlightedToolButton.h"
 #include <KisGlobalResourcesInterface.h>
+#include <KisBrushDabCache.h>
 #include "KisResourceLoader.h"
 #include "KisResourceLoaderRegistry.h"
 #include "kis_acyclic_signal_connector.h"
@@ -671,6 +672,14 @@ void KisPaintopBox::setCurrentPaintop(KisPaintOpPresetSP preset)
     if (m_resourceProvider->currentPreset()) {
         m_resourceProvider->setPreviousPaintOpPreset(m_resourceProvider->currentPreset());
 
+        /**
+         * The dabs of the previous preset will hardly be reused, so
+         * free the budget of the global dab cache for the new one
+         */
+        if (m_resourceProvider->currentPreset() != preset) {
+            KisBrushDabCache::instance()->clear();
+        }
+
         if (m_optionWidget) {
             m_optionWidget->hide();
         }
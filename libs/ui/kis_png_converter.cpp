@@ -22,9 +22,17 @@
 #include <stdio.h>
 #include <zlib.h>
 
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <vector>
+
 #include <QBuffer>
 #include <QFile>
 #include <QApplication>
+#include <QThread>
+#include <QtConcurrent>
+#include <QtEndian>
 
 #include <klocalizedstring.h>
 #include <QUrl>
@@ -56,6 +64,7 @@
 #include <kis_transaction.h>
 
 #include <kis_assert.h>
+#include <KisRowBandReader.h>
 
 namespace
 {
@@ -410,6 +419,317 @@ void _flush_fn(png_structp png_ptr)
     Q_UNUSED(png_ptr);
 }
 
+namespace
+{
+
+/**
+ * Writes the IDAT stream of a non-interlaced image the way pigz does:
+ * the rows are split into strips that are filtered and deflated
+ * concurrently. Every strip uses the tail of the preceding data as a
+ * preset dictionary, so the compression ratio stays close to the one of
+ * a single stream. All the strips except the last one are terminated
+ * with a sync flush, which makes them byte-aligned and lets us just
+ * concatenate them into one valid zlib stream. The checksum of the
+ * stream is combined from the checksums of the strips.
+ *
+ * The rows are requested from \p fillRow in sequential order right before
+ * the strips that need them are encoded, and only the rows of the current
+ * batch of strips are kept in memory. The callback should write the
+ * samples in the network byte order.
+ */
+class KisPNGStripEncoder
+{
+public:
+    using FillRowFunc = std::function<bool(int row, png_byte *dst)>;
+
+    KisPNGStripEncoder(FillRowFunc fillRow, int numRows, size_t rowSize,
+                       int bytesPerPixel, bool useFilters, int compressionLevel)
+        : m_fillRow(fillRow),
+          m_rows(numRows),
+          m_numRows(numRows),
+          m_rowSize(rowSize),
+          m_bytesPerPixel(bytesPerPixel),
+          m_useFilters(useFilters),
+          m_compressionLevel(compressionLevel)
+    {
+    }
+
+    /**
+     * Writes IDAT and IEND chunks of the image. Should be called right after
+     * png_write_info(), png_write_end() should **not** be called afterwards.
+     */
+    bool writeImage(png_structp png_ptr)
+    {
+        KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(m_numRows > 0, false);
+
+        const size_t filteredRowSize = m_rowSize + 1;
+        const int rowsPerStrip = qMax(1, int(StripSize / filteredRowSize));
+        const int numStrips = (m_numRows + rowsPerStrip - 1) / rowsPerStrip;
+
+        /**
+         * Keep only a limited number of compressed strips in memory at a
+         * time, the whole compressed image may be huge
+         */
+        const int stripsPerBatch = qMax(1, QThread::idealThreadCount()) * 4;
+
+        uLong checksum = adler32(0L, Z_NULL, 0);
+
+        for (int batchStart = 0; batchStart < numStrips; batchStart += stripsPerBatch) {
+            const int batchEndRow = qMin(m_numRows, (batchStart + stripsPerBatch) * rowsPerStrip);
+            if (!prepareRows(batchStart * rowsPerStrip, batchEndRow)) return false;
+
+            QVector<Strip> strips;
+
+            for (int i = batchStart; i < qMin(numStrips, batchStart + stripsPerBatch); i++) {
+                Strip strip;
+                strip.firstRow = i * rowsPerStrip;
+                strip.numRows = qMin(rowsPerStrip, m_numRows - strip.firstRow);
+                strip.isLast = i == numStrips - 1;
+                strips.append(strip);
+            }
+
+            QtConcurrent::blockingMap(strips, [this] (Strip &strip) { encodeStrip(strip); });
+
+            for (Strip &strip : strips) {
+                if (!strip.isValid) return false;
+
+                checksum = adler32_combine(checksum, strip.checksum, z_off_t(strip.numRows * filteredRowSize));
+
+                if (strip.firstRow == 0) {
+                    strip.data.prepend(zlibHeader());
+                }
+
+                if (strip.isLast) {
+                    strip.data.append(char((checksum >> 24) & 0xff));
+                    strip.data.append(char((checksum >> 16) & 0xff));
+                    strip.data.append(char((checksum >> 8) & 0xff));
+                    strip.data.append(char(checksum & 0xff));
+                }
+
+                png_write_chunk(png_ptr, reinterpret_cast<png_const_bytep>("IDAT"),
+                                reinterpret_cast<png_const_bytep>(strip.data.constData()),
+                                size_t(strip.data.size()));
+            }
+        }
+
+        png_write_chunk(png_ptr, reinterpret_cast<png_const_bytep>("IEND"), nullptr, 0);
+        png_write_flush(png_ptr);
+
+        return true;
+    }
+
+private:
+    struct Strip {
+        int firstRow = 0;
+        int numRows = 0;
+        bool isLast = false;
+
+        QByteArray data;
+        uLong checksum = 0;
+        bool isValid = false;
+    };
+
+    static constexpr size_t StripSize = 512 * 1024;
+    static constexpr size_t DictionarySize = 32 * 1024;
+
+    int numDictionaryRows() const
+    {
+        const size_t filteredRowSize = m_rowSize + 1;
+        return int((DictionarySize + filteredRowSize - 1) / filteredRowSize);
+    }
+
+    /**
+     * Makes sure rows [firstRow, endRow) are available for the strips
+     * together with the rows needed to filter their dictionaries, and
+     * releases the rows nobody needs anymore
+     */
+    bool prepareRows(int firstRow, int endRow)
+    {
+        const int firstNeededRow = qMax(0, firstRow - numDictionaryRows() - 1);
+
+        for (; m_numReleasedRows < firstNeededRow; m_numReleasedRows++) {
+            m_rows[m_numReleasedRows].reset();
+        }
+
+        for (; m_numFilledRows < endRow; m_numFilledRows++) {
+            m_rows[m_numFilledRows].reset(new png_byte[m_rowSize]);
+            if (!m_fillRow(m_numFilledRows, m_rows[m_numFilledRows].get())) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    QByteArray zlibHeader() const
+    {
+        // deflate with 32K window, FLEVEL is chosen the same way zlib does
+        const int level = m_compressionLevel < 0 ? 6 : m_compressionLevel;
+        const int flevel = level < 2 ? 0 : level < 6 ? 1 : level == 6 ? 2 : 3;
+
+        int header = (0x78 << 8) | (flevel << 6);
+        header += 31 - header % 31;
+
+        QByteArray result;
+        result.append(char(header >> 8));
+        result.append(char(header & 0xff));
+        return result;
+    }
+
+    static inline int paethPredictor(int a, int b, int c)
+    {
+        const int p = a + b - c;
+        const int pa = qAbs(p - a);
+        const int pb = qAbs(p - b);
+        const int pc = qAbs(p - c);
+
+        return pa <= pb && pa <= pc ? a : pb <= pc ? b : c;
+    }
+
+    static inline png_byte filterValue(int filter, int raw, int left, int up, int upLeft)
+    {
+        switch (filter) {
+        case PNG_FILTER_VALUE_SUB:
+            return png_byte(raw - left);
+        case PNG_FILTER_VALUE_UP:
+            return png_byte(raw - up);
+        case PNG_FILTER_VALUE_AVG:
+            return png_byte(raw - ((left + up) >> 1));
+        case PNG_FILTER_VALUE_PAETH:
+            return png_byte(raw - paethPredictor(left, up, upLeft));
+        default:
+            return png_byte(raw);
+        }
+    }
+
+    /**
+     * Filters the row with the same heuristic libpng uses by default:
+     * the filter with the minimum sum of absolute values of the
+     * (signed) residuals is chosen. \p dst should have space for
+     * the filter type byte.
+     */
+    void filterRow(int row, png_byte *dst) const
+    {
+        const png_byte *raw = m_rows[row].get();
+
+        if (!m_useFilters) {
+            dst[0] = PNG_FILTER_VALUE_NONE;
+            memcpy(dst + 1, raw, m_rowSize);
+            return;
+        }
+
+        const png_byte *prev = row > 0 ? m_rows[row - 1].get() : nullptr;
+
+        auto forEachByte = [&] (auto func) {
+            for (size_t i = 0; i < m_rowSize; i++) {
+                const int left = i >= size_t(m_bytesPerPixel) ? raw[i - m_bytesPerPixel] : 0;
+                const int up = prev ? prev[i] : 0;
+                const int upLeft = prev && i >= size_t(m_bytesPerPixel) ? prev[i - m_bytesPerPixel] : 0;
+                func(i, raw[i], left, up, upLeft);
+            }
+        };
+
+        quint64 sums[PNG_FILTER_VALUE_LAST] = {0, 0, 0, 0, 0};
+
+        forEachByte([&] (size_t, int value, int left, int up, int upLeft) {
+            for (int filter = 0; filter < PNG_FILTER_VALUE_LAST; filter++) {
+                const int residual = filterValue(filter, value, left, up, upLeft);
+                sums[filter] += residual < 128 ? residual : 256 - residual;
+            }
+        });
+
+        const int bestFilter = int(std::min_element(sums, sums + PNG_FILTER_VALUE_LAST) - sums);
+
+        dst[0] = png_byte(bestFilter);
+        forEachByte([&] (size_t i, int value, int left, int up, int upLeft) {
+            dst[i + 1] = filterValue(bestFilter, value, left, up, upLeft);
+        });
+    }
+
+    void encodeStrip(Strip &strip) const
+    {
+        const size_t filteredRowSize = m_rowSize + 1;
+
+        std::vector<png_byte> filtered(strip.numRows * filteredRowSize);
+        for (int i = 0; i < strip.numRows; i++) {
+            filterRow(strip.firstRow + i, filtered.data() + i * filteredRowSize);
+        }
+
+        strip.checksum = adler32(adler32(0L, Z_NULL, 0), filtered.data(), uInt(filtered.size()));
+
+        /**
+         * Filtering is deterministic, so instead of waiting for the
+         * preceding strip we just filter its last rows once more to
+         * get the dictionary
+         */
+        std::vector<png_byte> dictionary;
+        if (strip.firstRow > 0) {
+            const int numRows = qMin(strip.firstRow, numDictionaryRows());
+
+            dictionary.resize(numRows * filteredRowSize);
+            for (int i = 0; i < numRows; i++) {
+                filterRow(strip.firstRow - numRows + i, dictionary.data() + i * filteredRowSize);
+            }
+        }
+
+        z_stream stream;
+        memset(&stream, 0, sizeof(z_stream));
+
+        // negative window bits produce a raw deflate stream without a header
+        if (deflateInit2(&stream, m_compressionLevel, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+            return;
+        }
+
+        if (!dictionary.empty()) {
+            const size_t dictionarySize = qMin(DictionarySize, dictionary.size());
+            deflateSetDictionary(&stream, dictionary.data() + dictionary.size() - dictionarySize, uInt(dictionarySize));
+        }
+
+        strip.data.resize(int(deflateBound(&stream, uLong(filtered.size())) + 16));
+
+        stream.next_in = filtered.data();
+        stream.avail_in = uInt(filtered.size());
+        stream.next_out = reinterpret_cast<Bytef*>(strip.data.data());
+        stream.avail_out = uInt(strip.data.size());
+
+        const int flush = strip.isLast ? Z_FINISH : Z_SYNC_FLUSH;
+
+        forever {
+            const int result = deflate(&stream, flush);
+
+            if (result == Z_STREAM_END ||
+                (!strip.isLast && result == Z_OK && stream.avail_out > 0)) {
+
+                strip.isValid = true;
+                break;
+            }
+
+            if (result != Z_OK || stream.avail_out > 0) break;
+
+            const int written = int(stream.total_out);
+            strip.data.resize(strip.data.size() * 2);
+            stream.next_out = reinterpret_cast<Bytef*>(strip.data.data()) + written;
+            stream.avail_out = uInt(strip.data.size() - written);
+        }
+
+        strip.data.resize(int(stream.total_out));
+        deflateEnd(&stream);
+    }
+
+private:
+    FillRowFunc m_fillRow;
+    std::vector<std::unique_ptr<png_byte[]>> m_rows;
+    int m_numFilledRows = 0;
+    int m_numReleasedRows = 0;
+    int m_numRows;
+    size_t m_rowSize;
+    int m_bytesPerPixel;
+    bool m_useFilters;
+    int m_compressionLevel;
+};
+
+}
+
 KisImportExportErrorCode KisPNGConverter::buildImage(QIODevice* iod)
 {
     dbgFile << "Start decoding PNG File";
@@ -860,32 +1180,10 @@ bool KisPNGConverter::saveDeviceToStore(const QString &filename, const QRect &im
             dbgFile << "Could not open for writing:" << filename;
             return false;
         }
-        KisPNGConverter pngconv(0);
-        vKisAnnotationSP_it annotIt;
-        KisMetaData::Store* metaDataStore = 0;
-        if (metaData) {
-            metaDataStore = new KisMetaData::Store(*metaData);
-        }
-        KisPNGOptions options;
-        options.compression = 3;
-        options.interlace = false;
-        options.tryToSaveAsIndexed = false;
-        options.alpha = true;
-        options.saveSRGBProfile = false;
-        options.downsample = false;
-
-        if (dev->colorSpace()->id() != "RGBA") {
-            dev = new KisPaintDevice(*dev.data());
-            dev->convertTo(KoColorSpaceRegistry::instance()->rgb8());
-        }
-
-        KisImportExportErrorCode success = pngconv.buildFile(&io, imageRect, xRes, yRes, dev, annotIt, annotIt, options, metaDataStore);
-        if (!success.isOk()) {
+        if (!saveDeviceToIODevice(&io, imageRect, xRes, yRes, dev, 3, metaData)) {
             dbgFile << "Saving PNG failed:" << filename;
-            delete metaDataStore;
             return false;
         }
-        delete metaDataStore;
         io.close();
         if (!store->close()) {
             return false;
@@ -898,6 +1196,33 @@ bool KisPNGConverter::saveDeviceToStore(const QString &filename, const QRect &im
 
 }
 
+bool KisPNGConverter::saveDeviceToIODevice(QIODevice *io, const QRect &imageRect, const qreal xRes, const qreal yRes, KisPaintDeviceSP dev, int compression, KisMetaData::Store* metaData)
+{
+    KisPNGConverter pngconv(0);
+    vKisAnnotationSP_it annotIt;
+    KisMetaData::Store* metaDataStore = 0;
+    if (metaData) {
+        metaDataStore = new KisMetaData::Store(*metaData);
+    }
+    KisPNGOptions options;
+    options.compression = compression;
+    options.interlace = false;
+    options.tryToSaveAsIndexed = false;
+    options.alpha = true;
+    options.saveSRGBProfile = false;
+    options.downsample = false;
+
+    if (dev->colorSpace()->id() != "RGBA") {
+        dev = new KisPaintDevice(*dev.data());
+        dev->convertTo(KoColorSpaceRegistry::instance()->rgb8());
+    }
+
+    KisImportExportErrorCode success = pngconv.buildFile(io, imageRect, xRes, yRes, dev, annotIt, annotIt, options, metaDataStore);
+    delete metaDataStore;
+
+    return success.isOk();
+}
+
 
 KisImportExportErrorCode KisPNGConverter::buildFile(const QString &filename, const QRect &imageRect, const qreal xRes, const qreal yRes, KisPaintDeviceSP device, vKisAnnotationSP_it annotationsStart, vKisAnnotationSP_it annotationsEnd, KisPNGOptions options, KisMetaData::Store* metaData)
 {
@@ -918,16 +1243,6 @@ KisImportExportErrorCode KisPNGConverter::buildFile(QIODevice* iodevice, const Q
 {
     KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(device, ImportExportCodes::InternalError);
 
-    if (!options.alpha) {
-        KisPaintDeviceSP tmp = new KisPaintDevice(device->colorSpace());
-        KoColor c(options.transparencyFillColor, device->colorSpace());
-        tmp->fill(imageRect, c);
-        KisPainter gc(tmp);
-        gc.bitBlt(imageRect.topLeft(), device, imageRect);
-        gc.end();
-        device = tmp;
-    }
-
     KIS_SAFE_ASSERT_RECOVER(!options.saveAsHDR || !options.forceSRGB) {
         options.forceSRGB = false;
     }
@@ -962,17 +1277,29 @@ KisImportExportErrorCode KisPNGConverter::buildFile(QIODevice* iodevice, const Q
         }
     }
 
+    const KoColorSpace *dstCs = device->colorSpace();
+
     if (needColorTransform) {
-        const KoColorSpace *dstCs = KoColorSpaceRegistry::instance()->colorSpace(dstModel, dstDepth, dstProfile);
+        dstCs = KoColorSpaceRegistry::instance()->colorSpace(dstModel, dstDepth, dstProfile);
 
         if (!dstCs) {
             return ImportExportCodes::FormatColorSpaceUnsupported;
         }
+    }
+
+    /**
+     * The pixels are flattened and converted in bands of rows right
+     * when they are written, so we never create a converted copy of
+     * the whole image
+     */
+    KisRowBandReader reader(device, imageRect, dstCs);
 
-        device = new KisPaintDevice(*device);
-        device->convertTo(dstCs);
+    if (!options.alpha) {
+        reader.setBackgroundColor(KoColor(options.transparencyFillColor, device->colorSpace()));
     }
 
+    const KoColorSpace *cs = reader.colorSpace();
+
     KIS_SAFE_ASSERT_RECOVER(!options.saveAsHDR || !options.tryToSaveAsIndexed) {
         options.tryToSaveAsIndexed = false;
     }
@@ -1033,41 +1360,43 @@ KisImportExportErrorCode KisPNGConverter::buildFile(QIODevice* iodevice, const Q
     png_set_compression_method(png_ptr, 8);
     png_set_compression_buffer_size(png_ptr, 8192);
 
-    int color_nb_bits = 8 * device->pixelSize() / device->channelCount();
-    int color_type = getColorTypeforColorSpace(device->colorSpace(), options.alpha);
+    int color_nb_bits = 8 * cs->pixelSize() / cs->channelCount();
+    int color_type = getColorTypeforColorSpace(cs, options.alpha);
 
     Q_ASSERT(color_type > -1);
 
     // Try to compute a table of color if the colorspace is RGB8f
     QScopedArrayPointer<png_color> palette;
     int num_palette = 0;
-    if (!options.alpha && options.tryToSaveAsIndexed && KoID(device->colorSpace()->id()) == KoID("RGBA")) { // png doesn't handle indexed images and alpha, and only have indexed for RGB8
+    if (!options.alpha && options.tryToSaveAsIndexed && KoID(cs->id()) == KoID("RGBA")) { // png doesn't handle indexed images and alpha, and only have indexed for RGB8
         palette.reset(new png_color[255]);
 
-        KisSequentialIterator it(device, imageRect);
-
         bool toomuchcolor = false;
-        while (it.nextPixel()) {
-            const quint8* c = it.oldRawData();
-            bool findit = false;
-            for (int i = 0; i < num_palette; i++) {
-                if (palette[i].red == c[2] &&
-                        palette[i].green == c[1] &&
-                        palette[i].blue == c[0]) {
-                    findit = true;
-                    break;
+        for (int y = imageRect.y(); y < imageRect.y() + imageRect.height() && !toomuchcolor; y++) {
+            KisHLineConstIteratorSP it = reader.deviceForRow(y)->createHLineConstIteratorNG(imageRect.x(), y, imageRect.width());
+
+            do {
+                const quint8* c = it->oldRawData();
+                bool findit = false;
+                for (int i = 0; i < num_palette; i++) {
+                    if (palette[i].red == c[2] &&
+                            palette[i].green == c[1] &&
+                            palette[i].blue == c[0]) {
+                        findit = true;
+                        break;
+                    }
                 }
-            }
-            if (!findit) {
-                if (num_palette == 255) {
-                    toomuchcolor = true;
-                    break;
+                if (!findit) {
+                    if (num_palette == 255) {
+                        toomuchcolor = true;
+                        break;
+                    }
+                    palette[num_palette].red = c[2];
+                    palette[num_palette].green = c[1];
+                    palette[num_palette].blue = c[0];
+                    num_palette++;
                 }
-                palette[num_palette].red = c[2];
-                palette[num_palette].green = c[1];
-                palette[num_palette].blue = c[0];
-                num_palette++;
-            }
+            } while (it->nextPixel());
         }
 
         if (!toomuchcolor) {
@@ -1100,7 +1429,7 @@ KisImportExportErrorCode KisPNGConverter::buildFile(QIODevice* iodevice, const Q
 
     // set sRGB only if the profile is sRGB  -- http://www.w3.org/TR/PNG/#11sRGB says sRGB and iCCP should not both be present
 
-    const bool sRGB = *device->colorSpace()->profile() == *KoColorSpaceRegistry::instance()->p709SRGBProfile();
+    const bool sRGB = *cs->profile() == *KoColorSpaceRegistry::instance()->p709SRGBProfile();
     /*
      * This automatically writes the correct gamma and chroma chunks along with the sRGB chunk, but firefox's
      * color management is bugged, so once you give it any incentive to start color managing an sRGB image it
@@ -1183,7 +1512,7 @@ KisImportExportErrorCode KisPNGConverter::buildFile(QIODevice* iodevice, const Q
     }
 
     // Save the color profile
-    const KoColorProfile* colorProfile = device->colorSpace()->profile();
+    const KoColorProfile* colorProfile = cs->profile();
     QByteArray colorProfileData = colorProfile->rawData();
     if (!sRGB || options.saveSRGBProfile) {
 
@@ -1294,57 +1623,39 @@ KisImportExportErrorCode KisPNGConverter::buildFile(QIODevice* iodevice, const Q
     png_write_info(png_ptr, info_ptr);
     png_write_flush(png_ptr);
 
+    /**
+     * Adam7 passes cannot be split into independent strips, so the
+     * interlaced images are always written by libpng
+     */
+    const bool writeStrips = options.parallelEncoding && interlace_type == PNG_INTERLACE_NONE;
+
     // swap byteorder on little endian machines.
 #ifndef WORDS_BIGENDIAN
-    if (color_nb_bits > 8)
+    if (color_nb_bits > 8 && !writeStrips)
         png_set_swap(png_ptr);
 #endif
 
     // Write the PNG
     //     png_write_png(png_ptr, info_ptr, PNG_TRANSFORM_IDENTITY, 0);
 
-    struct RowPointersStruct {
-        RowPointersStruct(const QSize &size, int pixelSize)
-            : numRows(size.height())
-        {
-            rows = new png_byte*[numRows];
+    const size_t rowSize = png_get_rowbytes(png_ptr, info_ptr);
 
-            for (int i = 0; i < numRows; i++) {
-                rows[i] = new png_byte[size.width() * pixelSize];
-            }
-        }
-
-        ~RowPointersStruct() {
-            for (int i = 0; i < numRows; i++) {
-                delete[] rows[i];
-            }
-            delete[] rows;
-        }
-
-        const int numRows = 0;
-        png_byte** rows = 0;
-    };
-
-
-    // Fill the data structure
-    RowPointersStruct rowPointers(imageRect.size(), device->pixelSize());
-
-    int row = 0;
-    for (int y = imageRect.y(); y < imageRect.y() + imageRect.height(); y++, row++) {
-        KisHLineConstIteratorSP it = device->createHLineConstIteratorNG(imageRect.x(), y, imageRect.width());
+    auto fillRow = [&] (int row, png_byte *rowData) {
+        const int y = imageRect.y() + row;
+        KisHLineConstIteratorSP it = reader.deviceForRow(y)->createHLineConstIteratorNG(imageRect.x(), y, imageRect.width());
 
         switch (color_type) {
         case PNG_COLOR_TYPE_GRAY:
         case PNG_COLOR_TYPE_GRAY_ALPHA:
             if (color_nb_bits == 16) {
-                quint16 *dst = reinterpret_cast<quint16 *>(rowPointers.rows[row]);
+                quint16 *dst = reinterpret_cast<quint16 *>(rowData);
                 do {
                     const quint16 *d = reinterpret_cast<const quint16 *>(it->oldRawData());
                     *(dst++) = d[0];
                     if (options.alpha) *(dst++) = d[1];
                 } while (it->nextPixel());
             } else {
-                quint8 *dst = rowPointers.rows[row];
+                quint8 *dst = rowData;
                 do {
                     const quint8 *d = it->oldRawData();
                     *(dst++) = d[0];
@@ -1355,7 +1666,7 @@ KisImportExportErrorCode KisPNGConverter::buildFile(QIODevice* iodevice, const Q
         case PNG_COLOR_TYPE_RGB:
         case PNG_COLOR_TYPE_RGB_ALPHA:
             if (color_nb_bits == 16) {
-                quint16 *dst = reinterpret_cast<quint16 *>(rowPointers.rows[row]);
+                quint16 *dst = reinterpret_cast<quint16 *>(rowData);
                 do {
                     const quint16 *d = reinterpret_cast<const quint16 *>(it->oldRawData());
                     *(dst++) = d[2];
@@ -1364,7 +1675,7 @@ KisImportExportErrorCode KisPNGConverter::buildFile(QIODevice* iodevice, const Q
                     if (options.alpha) *(dst++) = d[3];
                 } while (it->nextPixel());
             } else {
-                quint8 *dst = rowPointers.rows[row];
+                quint8 *dst = rowData;
                 do {
                     const quint8 *d = it->oldRawData();
                     *(dst++) = d[2];
@@ -1375,7 +1686,7 @@ KisImportExportErrorCode KisPNGConverter::buildFile(QIODevice* iodevice, const Q
             }
             break;
         case PNG_COLOR_TYPE_PALETTE: {
-            quint8 *dst = rowPointers.rows[row];
+            quint8 *dst = rowData;
             KisPNGWriteStream writestream(dst, color_nb_bits);
             do {
                 const quint8 *d = it->oldRawData();
@@ -1392,14 +1703,88 @@ KisImportExportErrorCode KisPNGConverter::buildFile(QIODevice* iodevice, const Q
         }
             break;
         default:
-            return ImportExportCodes::FormatColorSpaceUnsupported;
+            return false;
         }
-    }
 
-    png_write_image(png_ptr, rowPointers.rows);
+#ifndef WORDS_BIGENDIAN
+        // the strip encoder doesn't have libpng's transformations
+        if (writeStrips && color_nb_bits > 8) {
+            quint16 *values = reinterpret_cast<quint16 *>(rowData);
+            const size_t numValues = rowSize / sizeof(quint16);
+            for (size_t i = 0; i < numValues; i++) {
+                values[i] = qToBigEndian(values[i]);
+            }
+        }
+#endif
+
+        return true;
+    };
+
+    if (writeStrips) {
+        KisPNGStripEncoder encoder(fillRow,
+                                   imageRect.height(),
+                                   rowSize,
+                                   qMax(1, png_get_channels(png_ptr, info_ptr) * color_nb_bits / 8),
+                                   color_type != PNG_COLOR_TYPE_PALETTE && color_nb_bits >= 8,
+                                   options.compression);
+
+        if (!encoder.writeImage(png_ptr)) {
+            png_destroy_write_struct(&png_ptr, &info_ptr);
+            return ImportExportCodes::Failure;
+        }
+    } else if (interlace_type == PNG_INTERLACE_NONE) {
+        // write the rows one by one, so only a single band of the image is kept in memory
+        QScopedArrayPointer<png_byte> rowData(new png_byte[rowSize]);
+
+        for (int row = 0; row < imageRect.height(); row++) {
+            if (!fillRow(row, rowData.data())) {
+                png_destroy_write_struct(&png_ptr, &info_ptr);
+                return ImportExportCodes::FormatColorSpaceUnsupported;
+            }
+            png_write_row(png_ptr, rowData.data());
+        }
+
+        // Writing is over
+        png_write_end(png_ptr, info_ptr);
+    } else {
+        // Adam7 passes need the whole image
+        struct RowPointersStruct {
+            RowPointersStruct(int numRows, size_t rowSize)
+                : numRows(numRows)
+            {
+                rows = new png_byte*[numRows];
+
+                for (int i = 0; i < numRows; i++) {
+                    rows[i] = new png_byte[rowSize];
+                }
+            }
 
-    // Writing is over
-    png_write_end(png_ptr, info_ptr);
+            ~RowPointersStruct() {
+                for (int i = 0; i < numRows; i++) {
+                    delete[] rows[i];
+                }
+                delete[] rows;
+            }
+
+            const int numRows = 0;
+            png_byte** rows = 0;
+        };
+
+        // Fill the data structure
+        RowPointersStruct rowPointers(imageRect.height(), rowSize);
+
+        for (int row = 0; row < imageRect.height(); row++) {
+            if (!fillRow(row, rowPointers.rows[row])) {
+                png_destroy_write_struct(&png_ptr, &info_ptr);
+                return ImportExportCodes::FormatColorSpaceUnsupported;
+            }
+        }
+
+        png_write_image(png_ptr, rowPointers.rows);
+
+        // Writing is over
+        png_write_end(png_ptr, info_ptr);
+    }
 
     // Free memory
     png_destroy_write_struct(&png_ptr, &info_ptr);
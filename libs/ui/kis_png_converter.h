@@ -45,6 +45,7 @@ struct KisPNGOptions {
         , saveAsHDR(false)
         , transparencyFillColor(Qt::white)
         , downsample(false)
+        , parallelEncoding(false)
     {}
 
     int compression;
@@ -62,6 +63,7 @@ struct KisPNGOptions {
     QList<const KisMetaData::Filter*> filters;
     QColor transparencyFillColor;
     bool downsample; // Converts to 8 bit on export
+    bool parallelEncoding; // Filters and deflates strips of rows concurrently
 };
 
 /**
@@ -116,6 +118,14 @@ public:
      */
     static bool saveDeviceToStore(const QString &filename, const QRect &imageRect, const qreal xRes, const qreal yRes, KisPaintDeviceSP dev, KoStore *store, KisMetaData::Store* metaData = 0);
 
+    /**
+     * @brief saveDeviceToIODevice encodes the given paint device into \p io the same way
+     *        saveDeviceToStore() does, but with the zlib \p compression level passed
+     *        by the caller. The device \p io must already be open for writing.
+     * @return true if the saving succeeds
+     */
+    static bool saveDeviceToIODevice(QIODevice *io, const QRect &imageRect, const qreal xRes, const qreal yRes, KisPaintDeviceSP dev, int compression, KisMetaData::Store* metaData = 0);
+
     static bool isColorSpaceSupported(const KoColorSpace *cs);
 
 public Q_SLOTS:
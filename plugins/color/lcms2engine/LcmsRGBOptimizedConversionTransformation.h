@@ -0,0 +1,168 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef LCMSRGBOPTIMIZEDCONVERSIONTRANSFORMATION_H
+#define LCMSRGBOPTIMIZEDCONVERSIONTRANSFORMATION_H
+
+#include <QScopedPointer>
+
+#include "kis_assert.h"
+#include "KoColorModelStandardIds.h"
+#include "KoColorConversionTransformation.h"
+#include "KoColorConversionTransformationFactory.h"
+#include "KoOptimizedRgbPixelDataConverterFactory.h"
+
+/**
+ * A color conversion transformation that doesn't change the primaries
+ * of the color space, it either changes the bit depth of the pixels
+ * or adds/removes the sRGB transfer curve. Such conversions are done by
+ * the vectorized KoOptimizedRgbPixelDataConverter instead of LCMS.
+ */
+struct LcmsOptimizedRgbConversionTransformation : public KoColorConversionTransformation
+{
+    LcmsOptimizedRgbConversionTransformation(const KoColorSpace* srcCs,
+                                             const KoColorSpace* dstCs,
+                                             Intent renderingIntent,
+                                             ConversionFlags conversionFlags,
+                                             KoOptimizedRgbPixelDataConverterBase *converter)
+        : KoColorConversionTransformation(srcCs,
+                                          dstCs,
+                                          renderingIntent,
+                                          conversionFlags),
+          m_converter(converter)
+    {
+    }
+
+    void transform(const quint8 *src, quint8 *dst, qint32 nPixels) const override {
+        KIS_ASSERT(src != dst);
+        m_converter->convertPixels(src, dst, nPixels);
+    }
+
+private:
+    QScopedPointer<KoOptimizedRgbPixelDataConverterBase> m_converter;
+};
+
+class LcmsOptimizedRgbConversionTransformationFactory : public KoColorConversionTransformationFactory
+{
+public:
+    LcmsOptimizedRgbConversionTransformationFactory(const KoID &srcDepthId,
+                                                    const QString &srcProfile,
+                                                    const KoID &dstDepthId,
+                                                    const QString &dstProfile,
+                                                    KoOptimizedRgbPixelDataConverterBase::TransferCurve transferCurve)
+        : KoColorConversionTransformationFactory(RGBAColorModelID.id(),
+                                                 srcDepthId.id(),
+                                                 srcProfile,
+                                                 RGBAColorModelID.id(),
+                                                 dstDepthId.id(),
+                                                 dstProfile),
+          m_srcChannelType(channelTypeForDepth(srcDepthId)),
+          m_dstChannelType(channelTypeForDepth(dstDepthId)),
+          m_transferCurve(transferCurve)
+    {
+        KIS_SAFE_ASSERT_RECOVER_NOOP(srcDepthId != dstDepthId ||
+                                     srcProfile != dstProfile);
+    }
+
+    KoColorConversionTransformation* createColorTransformation(const KoColorSpace* srcColorSpace,
+                                                               const KoColorSpace* dstColorSpace,
+                                                               KoColorConversionTransformation::Intent renderingIntent,
+                                                               KoColorConversionTransformation::ConversionFlags conversionFlags) const override
+    {
+        return new LcmsOptimizedRgbConversionTransformation(
+                    srcColorSpace, dstColorSpace,
+                    renderingIntent, conversionFlags,
+                    KoOptimizedRgbPixelDataConverterFactory::createConverter(m_srcChannelType,
+                                                                             m_dstChannelType,
+                                                                             m_transferCurve));
+    }
+
+    static bool isDepthSupported(const KoID &depthId) {
+        return depthId == Integer8BitsColorDepthID ||
+               depthId == Integer16BitsColorDepthID ||
+               depthId == Float32BitsColorDepthID;
+    }
+
+private:
+    static KoOptimizedRgbPixelDataConverterBase::ChannelType channelTypeForDepth(const KoID &depthId) {
+        KIS_SAFE_ASSERT_RECOVER_NOOP(isDepthSupported(depthId));
+
+        return
+            depthId == Integer8BitsColorDepthID ? KoOptimizedRgbPixelDataConverterBase::UInt8Channels :
+            depthId == Integer16BitsColorDepthID ? KoOptimizedRgbPixelDataConverterBase::UInt16Channels :
+            KoOptimizedRgbPixelDataConverterBase::Float32Channels;
+    }
+
+private:
+    KoOptimizedRgbPixelDataConverterBase::ChannelType m_srcChannelType;
+    KoOptimizedRgbPixelDataConverterBase::ChannelType m_dstChannelType;
+    KoOptimizedRgbPixelDataConverterBase::TransferCurve m_transferCurve;
+};
+
+/**
+ * Adds **outgoing** optimized conversions for the color space with
+ * \p srcDepthId. The optimized conversions are registered only for the
+ * profiles bundled with Krita that come in pairs with exactly the same
+ * primaries: a linear one and one with the sRGB TRC. All the other
+ * conversions are still handled by LCMS.
+ *
+ * The sRGB curve is applied only when the destination is an integer
+ * color space, so the values outside [0, 1] range never go through
+ * the fast path (LCMS handles the extended range of the curves itself).
+ */
+inline void addOptimizedRgbConversions(QList<KoColorConversionTransformationFactory*> &list, const KoID &srcDepthId)
+{
+    using Factory = LcmsOptimizedRgbConversionTransformationFactory;
+
+    if (!Factory::isDepthSupported(srcDepthId)) return;
+
+    struct ProfilePair {
+        const char *linearProfile;
+        const char *srgbTrcProfile;
+    };
+
+    static const ProfilePair profilePairs[] = {
+        {"sRGB-elle-V2-g10.icc", "sRGB-elle-V2-srgbtrc.icc"},
+        {"sRGB-elle-V4-g10.icc", "sRGB-elle-V4-srgbtrc.icc"},
+        {"Rec2020-elle-V4-g10.icc", "Rec2020-elle-V4-srgbtrc.icc"}
+    };
+
+    const KoID depthIds[] = {
+        Integer8BitsColorDepthID,
+        Integer16BitsColorDepthID,
+        Float32BitsColorDepthID
+    };
+
+    const bool srcIsInteger = srcDepthId != Float32BitsColorDepthID;
+
+    for (const ProfilePair &pair : profilePairs) {
+        const QString linearProfile = QString::fromLatin1(pair.linearProfile);
+        const QString srgbTrcProfile = QString::fromLatin1(pair.srgbTrcProfile);
+
+        for (const KoID &dstDepthId : depthIds) {
+            const bool dstIsInteger = dstDepthId != Float32BitsColorDepthID;
+
+            if (dstDepthId != srcDepthId) {
+                list << new Factory(srcDepthId, linearProfile, dstDepthId, linearProfile,
+                                    KoOptimizedRgbPixelDataConverterBase::KeepTransferCurve);
+                list << new Factory(srcDepthId, srgbTrcProfile, dstDepthId, srgbTrcProfile,
+                                    KoOptimizedRgbPixelDataConverterBase::KeepTransferCurve);
+            }
+
+            if (dstIsInteger) {
+                list << new Factory(srcDepthId, linearProfile, dstDepthId, srgbTrcProfile,
+                                    KoOptimizedRgbPixelDataConverterBase::ApplySrgbCurve);
+            }
+
+            if (srcIsInteger) {
+                list << new Factory(srcDepthId, srgbTrcProfile, dstDepthId, linearProfile,
+                                    KoOptimizedRgbPixelDataConverterBase::RemoveSrgbCurve);
+            }
+        }
+    }
+}
+
+#endif // LCMSRGBOPTIMIZEDCONVERSIONTRANSFORMATION_H
@@ -20,6 +20,7 @@
 #include "KoColorConversionTransformationFactory.h"
 
 #include <LcmsRGBP2020PQColorSpaceTransformation.h>
+#include <LcmsRGBOptimizedConversionTransformation.h>
 
 template <class T>
 struct ColorSpaceFromFactory {
@@ -127,6 +128,9 @@ class LcmsRGBP2020PQColorSpaceFactoryWrapper : public BaseColorSpaceFactory
         // internally, we can convert to RGB U8 if needed
         addInternalConversion<RelatedColorSpaceType>(list, static_cast<KoBgrU8Traits*>(0));
 
+        // fast paths for depth and transfer curve changes of the bundled profiles
+        addOptimizedRgbConversions(list, this->colorDepthId());
+
         return list;
     }
 };
@@ -0,0 +1,141 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "TestLcmsRGBOptimizedConversion.h"
+
+#include <simpletest.h>
+#include <testpigment.h>
+
+#include <random>
+
+#include "kis_debug.h"
+
+#include "KoColorSpaceRegistry.h"
+#include "KoColorSpaceEngine.h"
+#include "KoColorModelStandardIds.h"
+#include "KoColorConversionTransformation.h"
+
+namespace {
+
+const KoColorSpace* rgbColorSpace(const KoID &depthId, const QString &profileName)
+{
+    return KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(), depthId.id(), profileName);
+}
+
+void fillRandomPixels(const KoColorSpace *cs, quint8 *data, int numPixels)
+{
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<float> dis(0.0f, 1.0f);
+
+    QVector<float> channels(4);
+
+    for (int i = 0; i < numPixels; i++) {
+        for (int j = 0; j < 4; j++) {
+            channels[j] = dis(gen);
+        }
+        cs->fromNormalisedChannelsValue(data + i * cs->pixelSize(), channels);
+    }
+}
+
+}
+
+void TestLcmsRGBOptimizedConversion::testCompareWithLcms_data()
+{
+    QTest::addColumn<QString>("srcDepthId");
+    QTest::addColumn<QString>("srcProfile");
+    QTest::addColumn<QString>("dstDepthId");
+    QTest::addColumn<QString>("dstProfile");
+
+    const QString linear = "sRGB-elle-V2-g10.icc";
+    const QString srgb = "sRGB-elle-V2-srgbtrc.icc";
+
+    const QVector<KoID> depths = {Integer8BitsColorDepthID, Integer16BitsColorDepthID, Float32BitsColorDepthID};
+
+    Q_FOREACH (const KoID &src, depths) {
+        Q_FOREACH (const KoID &dst, depths) {
+            if (src != dst) {
+                QTest::addRow("%s-linear-%s-linear", src.id().toLatin1().data(), dst.id().toLatin1().data())
+                    << src.id() << linear << dst.id() << linear;
+                QTest::addRow("%s-srgb-%s-srgb", src.id().toLatin1().data(), dst.id().toLatin1().data())
+                    << src.id() << srgb << dst.id() << srgb;
+            }
+
+            if (dst != Float32BitsColorDepthID) {
+                QTest::addRow("%s-linear-%s-srgb", src.id().toLatin1().data(), dst.id().toLatin1().data())
+                    << src.id() << linear << dst.id() << srgb;
+            }
+
+            if (src != Float32BitsColorDepthID) {
+                QTest::addRow("%s-srgb-%s-linear", src.id().toLatin1().data(), dst.id().toLatin1().data())
+                    << src.id() << srgb << dst.id() << linear;
+            }
+        }
+    }
+}
+
+void TestLcmsRGBOptimizedConversion::testCompareWithLcms()
+{
+    QFETCH(QString, srcDepthId);
+    QFETCH(QString, srcProfile);
+    QFETCH(QString, dstDepthId);
+    QFETCH(QString, dstProfile);
+
+    const KoColorSpace *srcCS = rgbColorSpace(KoID(srcDepthId), srcProfile);
+    const KoColorSpace *dstCS = rgbColorSpace(KoID(dstDepthId), dstProfile);
+
+    if (!srcCS || !dstCS) {
+        QSKIP("The bundled profiles are not available");
+    }
+
+    const KoColorConversionTransformation::Intent intent =
+        KoColorConversionTransformation::internalRenderingIntent();
+    const KoColorConversionTransformation::ConversionFlags flags =
+        KoColorConversionTransformation::internalConversionFlags();
+
+    KoColorSpaceEngine *engine = KoColorSpaceEngineRegistry::instance()->get("icc");
+    QVERIFY(engine);
+
+    QScopedPointer<KoColorConversionTransformation> optimized(
+        KoColorSpaceRegistry::instance()->createColorConverter(srcCS, dstCS, intent, flags));
+    QScopedPointer<KoColorConversionTransformation> reference(
+        engine->createColorTransformation(srcCS, dstCS, intent, flags));
+
+    // a number that is not divisible by any vector size to test the tail
+    const int numPixels = 1027;
+
+    QVector<quint8> src(numPixels * srcCS->pixelSize());
+    QVector<quint8> dst(numPixels * dstCS->pixelSize());
+    QVector<quint8> ref(numPixels * dstCS->pixelSize());
+
+    fillRandomPixels(srcCS, src.data(), numPixels);
+
+    optimized->transform(src.data(), dst.data(), numPixels);
+    reference->transform(src.data(), ref.data(), numPixels);
+
+    /**
+     * LCMS uses sampled curves for the V2 profiles and different rounding
+     * rules, so we compare the normalized values with some tolerance
+     */
+    const float tolerance = dstDepthId == Integer8BitsColorDepthID.id() ? 1.01f / 255.0f : 0.002f;
+
+    QVector<float> dstChannels(4);
+    QVector<float> refChannels(4);
+
+    for (int i = 0; i < numPixels; i++) {
+        dstCS->normalisedChannelsValue(dst.data() + i * dstCS->pixelSize(), dstChannels);
+        dstCS->normalisedChannelsValue(ref.data() + i * dstCS->pixelSize(), refChannels);
+
+        for (int j = 0; j < 4; j++) {
+            if (qAbs(dstChannels[j] - refChannels[j]) > tolerance) {
+                qDebug() << "pixel" << i << "channel" << j
+                         << "optimized" << dstChannels << "lcms" << refChannels;
+                QFAIL("the optimized conversion differs from LCMS");
+            }
+        }
+    }
+}
+
+KISTEST_MAIN(TestLcmsRGBOptimizedConversion)
@@ -0,0 +1,20 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef TESTLCMSRGBOPTIMIZEDCONVERSION_H
+#define TESTLCMSRGBOPTIMIZEDCONVERSION_H
+
+#include <QObject>
+
+class TestLcmsRGBOptimizedConversion : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testCompareWithLcms_data();
+    void testCompareWithLcms();
+};
+
+#endif // TESTLCMSRGBOPTIMIZEDCONVERSION_H
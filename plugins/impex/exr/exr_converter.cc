@@ -11,10 +11,12 @@
 
 #include <ImfAttribute.h>
 #include <ImfChannelList.h>
+#include <ImfCompressor.h>
 #include <ImfFrameBuffer.h>
 #include <ImfHeader.h>
 #include <ImfInputFile.h>
 #include <ImfOutputFile.h>
+#include <ImfTileDescription.h>
 
 #include <ImfStringAttribute.h>
 #include "exr_extra_tags.h"
@@ -23,6 +25,10 @@
 #include <QMessageBox>
 #include <QDomDocument>
 #include <QThread>
+#include <QtConcurrent>
+
+#include <atomic>
+#include <memory>
 
 #include <QFileInfo>
 
@@ -41,6 +47,7 @@
 #include <kis_transaction.h>
 #include "kis_iterator_ng.h"
 #include <kis_exr_layers_sorter.h>
+#include <kis_algebra_2d.h>
 
 #include <kis_meta_data_entry.h>
 #include <kis_meta_data_schema.h>
@@ -134,7 +141,7 @@ struct EXRConverter::Private {
     KisImageSP image;
     KisDocument *doc;
 
-    bool alphaWasModified;
+    std::atomic<bool> alphaWasModified;
     bool showNotifications;
 
     QString errorMessage;
@@ -142,11 +149,28 @@ struct EXRConverter::Private {
     template <class WrapperType>
     void unmultiplyAlpha(typename WrapperType::pixel_type *pixel);
 
+    /**
+     * Decodes a band of rows of one paint layer. The channels of all the
+     * layers are read from the file into the band buffers in one pass,
+     * then the buffers are written into the layers concurrently.
+     */
+    struct BandDecoderBase {
+        virtual ~BandDecoderBase() {}
+
+        /// insert the slices of the band buffer with the top row \p bandTop
+        virtual void insertSlices(Imf::FrameBuffer &frameBuffer, int bandTop) = 0;
+
+        /// write the part \p rc of the band with the top row \p bandTop into the layer
+        virtual void writePixels(const QRect &rc, int bandTop) = 0;
+    };
+
     template<typename _T_>
-    void decodeData4(Imf::InputFile& file, ExrPaintLayerInfo& info, KisPaintLayerSP layer, int width, int xstart, int ystart, int height, Imf::PixelType ptype);
+    struct BandDecoder4;
 
     template<typename _T_>
-    void decodeData1(Imf::InputFile& file, ExrPaintLayerInfo& info, KisPaintLayerSP layer, int width, int xstart, int ystart, int height, Imf::PixelType ptype);
+    struct BandDecoder1;
+
+    void decodeLayers(Imf::InputFile& file, const QVector<BandDecoderBase*> &decoders, int width, int xstart, int ystart, int height, int bandHeight);
 
 
     QDomDocument loadExtraLayersInfo(const Imf::Header &header);
@@ -367,111 +391,173 @@ void multiplyAlpha(Pixel *pixel)
 }
 
 template<typename _T_>
-void EXRConverter::Private::decodeData4(Imf::InputFile& file, ExrPaintLayerInfo& info, KisPaintLayerSP layer, int width, int xstart, int ystart, int height, Imf::PixelType ptype)
+struct EXRConverter::Private::BandDecoder4 : public EXRConverter::Private::BandDecoderBase
 {
-    typedef Rgba<_T_> Rgba;
-
-    QVector<Rgba> pixels(width * height);
-
-    bool hasAlpha = info.channelMap.contains("A");
-
-    Imf::FrameBuffer frameBuffer;
-    Rgba* frameBufferData = (pixels.data()) - xstart - ystart * width;
-    frameBuffer.insert(info.channelMap["R"].toLatin1().constData(),
-            Imf::Slice(ptype, (char *) &frameBufferData->r,
-                       sizeof(Rgba) * 1,
-                       sizeof(Rgba) * width));
-    frameBuffer.insert(info.channelMap["G"].toLatin1().constData(),
-            Imf::Slice(ptype, (char *) &frameBufferData->g,
-                       sizeof(Rgba) * 1,
-                       sizeof(Rgba) * width));
-    frameBuffer.insert(info.channelMap["B"].toLatin1().constData(),
-            Imf::Slice(ptype, (char *) &frameBufferData->b,
-                       sizeof(Rgba) * 1,
-                       sizeof(Rgba) * width));
-    if (hasAlpha) {
-        frameBuffer.insert(info.channelMap["A"].toLatin1().constData(),
-                Imf::Slice(ptype, (char *) &frameBufferData->a,
-                           sizeof(Rgba) * 1,
-                           sizeof(Rgba) * width));
-    }
+    typedef Rgba<_T_> pixel_type;
 
-    file.setFrameBuffer(frameBuffer);
-    file.readPixels(ystart, height + ystart - 1);
-    Rgba *rgba = pixels.data();
+    BandDecoder4(Private *_d, const ExrPaintLayerInfo &_info, KisPaintLayerSP _layer, int _width, int _xstart, int bandHeight, Imf::PixelType _ptype)
+        : d(_d), info(_info), layer(_layer), width(_width), xstart(_xstart), ptype(_ptype),
+          hasAlpha(info.channelMap.contains("A")),
+          pixels(width * bandHeight)
+    {
+    }
 
-    QRect paintRegion(xstart, ystart, width, height);
-    KisSequentialIterator it(layer->paintDevice(), paintRegion);
-    while (it.nextPixel()) {
+    void insertSlices(Imf::FrameBuffer &frameBuffer, int bandTop) override
+    {
+        pixel_type* frameBufferData = (pixels.data()) - xstart - bandTop * width;
+        frameBuffer.insert(info.channelMap["R"].toLatin1().constData(),
+                Imf::Slice(ptype, (char *) &frameBufferData->r,
+                           sizeof(pixel_type) * 1,
+                           sizeof(pixel_type) * width));
+        frameBuffer.insert(info.channelMap["G"].toLatin1().constData(),
+                Imf::Slice(ptype, (char *) &frameBufferData->g,
+                           sizeof(pixel_type) * 1,
+                           sizeof(pixel_type) * width));
+        frameBuffer.insert(info.channelMap["B"].toLatin1().constData(),
+                Imf::Slice(ptype, (char *) &frameBufferData->b,
+                           sizeof(pixel_type) * 1,
+                           sizeof(pixel_type) * width));
         if (hasAlpha) {
-            unmultiplyAlpha<RgbPixelWrapper<_T_> >(rgba);
+            frameBuffer.insert(info.channelMap["A"].toLatin1().constData(),
+                    Imf::Slice(ptype, (char *) &frameBufferData->a,
+                               sizeof(pixel_type) * 1,
+                               sizeof(pixel_type) * width));
         }
+    }
 
-        typename KoRgbTraits<_T_>::Pixel* dst = reinterpret_cast<typename KoRgbTraits<_T_>::Pixel*>(it.rawData());
+    void writePixels(const QRect &rc, int bandTop) override
+    {
+        KisSequentialIterator it(layer->paintDevice(), rc);
+        while (it.nextPixel()) {
+            pixel_type *rgba = pixels.data() + (it.y() - bandTop) * width + (it.x() - xstart);
 
-        dst->red = rgba->r;
-        dst->green = rgba->g;
-        dst->blue = rgba->b;
-        if (hasAlpha) {
-            dst->alpha = rgba->a;
-        } else {
-            dst->alpha = 1.0;
-        }
+            if (hasAlpha) {
+                d->unmultiplyAlpha<RgbPixelWrapper<_T_> >(rgba);
+            }
 
-        ++rgba;
+            typename KoRgbTraits<_T_>::Pixel* dst = reinterpret_cast<typename KoRgbTraits<_T_>::Pixel*>(it.rawData());
+
+            dst->red = rgba->r;
+            dst->green = rgba->g;
+            dst->blue = rgba->b;
+            if (hasAlpha) {
+                dst->alpha = rgba->a;
+            } else {
+                dst->alpha = 1.0;
+            }
+        }
     }
-}
+
+    Private *d;
+    ExrPaintLayerInfo info;
+    KisPaintLayerSP layer;
+    int width;
+    int xstart;
+    Imf::PixelType ptype;
+    bool hasAlpha;
+    QVector<pixel_type> pixels;
+};
 
 template<typename _T_>
-void EXRConverter::Private::decodeData1(Imf::InputFile& file, ExrPaintLayerInfo& info, KisPaintLayerSP layer, int width, int xstart, int ystart, int height, Imf::PixelType ptype)
+struct EXRConverter::Private::BandDecoder1 : public EXRConverter::Private::BandDecoderBase
 {
     typedef typename GrayPixelWrapper<_T_>::channel_type channel_type;
     typedef typename GrayPixelWrapper<_T_>::pixel_type pixel_type;
 
-    KIS_ASSERT_RECOVER_RETURN(
-                layer->paintDevice()->colorSpace()->colorModelId() == GrayAColorModelID);
+    BandDecoder1(Private *_d, const ExrPaintLayerInfo &_info, KisPaintLayerSP _layer, int _width, int _xstart, int bandHeight, Imf::PixelType _ptype)
+        : d(_d), info(_info), layer(_layer), width(_width), xstart(_xstart), ptype(_ptype),
+          hasAlpha(info.channelMap.contains("A")),
+          pixels(width * bandHeight)
+    {
+        Q_ASSERT(info.channelMap.contains("Y"));
+        dbgFile << "Gray -> " << info.channelMap["Y"];
+        dbgFile << "Has Alpha:" << hasAlpha;
+    }
 
-    QVector<pixel_type> pixels(width * height);
+    void insertSlices(Imf::FrameBuffer &frameBuffer, int bandTop) override
+    {
+        pixel_type* frameBufferData = (pixels.data()) - xstart - bandTop * width;
+        frameBuffer.insert(
+            info.channelMap["Y"].toLatin1().constData(),
+            Imf::Slice(ptype, (char *)&frameBufferData->gray, sizeof(pixel_type) * 1, sizeof(pixel_type) * width));
 
-    Q_ASSERT(info.channelMap.contains("Y"));
-    dbgFile << "Gray -> " << info.channelMap["Y"];
+        if (hasAlpha) {
+            frameBuffer.insert(info.channelMap["A"].toLatin1().constData(),
+                    Imf::Slice(ptype, (char *) &frameBufferData->alpha,
+                               sizeof(pixel_type) * 1,
+                               sizeof(pixel_type) * width));
+        }
+    }
 
-    bool hasAlpha = info.channelMap.contains("A");
-    dbgFile << "Has Alpha:" << hasAlpha;
+    void writePixels(const QRect &rc, int bandTop) override
+    {
+        KIS_ASSERT_RECOVER_RETURN(
+                    layer->paintDevice()->colorSpace()->colorModelId() == GrayAColorModelID);
 
+        KisSequentialIterator it(layer->paintDevice(), rc);
+        while (it.nextPixel()) {
+            pixel_type *srcPtr = pixels.data() + (it.y() - bandTop) * width + (it.x() - xstart);
 
-    Imf::FrameBuffer frameBuffer;
-    pixel_type* frameBufferData = (pixels.data()) - xstart - ystart * width;
-    frameBuffer.insert(
-        info.channelMap["Y"].toLatin1().constData(),
-        Imf::Slice(ptype, (char *)&frameBufferData->gray, sizeof(pixel_type) * 1, sizeof(pixel_type) * width));
+            if (hasAlpha) {
+                d->unmultiplyAlpha<GrayPixelWrapper<_T_> >(srcPtr);
+            }
 
-    if (hasAlpha) {
-        frameBuffer.insert(info.channelMap["A"].toLatin1().constData(),
-                Imf::Slice(ptype, (char *) &frameBufferData->alpha,
-                           sizeof(pixel_type) * 1,
-                           sizeof(pixel_type) * width));
+            pixel_type* dstPtr = reinterpret_cast<pixel_type*>(it.rawData());
+
+            dstPtr->gray = srcPtr->gray;
+            dstPtr->alpha = hasAlpha ? srcPtr->alpha : channel_type(1.0);
+        }
     }
 
-    file.setFrameBuffer(frameBuffer);
-    file.readPixels(ystart, height + ystart - 1);
+    Private *d;
+    ExrPaintLayerInfo info;
+    KisPaintLayerSP layer;
+    int width;
+    int xstart;
+    Imf::PixelType ptype;
+    bool hasAlpha;
+    QVector<pixel_type> pixels;
+};
+
+void EXRConverter::Private::decodeLayers(Imf::InputFile& file, const QVector<BandDecoderBase*> &decoders, int width, int xstart, int ystart, int height, int bandHeight)
+{
+    /**
+     * The pixels of a band are written into the devices in patches
+     * aligned to the tiles, so that the concurrent jobs never share
+     * a tile of the same layer.
+     */
+    const int patchWidth = 256;
+
+    struct WriteJob {
+        BandDecoderBase *decoder;
+        QRect rc;
+    };
 
-    pixel_type *srcPtr = pixels.data();
+    for (int bandTop = ystart; bandTop < ystart + height; bandTop += bandHeight) {
+        const int bandBottom = qMin(bandTop + bandHeight, ystart + height) - 1;
 
-    QRect paintRegion(xstart, ystart, width, height);
-    KisSequentialIterator it(layer->paintDevice(), paintRegion);
-    while (it.nextPixel()) {
-        if (hasAlpha) {
-            unmultiplyAlpha<GrayPixelWrapper<_T_> >(srcPtr);
+        Imf::FrameBuffer frameBuffer;
+        Q_FOREACH (BandDecoderBase *decoder, decoders) {
+            decoder->insertSlices(frameBuffer, bandTop);
         }
 
-        pixel_type* dstPtr = reinterpret_cast<pixel_type*>(it.rawData());
-
-        dstPtr->gray = srcPtr->gray;
-        dstPtr->alpha = hasAlpha ? srcPtr->alpha : channel_type(1.0);
+        // the line blocks are decompressed by the OpenEXR thread pool
+        file.setFrameBuffer(frameBuffer);
+        file.readPixels(bandTop, bandBottom);
+
+        QVector<WriteJob> jobs;
+        Q_FOREACH (BandDecoderBase *decoder, decoders) {
+            for (int x = xstart; x < xstart + width;) {
+                const int patchRight = qMin(xstart + width, x - KisAlgebra2D::wrapValue(x, patchWidth) + patchWidth);
+                jobs.append({decoder, QRect(x, bandTop, patchRight - x, bandBottom - bandTop + 1)});
+                x = patchRight;
+            }
+        }
 
-        ++srcPtr;
-    } ;
+        QtConcurrent::blockingMap(jobs, [bandTop] (const WriteJob &job) {
+            job.decoder->writePixels(job.rc, bandTop);
+        });
+    }
 }
 
 bool recCheckGroup(const ExrGroupLayerInfo& group, QStringList list, int idx1, int idx2)
@@ -839,7 +925,21 @@ KisImportExportErrorCode EXRConverter::decode(const QString &filename)
             d->image->addNode(info.groupLayer, groupLayerParent);
         }
 
-        // Load the layers
+        // Create the layers and the decoders for their pixel data
+        QVector<KisPaintLayerSP> layers;
+        QVector<const ExrPaintLayerInfo*> layerInfos;
+        std::vector<std::unique_ptr<Private::BandDecoderBase>> decoders;
+
+        /**
+         * The file is read in bands of rows to avoid allocating the
+         * buffers for the whole image. The bands are aligned to the
+         * scanline blocks (or tiles) of the file, so that every block
+         * is decompressed only once.
+         */
+        const int blockHeight = file.header().hasTileDescription() ?
+                    int(file.header().tileDescription().ySize) :
+                    Imf::numLinesInBuffer(file.header().compression());
+
         for (int i = informationObjects.size() - 1; i >= 0; --i) {
             ExrPaintLayerInfo& info = informationObjects[i];
             if (info.colorSpace) {
@@ -852,57 +952,101 @@ KisImportExportErrorCode EXRConverter::decode(const QString &filename)
 
                 layer->setCompositeOpId(COMPOSITE_OVER);
 
-                switch (info.channelMap.size()) {
-                case 1:
-                case 2:
-                    // Decode the data
-                    switch (info.imageType) {
-                    case IT_FLOAT16:
-                        d->decodeData1<half>(file, info, layer, width, dx, dy, height, Imf::HALF);
-                        break;
-                    case IT_FLOAT32:
-                        d->decodeData1<float>(file, info, layer, width, dx, dy, height, Imf::FLOAT);
-                        break;
-                    case IT_UNKNOWN:
-                    case IT_UNSUPPORTED:
-                        qFatal("Impossible error");
-                    }
+                layers.append(layer);
+                layerInfos.append(&info);
+            } else {
+                dbgFile << "No decoding " << info.name << " with " << info.channelMap.size() << " channels, and lack of a color space";
+            }
+        }
+
+        int totalRowSize = 0;
+        for (int i = 0; i < layers.size(); i++) {
+            const int pixelSize = layerInfos[i]->imageType == IT_FLOAT16 ? sizeof(half) : sizeof(float);
+            totalRowSize += width * pixelSize * (layerInfos[i]->channelMap.size() <= 2 ? 2 : 4);
+        }
+
+        /**
+         * The band is rounded to the whole blocks, unless a single block
+         * doesn't fit into the memory limit. In such a case the band is
+         * clamped to the limit, at the cost of decompressing the blocks
+         * more than once.
+         */
+        const int bandMemoryLimit = 64 * 1024 * 1024;
+        const int maxBandHeight = qMax(1, bandMemoryLimit / qMax(1, totalRowSize));
+        const int bandHeight =
+            qMin(maxBandHeight, qMax(1, maxBandHeight / qMax(1, blockHeight)) * qMax(1, blockHeight));
+
+        dbgFile << "Reading the file in bands of" << bandHeight << "rows, block height" << blockHeight;
+
+        for (int i = 0; i < layers.size(); i++) {
+            const ExrPaintLayerInfo& info = *layerInfos[i];
+            KisPaintLayerSP layer = layers[i];
+
+            switch (info.channelMap.size()) {
+            case 1:
+            case 2:
+                // Decode the data
+                switch (info.imageType) {
+                case IT_FLOAT16:
+                    decoders.emplace_back(new Private::BandDecoder1<half>(d.data(), info, layer, width, dx, bandHeight, Imf::HALF));
                     break;
-                case 3:
-                case 4:
-                    // Decode the data
-                    switch (info.imageType) {
-                    case IT_FLOAT16:
-                        d->decodeData4<half>(file, info, layer, width, dx, dy, height, Imf::HALF);
-                        break;
-                    case IT_FLOAT32:
-                        d->decodeData4<float>(file, info, layer, width, dx, dy, height, Imf::FLOAT);
-                        break;
-                    case IT_UNKNOWN:
-                    case IT_UNSUPPORTED:
-                        qFatal("Impossible error");
-                    }
+                case IT_FLOAT32:
+                    decoders.emplace_back(new Private::BandDecoder1<float>(d.data(), info, layer, width, dx, bandHeight, Imf::FLOAT));
                     break;
-                default:
-                    qFatal("Invalid number of channels: %i", info.channelMap.size());
+                case IT_UNKNOWN:
+                case IT_UNSUPPORTED:
+                    qFatal("Impossible error");
                 }
-                // Check if should set the channels
-                if (!info.remappedChannels.isEmpty()) {
-                    QList<KisMetaData::Value> values;
-                    Q_FOREACH (const ExrPaintLayerInfo::Remap& remap, info.remappedChannels) {
-                        QMap<QString, KisMetaData::Value> map;
-                        map["original"] = KisMetaData::Value(remap.original);
-                        map["current"] = KisMetaData::Value(remap.current);
-                        values.append(map);
-                    }
-                    layer->metaData()->addEntry(KisMetaData::Entry(KisMetaData::SchemaRegistry::instance()->create("http://krita.org/exrchannels/1.0/" , "exrchannels"), "channelsmap", values));
+                break;
+            case 3:
+            case 4:
+                // Decode the data
+                switch (info.imageType) {
+                case IT_FLOAT16:
+                    decoders.emplace_back(new Private::BandDecoder4<half>(d.data(), info, layer, width, dx, bandHeight, Imf::HALF));
+                    break;
+                case IT_FLOAT32:
+                    decoders.emplace_back(new Private::BandDecoder4<float>(d.data(), info, layer, width, dx, bandHeight, Imf::FLOAT));
+                    break;
+                case IT_UNKNOWN:
+                case IT_UNSUPPORTED:
+                    qFatal("Impossible error");
                 }
-                // Add the layer
-                KisGroupLayerSP groupLayerParent = (info.parent) ? info.parent->groupLayer : d->image->rootLayer();
-                d->image->addNode(layer, groupLayerParent);
-            } else {
-                dbgFile << "No decoding " << info.name << " with " << info.channelMap.size() << " channels, and lack of a color space";
+                break;
+            default:
+                qFatal("Invalid number of channels: %i", info.channelMap.size());
+            }
+        }
+
+        // Load the layers
+        {
+            QVector<Private::BandDecoderBase*> decoderPtrs;
+            for (const auto &decoder : decoders) {
+                decoderPtrs.append(decoder.get());
             }
+
+            d->decodeLayers(file, decoderPtrs, width, dx, dy, height, bandHeight);
+            decoders.clear();
+        }
+
+        for (int i = 0; i < layers.size(); i++) {
+            const ExrPaintLayerInfo& info = *layerInfos[i];
+            KisPaintLayerSP layer = layers[i];
+
+            // Check if should set the channels
+            if (!info.remappedChannels.isEmpty()) {
+                QList<KisMetaData::Value> values;
+                Q_FOREACH (const ExrPaintLayerInfo::Remap& remap, info.remappedChannels) {
+                    QMap<QString, KisMetaData::Value> map;
+                    map["original"] = KisMetaData::Value(remap.original);
+                    map["current"] = KisMetaData::Value(remap.current);
+                    values.append(map);
+                }
+                layer->metaData()->addEntry(KisMetaData::Entry(KisMetaData::SchemaRegistry::instance()->create("http://krita.org/exrchannels/1.0/" , "exrchannels"), "channelsmap", values));
+            }
+            // Add the layer
+            KisGroupLayerSP groupLayerParent = (info.parent) ? info.parent->groupLayer : d->image->rootLayer();
+            d->image->addNode(layer, groupLayerParent);
         }
 
         // After reading the image, notify the user about changed alpha.
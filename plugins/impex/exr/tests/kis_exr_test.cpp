@@ -13,6 +13,10 @@
 
 #include <half.h>
 #include <KisMimeDatabase.h>
+#include <KoColorSpaceRegistry.h>
+#include <KoColorModelStandardIds.h>
+#include <kis_layer_utils.h>
+#include <kis_paint_layer.h>
 #include "filestest.h"
 
 #ifndef FILES_DATA_DIR
@@ -93,6 +97,61 @@ void KisExrTest::testRoundTrip()
 
 }
 
+void KisExrTest::testMultiLayerRoundTrip()
+{
+    const KoColorSpace *cs =
+        KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(), Float16BitsColorDepthID.id(), QString());
+
+    // the size is not aligned to the tiles or to the bands of the importer
+    const QRect imageRect(0, 0, 517, 333);
+
+    QScopedPointer<KisDocument> doc1(KisPart::instance()->createDocument());
+    KisImageSP image = new KisImage(0, imageRect.width(), imageRect.height(), cs, "exr multilayer test");
+    doc1->setCurrentImage(image);
+
+    const int numLayers = 5;
+
+    for (int i = 0; i < numLayers; i++) {
+        /**
+         * The noise is generated in 8 bits, because random bytes would
+         * make NaNs and infinities in the half-float channels
+         */
+        KisPaintDeviceSP dev = new KisPaintDevice(KoColorSpaceRegistry::instance()->rgb8());
+        TestUtil::fillWithNoise(dev, imageRect.adjusted(i * 7, i * 11, -i * 13, -i * 3), i + 1, true);
+        dev->convertTo(cs);
+
+        KisPaintLayerSP layer = new KisPaintLayer(image, QString("layer%1").arg(i), OPACITY_OPAQUE_U8, dev);
+        image->addNode(layer, image->root());
+    }
+
+    image->initialRefreshGraph();
+
+    QTemporaryFile savedFile(QDir::tempPath() + QLatin1String("/krita_XXXXXX") + QLatin1String(".exr"));
+    savedFile.setAutoRemove(true);
+    savedFile.open();
+
+    const QString savedFileName(savedFile.fileName());
+
+    QVERIFY(doc1->exportDocumentSync(savedFileName, ExrMimetype.toLatin1()));
+
+    QScopedPointer<KisDocument> doc2(KisPart::instance()->createDocument());
+    doc2->setFileBatchMode(true);
+    QVERIFY(doc2->importDocument(savedFileName));
+    QVERIFY(doc2->image());
+
+    for (int i = 0; i < numLayers; i++) {
+        const QString name = QString("layer%1").arg(i);
+
+        KisNodeSP srcNode = KisLayerUtils::findNodeByName(doc1->image()->root(), name);
+        KisNodeSP dstNode = KisLayerUtils::findNodeByName(doc2->image()->root(), name);
+
+        QVERIFY(srcNode);
+        QVERIFY(dstNode);
+
+        QVERIFY(TestUtil::comparePaintDevicesClever<half>(srcNode->paintDevice(), dstNode->paintDevice(), 0.01 /* meaningless alpha */));
+    }
+}
+
 KISTEST_MAIN(KisExrTest)
 
 
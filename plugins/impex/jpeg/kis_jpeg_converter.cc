@@ -55,6 +55,7 @@ extern "C" {
 #include <kis_painter.h>
 #include <kis_transaction.h>
 #include <kis_transform_worker.h>
+#include <KisRowBandReader.h>
 
 #define ICC_MARKER  (JPEG_APP0 + 2) /* JPEG marker code for ICC */
 #define ICC_OVERHEAD_LEN  14    /* size of non-profile data in APP2 */
@@ -454,26 +455,25 @@ KisImageSP KisJPEGConverter::image()
 }
 
 
-KisImportExportErrorCode KisJPEGConverter::buildFile(QIODevice *io, KisPaintLayerSP layer, KisJPEGOptions options, KisMetaData::Store* metaData)
+KisImportExportErrorCode KisJPEGConverter::buildFile(QIODevice *io, KisImageSP image, KisPaintDeviceSP device, KisJPEGOptions options, KisMetaData::Store* metaData)
 {
-    KIS_ASSERT_RECOVER_RETURN_VALUE(layer, ImportExportCodes::InternalError);
-
-    KisImageSP image = KisImageSP(layer->image());
     KIS_ASSERT_RECOVER_RETURN_VALUE(image, ImportExportCodes::InternalError);
+    KIS_ASSERT_RECOVER_RETURN_VALUE(device, ImportExportCodes::InternalError);
 
-    const KoColorSpace * cs = layer->colorSpace();
+    /**
+     * The device is never modified, the pixels are converted into
+     * the destination color space when the scanlines are written
+     */
+    const KoColorSpace * cs = device->colorSpace();
     J_COLOR_SPACE color_type = getColorTypeforColorSpace(cs);
 
     if (color_type == JCS_UNKNOWN) {
-        layer->paintDevice()->convertTo(KoColorSpaceRegistry::instance()->rgb8(), KoColorConversionTransformation::internalRenderingIntent(), KoColorConversionTransformation::internalConversionFlags());
         cs = KoColorSpaceRegistry::instance()->rgb8();
         color_type = JCS_RGB;
     }
 
     if (options.forceSRGB) {
-        const KoColorSpace* dst = KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(), layer->colorSpace()->colorDepthId().id(), "sRGB built-in - (lcms internal)");
-        layer->paintDevice()->convertTo(dst);
-        cs = dst;
+        cs = KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(), cs->colorDepthId().id(), "sRGB built-in - (lcms internal)");
         color_type = JCS_RGB;
     }
 
@@ -621,16 +621,17 @@ KisImportExportErrorCode KisJPEGConverter::buildFile(QIODevice *io, KisPaintLaye
         }
 
 
-        KisPaintDeviceSP dev = new KisPaintDevice(layer->colorSpace());
-        KoColor c(options.transparencyFillColor, layer->colorSpace());
-        dev->fill(QRect(0, 0, width, height), c);
-        KisPainter gc(dev);
-        gc.bitBlt(QPoint(0, 0), layer->paintDevice(), QRect(0, 0, width, height));
-        gc.end();
+        /**
+         * The image is flattened onto the transparency fill color and
+         * converted in bands of rows, so we never create a copy of the
+         * whole image
+         */
+        KisRowBandReader reader(device, QRect(0, 0, width, height), cs);
+        reader.setBackgroundColor(KoColor(options.transparencyFillColor, device->colorSpace()));
 
 
         if (options.saveProfile) {
-            const KoColorProfile* colorProfile = layer->colorSpace()->profile();
+            const KoColorProfile* colorProfile = cs->profile();
             QByteArray colorProfileData = colorProfile->rawData();
             write_icc_profile(& cinfo, (uchar*) colorProfileData.data(), colorProfileData.size());
         }
@@ -638,10 +639,10 @@ KisImportExportErrorCode KisJPEGConverter::buildFile(QIODevice *io, KisPaintLaye
         // Write data information
 
         JSAMPROW row_pointer = new JSAMPLE[width*cinfo.input_components];
-        int color_nb_bits = 8 * layer->paintDevice()->pixelSize() / layer->paintDevice()->channelCount();
+        int color_nb_bits = 8 * cs->pixelSize() / cs->channelCount();
 
         for (; cinfo.next_scanline < height;) {
-            KisHLineConstIteratorSP it = dev->createHLineConstIteratorNG(0, cinfo.next_scanline, width);
+            KisHLineConstIteratorSP it = reader.deviceForRow(cinfo.next_scanline)->createHLineConstIteratorNG(0, cinfo.next_scanline, width);
             quint8 *dst = row_pointer;
             switch (color_type) {
             case JCS_GRAYSCALE:
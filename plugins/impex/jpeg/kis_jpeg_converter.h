@@ -57,7 +57,7 @@ public:
     ~KisJPEGConverter() override;
 public:
     KisImportExportErrorCode buildImage(QIODevice *io);
-    KisImportExportErrorCode buildFile(QIODevice *io, KisPaintLayerSP layer, KisJPEGOptions options, KisMetaData::Store* metaData);
+    KisImportExportErrorCode buildFile(QIODevice *io, KisImageSP image, KisPaintDeviceSP device, KisJPEGOptions options, KisMetaData::Store* metaData);
     /** Retrieve the constructed image
     */
     KisImageSP image();
@@ -0,0 +1,67 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kis_kra_autosave_cache.h"
+
+#include <QFileInfo>
+#include <QGlobalStatic>
+
+Q_GLOBAL_STATIC(KisKraAutosaveCache, s_instance)
+
+namespace {
+/**
+ * The file is committed after the entries are recorded and some file
+ * systems store the modification time with two seconds precision
+ */
+const int modificationTimeTolerance = 2;
+}
+
+KisKraAutosaveCache* KisKraAutosaveCache::instance()
+{
+    return s_instance;
+}
+
+KisKraAutosaveCache::Entries KisKraAutosaveCache::entries(const QString &fileName)
+{
+    QMutexLocker l(&m_mutex);
+
+    auto it = m_files.find(fileName);
+    if (it == m_files.end()) {
+        return Entries();
+    }
+
+    /**
+     * If the saving failed after the entries had been recorded, the
+     * file still contains the data of some older save, so we check that
+     * it has really been written after the entries were recorded
+     */
+    const QFileInfo info(fileName);
+    if (!info.exists() ||
+        info.lastModified() < it->saveTime.addSecs(-modificationTimeTolerance)) {
+
+        m_files.erase(it);
+        return Entries();
+    }
+
+    return it->entries;
+}
+
+void KisKraAutosaveCache::setEntries(const QString &fileName, const Entries &entries)
+{
+    QMutexLocker l(&m_mutex);
+
+    FileRecord record;
+    record.entries = entries;
+    record.saveTime = QDateTime::currentDateTime();
+
+    m_files.insert(fileName, record);
+}
+
+void KisKraAutosaveCache::forget(const QString &fileName)
+{
+    QMutexLocker l(&m_mutex);
+    m_files.remove(fileName);
+}
@@ -0,0 +1,69 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KIS_KRA_AUTOSAVE_CACHE_H
+#define KIS_KRA_AUTOSAVE_CACHE_H
+
+#include <QDateTime>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+
+#include "kritalibkra_export.h"
+
+/**
+ * Remembers which pixel data entries have been written into the autosave
+ * files and which content versions of the devices (see
+ * KisPaintDevice::contentVersion()) they store.
+ *
+ * The next autosave of the same document copies the entries of the devices
+ * that haven't been changed since then from the previous file instead of
+ * encoding the devices again.
+ */
+class KRITALIBKRA_EXPORT KisKraAutosaveCache
+{
+public:
+    struct Entry {
+        /// absolute location of the entry in the store, e.g. "tar:/image/layers/layer2"
+        QString location;
+        /// size of the uncompressed entry data
+        qint64 size {0};
+    };
+
+    /// the entries keyed by the content version of the saved devices
+    using Entries = QHash<quint64, Entry>;
+
+    static KisKraAutosaveCache* instance();
+
+    /**
+     * @return the entries written by the last successful save into
+     *         \p fileName, or an empty hash if the file doesn't exist
+     *         anymore or has been written by somebody else since then
+     */
+    Entries entries(const QString &fileName);
+
+    /**
+     * Record that \p fileName now contains \p entries
+     */
+    void setEntries(const QString &fileName, const Entries &entries);
+
+    /**
+     * Forget the entries of \p fileName, e.g. when the file turned out
+     * to be unreadable
+     */
+    void forget(const QString &fileName);
+
+private:
+    struct FileRecord {
+        Entries entries;
+        QDateTime saveTime;
+    };
+
+    QMutex m_mutex;
+    QHash<QString, FileRecord> m_files;
+};
+
+#endif // KIS_KRA_AUTOSAVE_CACHE_H
@@ -17,6 +17,7 @@
 #include <QByteArray>
 #include <QMessageBox>
 #include <QApplication>
+#include <QtConcurrent>
 
 #include <KoMD5Generator.h>
 #include <KoColorSpaceRegistry.h>
@@ -32,6 +33,7 @@
 #include "kis_dom_utils.h"
 #include "kis_filter_registry.h"
 #include "kis_generator_registry.h"
+#include "kis_image_config.h"
 #include "kis_paint_device_frames_interface.h"
 #include "kis_raster_keyframe_channel.h"
 #include "kis_shape_selection.h"
@@ -117,6 +119,26 @@ KisKraLoadVisitor::KisKraLoadVisitor(KisImageSP image,
         m_store->popDirectory();
     }
     m_syntaxVersion = syntaxVersion;
+
+    KisImageConfig cfg(true);
+
+    const int numThreads = qMax(1, cfg.maxNumberOfThreads());
+    m_decodingPool.setMaxThreadCount(numThreads);
+
+    // the devices are decoded on the pool, so read the config only once
+    m_tilesStreamOptions.lazyDecompression = cfg.lazyTilesDecompression();
+
+    // keep a few devices in flight per thread, but don't keep
+    // the whole compressed document in memory
+    m_maxPendingDeviceReads = 2 * numThreads;
+}
+
+KisKraLoadVisitor::~KisKraLoadVisitor()
+{
+    KIS_SAFE_ASSERT_RECOVER_NOOP(m_pendingDeviceReads.empty() &&
+                                 "flushPendingDeviceReads() hasn't been called");
+    m_pendingDeviceReads.clear();
+    m_decodingPool.waitForDone();
 }
 
 void KisKraLoadVisitor::setExternalUri(const QString &uri)
@@ -189,10 +211,14 @@ bool KisKraLoadVisitor::visit(KisPaintLayer *layer)
 {
     loadNodeKeyframes(layer);
 
-    if (!loadPaintDevice(layer->paintDevice(), getLocation(layer))) {
+    /**
+     * The pixel data of the layer may be decoded in a background thread,
+     * so the profile should be assigned to the device before that
+     */
+    if (!loadProfile(layer->paintDevice(), getLocation(layer, DOT_ICC))) {
         return false;
     }
-    if (!loadProfile(layer->paintDevice(), getLocation(layer, DOT_ICC))) {
+    if (!loadPaintDevice(layer->paintDevice(), getLocation(layer), true)) {
         return false;
     }
     if (!loadMetaData(layer)) {
@@ -529,22 +555,28 @@ QStringList KisKraLoadVisitor::warningMessages() const
 
 struct SimpleDevicePolicy
 {
+    SimpleDevicePolicy(const KisTilesStreamOptions &options)
+        : m_options(options) {}
+
     bool read(KisPaintDeviceSP dev, QIODevice *stream) {
-        return dev->read(stream);
+        return dev->read(stream, m_options);
     }
 
     void setDefaultPixel(KisPaintDeviceSP dev, const KoColor &defaultPixel) const {
         return dev->setDefaultPixel(defaultPixel);
     }
+
+    KisTilesStreamOptions m_options;
 };
 
 struct FramedDevicePolicy
 {
-    FramedDevicePolicy(int frameId)
-        :  m_frameId(frameId) {}
+    FramedDevicePolicy(int frameId, const KisTilesStreamOptions &options)
+        :  m_frameId(frameId),
+           m_options(options) {}
 
     bool read(KisPaintDeviceSP dev, QIODevice *stream) {
-        return dev->framesInterface()->readFrame(stream, m_frameId);
+        return dev->framesInterface()->readFrame(stream, m_frameId, m_options);
     }
 
     void setDefaultPixel(KisPaintDeviceSP dev, const KoColor &defaultPixel) const {
@@ -552,9 +584,38 @@ struct FramedDevicePolicy
     }
 
     int m_frameId;
+    KisTilesStreamOptions m_options;
 };
 
-bool KisKraLoadVisitor::loadPaintDevice(KisPaintDeviceSP device, const QString& location)
+struct FrameDeltaDevicePolicy
+{
+    FrameDeltaDevicePolicy(int frameId, int baseFrameId, const KisTilesStreamOptions &options)
+        : m_frameId(frameId),
+          m_baseFrameId(baseFrameId),
+          m_options(options) {}
+
+    bool read(KisPaintDeviceSP dev, QIODevice *stream) {
+        return dev->framesInterface()->readFrameDelta(stream, m_frameId, m_baseFrameId, m_options);
+    }
+
+    void setDefaultPixel(KisPaintDeviceSP dev, const KoColor &defaultPixel) const {
+        return dev->framesInterface()->setFrameDefaultPixel(defaultPixel, m_frameId);
+    }
+
+    int m_frameId;
+    int m_baseFrameId;
+    KisTilesStreamOptions m_options;
+};
+
+namespace {
+/**
+ * The compressed data of bigger devices is read from the store directly
+ * in the visitor's thread, we don't want to keep it in memory twice
+ */
+const qint64 maxBufferedDeviceSize = 256 * 1024 * 1024;
+}
+
+bool KisKraLoadVisitor::loadPaintDevice(KisPaintDeviceSP device, const QString& location, bool allowDeferredRead)
 {
     // Layer data
     KisPaintDeviceFramesInterface *frameInterface = device->framesInterface();
@@ -565,21 +626,79 @@ bool KisKraLoadVisitor::loadPaintDevice(KisPaintDeviceSP device, const QString&
     }
 
     if (!frameInterface || frames.count() <= 1) {
-        return loadPaintDeviceFrame(device, location, SimpleDevicePolicy());
+        return loadPaintDeviceFrame(device, location, SimpleDevicePolicy(m_tilesStreamOptions), allowDeferredRead);
     } else {
         KisRasterKeyframeChannel *keyframeChannel = device->keyframeChannel();
 
+        /**
+         * A frame may be saved as a difference with another frame of the
+         * same device, which is named in its ".base" entry. Such frames
+         * are loaded after their bases.
+         */
+        QHash<QString, int> frameIdByFilename;
+        Q_FOREACH (int id, frames) {
+            frameIdByFilename.insert(keyframeChannel->frameFilename(id), id);
+        }
+
+        const int noBaseFrame = -1;
+        const int missingBaseFrame = -2;
+
+        QSet<int> processedFrames;
+        QSet<int> loadedFrames;
+
         for (int i = 0; i < frames.count(); i++) {
+            // pairs of (frameId, baseFrameId), the frame comes before its base
+            QVector<QPair<int, int>> chain;
+            QSet<int> chainFrames;
+
             int id = frames[i];
-            if (keyframeChannel->frameFilename(id).isEmpty()) {
-                m_warningMessages << i18n("Could not find keyframe pixel data for frame %1 in %2.", id, location);
+            while (!processedFrames.contains(id) && !chainFrames.contains(id)) {
+                const QString frameFilename = keyframeChannel->frameFilename(id);
+                const QString baseFrameFilename =
+                    frameFilename.isEmpty() ? QString() : loadBaseFrameFilename(getLocation(frameFilename));
+
+                const int baseId =
+                    baseFrameFilename.isEmpty() ? noBaseFrame :
+                    frameIdByFilename.value(baseFrameFilename, missingBaseFrame);
+
+                chain.append(qMakePair(id, baseId));
+                chainFrames.insert(id);
+
+                if (baseId < 0) break;
+                id = baseId;
             }
-            else {
-                Q_ASSERT(!keyframeChannel->frameFilename(id).isEmpty());
+
+            for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+                const int id = it->first;
+                const int baseId = it->second;
+
+                processedFrames.insert(id);
+
+                if (keyframeChannel->frameFilename(id).isEmpty()) {
+                    m_warningMessages << i18n("Could not find keyframe pixel data for frame %1 in %2.", id, location);
+                    continue;
+                }
+
                 QString frameFilename = getLocation(keyframeChannel->frameFilename(id));
                 Q_ASSERT(!frameFilename.isEmpty());
 
-                if (!loadPaintDeviceFrame(device, frameFilename, FramedDevicePolicy(id))) {
+                bool result = false;
+
+                if (baseId == noBaseFrame) {
+                    result = loadPaintDeviceFrame(device, frameFilename, FramedDevicePolicy(id, m_tilesStreamOptions), allowDeferredRead);
+                } else if (loadedFrames.contains(baseId)) {
+                    /**
+                     * The base should be fully decoded before we share
+                     * its tiles. The deltas are small, so they are read
+                     * directly.
+                     */
+                    finishPendingDeviceReads(device);
+                    result = loadPaintDeviceFrame(device, frameFilename, FrameDeltaDevicePolicy(id, baseId, m_tilesStreamOptions), false);
+                }
+
+                if (result) {
+                    loadedFrames.insert(id);
+                } else {
                     m_warningMessages << i18n("Could not load keyframe pixel data for frame %1 in %2.", id, location);
                 }
             }
@@ -590,7 +709,7 @@ bool KisKraLoadVisitor::loadPaintDevice(KisPaintDeviceSP device, const QString&
 }
 
 template<class DevicePolicy>
-bool KisKraLoadVisitor::loadPaintDeviceFrame(KisPaintDeviceSP device, const QString &location, DevicePolicy policy)
+bool KisKraLoadVisitor::loadPaintDeviceFrame(KisPaintDeviceSP device, const QString &location, DevicePolicy policy, bool allowDeferredRead)
 {
     {
         const int pixelSize = device->colorSpace()->pixelSize();
@@ -608,6 +727,30 @@ bool KisKraLoadVisitor::loadPaintDeviceFrame(KisPaintDeviceSP device, const QStr
     }
 
     if (m_store->open(location)) {
+        if (allowDeferredRead && m_store->size() <= maxBufferedDeviceSize) {
+            const QByteArray data = m_store->read(m_store->size());
+            m_store->close();
+
+            PendingDeviceRead pending;
+            pending.location = location;
+            pending.device = device;
+            pending.readResult = QtConcurrent::run(&m_decodingPool,
+                [device, data, policy] () mutable {
+                    QBuffer buffer;
+                    buffer.setData(data);
+                    buffer.open(QIODevice::ReadOnly);
+                    return policy.read(device, &buffer);
+                });
+
+            m_pendingDeviceReads.push_back(pending);
+
+            while (int(m_pendingDeviceReads.size()) > m_maxPendingDeviceReads) {
+                finishFrontPendingDevice();
+            }
+
+            return true;
+        }
+
         if (!policy.read(device, m_store->device())) {
             m_warningMessages << i18n("Could not read pixel data: %1.", location);
             device->disconnect();
@@ -623,6 +766,57 @@ bool KisKraLoadVisitor::loadPaintDeviceFrame(KisPaintDeviceSP device, const QStr
     return true;
 }
 
+bool KisKraLoadVisitor::finishFrontPendingDevice()
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(!m_pendingDeviceReads.empty(), false);
+
+    PendingDeviceRead pending = m_pendingDeviceReads.front();
+    m_pendingDeviceReads.pop_front();
+
+    if (!pending.readResult.result()) {
+        m_warningMessages << i18n("Could not read pixel data: %1.", pending.location);
+        pending.device->disconnect();
+        return false;
+    }
+
+    return true;
+}
+
+void KisKraLoadVisitor::finishPendingDeviceReads(KisPaintDeviceSP device)
+{
+    auto isReadingDevice = [device] (const PendingDeviceRead &pending) {
+        return pending.device == device;
+    };
+
+    while (std::find_if(m_pendingDeviceReads.begin(), m_pendingDeviceReads.end(), isReadingDevice) !=
+           m_pendingDeviceReads.end()) {
+
+        finishFrontPendingDevice();
+    }
+}
+
+QString KisKraLoadVisitor::loadBaseFrameFilename(const QString &location)
+{
+    QString result;
+
+    if (m_store->hasFile(location + ".base") && m_store->open(location + ".base")) {
+        result = QString::fromUtf8(m_store->read(m_store->size())).trimmed();
+        m_store->close();
+    }
+
+    return result;
+}
+
+bool KisKraLoadVisitor::flushPendingDeviceReads()
+{
+    bool result = true;
+
+    while (!m_pendingDeviceReads.empty()) {
+        result &= finishFrontPendingDevice();
+    }
+
+    return result;
+}
 
 bool KisKraLoadVisitor::loadProfile(KisPaintDeviceSP device, const QString& location)
 {
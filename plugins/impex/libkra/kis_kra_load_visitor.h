@@ -10,10 +10,15 @@
 
 #include <QRect>
 #include <QStringList>
+#include <QFuture>
+#include <QThreadPool>
+
+#include <deque>
 
 // kritaimage
 #include "kis_types.h"
 #include "kis_node_visitor.h"
+#include <tiles3/KisTilesStreamOptions.h>
 
 #include "kritalibkra_export.h"
 
@@ -35,6 +40,7 @@ public:
                       QMap<KisNode *, QString> &keyframeFilenames,
                       const QString & name,
                       int syntaxVersion);
+    ~KisKraLoadVisitor() override;
 
 public:
     void setExternalUri(const QString &uri);
@@ -57,12 +63,35 @@ public:
     QStringList errorMessages() const;
     QStringList warningMessages() const;
 
+    /**
+     * The pixel data of the paint layers is read from the store serially,
+     * but it is decoded into the paint devices on a pool of worker threads
+     * while the visitor goes on with the other nodes. Call this method
+     * after the node tree has been visited to wait until all the devices
+     * are decoded. Nobody should access the pixels of the paint layers
+     * before that.
+     *
+     * @return false if some of the devices couldn't be read, the reasons
+     *         are added to warningMessages()
+     */
+    bool flushPendingDeviceReads();
+
 private:
+    struct PendingDeviceRead {
+        QString location;
+        KisPaintDeviceSP device;
+        QFuture<bool> readResult;
+    };
 
-    bool loadPaintDevice(KisPaintDeviceSP device, const QString& location);
+    bool finishFrontPendingDevice();
+    void finishPendingDeviceReads(KisPaintDeviceSP device);
+
+    QString loadBaseFrameFilename(const QString &location);
+
+    bool loadPaintDevice(KisPaintDeviceSP device, const QString& location, bool allowDeferredRead = false);
 
     template<class DevicePolicy>
-    bool loadPaintDeviceFrame(KisPaintDeviceSP device, const QString &location, DevicePolicy policy);
+    bool loadPaintDeviceFrame(KisPaintDeviceSP device, const QString &location, DevicePolicy policy, bool allowDeferredRead);
 
     bool loadProfile(KisPaintDeviceSP device,  const QString& location);
     bool loadFilterConfiguration(KisFilterConfigurationSP kfc, const QString& location);
@@ -96,6 +125,11 @@ private:
     QStringList m_warningMessages;
     KoShapeControllerBase *m_shapeController;
     QMap<QString, const KoColorProfile *> m_profileCache;
+
+    QThreadPool m_decodingPool;
+    std::deque<PendingDeviceRead> m_pendingDeviceReads;
+    int m_maxPendingDeviceReads;
+    KisTilesStreamOptions m_tilesStreamOptions;
 };
 
 #endif // KIS_KRA_LOAD_VISITOR_H_
@@ -491,6 +491,8 @@ void KisKraLoader::loadBinaryData(KoStore * store, KisImageSP image, const QStri
     }
 
     image->rootLayer()->accept(visitor);
+    visitor.flushPendingDeviceReads();
+
     if (!visitor.errorMessages().isEmpty()) {
         m_d->errorMessages.append(visitor.errorMessages());
     }
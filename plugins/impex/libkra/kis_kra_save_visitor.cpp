@@ -9,8 +9,11 @@
 #include "kis_kra_save_visitor.h"
 #include "kis_kra_tags.h"
 
+#include <algorithm>
+#include <limits>
 #include <QBuffer>
 #include <QByteArray>
+#include <QtConcurrent>
 
 #include <KoColorProfile.h>
 #include <KoStore.h>
@@ -43,11 +46,13 @@
 #include <kis_transparency_mask.h>
 
 #include "kis_config.h"
+#include "kis_image_config.h"
 #include "kis_store_paintdevice_writer.h"
 #include "flake/kis_shape_selection.h"
 
 #include "kis_raster_keyframe_channel.h"
 #include "kis_paint_device_frames_interface.h"
+#include "kis_datamanager.h"
 
 #include "lazybrush/kis_lazy_fill_tools.h"
 #include <KoStoreDevice.h>
@@ -65,10 +70,27 @@ KisKraSaveVisitor::KisKraSaveVisitor(KoStore *store, const QString & name, QMap<
     , m_nodeFileNames(nodeFileNames)
     , m_writer(new KisStorePaintDeviceWriter(store))
 {
+    KisImageConfig cfg(true);
+
+    const int numThreads = qMax(1, cfg.maxNumberOfThreads());
+    m_encodingPool.setMaxThreadCount(numThreads);
+
+    // the devices are encoded on the pool, so read the config only once
+    m_tilesStreamOptions.compressionAlgorithm =
+        KisCompressionFactory::fromName(cfg.fileTilesCompressionAlgorithm());
+
+    // keep a few devices in flight per thread, but don't keep
+    // the whole encoded document in memory
+    m_maxPendingDeviceWrites = 2 * numThreads;
 }
 
 KisKraSaveVisitor::~KisKraSaveVisitor()
 {
+    KIS_SAFE_ASSERT_RECOVER_NOOP(m_pendingDeviceWrites.empty() &&
+                                 "flushPendingDeviceWrites() hasn't been called");
+    m_pendingDeviceWrites.clear();
+    m_encodingPool.waitForDone();
+
     delete m_writer;
 }
 
@@ -309,37 +331,164 @@ QStringList KisKraSaveVisitor::errorMessages() const
 
 struct SimpleDevicePolicy
 {
+    SimpleDevicePolicy(const KisTilesStreamOptions &options)
+        : m_options(options) {}
+
     bool write(KisPaintDeviceSP dev, KisPaintDeviceWriter &store) {
-        return dev->write(store);
+        return dev->write(store, m_options);
     }
 
     KoColor defaultPixel(KisPaintDeviceSP dev) const {
         return dev->defaultPixel();
     }
+
+    quint64 contentVersion(KisPaintDeviceSP dev) const {
+        return dev->contentVersion();
+    }
+
+    QString baseFrameFilename() const {
+        return QString();
+    }
+
+    KisTilesStreamOptions m_options;
 };
 
 struct FramedDevicePolicy
 {
-    FramedDevicePolicy(int frameId)
-        :  m_frameId(frameId) {}
+    FramedDevicePolicy(int frameId, const KisTilesStreamOptions &options)
+        :  m_frameId(frameId),
+           m_options(options) {}
 
     bool write(KisPaintDeviceSP dev, KisPaintDeviceWriter &store) {
-        return dev->framesInterface()->writeFrame(store, m_frameId);
+        return dev->framesInterface()->writeFrame(store, m_frameId, m_options);
     }
 
     KoColor defaultPixel(KisPaintDeviceSP dev) const {
         return dev->framesInterface()->frameDefaultPixel(m_frameId);
     }
 
+    quint64 contentVersion(KisPaintDeviceSP dev) const {
+        return dev->framesInterface()->frameContentVersion(m_frameId);
+    }
+
+    QString baseFrameFilename() const {
+        return QString();
+    }
+
     int m_frameId;
+    KisTilesStreamOptions m_options;
 };
 
+struct FrameDeltaDevicePolicy
+{
+    FrameDeltaDevicePolicy(int frameId, const KisTiledDataManagerDelta &delta,
+                           const QString &baseFrameFilename, const KisTilesStreamOptions &options)
+        : m_frameId(frameId),
+          m_delta(delta),
+          m_baseFrameFilename(baseFrameFilename),
+          m_options(options) {}
+
+    bool write(KisPaintDeviceSP dev, KisPaintDeviceWriter &store) {
+        return dev->framesInterface()->writeFrameDelta(store, m_frameId, m_delta, m_options);
+    }
+
+    KoColor defaultPixel(KisPaintDeviceSP dev) const {
+        return dev->framesInterface()->frameDefaultPixel(m_frameId);
+    }
+
+    quint64 contentVersion(KisPaintDeviceSP dev) const {
+        Q_UNUSED(dev);
+
+        /**
+         * The delta depends on the content of the base frame as well,
+         * so it cannot be reused by the next autosave
+         */
+        return 0;
+    }
+
+    QString baseFrameFilename() const {
+        return m_baseFrameFilename;
+    }
+
+    int m_frameId;
+    KisTiledDataManagerDelta m_delta;
+    QString m_baseFrameFilename;
+    KisTilesStreamOptions m_options;
+};
+
+namespace {
+
+struct ByteArrayPaintDeviceWriter : public KisPaintDeviceWriter
+{
+    ByteArrayPaintDeviceWriter(QByteArray *data)
+        : m_data(data)
+    {
+    }
+
+    bool write(const QByteArray &data) override {
+        m_data->append(data);
+        return true;
+    }
+
+    bool write(const char* data, qint64 length) override {
+        m_data->append(data, int(length));
+        return true;
+    }
+
+    QByteArray *m_data;
+};
+
+struct CountingPaintDeviceWriter : public KisPaintDeviceWriter
+{
+    CountingPaintDeviceWriter(KisPaintDeviceWriter *writer)
+        : m_writer(writer)
+    {
+    }
+
+    bool write(const QByteArray &data) override {
+        m_bytesWritten += data.size();
+        return m_writer->write(data);
+    }
+
+    bool write(const char* data, qint64 length) override {
+        m_bytesWritten += length;
+        return m_writer->write(data, length);
+    }
+
+    KisPaintDeviceWriter *m_writer;
+    qint64 m_bytesWritten {0};
+};
+
+/**
+ * The devices smaller than this limit are encoded into a memory buffer on
+ * the encoding pool and only then written into the store, both for STORED
+ * and deflated entries. The bigger ones are encoded directly into the
+ * store, so that we never get close to the size limit of QByteArray and
+ * don't double the memory footprint of the really huge layers
+ */
+const qint64 maxBufferedDeviceSize = 256 * 1024 * 1024;
+
+/**
+ * Every delta keyframe can be loaded only after its base frame has been
+ * loaded, so the chains of deltas are limited to let the loader decode
+ * the full keyframes in parallel
+ */
+const int maxKeyframeDeltaChainLength = 8;
+
+/**
+ * The entries reused from the previous save are copied in chunks
+ */
+const qint64 copyChunkSize = 1024 * 1024;
+
+}
+
 bool KisKraSaveVisitor::savePaintDevice(KisPaintDeviceSP device,
                                         QString location)
 {
     // Layer data
     KisConfig cfg(true);
-    m_store->setCompressionEnabled(cfg.compressKra());
+    const bool compressionEnabled = cfg.compressKra();
+    const bool saveKeyframesAsDeltas = cfg.saveKeyframesAsDeltas();
 
     KisPaintDeviceFramesInterface *frameInterface = device->framesInterface();
     QList<int> frames;
@@ -349,47 +498,276 @@ bool KisKraSaveVisitor::savePaintDevice(KisPaintDeviceSP device,
     }
 
     if (!frameInterface || frames.count() <= 1) {
-        savePaintDeviceFrame(device, location, SimpleDevicePolicy());
+        savePaintDeviceFrame(device, location, compressionEnabled, SimpleDevicePolicy(m_tilesStreamOptions));
     } else {
         KisRasterKeyframeChannel *keyframeChannel = device->keyframeChannel();
 
+        /**
+         * The neighbouring keyframes usually differ in a few tiles only,
+         * so, if enabled, we save every frame as a difference with the
+         * previous one, unless it has changed too much or the chain of
+         * deltas is already too long. The base frame filename is saved
+         * into a ".base" entry along with the frame.
+         */
+        auto firstTime = [keyframeChannel] (int id) {
+            const QSet<int> times = keyframeChannel->timesForFrameID(id);
+            return times.isEmpty() ? std::numeric_limits<int>::max() : *std::min_element(times.begin(), times.end());
+        };
+
+        std::stable_sort(frames.begin(), frames.end(),
+                         [firstTime] (int lhs, int rhs) {
+                             return firstTime(lhs) < firstTime(rhs);
+                         });
+
+        int deltaChainLength = 0;
+
         for (int i = 0; i < frames.count(); i++) {
             int id = frames[i];
 
             QString frameFilename = getLocation(keyframeChannel->frameFilename(id));
             Q_ASSERT(!frameFilename.isEmpty());
 
-            if (!savePaintDeviceFrame(device, frameFilename, FramedDevicePolicy(id))) {
+            bool result = false;
+
+            const bool canSaveDelta =
+                saveKeyframesAsDeltas && i > 0 &&
+                deltaChainLength < maxKeyframeDeltaChainLength;
+
+            KisTiledDataManagerDelta delta;
+            if (canSaveDelta) {
+                delta = frameInterface->frameDelta(id, frames[i - 1]);
+            }
+
+            if (canSaveDelta && 2 * delta.numTiles() < frameInterface->frameNumTiles(id)) {
+                deltaChainLength++;
+                const int baseId = frames[i - 1];
+                result = savePaintDeviceFrame(device, frameFilename, compressionEnabled,
+                                              FrameDeltaDevicePolicy(id, delta, keyframeChannel->frameFilename(baseId),
+                                                                     m_tilesStreamOptions));
+            } else {
+                deltaChainLength = 0;
+                result = savePaintDeviceFrame(device, frameFilename, compressionEnabled, FramedDevicePolicy(id, m_tilesStreamOptions));
+            }
+
+            if (!result) {
                 return false;
             }
         }
     }
 
-    m_store->setCompressionEnabled(true);
     return true;
 }
 
 
 template<class DevicePolicy>
-bool KisKraSaveVisitor::savePaintDeviceFrame(KisPaintDeviceSP device, QString location, DevicePolicy policy)
+bool KisKraSaveVisitor::savePaintDeviceFrame(KisPaintDeviceSP device, QString location, bool compressionEnabled, DevicePolicy policy)
 {
-    if (m_store->open(location)) {
-        if (!policy.write(device, *m_writer)) {
-            device->disconnect();
+    const KoColor defaultPixel = policy.defaultPixel(device);
+    const quint64 contentVersion = policy.contentVersion(device);
+    const QRect extent = device->extent();
+    const qint64 estimatedSize = qint64(extent.width()) * extent.height() * device->pixelSize();
+
+    /**
+     * The pending entries are written into the store later, when the store
+     * might have already left the current directory (e.g. for colorize
+     * masks), so we should resolve the path right now.
+     */
+    const QString absoluteLocation = location.startsWith("tar:/") ? location : "tar:/" + m_store->currentPath() + location;
+
+    if (m_previousStore && m_previousEntries.contains(contentVersion)) {
+        const KisKraAutosaveCache::Entry previousEntry = m_previousEntries.value(contentVersion);
+        const CopyResult result = copyPreviousDeviceEntry(previousEntry, absoluteLocation, compressionEnabled);
+
+        if (result == CopyResult::Copied) {
+            m_savedEntries.insert(contentVersion, {absoluteLocation, previousEntry.size});
+            m_numReusedEntries++;
+
+            if (m_store->open(absoluteLocation + ".defaultpixel")) {
+                m_store->write((char*)defaultPixel.data(), device->colorSpace()->pixelSize());
+                m_store->close();
+            }
+            return true;
+        } else if (result == CopyResult::Failed) {
+            m_errorMessages << i18n("Failed to save the pixel data to %1.", absoluteLocation);
+            return false;
+        }
+    }
+
+    if (estimatedSize > maxBufferedDeviceSize) {
+        m_store->setCompressionEnabled(compressionEnabled);
+
+        if (m_store->open(location)) {
+            CountingPaintDeviceWriter writer(m_writer);
+
+            if (!policy.write(device, writer)) {
+                device->disconnect();
+                m_store->close();
+                m_store->setCompressionEnabled(true);
+                return false;
+            }
+
+            m_store->close();
+
+            if (contentVersion) {
+                m_savedEntries.insert(contentVersion, {absoluteLocation, writer.m_bytesWritten});
+            }
+        }
+        if (m_store->open(location + ".defaultpixel")) {
+            m_store->write((char*)defaultPixel.data(), device->colorSpace()->pixelSize());
+            m_store->close();
+        }
+        if (!policy.baseFrameFilename().isEmpty() && m_store->open(location + ".base")) {
+            m_store->write(policy.baseFrameFilename().toUtf8());
+            m_store->close();
+        }
+
+        m_store->setCompressionEnabled(true);
+        return true;
+    }
+
+    PendingDeviceWrite pending;
+
+    pending.location = absoluteLocation;
+    pending.compressionEnabled = compressionEnabled;
+    pending.defaultPixel = QByteArray((const char*)defaultPixel.data(), device->colorSpace()->pixelSize());
+    pending.contentVersion = contentVersion;
+    pending.baseFrameFilename = policy.baseFrameFilename();
+    pending.device = device;
+    pending.encodedDevice = QtConcurrent::run(&m_encodingPool,
+        [device, policy] () mutable {
+            EncodedDevice result;
+            ByteArrayPaintDeviceWriter writer(&result.data);
+            result.success = policy.write(device, writer);
+            return result;
+        });
+
+    m_pendingDeviceWrites.push_back(pending);
+
+    bool result = true;
+
+    while (int(m_pendingDeviceWrites.size()) > m_maxPendingDeviceWrites) {
+        result &= writeFrontPendingDevice();
+    }
+
+    return result;
+}
+
+KisKraSaveVisitor::CopyResult
+KisKraSaveVisitor::copyPreviousDeviceEntry(const KisKraAutosaveCache::Entry &entry,
+                                           const QString &location,
+                                           bool compressionEnabled)
+{
+    /**
+     * Until we open the new entry, we can still fall back to encoding
+     * the device, e.g. when the previous file has been damaged
+     */
+    if (!m_previousStore->open(entry.location)) {
+        return CopyResult::Unavailable;
+    }
+
+    if (m_previousStore->size() != entry.size) {
+        m_previousStore->close();
+        return CopyResult::Unavailable;
+    }
+
+    m_store->setCompressionEnabled(compressionEnabled);
+
+    if (!m_store->open(location)) {
+        m_previousStore->close();
+        m_store->setCompressionEnabled(true);
+        return CopyResult::Failed;
+    }
+
+    QByteArray buffer(int(qMin(entry.size, copyChunkSize)), Qt::Uninitialized);
+    qint64 bytesLeft = entry.size;
+
+    while (bytesLeft > 0) {
+        const qint64 bytesRead = m_previousStore->read(buffer.data(), qMin(bytesLeft, qint64(buffer.size())));
+
+        if (bytesRead <= 0 || m_store->write(buffer.constData(), bytesRead) != bytesRead) {
+            break;
+        }
+
+        bytesLeft -= bytesRead;
+    }
+
+    m_previousStore->close();
+    m_store->close();
+    m_store->setCompressionEnabled(true);
+
+    if (bytesLeft > 0) {
+        return CopyResult::Failed;
+    }
+
+    return CopyResult::Copied;
+}
+
+bool KisKraSaveVisitor::writeFrontPendingDevice()
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(!m_pendingDeviceWrites.empty(), false);
+
+    PendingDeviceWrite pending = m_pendingDeviceWrites.front();
+    m_pendingDeviceWrites.pop_front();
+
+    const EncodedDevice encoded = pending.encodedDevice.result();
+
+    m_store->setCompressionEnabled(pending.compressionEnabled);
+
+    if (m_store->open(pending.location)) {
+        if (!encoded.success || m_store->write(encoded.data) != encoded.data.size()) {
+            pending.device->disconnect();
             m_store->close();
+            m_store->setCompressionEnabled(true);
+            m_errorMessages << i18n("Failed to save the pixel data to %1.", pending.location);
             return false;
         }
 
         m_store->close();
+
+        if (pending.contentVersion) {
+            m_savedEntries.insert(pending.contentVersion, {pending.location, qint64(encoded.data.size())});
+        }
+    }
+    if (m_store->open(pending.location + ".defaultpixel")) {
+        m_store->write(pending.defaultPixel);
+        m_store->close();
     }
-    if (m_store->open(location + ".defaultpixel")) {
-        m_store->write((char*)policy.defaultPixel(device).data(), device->colorSpace()->pixelSize());
+    if (!pending.baseFrameFilename.isEmpty() && m_store->open(pending.location + ".base")) {
+        m_store->write(pending.baseFrameFilename.toUtf8());
         m_store->close();
     }
 
+    m_store->setCompressionEnabled(true);
     return true;
 }
 
+bool KisKraSaveVisitor::flushPendingDeviceWrites()
+{
+    bool result = true;
+
+    while (!m_pendingDeviceWrites.empty()) {
+        result &= writeFrontPendingDevice();
+    }
+
+    return result;
+}
+
+void KisKraSaveVisitor::setPreviousSave(KoStore *previousStore, const KisKraAutosaveCache::Entries &entries)
+{
+    m_previousStore = previousStore;
+    m_previousEntries = entries;
+}
+
+KisKraAutosaveCache::Entries KisKraSaveVisitor::savedDeviceEntries() const
+{
+    return m_savedEntries;
+}
+
+int KisKraSaveVisitor::numReusedDeviceEntries() const
+{
+    return m_numReusedEntries;
+}
+
 bool KisKraSaveVisitor::saveAnnotations(KisLayer* layer)
 {
     if (!layer) return false;
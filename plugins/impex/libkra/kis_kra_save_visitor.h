@@ -8,12 +8,18 @@
 #ifndef KIS_KRA_SAVE_VISITOR_H_
 #define KIS_KRA_SAVE_VISITOR_H_
 
+#include <QFuture>
 #include <QRect>
 #include <QStringList>
+#include <QThreadPool>
+
+#include <deque>
 
 #include "kis_types.h"
 #include "kis_node_visitor.h"
 #include "kis_image.h"
+#include "kis_kra_autosave_cache.h"
+#include <tiles3/KisTilesStreamOptions.h>
 #include "kritalibkra_export.h"
 
 class KisPaintDeviceWriter;
@@ -58,12 +64,65 @@ public:
     /// @return a list with everything that went wrong while saving
     QStringList errorMessages() const;
 
+    /**
+     * The pixel data of the devices is encoded on a pool of worker threads
+     * while the visitor goes on with the other nodes; only writing the
+     * encoded data into the store is serialized. Call this method after
+     * the node tree has been visited to wait for the pending devices and
+     * write them into the store.
+     *
+     * @return false if some of the devices couldn't be saved, the reasons
+     *         are added to errorMessages()
+     */
+    bool flushPendingDeviceWrites();
+
+    /**
+     * Copy the pixel data of the devices that haven't been changed since
+     * the save described by \p entries from \p previousStore instead of
+     * encoding the devices again. The store should be opened for reading
+     * and should outlive the visitor.
+     */
+    void setPreviousSave(KoStore *previousStore, const KisKraAutosaveCache::Entries &entries);
+
+    /**
+     * @return the pixel data entries written by the visitor, they can be
+     *         passed to setPreviousSave() on the next save
+     */
+    KisKraAutosaveCache::Entries savedDeviceEntries() const;
+
+    /// @return the number of entries copied from the previous save
+    int numReusedDeviceEntries() const;
+
 private:
+    struct EncodedDevice {
+        bool success = false;
+        QByteArray data;
+    };
+
+    struct PendingDeviceWrite {
+        QString location;
+        bool compressionEnabled = true;
+        QByteArray defaultPixel;
+        quint64 contentVersion = 0;
+        QString baseFrameFilename;
+        KisPaintDeviceSP device;
+        QFuture<EncodedDevice> encodedDevice;
+    };
+
+    enum class CopyResult {
+        Copied,
+        Unavailable,
+        Failed
+    };
+
+    bool writeFrontPendingDevice();
+    CopyResult copyPreviousDeviceEntry(const KisKraAutosaveCache::Entry &entry, const QString &location, bool compressionEnabled);
+
 
     bool savePaintDevice(KisPaintDeviceSP device, QString location);
 
     template<class DevicePolicy>
-    bool savePaintDeviceFrame(KisPaintDeviceSP device, QString location, DevicePolicy policy);
+    bool savePaintDeviceFrame(KisPaintDeviceSP device, QString location, bool compressionEnabled, DevicePolicy policy);
 
     bool saveAnnotations(KisLayer* layer);
     bool saveSelection(KisNode* node);
@@ -82,6 +141,16 @@ private:
     QMap<const KisNode*, QString> m_nodeFileNames;
     KisPaintDeviceWriter *m_writer;
     QStringList m_errorMessages;
+
+    QThreadPool m_encodingPool;
+    KisTilesStreamOptions m_tilesStreamOptions;
+    std::deque<PendingDeviceWrite> m_pendingDeviceWrites;
+    int m_maxPendingDeviceWrites;
+
+    KoStore *m_previousStore {nullptr};
+    KisKraAutosaveCache::Entries m_previousEntries;
+    KisKraAutosaveCache::Entries m_savedEntries;
+    int m_numReusedEntries {0};
 };
 
 #endif // KIS_KRA_SAVE_VISITOR_H_
@@ -19,6 +19,8 @@
 
 #include <QUrl>
 #include <QBuffer>
+#include <QElapsedTimer>
+#include <QtConcurrent>
 
 #include <KoDocumentInfo.h>
 #include <KoColorSpaceRegistry.h>
@@ -40,6 +42,7 @@
 #include <kis_layer_composition.h>
 #include <kis_painting_assistants_decoration.h>
 #include "kis_png_converter.h"
+#include "kis_config.h"
 #include "kis_keyframe_channel.h"
 #include <kis_time_span.h>
 #include "KisDocument.h"
@@ -58,6 +61,16 @@
 
 using namespace KRA;
 
+namespace {
+
+struct EncodedMergedImage {
+    bool success {false};
+    QByteArray data;
+    qint64 encodingTime {0};
+};
+
+}
+
 struct KisKraSaver::Private
 {
     KisDocument* doc {nullptr};
@@ -71,6 +84,13 @@ struct KisKraSaver::Private
     bool addMergedImage {false};
     QList<KoResourceLoadResult> linkedDocumentResources;
 
+    KoStore *previousStore {nullptr};
+    KisKraAutosaveCache::Entries previousEntries;
+    KisKraAutosaveCache::Entries savedEntries;
+    int numReusedEntries {0};
+
+    QVector<QPair<QString, qint64>> stageTimes;
+
     Private() {
         specialAnnotations << "exif" << "icc";
     }
@@ -473,16 +493,54 @@ bool KisKraSaver::saveBinaryData(KoStore* store, KisImageSP image, const QString
 {
     QString location;
 
+    m_d->stageTimes.clear();
+
+    /**
+     * The merged image is encoded on a separate thread while the layers
+     * are being encoded, we wait for it only when writing it into the store
+     */
+    QFuture<EncodedMergedImage> mergedImage;
+    if (addMergedImage) {
+        const int compression = KisConfig(true).kraMergedImageCompression();
+
+        mergedImage = QtConcurrent::run([image, compression] () {
+            QElapsedTimer timer;
+            timer.start();
+
+            EncodedMergedImage result;
+            {
+                QBuffer buffer(&result.data);
+                buffer.open(QIODevice::WriteOnly);
+                result.success = KisPNGConverter::saveDeviceToIODevice(&buffer, image->bounds(), image->xRes(), image->yRes(), image->projection(), compression);
+            }
+            result.encodingTime = timer.elapsed();
+            return result;
+        });
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
     // Save the layers data
     KisKraSaveVisitor visitor(store, m_d->imageName, m_d->nodeFileNames);
 
     if (external)
         visitor.setExternalUri(uri);
 
+    if (m_d->previousStore) {
+        visitor.setPreviousSave(m_d->previousStore, m_d->previousEntries);
+    }
+
     image->rootLayer()->accept(visitor);
+    visitor.flushPendingDeviceWrites();
+
+    m_d->savedEntries = visitor.savedDeviceEntries();
+    m_d->numReusedEntries = visitor.numReusedDeviceEntries();
+    m_d->stageTimes << qMakePair(QString("layers"), timer.elapsed());
 
     m_d->errorMessages.append(visitor.errorMessages());
     if (!m_d->errorMessages.isEmpty()) {
+        mergedImage.waitForFinished();
         return false;
     }
 
@@ -645,11 +703,23 @@ bool KisKraSaver::saveBinaryData(KoStore* store, KisImageSP image, const QString
 
     bool savingMergedImageSuccess = true;
     if (addMergedImage) {
-        KisPaintDeviceSP dev = image->projection();
-        store->setCompressionEnabled(false);
-        r = KisPNGConverter::saveDeviceToStore("mergedimage.png", image->bounds(), image->xRes(), image->yRes(), dev, store);
-        savingMergedImageSuccess = savingMergedImageSuccess && r;
-        store->setCompressionEnabled(KisConfig(true).compressKra());
+        timer.restart();
+        const EncodedMergedImage encoded = mergedImage.result();
+        m_d->stageTimes << qMakePair(QString("merged image (in background)"), encoded.encodingTime);
+        m_d->stageTimes << qMakePair(QString("waiting for merged image"), timer.elapsed());
+
+        savingMergedImageSuccess = encoded.success;
+
+        if (savingMergedImageSuccess) {
+            store->setCompressionEnabled(false);
+            if (store->open("mergedimage.png")) {
+                savingMergedImageSuccess = store->write(encoded.data) == encoded.data.size();
+                savingMergedImageSuccess &= store->close();
+            } else {
+                savingMergedImageSuccess = false;
+            }
+            store->setCompressionEnabled(true);
+        }
     }
 
     if (!savingMergedImageSuccess) {
@@ -676,6 +746,27 @@ QStringList KisKraSaver::warningMessages() const
     return m_d->warningMessages;
 }
 
+void KisKraSaver::setPreviousSave(KoStore *previousStore, const KisKraAutosaveCache::Entries &entries)
+{
+    m_d->previousStore = previousStore;
+    m_d->previousEntries = entries;
+}
+
+KisKraAutosaveCache::Entries KisKraSaver::savedDeviceEntries() const
+{
+    return m_d->savedEntries;
+}
+
+int KisKraSaver::numReusedDeviceEntries() const
+{
+    return m_d->numReusedEntries;
+}
+
+QVector<QPair<QString, qint64>> KisKraSaver::stageTimes() const
+{
+    return m_d->stageTimes;
+}
+
 void KisKraSaver::saveBackgroundColor(QDomDocument& doc, QDomElement& element, KisImageSP image)
 {
     QDomElement e = doc.createElement(CANVASPROJECTIONCOLOR);
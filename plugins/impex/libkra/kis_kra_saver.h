@@ -12,12 +12,15 @@
 #include <QDomElement>
 #include <QStringList>
 #include <QString>
+#include <QVector>
+#include <QPair>
 
 class KisDocument;
 class KoStore;
 
 
 #include "kritalibkra_export.h"
+#include "kis_kra_autosave_cache.h"
 #include "KoColor.h"
 
 class KRITALIBKRA_EXPORT KisKraSaver
@@ -42,6 +45,22 @@ public:
 
     bool saveAudio(KoStore *store);
 
+    /**
+     * Make saveBinaryData() copy the pixel data of the devices that haven't
+     * been changed since the save described by \p entries from
+     * \p previousStore instead of encoding them again
+     */
+    void setPreviousSave(KoStore *previousStore, const KisKraAutosaveCache::Entries &entries);
+
+    /// @return the pixel data entries written by saveBinaryData()
+    KisKraAutosaveCache::Entries savedDeviceEntries() const;
+
+    /// @return the number of pixel data entries copied from the previous save
+    int numReusedDeviceEntries() const;
+
+    /// @return the names and durations (in milliseconds) of the stages of saveBinaryData()
+    QVector<QPair<QString, qint64>> stageTimes() const;
+
     /// @return a list with everything that went wrong while saving
     QStringList errorMessages() const;
 
@@ -7,10 +7,13 @@
 #include "kra_converter.h"
 
 #include <QApplication>
+#include <QBuffer>
+#include <QElapsedTimer>
 #include <QFileInfo>
 #include <QScopedPointer>
 #include <QUrl>
 #include <QVersionNumber>
+#include <QtConcurrent>
 
 #include <KoStore.h>
 #include <KoStoreDevice.h>
@@ -25,6 +28,8 @@
 #include <kis_image.h>
 #include <kis_paint_layer.h>
 
+#include "kis_kra_autosave_cache.h"
+
 static const char CURRENT_DTD_VERSION[] = "2.0";
 
 KraConverter::KraConverter(KisDocument *doc)
@@ -150,16 +155,67 @@ KisImportExportErrorCode KraConverter::buildFile(QIODevice *io, const QString &f
         return ImportExportCodes::CannotCreateFile;
     }
 
+    QElapsedTimer totalTimer;
+    totalTimer.start();
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QVector<QPair<QString, qint64>> stageTimes;
+
+    auto finishStage = [&stageTimes, &timer] (const QString &name) {
+        stageTimes << qMakePair(name, timer.restart());
+    };
+
+    /**
+     * The preview is generated and encoded on a separate thread while
+     * the rest of the document is being saved, it is written into the
+     * store at the very end
+     */
+    qint64 previewEncodingTime = 0;
+    QFuture<QByteArray> preview = QtConcurrent::run([this, &previewEncodingTime] () {
+        QElapsedTimer timer;
+        timer.start();
+
+        const QByteArray result = encodePreview();
+        previewEncodingTime = timer.elapsed();
+        return result;
+    });
+
     setProgress(20);
 
     m_kraSaver = new KisKraSaver(m_doc, filename, addMergedImage);
 
+    /**
+     * Autosave rewrites the same file again and again, so the pixel data
+     * of the devices that haven't been changed since the previous autosave
+     * is copied from that file instead of being encoded again
+     */
+    const bool reusePreviousSave = m_doc->isAutosaving();
+    QScopedPointer<KoStore> previousStore;
+
+    if (reusePreviousSave) {
+        const KisKraAutosaveCache::Entries previousEntries =
+            KisKraAutosaveCache::instance()->entries(filename);
+
+        if (!previousEntries.isEmpty()) {
+            previousStore.reset(KoStore::createStore(filename, KoStore::Read, "", KoStore::Zip));
+
+            if (!previousStore->bad()) {
+                m_kraSaver->setPreviousSave(previousStore.data(), previousEntries);
+            }
+        }
+    }
+
     KisImportExportErrorCode resultCode = saveRootDocuments(m_store);
 
     if (!resultCode.isOk()) {
+        preview.waitForFinished();
         return resultCode;
     }
 
+    finishStage("root documents");
+
     setProgress(40);
     bool result;
 
@@ -168,12 +224,17 @@ KisImportExportErrorCode KraConverter::buildFile(QIODevice *io, const QString &f
         success = false;
         qWarning() << "saving key frames failed";
     }
+    finishStage("keyframes");
+
     setProgress(60);
     result = m_kraSaver->saveBinaryData(m_store, m_image, m_doc->path(), true, addMergedImage);
     if (!result) {
         success = false;
         qWarning() << "saving binary data failed";
     }
+    stageTimes << m_kraSaver->stageTimes();
+    finishStage("binary data total");
+
     setProgress(70);
     result = m_kraSaver->saveResources(m_store, m_image, m_doc->path());
     if (!result) {
@@ -198,17 +259,54 @@ KisImportExportErrorCode KraConverter::buildFile(QIODevice *io, const QString &f
         success = false;
         qWarning() << "Saving audio data failed";
     }
+    finishStage("resources");
+
+    const QByteArray previewData = preview.result();
+    stageTimes << qMakePair(QString("preview (in background)"), previewEncodingTime);
+    finishStage("waiting for preview");
+
+    if (previewData.isEmpty() || !m_store->open("preview.png")) {
+        success = false;
+        qWarning() << "Saving preview failed";
+    } else {
+        if (m_store->write(previewData) != previewData.size()) {
+            success = false;
+            qWarning() << "Saving preview failed";
+        }
+        m_store->close();
+    }
 
     setProgress(80);
 
     if (!m_store->finalize()) {
         success = false;
     }
+    finishStage("finalizing");
+
     if (!success || !m_kraSaver->errorMessages().isEmpty()) {
+        if (reusePreviousSave) {
+            KisKraAutosaveCache::instance()->forget(filename);
+        }
         m_doc->setErrorMessage(m_kraSaver->errorMessages().join(".\n"));
         return ImportExportCodes::Failure;
     }
 
+    if (reusePreviousSave) {
+        dbgFile << "Reused" << m_kraSaver->numReusedDeviceEntries()
+                << "of" << m_kraSaver->savedDeviceEntries().size()
+                << "pixel data entries of the previous autosave";
+
+        KisKraAutosaveCache::instance()->setEntries(filename, m_kraSaver->savedDeviceEntries());
+    }
+
+    QStringList stageReport;
+    for (auto it = stageTimes.constBegin(); it != stageTimes.constEnd(); ++it) {
+        stageReport << QString("%1 %2 ms").arg(it->first).arg(it->second);
+    }
+
+    dbgFile << "Saved" << filename << "in" << totalTimer.elapsed() << "ms:"
+            << stageReport.join(", ");
+
     m_doc->setWarningMessage(m_kraSaver->warningMessages().join(".\n"));
 
     setProgress(90);
@@ -244,17 +342,6 @@ KisImportExportErrorCode KraConverter::saveRootDocuments(KoStore *store)
         return ImportExportCodes::Failure;
     }
 
-    if (store->open("preview.png")) {
-        // ### TODO: missing error checking (The partition could be full!)
-        KisImportExportErrorCode result = savePreview(store);
-        (void)store->close();
-        if (!result.isOk()) {
-            return result;
-        }
-    } else {
-        return ImportExportCodes::Failure;
-    }
-
     dbgUI << "Saving done of url:" << m_doc->path();
     return ImportExportCodes::OK;
 }
@@ -289,7 +376,7 @@ QDomDocument KraConverter::createDomDocument()
     return doc;
 }
 
-KisImportExportErrorCode KraConverter::savePreview(KoStore *store)
+QByteArray KraConverter::encodePreview()
 {
     QPixmap pix = m_doc->generatePreview(QSize(256, 256));
     QImage preview(pix.toImage().convertToFormat(QImage::Format_ARGB32, Qt::ColorOnly));
@@ -301,13 +388,12 @@ KisImportExportErrorCode KraConverter::savePreview(KoStore *store)
         preview.fill(QColor(0, 0, 0, 0));
     }
 
-    KoStoreDevice io(store);
-    if (!io.open(QIODevice::WriteOnly)) {
-        return ImportExportCodes::NoAccessToWrite;
+    QByteArray data;
+    QBuffer buffer(&data);
+    if (!buffer.open(QIODevice::WriteOnly) || !preview.save(&buffer, "PNG")) {
+        return QByteArray();
     }
-    bool ret = preview.save(&io, "PNG");
-    io.close();
-    return ret ? ImportExportCodes::OK : ImportExportCodes::ErrorWhileWriting;
+    return data;
 }
 
 
@@ -53,7 +53,7 @@ private:
     KisImportExportErrorCode saveRootDocuments(KoStore *store);
     bool saveToStream(QIODevice *dev);
     QDomDocument createDomDocument();
-    KisImportExportErrorCode savePreview(KoStore *store);
+    QByteArray encodePreview();
     KisImportExportErrorCode oldLoadAndParse(KoStore *store, const QString &filename, QDomDocument &xmldoc);
     KisImportExportErrorCode loadXML(const QDomDocument &doc, KoStore *store);
     bool completeLoading(KoStore *store);
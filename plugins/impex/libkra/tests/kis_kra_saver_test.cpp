@@ -9,9 +9,11 @@
 #include <simpletest.h>
 
 #include <QBitArray>
+#include <QBuffer>
 
 #include <KisDocument.h>
 #include <KoDocumentInfo.h>
+#include <KoStore.h>
 #include <KoShapeContainer.h>
 #include <KoPathShape.h>
 
@@ -32,12 +34,14 @@
 #include "kis_selection.h"
 #include "kis_fill_painter.h"
 #include "kis_shape_selection.h"
+#include "kis_kra_save_visitor.h"
 #include "util.h"
 #include <testutil.h>
 #include "kis_keyframe_channel.h"
 #include "kis_image_animation_interface.h"
 #include "kis_layer_properties_icons.h"
 #include <KisGlobalResourcesInterface.h>
+#include <kis_config.h>
 
 #include "KritaTransformMaskStubs.h"
 #include "KisDumbTransformMaskParams.h"
@@ -111,6 +115,29 @@ void KisKraSaverTest::testRoundTrip()
     QCOMPARE(t, createTestingTransform());
 }
 
+void KisKraSaverTest::testMergedImageAndPreview()
+{
+    QScopedPointer<KisDocument> doc(createCompleteDocument());
+    doc->image()->waitForDone();
+    QVERIFY(doc->exportDocumentSync("mergedimagetest.kra", doc->mimeType()));
+
+    QScopedPointer<KoStore> store(KoStore::createStore("mergedimagetest.kra", KoStore::Read, "", KoStore::Zip));
+    QVERIFY(!store->bad());
+
+    QVERIFY(store->open("mergedimage.png"));
+    QImage mergedImage;
+    QVERIFY(mergedImage.loadFromData(store->read(store->size()), "PNG"));
+    store->close();
+    QCOMPARE(mergedImage.size(), doc->image()->size());
+
+    QVERIFY(store->open("preview.png"));
+    QImage preview;
+    QVERIFY(preview.loadFromData(store->read(store->size()), "PNG"));
+    store->close();
+    QVERIFY(!preview.isNull());
+    QVERIFY(preview.width() <= 256 && preview.height() <= 256);
+}
+
 void KisKraSaverTest::testSaveEmpty()
 {
     KisDocument* doc = createEmptyDocument();
@@ -340,6 +367,87 @@ void KisKraSaverTest::testRoundTripAnimation()
 
 }
 
+void KisKraSaverTest::testRoundTripAnimationDeltaFrames()
+{
+    QScopedPointer<KisDocument> doc(KisPart::instance()->createDocument());
+
+    QRect imageRect(0,0,512,512);
+    const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(new KisSurrogateUndoStore(), imageRect.width(), imageRect.height(), cs, "test image");
+    KisPaintLayerSP layer1 = new KisPaintLayer(image, "paint1", OPACITY_OPAQUE_U8);
+    image->addNode(layer1);
+
+    layer1->paintDevice()->fill(imageRect, KoColor(Qt::black, cs));
+
+    KUndo2Command parentCommand;
+
+    layer1->enableAnimation();
+    KisKeyframeChannel *rasterChannel = layer1->getKeyframeChannel(KisKeyframeChannel::Raster.id(), true);
+    QVERIFY(rasterChannel);
+
+    // frame 10 changes a few tiles of frame 0
+    rasterChannel->copyKeyframe(0, 10, &parentCommand);
+    image->animationInterface()->switchCurrentTimeAsync(10);
+    image->waitForDone();
+    layer1->paintDevice()->fill(QRect(100, 100, 20, 20), KoColor(Qt::red, cs));
+
+    // frame 20 removes a few tiles of frame 10
+    rasterChannel->copyKeyframe(10, 20, &parentCommand);
+    image->animationInterface()->switchCurrentTimeAsync(20);
+    image->waitForDone();
+    layer1->paintDevice()->clear(QRect(384, 384, 128, 128));
+    layer1->paintDevice()->setDefaultPixel(KoColor(Qt::blue, cs));
+
+    // frame 30 has nothing in common with frame 20
+    rasterChannel->addKeyframe(30, &parentCommand);
+    image->animationInterface()->switchCurrentTimeAsync(30);
+    image->waitForDone();
+    layer1->paintDevice()->fill(QRect(200, 50, 10, 10), KoColor(Qt::green, cs));
+
+    doc->setCurrentImage(image);
+
+    {
+        KisConfig cfg(false);
+        const bool oldSaveKeyframesAsDeltas = cfg.saveKeyframesAsDeltas();
+        cfg.setSaveKeyframesAsDeltas(true);
+        doc->exportDocumentSync("roundtrip_animation_delta.kra", doc->mimeType());
+        cfg.setSaveKeyframesAsDeltas(oldSaveKeyframesAsDeltas);
+    }
+
+    {
+        // the file names are kept in the zip directory uncompressed
+        QFile file("roundtrip_animation_delta.kra");
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        QVERIFY(file.readAll().contains(".base"));
+    }
+
+    QScopedPointer<KisDocument> doc2(KisPart::instance()->createDocument());
+    doc2->loadNativeFormat("roundtrip_animation_delta.kra");
+    KisImageSP image2 = doc2->image();
+    KisNodeSP node = image2->root()->firstChild();
+
+    QVERIFY(node->inherits("KisPaintLayer"));
+    KisPaintLayerSP layer2 = qobject_cast<KisPaintLayer*>(node.data());
+
+    KisKeyframeChannel *channel = layer2->getKeyframeChannel(KisKeyframeChannel::Raster.id());
+    QVERIFY(channel);
+    QCOMPARE(channel->keyframeCount(), 4);
+
+    Q_FOREACH (int time, QList<int>({0, 10, 20, 30})) {
+        image->animationInterface()->switchCurrentTimeAsync(time);
+        image->waitForDone();
+        image2->animationInterface()->switchCurrentTimeAsync(time);
+        image2->waitForDone();
+
+        KisPaintDeviceSP device1 = layer1->paintDevice();
+        KisPaintDeviceSP device2 = layer2->paintDevice();
+
+        QCOMPARE(device2->extent(), device1->extent());
+        QCOMPARE(device2->defaultPixel(), device1->defaultPixel());
+        QCOMPARE(device2->convertToQImage(0, imageRect), device1->convertToQImage(0, imageRect));
+    }
+}
+
 #include "lazybrush/kis_lazy_fill_tools.h"
 
 void KisKraSaverTest::testRoundTripColorizeMask()
@@ -572,4 +680,90 @@ void KisKraSaverTest::testExportToReadonly()
     TestUtil::testExportToReadonly(KraMimetype);
 }
 
+namespace {
+
+QMap<const KisNode*, QString> layerFileNames(KisImageSP image)
+{
+    QMap<const KisNode*, QString> fileNames;
+    fileNames.insert(image->root().data(), "root");
+
+    int i = 0;
+    for (KisNodeSP node = image->root()->firstChild(); node; node = node->nextSibling()) {
+        fileNames.insert(node.data(), QString("layer%1").arg(i++));
+    }
+
+    return fileNames;
+}
+
+}
+
+void KisKraSaverTest::testReuseUnchangedDevices()
+{
+    const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(new KisSurrogateUndoStore(), 256, 256, cs, "test image");
+
+    KisPaintLayerSP layer1 = new KisPaintLayer(image, "paint1", OPACITY_OPAQUE_U8);
+    KisPaintLayerSP layer2 = new KisPaintLayer(image, "paint2", OPACITY_OPAQUE_U8);
+    image->addNode(layer1);
+    image->addNode(layer2);
+
+    layer1->paintDevice()->fill(QRect(10, 10, 100, 100), KoColor(Qt::red, cs));
+    layer2->paintDevice()->fill(QRect(50, 50, 150, 100), KoColor(Qt::blue, cs));
+
+    QBuffer previousBuffer;
+    KisKraAutosaveCache::Entries previousEntries;
+
+    {
+        QScopedPointer<KoStore> store(KoStore::createStore(&previousBuffer, KoStore::Write, "application/x-krita", KoStore::Zip));
+        KisKraSaveVisitor visitor(store.data(), "test", layerFileNames(image));
+        image->rootLayer()->accept(visitor);
+        QVERIFY(visitor.flushPendingDeviceWrites());
+        QVERIFY(store->finalize());
+
+        previousEntries = visitor.savedDeviceEntries();
+        QCOMPARE(previousEntries.size(), 2);
+        QCOMPARE(visitor.numReusedDeviceEntries(), 0);
+    }
+
+    layer1->paintDevice()->fill(QRect(100, 100, 20, 20), KoColor(Qt::green, cs));
+
+    // autosave saves a clone of the image, the clones should keep the versions
+    KisImageSP clonedImage = image->clone(true);
+
+    QBuffer buffer;
+    KisKraAutosaveCache::Entries entries;
+
+    {
+        QScopedPointer<KoStore> previousStore(KoStore::createStore(&previousBuffer, KoStore::Read, "", KoStore::Zip));
+        QVERIFY(!previousStore->bad());
+
+        QScopedPointer<KoStore> store(KoStore::createStore(&buffer, KoStore::Write, "application/x-krita", KoStore::Zip));
+        KisKraSaveVisitor visitor(store.data(), "test", layerFileNames(clonedImage));
+        visitor.setPreviousSave(previousStore.data(), previousEntries);
+        clonedImage->rootLayer()->accept(visitor);
+        QVERIFY(visitor.flushPendingDeviceWrites());
+        QVERIFY(store->finalize());
+
+        entries = visitor.savedDeviceEntries();
+        QCOMPARE(entries.size(), 2);
+        QCOMPARE(visitor.numReusedDeviceEntries(), 1);
+    }
+
+    QScopedPointer<KoStore> store(KoStore::createStore(&buffer, KoStore::Read, "", KoStore::Zip));
+    QVERIFY(!store->bad());
+
+    Q_FOREACH (KisPaintLayerSP layer, QList<KisPaintLayerSP>({layer1, layer2})) {
+        KisPaintDeviceSP device = layer->paintDevice();
+        QVERIFY(entries.contains(device->contentVersion()));
+
+        QVERIFY(store->open(entries.value(device->contentVersion()).location));
+        KisPaintDeviceSP loadedDevice = new KisPaintDevice(cs);
+        QVERIFY(loadedDevice->read(store->device()));
+        store->close();
+
+        QPoint errorPoint;
+        QVERIFY(TestUtil::comparePaintDevices(errorPoint, device, loadedDevice));
+    }
+}
+
 KISTEST_MAIN(KisKraSaverTest)
@@ -21,6 +21,8 @@ private Q_SLOTS:
     // XXX: Also test roundtripping of metadata
     void testRoundTrip();
 
+    void testMergedImageAndPreview();
+
     void testSaveEmpty();
     void testRoundTripFillLayerColor();
     void testRoundTripFillLayerPattern();
@@ -28,6 +30,7 @@ private Q_SLOTS:
     void testRoundTripLayerStyles();
 
     void testRoundTripAnimation();
+    void testRoundTripAnimationDeltaFrames();
 
     void testRoundTripColorizeMask();
 
@@ -35,6 +38,8 @@ private Q_SLOTS:
     void testRoundTripShapeSelection();
     void testRoundTripStoryboard();
 
+    void testReuseUnchangedDevices();
+
     void testExportToReadonly();
 
 };
@@ -63,6 +63,7 @@ KisImportExportErrorCode KisPNGExport::convert(KisDocument *document, QIODevice
     options.storeMetaData = configuration->getBool("storeMetaData", false);
     options.saveAsHDR = configuration->getBool("saveAsHDR", false);
     options.downsample = configuration->getBool("downsample", false);
+    options.parallelEncoding = configuration->getBool("parallelEncoding", true);
 
     vKisAnnotationSP_it beginIt = image->beginAnnotations();
     vKisAnnotationSP_it endIt = image->endAnnotations();
@@ -107,6 +108,7 @@ KisPropertiesConfigurationSP KisPNGExport::defaultConfiguration(const QByteArray
     cfg->setProperty("storeMetaData", false);
     cfg->setProperty("storeAuthor", false);
     cfg->setProperty("downsample", false);
+    cfg->setProperty("parallelEncoding", true);
     return cfg;
 }
 
@@ -186,6 +188,7 @@ void KisWdgOptionsPNG::setConfiguration(const KisPropertiesConfigurationSP cfg)
     bnTransparencyFillColor->setColor(cfg->getColor("transparencyFillcolor", background));
 
     chkDownsample->setChecked(cfg->getBool("downsample", false));
+    chkParallelEncoding->setChecked(cfg->getBool("parallelEncoding", true));
 }
 
 KisPropertiesConfigurationSP KisWdgOptionsPNG::configuration() const
@@ -203,6 +206,7 @@ KisPropertiesConfigurationSP KisWdgOptionsPNG::configuration() const
     bool storeAuthor = chkAuthor->isChecked();
     bool storeMetaData = chkMetaData->isChecked();
     bool downsample = chkDownsample->isChecked();
+    bool parallelEncoding = chkParallelEncoding->isChecked();
 
 
     QVariant transparencyFillcolor;
@@ -219,6 +223,7 @@ KisPropertiesConfigurationSP KisWdgOptionsPNG::configuration() const
     cfg->setProperty("storeAuthor", storeAuthor);
     cfg->setProperty("storeMetaData", storeMetaData);
     cfg->setProperty("downsample", downsample);
+    cfg->setProperty("parallelEncoding", parallelEncoding);
     return cfg;
 }
 
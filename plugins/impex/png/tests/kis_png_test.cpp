@@ -13,6 +13,12 @@
 #include "filestest.h"
 
 #include <testui.h>
+#include <testutil.h>
+
+#include <QBuffer>
+
+#include <kis_png_converter.h>
+#include <kis_sequential_iterator.h>
 
 #ifndef FILES_DATA_DIR
 #error "FILES_DATA_DIR not set. A directory with the data used for testing the importing of files in krita"
@@ -165,5 +171,78 @@ void KisPngTest::testSaveHDR()
                     KoColorSpaceRegistry::instance()->p2020PQProfile()));
 }
 
+void KisPngTest::testParallelEncoding_data()
+{
+    QTest::addColumn<bool>("is16Bit");
+    QTest::addColumn<bool>("alpha");
+    QTest::addColumn<int>("compression");
+
+    QTest::addRow("rgba8") << false << true << 3;
+    QTest::addRow("rgb8") << false << false << 9;
+    QTest::addRow("rgba16") << true << true << 1;
+}
+
+void KisPngTest::testParallelEncoding()
+{
+    QFETCH(bool, is16Bit);
+    QFETCH(bool, alpha);
+    QFETCH(int, compression);
+
+    const KoColorSpace *cs = is16Bit ?
+        KoColorSpaceRegistry::instance()->rgb16() :
+        KoColorSpaceRegistry::instance()->rgb8();
+
+    // the height is big enough to be split into several strips
+    const QRect rc(0, 0, 1031, 733);
+
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+
+    KisSequentialIterator it(dev, rc);
+    while (it.nextPixel()) {
+        quint8 *dst = it.rawData();
+
+        for (quint32 i = 0; i < cs->pixelSize(); i++) {
+            dst[i] = quint8(it.x() + i);
+        }
+
+        if (!alpha) {
+            cs->setOpacity(dst, OPACITY_OPAQUE_U8, 1);
+        }
+    }
+
+    TestUtil::fillCellsWithNoise(dev, rc, 32, 2, 1, 1, !alpha);
+
+    KisPNGOptions options;
+    options.alpha = alpha;
+    options.compression = compression;
+    options.tryToSaveAsIndexed = false;
+    options.parallelEncoding = true;
+
+    QBuffer buffer;
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+
+    vKisAnnotationSP annotations;
+    KisPNGConverter saver(0, true);
+    QVERIFY(saver.buildFile(&buffer, rc, 72, 72, dev, annotations.begin(), annotations.end(), options, 0).isOk());
+    buffer.close();
+
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    KisPNGConverter loader(0, true);
+    QVERIFY(loader.buildImage(&buffer).isOk());
+
+    KisImageSP image = loader.image();
+    QVERIFY(image);
+    image->initialRefreshGraph();
+
+    KisPaintDeviceSP result = image->root()->firstChild()->paintDevice();
+    QCOMPARE(result->colorSpace()->pixelSize(), cs->pixelSize());
+    QCOMPARE(result->exactBounds(), rc);
+
+    QPoint pt;
+    if (!TestUtil::comparePaintDevices(pt, dev, result)) {
+        QFAIL(QString("The decoded image differs from the source at (%1, %2)").arg(pt.x()).arg(pt.y()).toLatin1());
+    }
+}
+
 KISTEST_MAIN(KisPngTest)
 
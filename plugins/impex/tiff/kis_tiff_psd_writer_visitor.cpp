@@ -17,6 +17,7 @@
 #include <KoColorSpaceRegistry.h>
 #include <KoConfig.h>
 #include <KoID.h>
+#include <KisRowBandReader.h>
 #include <KoUnit.h>
 #include <kis_group_layer.h>
 #include <kis_image.h>
@@ -66,10 +67,15 @@ KisImportExportErrorCode KisTiffPsdWriter::writeImage(KisGroupLayerSP layer)
             dbgFile << "Unsupported colorspace" << pd->colorSpace()->name();
             return ImportExportCodes::FormatColorSpaceUnsupported;
         }
-        pd.attach(new KisPaintDevice(*pd));
-        pd->convertTo(destColorSpace);
     }
 
+    /**
+     * The projection is converted in bands of rows right before they
+     * are written, so we don't keep a converted copy of the whole image
+     */
+    KisRowBandReader reader(pd, QRect(0, 0, layer->image()->width(), layer->image()->height()), destColorSpace);
+    const KoColorSpace *cs = reader.colorSpace();
+
     {
         // WORKAROUND: block any attempts to use YCbCr with alpha channels.
         // This should not happen because alpha is disabled by default
@@ -84,7 +90,7 @@ KisImportExportErrorCode KisTiffPsdWriter::writeImage(KisGroupLayerSP layer)
     }
 
     // Save depth
-    uint32_t depth = 8 * pd->pixelSize() / pd->channelCount();
+    uint32_t depth = 8 * cs->pixelSize() / cs->channelCount();
     TIFFSetField(image(), TIFFTAG_BITSPERSAMPLE, depth);
 
     {
@@ -99,11 +105,11 @@ KisImportExportErrorCode KisTiffPsdWriter::writeImage(KisGroupLayerSP layer)
 
     // Save number of samples
     if (m_options->alpha) {
-        TIFFSetField(image(), TIFFTAG_SAMPLESPERPIXEL, pd->channelCount());
+        TIFFSetField(image(), TIFFTAG_SAMPLESPERPIXEL, cs->channelCount());
         const std::array<uint16_t, 1> sampleinfo = {EXTRASAMPLE_UNASSALPHA};
         TIFFSetField(image(), TIFFTAG_EXTRASAMPLES, 1, sampleinfo.data());
     } else {
-        TIFFSetField(image(), TIFFTAG_SAMPLESPERPIXEL, pd->channelCount() - 1);
+        TIFFSetField(image(), TIFFTAG_SAMPLESPERPIXEL, cs->channelCount() - 1);
         TIFFSetField(image(), TIFFTAG_EXTRASAMPLES, 0);
     }
 
@@ -146,7 +152,7 @@ KisImportExportErrorCode KisTiffPsdWriter::writeImage(KisGroupLayerSP layer)
 
     // Save profile
     if (m_options->saveProfile) {
-        const KoColorProfile *profile = pd->colorSpace()->profile();
+        const KoColorProfile *profile = cs->profile();
         if (profile && profile->type() == "icc" && !profile->rawData().isEmpty()) {
             QByteArray ba = profile->rawData();
             TIFFSetField(image(), TIFFTAG_ICCPROFILE, ba.size(), ba.constData());
@@ -163,7 +169,7 @@ KisImportExportErrorCode KisTiffPsdWriter::writeImage(KisGroupLayerSP layer)
     qint32 width = layer->image()->width();
     bool r = true;
     for (qint32 y = 0; y < height; y++) {
-        KisHLineConstIteratorSP it = pd->createHLineConstIteratorNG(0, y, width);
+        KisHLineConstIteratorSP it = reader.deviceForRow(y)->createHLineConstIteratorNG(0, y, width);
         switch (color_type) {
         case PHOTOMETRIC_MINISBLACK: {
             const std::array<quint8, 5> poses = {0, 1};
@@ -238,7 +244,7 @@ KisImportExportErrorCode KisTiffPsdWriter::writeImage(KisGroupLayerSP layer)
                 static_cast<uint32_t>(width),
                 static_cast<uint32_t>(height),
                 static_cast<uint16_t>(depth),
-                static_cast<uint16_t>(pd->channelCount()),
+                static_cast<uint16_t>(cs->channelCount()),
                 color_type,
                 true);
 
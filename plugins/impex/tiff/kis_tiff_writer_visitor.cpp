@@ -16,6 +16,7 @@
 #include <KoColorSpace.h>
 #include <KoColorSpaceRegistry.h>
 #include <KoID.h>
+#include <KisRowBandReader.h>
 #include <kis_assert.h>
 #include <kis_meta_data_backend_registry.h>
 
@@ -47,10 +48,15 @@ bool KisTIFFWriterVisitor::saveLayerProjection(KisLayer *layer)
         if (!destColorSpace) {
             return false;
         }
-        pd.attach(new KisPaintDevice(*pd));
-        pd->convertTo(destColorSpace);
     }
 
+    /**
+     * The projection is converted in bands of rows right before they
+     * are written, so we don't keep a converted copy of the whole image
+     */
+    KisRowBandReader reader(pd, QRect(0, 0, layer->image()->width(), layer->image()->height()), destColorSpace);
+    const KoColorSpace *cs = reader.colorSpace();
+
     {
         // WORKAROUND: block any attempts to use YCbCr with alpha channels.
         // This should not happen because alpha is disabled by default
@@ -65,7 +71,7 @@ bool KisTIFFWriterVisitor::saveLayerProjection(KisLayer *layer)
     }
 
     // Save depth
-    uint32_t depth = 8 * pd->pixelSize() / pd->channelCount();
+    uint32_t depth = 8 * cs->pixelSize() / cs->channelCount();
     TIFFSetField(image(), TIFFTAG_BITSPERSAMPLE, depth);
 
     {
@@ -80,11 +86,11 @@ bool KisTIFFWriterVisitor::saveLayerProjection(KisLayer *layer)
 
     // Save number of samples
     if (m_options->alpha) {
-        TIFFSetField(image(), TIFFTAG_SAMPLESPERPIXEL, pd->channelCount());
+        TIFFSetField(image(), TIFFTAG_SAMPLESPERPIXEL, cs->channelCount());
         const std::array<uint16_t, 1> sampleinfo = {EXTRASAMPLE_UNASSALPHA};
         TIFFSetField(image(), TIFFTAG_EXTRASAMPLES, 1, sampleinfo.data());
     } else {
-        TIFFSetField(image(), TIFFTAG_SAMPLESPERPIXEL, pd->channelCount() - 1);
+        TIFFSetField(image(), TIFFTAG_SAMPLESPERPIXEL, cs->channelCount() - 1);
         TIFFSetField(image(), TIFFTAG_EXTRASAMPLES, 0);
     }
 
@@ -127,7 +133,7 @@ bool KisTIFFWriterVisitor::saveLayerProjection(KisLayer *layer)
 
     // Save profile
     if (m_options->saveProfile) {
-        const KoColorProfile* profile = pd->colorSpace()->profile();
+        const KoColorProfile* profile = cs->profile();
         if (profile && profile->type() == "icc" && !profile->rawData().isEmpty()) {
             QByteArray ba = profile->rawData();
             TIFFSetField(image(), TIFFTAG_ICCPROFILE, ba.size(), ba.constData());
@@ -177,7 +183,7 @@ bool KisTIFFWriterVisitor::saveLayerProjection(KisLayer *layer)
     qint32 width = layer->image()->width();
     bool r = true;
     for (int y = 0; y < height; y++) {
-        KisHLineConstIteratorSP it = pd->createHLineConstIteratorNG(0, y, width);
+        KisHLineConstIteratorSP it = reader.deviceForRow(y)->createHLineConstIteratorNG(0, y, width);
         switch (color_type) {
         case PHOTOMETRIC_MINISBLACK: {
             const std::array<quint8, 5> poses = {0, 1};
@@ -10,6 +10,8 @@
 #include <KisOptimizedByteArray.h>
 #include <kis_dab_cache.h>
 
+class KisRunnableStrokeJobData;
+
 class KisColorSmudgeStrategy
 {
 public:
@@ -26,6 +28,14 @@ public:
                             QRect *dstDabRect,
                             qreal lightnessStrength) = 0;
 
+    /**
+     * Paints the dab prepared by updateMask()
+     *
+     * If \p jobs is not null, the heavy parts of painting of big dabs may
+     * be appended to it as the stroke jobs instead of being done inline.
+     * The strategy must not be used until these jobs are finished. The
+     * returned rects become dirty only after that.
+     */
     virtual QVector<QRect> paintDab(const QRect &srcRect, const QRect &dstRect,
                                     const KoColor &currentPaintColor,
                                     qreal opacity,
@@ -33,7 +43,8 @@ public:
                                     qreal smudgeRateValue,
                                     qreal maxPossibleSmudgeRateValue,
                                     qreal lightnessStrengthValue,
-                                    qreal smudgeRadiusValue) = 0;
+                                    qreal smudgeRadiusValue,
+                                    QVector<KisRunnableStrokeJobData*> *jobs) = 0;
 
     virtual const KoColorSpace* preciseColorSpace() const = 0;
 
@@ -12,6 +12,27 @@
 #include "kis_paint_device.h"
 #include "KisColorSmudgeSampleUtils.h"
 
+#include <KisDabBandsUtils.h>
+#include <KisRunnableStrokeJobUtils.h>
+
+namespace {
+
+/**
+ * The bands always span the full width of the device, so the
+ * rows of the band are contiguous in memory
+ */
+inline quint8* bandData(KisFixedPaintDeviceSP device, int firstRow)
+{
+    return device->data() + firstRow * device->bounds().width() * device->pixelSize();
+}
+
+inline quint8* bandData(KisFixedPaintDeviceSP device, const QRect &band)
+{
+    return bandData(device, band.y() - device->bounds().y());
+}
+
+}
+
 /**********************************************************************************/
 /*                 DabColoringStrategyMask                                        */
 /**********************************************************************************/
@@ -32,10 +53,11 @@ void KisColorSmudgeStrategyBase::DabColoringStrategyMask::blendInFusedBackground
     colorRateOp->composite(dullingFillColor.data(), 1, paintColor.data(), 1, 0, 0, 1, 1, colorRateOpacity);
 
     if (smearOp->id() == COMPOSITE_COPY && qFuzzyCompare(smudgeRateOpacity, OPACITY_OPAQUE_F)) {
-        dst->fill(dst->bounds(), dullingFillColor);
+        dst->fill(dstRect, dullingFillColor);
     } else {
-        src->readBytes(dst->data(), dstRect);
-        smearOp->composite(dst->data(), dstRect.width() * dst->pixelSize(),
+        quint8 *dstPtr = bandData(dst, dstRect);
+        src->readBytes(dstPtr, dstRect);
+        smearOp->composite(dstPtr, dstRect.width() * dst->pixelSize(),
                            dullingFillColor.data(), 0,
                            0, 0,
                            1, dstRect.width() * dstRect.height(),
@@ -51,7 +73,7 @@ void KisColorSmudgeStrategyBase::DabColoringStrategyMask::blendInColorRate(const
 {
     KIS_SAFE_ASSERT_RECOVER_RETURN(*paintColor.colorSpace() == *colorRateOp->colorSpace());
 
-    colorRateOp->composite(dstDevice->data(), dstRect.width() * dstDevice->pixelSize(),
+    colorRateOp->composite(bandData(dstDevice, dstRect), dstRect.width() * dstDevice->pixelSize(),
                            paintColor.data(), 0,
                            0, 0,
                            dstRect.height(), dstRect.width(),
@@ -78,8 +100,10 @@ void KisColorSmudgeStrategyBase::DabColoringStrategyStamp::blendInColorRate(cons
     // TODO: check correctness for composition source device (transparency masks)
     KIS_ASSERT_RECOVER_RETURN(*dstDevice->colorSpace() == *m_origDab->colorSpace());
 
-    colorRateOp->composite(dstDevice->data(), dstRect.width() * dstDevice->pixelSize(),
-                           m_origDab->data(), dstRect.width() * m_origDab->pixelSize(),
+    const int firstRow = dstRect.y() - dstDevice->bounds().y();
+
+    colorRateOp->composite(bandData(dstDevice, firstRow), dstRect.width() * dstDevice->pixelSize(),
+                           bandData(m_origDab, firstRow), dstRect.width() * m_origDab->pixelSize(),
                            0, 0,
                            dstRect.height(), dstRect.width(),
                            colorRateOpacity);
@@ -185,7 +209,7 @@ KisColorSmudgeStrategyBase::blendBrush(const QVector<KisPainter *> dstPainters,
                                        KisFixedPaintDeviceSP maskDab, bool preserveMaskDab, const QRect &srcRect,
                                        const QRect &dstRect, const KoColor &currentPaintColor, qreal opacity,
                                        qreal smudgeRateValue, qreal maxPossibleSmudgeRateValue, qreal colorRateValue,
-                                       qreal smudgeRadiusValue)
+                                       qreal smudgeRadiusValue, QVector<KisRunnableStrokeJobData*> *jobs)
 {
     const qreal colorRateOpacity = this->colorRateOpacity(opacity, smudgeRateValue, colorRateValue, maxPossibleSmudgeRateValue);
 
@@ -206,76 +230,110 @@ KisColorSmudgeStrategyBase::blendBrush(const QVector<KisPainter *> dstPainters,
     DabColoringStrategy &coloringStrategy = this->coloringStrategy();
 
     const qreal dullingRateOpacity = this->dullingRateOpacity(opacity, smudgeRateValue);
+    const qreal smudgeRateOpacity = this->smearRateOpacity(opacity, smudgeRateValue);
+    const KoColor paintColor = currentPaintColor.convertedTo(m_preparedDullingColor.colorSpace());
 
-    if (colorRateOpacity > 0 &&
+    const bool useFusedBlending =
+        colorRateOpacity > 0 &&
         m_useDullingMode &&
         coloringStrategy.supportsFusedDullingBlending() &&
         ((m_smearOp->id() == COMPOSITE_OVER &&
           m_colorRateOp->id() == COMPOSITE_OVER) ||
          (m_smearOp->id() == COMPOSITE_COPY &&
-          qFuzzyCompare(dullingRateOpacity, OPACITY_OPAQUE_F)))) {
-
-        coloringStrategy.blendInFusedBackgroundAndColorRateWithDulling(m_blendDevice,
-                                                                       srcSampleDevice,
-                                                                       dstRect,
-                                                                       m_preparedDullingColor,
-                                                                       m_smearOp,
-                                                                       dullingRateOpacity,
-                                                                       currentPaintColor.convertedTo(
-                                                                               m_preparedDullingColor.colorSpace()),
-                                                                       m_colorRateOp,
-                                                                       colorRateOpacity);
+          qFuzzyCompare(dullingRateOpacity, OPACITY_OPAQUE_F)));
+
+    /**
+     * The lambdas may be executed by the stroke jobs after this function
+     * returns, so they should capture the values, not the local variables
+     */
+    DabColoringStrategy *coloringStrategyPtr = &coloringStrategy;
+
+    auto blendBand = [this, coloringStrategyPtr, srcSampleDevice, srcRect, dstRect,
+                      useFusedBlending, dullingRateOpacity, smudgeRateOpacity,
+                      colorRateOpacity, paintColor] (const QRect &dstBand) {
+        if (useFusedBlending) {
+            coloringStrategyPtr->blendInFusedBackgroundAndColorRateWithDulling(m_blendDevice,
+                                                                              srcSampleDevice,
+                                                                              dstBand,
+                                                                              m_preparedDullingColor,
+                                                                              m_smearOp,
+                                                                              dullingRateOpacity,
+                                                                              paintColor,
+                                                                              m_colorRateOp,
+                                                                              colorRateOpacity);
 
-    } else {
-        if (!m_useDullingMode) {
-            const qreal smudgeRateOpacity = this->smearRateOpacity(opacity, smudgeRateValue);
-            blendInBackgroundWithSmearing(m_blendDevice, srcSampleDevice,
-                                          srcRect, dstRect, smudgeRateOpacity);
         } else {
-            blendInBackgroundWithDulling(m_blendDevice, srcSampleDevice,
-                                         dstRect,
-                                         m_preparedDullingColor, dullingRateOpacity);
+            if (!m_useDullingMode) {
+                const QRect srcBand = dstBand.translated(srcRect.topLeft() - dstRect.topLeft());
+                blendInBackgroundWithSmearing(m_blendDevice, srcSampleDevice,
+                                              srcBand, dstBand, smudgeRateOpacity);
+            } else {
+                blendInBackgroundWithDulling(m_blendDevice, srcSampleDevice,
+                                             dstBand,
+                                             m_preparedDullingColor, dullingRateOpacity);
+            }
+
+            if (colorRateOpacity > 0) {
+                coloringStrategyPtr->blendInColorRate(
+                        paintColor,
+                        m_colorRateOp,
+                        colorRateOpacity,
+                        m_blendDevice, dstBand);
+            }
         }
+    };
 
-        if (colorRateOpacity > 0) {
-            coloringStrategy.blendInColorRate(
-                    currentPaintColor.convertedTo(m_preparedDullingColor.colorSpace()),
-                    m_colorRateOp,
-                    colorRateOpacity,
-                    m_blendDevice, dstRect);
-        }
-    }
-
-    const bool preserveDab = preserveMaskDab && dstPainters.size() > 1;
+    auto blitDab = [this, dstPainters, maskDab, preserveMaskDab, dstRect, opacity, smudgeRateValue] () {
+        const bool preserveDab = preserveMaskDab && dstPainters.size() > 1;
 
-    Q_FOREACH (KisPainter *dstPainter, dstPainters) {
-        dstPainter->setOpacityF(finalPainterOpacity(opacity, smudgeRateValue));
+        Q_FOREACH (KisPainter *dstPainter, dstPainters) {
+            dstPainter->setOpacityF(finalPainterOpacity(opacity, smudgeRateValue));
 
-        dstPainter->bltFixedWithFixedSelection(dstRect.x(), dstRect.y(),
-                                               m_blendDevice, maskDab,
-                                               maskDab->bounds().x(), maskDab->bounds().y(),
-                                               m_blendDevice->bounds().x(), m_blendDevice->bounds().y(),
-                                               dstRect.width(), dstRect.height());
-        dstPainter->renderMirrorMaskSafe(dstRect, m_blendDevice, maskDab, preserveDab);
+            dstPainter->bltFixedWithFixedSelection(dstRect.x(), dstRect.y(),
+                                                   m_blendDevice, maskDab,
+                                                   maskDab->bounds().x(), maskDab->bounds().y(),
+                                                   m_blendDevice->bounds().x(), m_blendDevice->bounds().y(),
+                                                   dstRect.width(), dstRect.height());
+            dstPainter->renderMirrorMaskSafe(dstRect, m_blendDevice, maskDab, preserveDab);
+        }
+    };
+
+    /**
+     * Big dabs are blended in bands of rows by the concurrent jobs of the
+     * stroke. The source of every band is fetched by the same job that
+     * blends it, so reading of one band overlaps with blending of another.
+     */
+    const QVector<QRect> bands =
+        jobs ? KisDabBandsUtils::splitIntoBands(dstRect) : QVector<QRect>({dstRect});
+
+    if (bands.size() > 1) {
+        Q_FOREACH (const QRect &band, bands) {
+            KritaUtils::addJobConcurrent(*jobs, [blendBand, band] () { blendBand(band); });
+        }
+        KritaUtils::addJobSequential(*jobs, blitDab);
+    } else {
+        blendBand(dstRect);
+        blitDab();
     }
-
 }
 
 void KisColorSmudgeStrategyBase::blendInBackgroundWithSmearing(KisFixedPaintDeviceSP dst, KisColorSmudgeSourceSP src,
                                                                const QRect &srcRect, const QRect &dstRect,
                                                                const qreal smudgeRateOpacity)
 {
+    quint8 *dstPtr = bandData(dst, dstRect);
+
     if (m_smearOp->id() == COMPOSITE_COPY && qFuzzyCompare(smudgeRateOpacity, OPACITY_OPAQUE_F)) {
-        src->readBytes(dst->data(), srcRect);
+        src->readBytes(dstPtr, srcRect);
     } else {
-        src->readBytes(dst->data(), dstRect);
+        src->readBytes(dstPtr, dstRect);
 
         KisFixedPaintDevice tempDevice(src->colorSpace(), m_memoryAllocator);
         tempDevice.setRect(srcRect);
         tempDevice.lazyGrowBufferWithoutInitialization();
 
         src->readBytes(tempDevice.data(), srcRect);
-        m_smearOp->composite(dst->data(), dstRect.width() * dst->pixelSize(),
+        m_smearOp->composite(dstPtr, dstRect.width() * dst->pixelSize(),
                              tempDevice.data(), dstRect.width() * tempDevice.pixelSize(), // stride should be random non-zero
                              0, 0,
                              1, dstRect.width() * dstRect.height(),
@@ -290,10 +348,11 @@ void KisColorSmudgeStrategyBase::blendInBackgroundWithDulling(KisFixedPaintDevic
     Q_UNUSED(preparedDullingColor);
 
     if (m_smearOp->id() == COMPOSITE_COPY && qFuzzyCompare(smudgeRateOpacity, OPACITY_OPAQUE_F)) {
-        dst->fill(dst->bounds(), m_preparedDullingColor);
+        dst->fill(dstRect, m_preparedDullingColor);
     } else {
-        src->readBytes(dst->data(), dstRect);
-        m_smearOp->composite(dst->data(), dstRect.width() * dst->pixelSize(),
+        quint8 *dstPtr = bandData(dst, dstRect);
+        src->readBytes(dstPtr, dstRect);
+        m_smearOp->composite(dstPtr, dstRect.width() * dst->pixelSize(),
                              m_preparedDullingColor.data(), 0,
                              0, 0,
                              1, dstRect.width() * dstRect.height(),
@@ -106,7 +106,8 @@ public:
     void blendBrush(const QVector<KisPainter *> dstPainters, KisColorSmudgeSourceSP srcSampleDevice,
                     KisFixedPaintDeviceSP maskDab, bool preserveMaskDab, const QRect &srcRect, const QRect &dstRect,
                     const KoColor &currentPaintColor, qreal opacity, qreal smudgeRateValue,
-                    qreal maxPossibleSmudgeRateValue, qreal colorRateValue, qreal smudgeRadiusValue);
+                    qreal maxPossibleSmudgeRateValue, qreal colorRateValue, qreal smudgeRadiusValue,
+                    QVector<KisRunnableStrokeJobData*> *jobs);
 
     void blendInBackgroundWithSmearing(KisFixedPaintDeviceSP dst, KisColorSmudgeSourceSP src, const QRect &srcRect,
                                        const QRect &dstRect, const qreal smudgeRateOpacity);
@@ -16,6 +16,8 @@
 #include "KisColorSmudgeInterstrokeData.h"
 #include "kis_algebra_2d.h"
 #include <KoBgrColorSpaceTraits.h>
+#include <KisRunnableStrokeJobUtils.h>
+#include <KisDabBandsUtils.h>
 
 KisColorSmudgeStrategyLightness::KisColorSmudgeStrategyLightness(KisPainter *painter, bool smearAlpha,
                                                                  bool useDullingMode, KisPaintThicknessOptionData::ThicknessMode thicknessMode)
@@ -138,7 +140,7 @@ QVector<QRect>
 KisColorSmudgeStrategyLightness::paintDab(const QRect &srcRect, const QRect &dstRect, const KoColor &currentPaintColor,
                                           qreal opacity, qreal colorRateValue, qreal smudgeRateValue,
                                           qreal maxPossibleSmudgeRateValue, qreal paintThicknessValue,
-                                          qreal smudgeRadiusValue)
+                                          qreal smudgeRadiusValue, QVector<KisRunnableStrokeJobData*> *jobs)
 {
     const int numPixels = dstRect.width() * dstRect.height();
 
@@ -149,6 +151,31 @@ KisColorSmudgeStrategyLightness::paintDab(const QRect &srcRect, const QRect &dst
     readRects << srcRect;
     m_sourceWrapperDevice->readRects(readRects);
 
+    const qreal overlaySmearRate = smudgeRateValue - 0.01; //adjust so minimum value is 0 instead of 1%
+    const qreal overlayAdjustment =
+        (m_thicknessMode == KisPaintThicknessOptionData::ThicknessMode::OVERWRITE) ?
+        1.0 : KisAlgebra2D::lerp(overlaySmearRate, 1.0, paintThicknessValue);
+    const qreal brushHeightmapOpacity = opacity * overlayAdjustment;
+
+    auto stampHeightmap = [this, brushHeightmapOpacity, dstRect] () {
+        m_heightmapPainter.setOpacityF(brushHeightmapOpacity);
+        m_heightmapPainter.bltFixed(dstRect.topLeft(), m_origDab, m_origDab->bounds());
+        m_heightmapPainter.renderMirrorMaskSafe(dstRect, m_origDab, m_shouldPreserveOriginalDab);
+    };
+
+    /**
+     * The heightmap uses only the original dab, not the blended color,
+     * so it is stamped by a concurrent job while the color of the dab is
+     * being blended. The two jobs write into different devices with
+     * different painters. Small dabs are painted inline.
+     */
+    const bool useJobs = jobs && KisDabBandsUtils::needsSplitting(numPixels);
+
+    if (useJobs) {
+        KritaUtils::addJobConcurrent(*jobs, stampHeightmap);
+    } else {
+        stampHeightmap();
+    }
 
     blendBrush({ &m_finalPainter },
         m_sourceWrapperDevice,
@@ -159,43 +186,41 @@ KisColorSmudgeStrategyLightness::paintDab(const QRect &srcRect, const QRect &dst
         smudgeRateValue,
         maxPossibleSmudgeRateValue,
         colorRateValue,
-        smudgeRadiusValue);
-
-
-    const qreal overlaySmearRate = smudgeRateValue - 0.01; //adjust so minimum value is 0 instead of 1%
-    const qreal overlayAdjustment =
-        (m_thicknessMode == KisPaintThicknessOptionData::ThicknessMode::OVERWRITE) ?
-        1.0 : KisAlgebra2D::lerp(overlaySmearRate, 1.0, paintThicknessValue);
-    const qreal brushHeightmapOpacity = opacity * overlayAdjustment;
-    m_heightmapPainter.setOpacityF(brushHeightmapOpacity);
-    m_heightmapPainter.bltFixed(dstRect.topLeft(), m_origDab, m_origDab->bounds());
-    m_heightmapPainter.renderMirrorMaskSafe(dstRect, m_origDab, m_shouldPreserveOriginalDab);
-
-
-    KisFixedPaintDeviceSP tempColorDevice =
-        new KisFixedPaintDevice(m_colorOnlyDevice->colorSpace(), m_memoryAllocator);
-
-    KisFixedPaintDeviceSP tempHeightmapDevice =
-        new KisFixedPaintDevice(m_heightmapDevice->colorSpace(), m_memoryAllocator);
-
-    Q_FOREACH(const QRect& rc, mirroredRects) {
-        tempColorDevice->setRect(rc);
-        tempColorDevice->lazyGrowBufferWithoutInitialization();
+        smudgeRadiusValue,
+        jobs);
+
+    auto modulateLightness = [this, mirroredRects, numPixels] () {
+        KisFixedPaintDeviceSP tempColorDevice =
+            new KisFixedPaintDevice(m_colorOnlyDevice->colorSpace(), m_memoryAllocator);
+
+        KisFixedPaintDeviceSP tempHeightmapDevice =
+            new KisFixedPaintDevice(m_heightmapDevice->colorSpace(), m_memoryAllocator);
+
+        Q_FOREACH(const QRect& rc, mirroredRects) {
+            tempColorDevice->setRect(rc);
+            tempColorDevice->lazyGrowBufferWithoutInitialization();
+
+            tempHeightmapDevice->setRect(rc);
+            tempHeightmapDevice->lazyGrowBufferWithoutInitialization();
+
+            m_colorOnlyDevice->readBytes(tempColorDevice->data(), rc);
+            m_heightmapDevice->readBytes(tempHeightmapDevice->data(), rc);
+            tempColorDevice->colorSpace()->
+                modulateLightnessByGrayBrush(tempColorDevice->data(),
+                    reinterpret_cast<const QRgb*>(tempHeightmapDevice->data()),
+                    1.0,
+                    numPixels);
+            m_projectionDevice->writeBytes(tempColorDevice->data(), tempColorDevice->bounds());
+        }
 
-        tempHeightmapDevice->setRect(rc);
-        tempHeightmapDevice->lazyGrowBufferWithoutInitialization();
+        m_layerOverlayDevice->writeRects(mirroredRects);
+    };
 
-        m_colorOnlyDevice->readBytes(tempColorDevice->data(), rc);
-        m_heightmapDevice->readBytes(tempHeightmapDevice->data(), rc);
-        tempColorDevice->colorSpace()->
-            modulateLightnessByGrayBrush(tempColorDevice->data(),
-                reinterpret_cast<const QRgb*>(tempHeightmapDevice->data()),
-                1.0,
-                numPixels);
-        m_projectionDevice->writeBytes(tempColorDevice->data(), tempColorDevice->bounds());
+    if (useJobs) {
+        KritaUtils::addJobSequential(*jobs, modulateLightness);
+    } else {
+        modulateLightness();
     }
- 
-    m_layerOverlayDevice->writeRects(mirroredRects);
 
     return mirroredRects;
 }
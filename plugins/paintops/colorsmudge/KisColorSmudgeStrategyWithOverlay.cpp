@@ -14,6 +14,7 @@
 #include "kis_selection.h"
 
 #include "KisOverlayPaintDeviceWrapper.h"
+#include <KisRunnableStrokeJobUtils.h>
 
 KisColorSmudgeStrategyWithOverlay::KisColorSmudgeStrategyWithOverlay(KisPainter *painter, KisImageSP image,
                                                                      bool smearAlpha, bool useDullingMode,
@@ -73,7 +74,8 @@ QVector<QRect> KisColorSmudgeStrategyWithOverlay::paintDab(const QRect &srcRect,
                                                            const KoColor &currentPaintColor, qreal opacity,
                                                            qreal colorRateValue, qreal smudgeRateValue,
                                                            qreal maxPossibleSmudgeRateValue,
-                                                           qreal lightnessStrengthValue, qreal smudgeRadiusValue)
+                                                           qreal lightnessStrengthValue, qreal smudgeRadiusValue,
+                                                           QVector<KisRunnableStrokeJobData*> *jobs)
 {
     Q_UNUSED(lightnessStrengthValue);
 
@@ -101,9 +103,16 @@ QVector<QRect> KisColorSmudgeStrategyWithOverlay::paintDab(const QRect &srcRect,
                opacity,
                smudgeRateValue,
                maxPossibleSmudgeRateValue,
-               colorRateValue, smudgeRadiusValue);
+               colorRateValue, smudgeRadiusValue,
+               jobs);
 
-    m_layerOverlayDevice->writeRects(mirroredRects);
+    if (jobs && !jobs->isEmpty()) {
+        KritaUtils::addJobSequential(*jobs, [this, mirroredRects] () {
+            m_layerOverlayDevice->writeRects(mirroredRects);
+        });
+    } else {
+        m_layerOverlayDevice->writeRects(mirroredRects);
+    }
 
     return mirroredRects;
 }
@@ -28,7 +28,8 @@ public:
 
     QVector<QRect> paintDab(const QRect &srcRect, const QRect &dstRect, const KoColor &currentPaintColor, qreal opacity,
                             qreal colorRateValue, qreal smudgeRateValue, qreal maxPossibleSmudgeRateValue,
-                            qreal lightnessStrengthValue, qreal smudgeRadiusValue) override;
+                            qreal lightnessStrengthValue, qreal smudgeRadiusValue,
+                            QVector<KisRunnableStrokeJobData*> *jobs) override;
 
 protected:
     KisFixedPaintDeviceSP m_maskDab;
@@ -17,6 +17,9 @@
 #include <kis_lod_transform.h>
 #include <kis_spacing_information.h>
 #include "kis_paintop_plugin_utils.h"
+#include <KisDabBandsUtils.h>
+#include <KisRunnableStrokeJobsInterface.h>
+#include <tool/strokes/FreehandStrokeRunnableJobDataWithUpdate.h>
 
 #include "KisInterstrokeData.h"
 #include "KisInterstrokeDataFactory.h"
@@ -128,6 +131,8 @@ KisColorSmudgeOp::KisColorSmudgeOp(const KisPaintOpSettingsSP settings, KisPaint
 
 KisColorSmudgeOp::~KisColorSmudgeOp()
 {
+    KIS_SAFE_ASSERT_RECOVER_NOOP(m_pendingDabs.empty());
+
     qDeleteAll(m_hsvOptions);
     delete m_hsvTransform;
 }
@@ -164,10 +169,10 @@ KisSpacingInformation KisColorSmudgeOp::paintAt(const KisPaintInformation& info)
 
     KisDabShape shape(scale, ratio, rotation);
 
-    QPointF scatteredPos =
-        m_scatterOption.apply(info,
-                              brush->maskWidth(shape, 0, 0, info),
-                              brush->maskHeight(shape, 0, 0, info));
+    const int maskWidth = brush->maskWidth(shape, 0, 0, info);
+    const int maskHeight = brush->maskHeight(shape, 0, 0, info);
+
+    QPointF scatteredPos = m_scatterOption.apply(info, maskWidth, maskHeight);
 
     const qreal smudgeRadiusPortion = m_smudgeRadiusOption.isChecked() ? m_smudgeRadiusOption.computeSizeLikeValue(info) : 0.0;
 
@@ -177,9 +182,78 @@ KisSpacingInformation KisColorSmudgeOp::paintAt(const KisPaintInformation& info)
 
     KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(m_strategy, spacingInfo);
 
+    DabRequest request;
+    request.info = info;
+    request.shape = shape;
+    request.cursorPos = scatteredPos;
+    request.paintThickness = m_paintThicknessOption.apply(info);
+    request.smudgeRadiusPortion = smudgeRadiusPortion;
+
+    if (m_pendingDabs.empty() &&
+        !KisDabBandsUtils::needsSplitting(qint64(maskWidth) * maskHeight)) {
+
+        QRect srcDabRect;
+        if (updateMask(request, &srcDabRect)) {
+            fillPaintValues(info, &request);
+
+            const QVector<QRect> dirtyRects =
+                    m_strategy->paintDab(srcDabRect, m_dstDabRect,
+                                         request.paintColor,
+                                         request.opacity, request.colorRate,
+                                         request.smudgeRate,
+                                         request.maxSmudgeRate,
+                                         request.paintThickness,
+                                         request.smudgeRadiusPortion,
+                                         nullptr);
+
+            painter()->addDirtyRects(dirtyRects);
+        }
+
+        return spacingInfo;
+    }
+
+    /**
+     * Big dabs are painted by the stroke jobs, so that their bands could be
+     * blended concurrently. The dab should smudge the result of the previous
+     * one, so the queue is processed in order, one dab per sequential job.
+     * The request keeps a copy of the paint information, so the sensors are
+     * evaluated here, while the drawing direction is still available.
+     */
+    fillPaintValues(info, &request);
+    m_pendingDabs.push_back(request);
+
+    painter()->runnableStrokeJobsInterface()->addRunnableJob(
+        new FreehandStrokeRunnableJobDataWithUpdate(
+            [this] () { paintNextPendingDab(); },
+            KisStrokeJobData::SEQUENTIAL));
 
-    const qreal paintThickness = m_paintThicknessOption.apply(info);
-    m_strategy->updateMask(m_dabCache, info, shape, scatteredPos, &m_dstDabRect, paintThickness);
+    return spacingInfo;
+}
+
+void KisColorSmudgeOp::fillPaintValues(const KisPaintInformation &info, DabRequest *request)
+{
+    request->colorRate = m_colorRateOption.isChecked() ? m_colorRateOption.computeSizeLikeValue(info) : 0.0;
+    request->smudgeRate = m_smudgeRateOption.isChecked() ? m_smudgeRateOption.computeSizeLikeValue(info) : 1.0;
+    request->maxSmudgeRate = m_smudgeRateOption.strengthValue();
+    request->opacity = m_opacityOption.apply(info);
+
+    KoColor paintColor = m_paintColor;
+
+    m_gradientOption.apply(paintColor, m_gradient, info);
+    if (m_hsvTransform) {
+        Q_FOREACH (KisHSVOption *option, m_hsvOptions) {
+            option->apply(m_hsvTransform, info);
+        }
+        m_hsvTransform->transform(paintColor.data(), paintColor.data(), 1);
+    }
+
+    request->paintColor = paintColor;
+}
+
+bool KisColorSmudgeOp::updateMask(const DabRequest &request, QRect *srcDabRect)
+{
+    m_strategy->updateMask(m_dabCache, request.info, request.shape, request.cursorPos,
+                           &m_dstDabRect, request.paintThickness);
 
     QPointF newCenterPos = QRectF(m_dstDabRect).center();
     /**
@@ -189,42 +263,54 @@ KisSpacingInformation KisColorSmudgeOp::paintAt(const KisPaintInformation& info)
      * brush (due to rounding effects), which will result in a
      * really weird quality.
      */
-    QRect srcDabRect = m_dstDabRect.translated((m_lastPaintPos - newCenterPos).toPoint());
+    *srcDabRect = m_dstDabRect.translated((m_lastPaintPos - newCenterPos).toPoint());
 
     m_lastPaintPos = newCenterPos;
 
     if (m_firstRun) {
         m_firstRun = false;
-        return spacingInfo;
+        return false;
     }
 
-    const qreal colorRate = m_colorRateOption.isChecked() ? m_colorRateOption.computeSizeLikeValue(info) : 0.0;
-    const qreal smudgeRate = m_smudgeRateOption.isChecked() ? m_smudgeRateOption.computeSizeLikeValue(info) : 1.0;
-    const qreal maxSmudgeRate = m_smudgeRateOption.strengthValue();
-    const qreal fpOpacity = m_opacityOption.apply(info);
+    return true;
+}
 
-    KoColor paintColor = m_paintColor;
+void KisColorSmudgeOp::paintNextPendingDab()
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN(!m_pendingDabs.empty());
 
-    m_gradientOption.apply(paintColor, m_gradient, info);
-    if (m_hsvTransform) {
-        Q_FOREACH (KisHSVOption *option, m_hsvOptions) {
-            option->apply(m_hsvTransform, info);
-        }
-        m_hsvTransform->transform(paintColor.data(), paintColor.data(), 1);
-    }
+    const DabRequest request = m_pendingDabs.front();
+    m_pendingDabs.pop_front();
+
+    QRect srcDabRect;
+    if (!updateMask(request, &srcDabRect)) return;
+
+    QVector<KisRunnableStrokeJobData*> jobs;
 
     const QVector<QRect> dirtyRects =
             m_strategy->paintDab(srcDabRect, m_dstDabRect,
-                                 paintColor,
-                                 fpOpacity, colorRate,
-                                 smudgeRate,
-                                 maxSmudgeRate,
-                                 paintThickness,
-                                 smudgeRadiusPortion);
+                                 request.paintColor,
+                                 request.opacity, request.colorRate,
+                                 request.smudgeRate,
+                                 request.maxSmudgeRate,
+                                 request.paintThickness,
+                                 request.smudgeRadiusPortion,
+                                 &jobs);
+
+    if (jobs.isEmpty()) {
+        painter()->addDirtyRects(dirtyRects);
+        return;
+    }
 
-    painter()->addDirtyRects(dirtyRects);
+    /**
+     * All the jobs are added at once, so they are executed right after
+     * this one and before the job of the next dab
+     */
+    jobs.append(new FreehandStrokeRunnableJobDataWithUpdate(
+        [this, dirtyRects] () { painter()->addDirtyRects(dirtyRects); },
+        KisStrokeJobData::SEQUENTIAL));
 
-    return spacingInfo;
+    painter()->runnableStrokeJobsInterface()->addRunnableJobs(jobs);
 }
 
 KisSpacingInformation KisColorSmudgeOp::updateSpacingImpl(const KisPaintInformation &info) const
@@ -8,12 +8,16 @@
 #define _KIS_COLORSMUDGEOP_H_
 
 #include <QRect>
+#include <deque>
 
 #include "KoColorTransformation.h"
 #include <KoAbstractGradient.h>
 
 #include <kis_brush_based_paintop.h>
 #include <kis_types.h>
+#include <kis_paint_information.h>
+#include <kis_dab_shape.h>
+#include <KoColor.h>
 
 #include "KisOverlayPaintDeviceWrapper.h"
 #include <KisOpacityOption.h>
@@ -52,6 +56,29 @@ protected:
     KisSpacingInformation updateSpacingImpl(const KisPaintInformation &info) const override;
     KisTimingInformation updateTimingImpl(const KisPaintInformation &info) const override;
 
+private:
+    /**
+     * Everything needed for painting a dab that is computed
+     * synchronously in paintAt()
+     */
+    struct DabRequest
+    {
+        KisPaintInformation info;
+        KisDabShape shape;
+        QPointF cursorPos;
+        qreal paintThickness {0.0};
+        qreal smudgeRadiusPortion {0.0};
+        qreal colorRate {0.0};
+        qreal smudgeRate {0.0};
+        qreal maxSmudgeRate {0.0};
+        qreal opacity {0.0};
+        KoColor paintColor;
+    };
+
+    void fillPaintValues(const KisPaintInformation &info, DabRequest *request);
+    bool updateMask(const DabRequest &request, QRect *srcDabRect);
+    void paintNextPendingDab();
+
 private:
     bool                      m_firstRun;
 
@@ -79,6 +106,13 @@ private:
 
     KoColorTransformation *m_hsvTransform {0};
     QScopedPointer<KisColorSmudgeStrategy> m_strategy;
+
+    /**
+     * Big dabs are painted by the stroke jobs. The dabs that come after
+     * them are queued here as well, since every dab smudges the result
+     * of the previous one.
+     */
+    std::deque<DabRequest> m_pendingDabs;
 };
 
 #endif // _KIS_COLORSMUDGEOP_H_
@@ -14,6 +14,7 @@
 #include <QVariant>
 #include <QHash>
 #include <QVector>
+#include <QtMath>
 
 #include <kis_types.h>
 #include <kis_random_accessor_ng.h>
@@ -124,8 +125,6 @@ void HairyBrush::paintLine(KisPaintDeviceSP dab, KisPaintDeviceSP layer, const K
     Bristle *bristle = 0;
     KoColor bristleColor(dab->colorSpace());
 
-    m_dabAccessor = dab->createRandomAccessorNG();
-
     m_dab = dab;
 
     // initialization block
@@ -156,6 +155,11 @@ void HairyBrush::paintLine(KisPaintDeviceSP dab, KisPaintDeviceSP layer, const K
     int bristleCount = m_bristles.size();
     int bristlePathSize;
     qreal threshold = 1.0 - pi2.pressure();
+
+    if (m_bristleInks.size() < bristleCount) {
+        m_bristleInks.resize(bristleCount);
+    }
+
     for (int i = 0; i < bristleCount; i++) {
 
         if (!m_bristles.at(i)->enabled()) continue;
@@ -205,6 +209,10 @@ void HairyBrush::paintLine(KisPaintDeviceSP dab, KisPaintDeviceSP layer, const K
             bristlePathSize -= 1;
         }
 
+        BristleInk &ink = m_bristleInks[m_renderer.numParticles()];
+        ink.positions.clear();
+        ink.colors.clear();
+
         memcpy(bristleColor.data(), bristle->color().data() , m_pixelSize);
         for (int i = 0; i < bristlePathSize ; i++) {
 
@@ -226,14 +234,35 @@ void HairyBrush::paintLine(KisPaintDeviceSP dab, KisPaintDeviceSP layer, const K
                 }
             }
 
-            addBristleInk(bristle, bristlePath.at(i), bristleColor);
+            addBristleInk(ink, bristlePath.at(i), bristleColor);
             bristle->setInkAmount(1.0 - inkDepletion);
             bristle->upIncrement();
         }
 
+        if (ink.positions.isEmpty()) continue;
+
+        // the ink may touch the pixels next to every position of the path
+        int left = qFloor(ink.positions.first().x());
+        int top = qFloor(ink.positions.first().y());
+        int right = left;
+        int bottom = top;
+
+        Q_FOREACH (const QPointF &pos, ink.positions) {
+            left = qMin(left, qFloor(pos.x()));
+            top = qMin(top, qFloor(pos.y()));
+            right = qMax(right, qFloor(pos.x()));
+            bottom = qMax(bottom, qFloor(pos.y()));
+        }
+
+        m_renderer.addParticle(QRect(QPoint(left, top), QPoint(right + 2, bottom + 2)));
     }
+
+    m_renderer.render(dab, [this] (KisParallelParticleRenderer::Target &target, int index) {
+        KisRandomAccessorSP accessor = target.accessor();
+        paintBristleInk(accessor, m_bristleInks[index]);
+    });
+
     m_dab = nullptr;
-    m_dabAccessor = nullptr;
 }
 
 
@@ -294,29 +323,48 @@ void HairyBrush::opacityDepletion(Bristle* bristle, KoColor& bristleColor, qreal
     bristleColor.setOpacity(opacity);
 }
 
-inline void HairyBrush::addBristleInk(Bristle *bristle,const QPointF &pos, const KoColor &color)
+inline void HairyBrush::addBristleInk(BristleInk &ink, const QPointF &pos, const KoColor &color)
+{
+    const int offset = ink.colors.size();
+    ink.positions.append(pos);
+    ink.colors.resize(offset + m_pixelSize);
+    memcpy(ink.colors.data() + offset, color.data(), m_pixelSize);
+}
+
+void HairyBrush::paintBristleInk(KisRandomAccessorSP &accessor, const BristleInk &ink)
+{
+    KoColor color(m_dab->colorSpace());
+
+    const quint8 *colorPtr = ink.colors.constData();
+    Q_FOREACH (const QPointF &pos, ink.positions) {
+        memcpy(color.data(), colorPtr, m_pixelSize);
+        paintInk(accessor, pos, color);
+        colorPtr += m_pixelSize;
+    }
+}
+
+inline void HairyBrush::paintInk(KisRandomAccessorSP &accessor, const QPointF &pos, const KoColor &color)
 {
-    Q_UNUSED(bristle);
     if (m_properties->antialias) {
         if (m_properties->useCompositing) {
-            paintParticle(pos, color);
+            paintParticle(accessor, pos, color);
         } else {
-            paintParticle(pos, color, 1.0);
+            paintParticle(accessor, pos, color, 1.0);
         }
     }
     else {
         int ix = qRound(pos.x());
         int iy = qRound(pos.y());
         if (m_properties->useCompositing) {
-            plotPixel(ix, iy, color);
+            plotPixel(accessor, ix, iy, color);
         }
         else {
-            darkenPixel(ix, iy, color);
+            darkenPixel(accessor, ix, iy, color);
         }
     }
 }
 
-void HairyBrush::paintParticle(QPointF pos, const KoColor& color, qreal weight)
+void HairyBrush::paintParticle(KisRandomAccessorSP &accessor, QPointF pos, const KoColor& color, qreal weight)
 {
     // opacity top left, right, bottom left, right
     quint8 opacity = color.opacityU8();
@@ -332,33 +380,33 @@ void HairyBrush::paintParticle(QPointF pos, const KoColor& color, qreal weight)
     quint8 bbl = qRound((1.0 - fx) * (fy)  * opacity);
     quint8 bbr = qRound((fx)  * (fy)  * opacity);
 
-    const KoColorSpace * cs = m_dab->colorSpace();
+    const KoColorSpace * cs = color.colorSpace();
 
-    m_dabAccessor->moveTo(ipx  , ipy);
-    btl = quint8(kisBoundFast<quint16>(OPACITY_TRANSPARENT_U8, btl + cs->opacityU8(m_dabAccessor->rawData()), OPACITY_OPAQUE_U8));
-    memcpy(m_dabAccessor->rawData(), color.data(), cs->pixelSize());
-    cs->setOpacity(m_dabAccessor->rawData(), btl, 1);
+    accessor->moveTo(ipx  , ipy);
+    btl = quint8(kisBoundFast<quint16>(OPACITY_TRANSPARENT_U8, btl + cs->opacityU8(accessor->rawData()), OPACITY_OPAQUE_U8));
+    memcpy(accessor->rawData(), color.data(), cs->pixelSize());
+    cs->setOpacity(accessor->rawData(), btl, 1);
 
-    m_dabAccessor->moveTo(ipx + 1, ipy);
-    btr =  quint8(kisBoundFast<quint16>(OPACITY_TRANSPARENT_U8, btr + cs->opacityU8(m_dabAccessor->rawData()), OPACITY_OPAQUE_U8));
-    memcpy(m_dabAccessor->rawData(), color.data(), cs->pixelSize());
-    cs->setOpacity(m_dabAccessor->rawData(), btr, 1);
+    accessor->moveTo(ipx + 1, ipy);
+    btr =  quint8(kisBoundFast<quint16>(OPACITY_TRANSPARENT_U8, btr + cs->opacityU8(accessor->rawData()), OPACITY_OPAQUE_U8));
+    memcpy(accessor->rawData(), color.data(), cs->pixelSize());
+    cs->setOpacity(accessor->rawData(), btr, 1);
 
-    m_dabAccessor->moveTo(ipx, ipy + 1);
-    bbl = quint8(kisBoundFast<quint16>(OPACITY_TRANSPARENT_U8, bbl + cs->opacityU8(m_dabAccessor->rawData()), OPACITY_OPAQUE_U8));
-    memcpy(m_dabAccessor->rawData(), color.data(), cs->pixelSize());
-    cs->setOpacity(m_dabAccessor->rawData(), bbl, 1);
+    accessor->moveTo(ipx, ipy + 1);
+    bbl = quint8(kisBoundFast<quint16>(OPACITY_TRANSPARENT_U8, bbl + cs->opacityU8(accessor->rawData()), OPACITY_OPAQUE_U8));
+    memcpy(accessor->rawData(), color.data(), cs->pixelSize());
+    cs->setOpacity(accessor->rawData(), bbl, 1);
 
-    m_dabAccessor->moveTo(ipx + 1, ipy + 1);
-    bbr = quint8(kisBoundFast<quint16>(OPACITY_TRANSPARENT_U8, bbr + cs->opacityU8(m_dabAccessor->rawData()), OPACITY_OPAQUE_U8));
-    memcpy(m_dabAccessor->rawData(), color.data(), cs->pixelSize());
-    cs->setOpacity(m_dabAccessor->rawData(), bbr, 1);
+    accessor->moveTo(ipx + 1, ipy + 1);
+    bbr = quint8(kisBoundFast<quint16>(OPACITY_TRANSPARENT_U8, bbr + cs->opacityU8(accessor->rawData()), OPACITY_OPAQUE_U8));
+    memcpy(accessor->rawData(), color.data(), cs->pixelSize());
+    cs->setOpacity(accessor->rawData(), bbr, 1);
 }
 
-void HairyBrush::paintParticle(QPointF pos, const KoColor& color)
+void HairyBrush::paintParticle(KisRandomAccessorSP &accessor, QPointF pos, const KoColor& color)
 {
     // opacity top left, right, bottom left, right
-    memcpy(m_color.data(), color.data(), m_pixelSize);
+    KoColor pixelColor(color);
     quint8 opacity = color.opacityU8();
 
     int ipx = int (pos.x());
@@ -371,31 +419,31 @@ void HairyBrush::paintParticle(QPointF pos, const KoColor& color)
     quint8 bbl = qRound((1.0 - fx) * (fy)  * opacity);
     quint8 bbr = qRound((fx)  * (fy)  * opacity);
 
-    m_color.setOpacity(btl);
-    plotPixel(ipx  , ipy, m_color);
+    pixelColor.setOpacity(btl);
+    plotPixel(accessor, ipx  , ipy, pixelColor);
 
-    m_color.setOpacity(btr);
-    plotPixel(ipx + 1  , ipy, m_color);
+    pixelColor.setOpacity(btr);
+    plotPixel(accessor, ipx + 1  , ipy, pixelColor);
 
-    m_color.setOpacity(bbl);
-    plotPixel(ipx  , ipy + 1, m_color);
+    pixelColor.setOpacity(bbl);
+    plotPixel(accessor, ipx  , ipy + 1, pixelColor);
 
-    m_color.setOpacity(bbr);
-    plotPixel(ipx + 1 , ipy + 1, m_color);
+    pixelColor.setOpacity(bbr);
+    plotPixel(accessor, ipx + 1 , ipy + 1, pixelColor);
 }
 
 
-inline void HairyBrush::plotPixel(int wx, int wy, const KoColor &color)
+inline void HairyBrush::plotPixel(KisRandomAccessorSP &accessor, int wx, int wy, const KoColor &color)
 {
-    m_dabAccessor->moveTo(wx, wy);
-    m_compositeOp->composite(m_dabAccessor->rawData(), m_pixelSize, color.data() , m_pixelSize, 0, 0, 1, 1, OPACITY_OPAQUE_F);
+    accessor->moveTo(wx, wy);
+    m_compositeOp->composite(accessor->rawData(), m_pixelSize, color.data() , m_pixelSize, 0, 0, 1, 1, OPACITY_OPAQUE_F);
 }
 
-inline void HairyBrush::darkenPixel(int wx, int wy, const KoColor &color)
+inline void HairyBrush::darkenPixel(KisRandomAccessorSP &accessor, int wx, int wy, const KoColor &color)
 {
-    m_dabAccessor->moveTo(wx, wy);
-    if (m_dab->colorSpace()->opacityU8(m_dabAccessor->rawData()) < color.opacityU8()) {
-        memcpy(m_dabAccessor->rawData(), color.data(), m_pixelSize);
+    accessor->moveTo(wx, wy);
+    if (color.colorSpace()->opacityU8(accessor->rawData()) < color.opacityU8()) {
+        memcpy(accessor->rawData(), color.data(), m_pixelSize);
     }
 }
 
@@ -19,6 +19,7 @@
 #include <kis_paint_device.h>
 #include <brushengine/kis_paint_information.h>
 #include <kis_random_accessor_ng.h>
+#include <KisParallelParticleRenderer.h>
 
 class KoCompositeOp;
 
@@ -74,16 +75,26 @@ public:
     void fromDabWithDensity(KisFixedPaintDeviceSP dab, qreal density);
 
 private:
-    /// paints single bristle
-    void addBristleInk(Bristle *bristle,const QPointF &pos, const KoColor &color);
+    /// the positions and the colors of the ink left by a single bristle
+    struct BristleInk {
+        QVector<QPointF> positions;
+        QVector<quint8> colors;
+    };
+
+    /// remembers the ink of the bristle, it is painted by the particle renderer later
+    void addBristleInk(BristleInk &ink, const QPointF &pos, const KoColor &color);
+    /// paints the ink of a single bristle
+    void paintBristleInk(KisRandomAccessorSP &accessor, const BristleInk &ink);
+    /// paints single point of the bristle
+    void paintInk(KisRandomAccessorSP &accessor, const QPointF &pos, const KoColor &color);
     /// composite single pixel to dab
-    void plotPixel(int wx, int wy, const KoColor &color);
+    void plotPixel(KisRandomAccessorSP &accessor, int wx, int wy, const KoColor &color);
     /// check the opacity of dab pixel and if the opacity is less than color, it will copy color to dab
-    void darkenPixel(int wx, int wy, const KoColor &color);
+    void darkenPixel(KisRandomAccessorSP &accessor, int wx, int wy, const KoColor &color);
     /// paint wu particle by copying the color and setup just the opacity, weight is complementary to opacity of the color
-    void paintParticle(QPointF pos, const KoColor& color, qreal weight);
+    void paintParticle(KisRandomAccessorSP &accessor, QPointF pos, const KoColor& color, qreal weight);
     /// paint wu particle using composite operation
-    void paintParticle(QPointF pos, const KoColor& color);
+    void paintParticle(KisRandomAccessorSP &accessor, QPointF pos, const KoColor& color);
     /// similar to sample input color in spray
     void colorifyBristles(KisPaintDeviceSP source, QPointF point);
 
@@ -111,7 +122,8 @@ private:
     QHash<QString, QVariant> m_params;
     // temporary device
     KisPaintDeviceSP m_dab;
-    KisRandomAccessorSP m_dabAccessor;
+    QVector<BristleInk> m_bristleInks;
+    KisParallelParticleRenderer m_renderer;
     const KoCompositeOp * m_compositeOp {nullptr};
     quint32 m_pixelSize {0};
 
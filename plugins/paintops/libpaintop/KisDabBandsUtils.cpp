@@ -0,0 +1,42 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisDabBandsUtils.h"
+
+#include <QThread>
+
+namespace KisDabBandsUtils
+{
+
+namespace {
+const int minPixelsForSplitting = 128 * 128;
+const int minPixelsPerBand = 64 * 64;
+}
+
+bool needsSplitting(qint64 numPixels)
+{
+    return numPixels >= minPixelsForSplitting;
+}
+
+QVector<QRect> splitIntoBands(const QRect &rc)
+{
+    const qint64 numPixels = qint64(rc.width()) * rc.height();
+
+    if (!needsSplitting(numPixels)) {
+        return {rc};
+    }
+
+    const int numBands = qBound(1, int(numPixels / minPixelsPerBand), QThread::idealThreadCount());
+    const int bandHeight = (rc.height() + numBands - 1) / numBands;
+
+    QVector<QRect> bands;
+    for (int y = rc.top(); y <= rc.bottom(); y += bandHeight) {
+        bands << QRect(rc.x(), y, rc.width(), qMin(bandHeight, rc.bottom() - y + 1));
+    }
+    return bands;
+}
+
+}
@@ -0,0 +1,39 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISDABBANDSUTILS_H
+#define KISDABBANDSUTILS_H
+
+#include <QRect>
+#include <QVector>
+
+#include "kritapaintop_export.h"
+
+/**
+ * Helpers for processing big dabs in bands of full rows on several
+ * threads. The bands are usually processed by the concurrent jobs of
+ * the stroke.
+ */
+namespace KisDabBandsUtils
+{
+
+/**
+ * @return true if the area of \p numPixels is big enough to be
+ *         processed by several jobs; for smaller areas spawning the
+ *         jobs costs more than processing the pixels
+ */
+PAINTOP_EXPORT bool needsSplitting(qint64 numPixels);
+
+/**
+ * Splits \p rc into bands of full rows, at most one band per thread.
+ * If the rect is too small for splitting, it is returned as a single
+ * band.
+ */
+PAINTOP_EXPORT QVector<QRect> splitIntoBands(const QRect &rc);
+
+}
+
+#endif // KISDABBANDSUTILS_H
@@ -47,6 +47,26 @@ void generateDab(const DabGenerationInfo &di, DabRenderingResources *resources,
     KIS_SAFE_ASSERT_RECOVER_RETURN(*dab);
     const KoColorSpace *cs = (*dab)->colorSpace();
 
+    KisBrushDabCache *persistentCache = nullptr;
+    KisBrushDabCache::Key persistentCacheKey;
+
+    if (di.usePersistentCache &&
+        di.solidColorFill &&
+        !forceNormalizedRGBAImageStamp &&
+        resources->brush->brushApplication() != IMAGESTAMP &&
+        resources->brush->persistentDabCacheId()) {
+
+        persistentCache = KisBrushDabCache::instance();
+
+        // the color is passed to the brush as raw bytes of the dab's color space
+        persistentCacheKey = di.persistentCacheKey;
+        persistentCacheKey.brushId = resources->brush->persistentDabCacheId();
+        persistentCacheKey.colorSpace = cs;
+    }
+
+    if (persistentCache && persistentCache->fetch(persistentCacheKey, *dab)) {
+        return;
+    }
 
     if (forceNormalizedRGBAImageStamp || resources->brush->brushApplication() == IMAGESTAMP) {
         *dab = resources->brush->paintDevice(cs, di.shape, di.info,
@@ -88,6 +108,10 @@ void generateDab(const DabGenerationInfo &di, DabRenderingResources *resources,
         (*dab)->mirror(di.mirrorProperties.horizontalMirror,
                        di.mirrorProperties.verticalMirror);
     }
+
+    if (persistentCache) {
+        persistentCache->insert(persistentCacheKey, *dab);
+    }
 }
 
 void postProcessDab(KisFixedPaintDeviceSP dab,
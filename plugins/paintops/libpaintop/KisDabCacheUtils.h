@@ -16,6 +16,7 @@
 #include <kis_paint_information.h>
 #include <KisMirrorProperties.h>
 #include "kis_dab_shape.h"
+#include <KisBrushDabCache.h>
 
 #include "kritapaintop_export.h"
 #include <functional>
@@ -93,6 +94,13 @@ struct PAINTOP_EXPORT DabGenerationInfo
     qreal lightnessStrength = 1.0;
 
     bool needsPostprocessing = false;
+
+    /**
+     * If true, the dab may be fetched from (and saved into) the global
+     * dab cache (KisBrushDabCache::instance()) using persistentCacheKey
+     */
+    bool usePersistentCache = false;
+    KisBrushDabCache::Key persistentCacheKey;
 };
 
 PAINTOP_EXPORT QRect correctDabRectWhenFetchedFromCache(const QRect &dabRect,
@@ -0,0 +1,306 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisParallelParticleRenderer.h"
+
+#include <QPainterPath>
+#include <QThread>
+#include <QVector>
+#include <QtConcurrent>
+#include <QtMath>
+
+#include <kis_paint_device.h>
+#include <kis_painter.h>
+#include <kis_fixed_paint_device.h>
+#include <kis_random_accessor_ng.h>
+
+namespace {
+
+/**
+ * Spawning the workers and copying the partitions costs more than
+ * drawing a few particles
+ */
+const int minParticlesForParallelRendering = 32;
+
+/**
+ * Particles scattered over a huge area (e.g. by the particle brush)
+ * would produce too many tiny jobs, so the partitions grow then
+ */
+const int maxPartitions = 1024;
+
+/**
+ * The particle brush may throw the particles really far away when its
+ * equations become unstable, such particles are drawn sequentially
+ */
+const int maxCoordinate = 1 << 28;
+
+struct Partition
+{
+    QRect rect;
+    QVector<int> particles;
+
+    /// the part of the rect covered by the particles
+    QRect dirtyRect;
+    KisPaintDeviceSP device;
+};
+
+inline int floorDiv(int value, int divisor)
+{
+    return qFloor(qreal(value) / divisor);
+}
+
+}
+
+/**********************************************************************************/
+/*                 KisParallelParticleRenderer::Target                            */
+/**********************************************************************************/
+
+struct KisParallelParticleRenderer::Target::Private
+{
+    KisPaintDeviceSP device;
+    std::function<void(KisPainter*)> painterInitializer;
+    QScopedPointer<KisPainter> painter;
+    KisRandomAccessorSP accessor;
+    QRect clipRect;
+
+    QRect clipped(const QRect &rc) const {
+        return clipRect.isNull() ? rc : rc & clipRect;
+    }
+};
+
+KisParallelParticleRenderer::Target::Target(KisPaintDeviceSP device, const std::function<void(KisPainter*)> &painterInitializer,
+                                            const QRect &clipRect)
+    : m_d(new Private)
+{
+    m_d->device = device;
+    m_d->painterInitializer = painterInitializer;
+    m_d->clipRect = clipRect;
+}
+
+KisParallelParticleRenderer::Target::~Target()
+{
+}
+
+KisPaintDeviceSP KisParallelParticleRenderer::Target::device() const
+{
+    return m_d->device;
+}
+
+KisPainter *KisParallelParticleRenderer::Target::painter()
+{
+    if (!m_d->painter) {
+        m_d->painter.reset(new KisPainter(m_d->device));
+        if (m_d->painterInitializer) {
+            m_d->painterInitializer(m_d->painter.data());
+        }
+    }
+    return m_d->painter.data();
+}
+
+KisRandomAccessorSP KisParallelParticleRenderer::Target::accessor()
+{
+    if (!m_d->accessor) {
+        m_d->accessor = m_d->device->createRandomAccessorNG();
+    }
+    return m_d->accessor;
+}
+
+QRect KisParallelParticleRenderer::Target::clipRect() const
+{
+    return m_d->clipRect;
+}
+
+void KisParallelParticleRenderer::Target::fillPainterPath(const QPainterPath &path)
+{
+    // KisPainter::fillPainterPath() expands the rect by one pixel for anti-aliasing
+    const QRect rc = m_d->clipped(path.boundingRect().toAlignedRect().adjusted(-1, -1, 1, 1));
+    if (rc.isEmpty()) return;
+
+    painter()->fillPainterPath(path, rc);
+}
+
+void KisParallelParticleRenderer::Target::bitBlt(const QPoint &pos, KisPaintDeviceSP src, const QRect &srcRect)
+{
+    const QRect rc = m_d->clipped(QRect(pos, srcRect.size()));
+    if (rc.isEmpty()) return;
+
+    painter()->bitBlt(rc.topLeft(), src, QRect(srcRect.topLeft() + rc.topLeft() - pos, rc.size()));
+}
+
+void KisParallelParticleRenderer::Target::bltFixed(const QPoint &pos, KisFixedPaintDeviceSP src, const QRect &srcRect)
+{
+    const QRect rc = m_d->clipped(QRect(pos, srcRect.size()));
+    if (rc.isEmpty()) return;
+
+    painter()->bltFixed(rc.topLeft(), src, QRect(srcRect.topLeft() + rc.topLeft() - pos, rc.size()));
+}
+
+void KisParallelParticleRenderer::Target::drawLine(const QPointF &start, const QPointF &end, qreal width, bool antialias)
+{
+    painter()->drawLine(start, end, width, antialias, m_d->clipRect);
+}
+
+/**********************************************************************************/
+/*                 KisParallelParticleRenderer                                    */
+/**********************************************************************************/
+
+struct KisParallelParticleRenderer::Private
+{
+    int partitionSize {128};
+    PainterInitializer painterInitializer;
+    QVector<QRect> particleBounds;
+    QRect totalBounds;
+
+    QVector<Partition> splitIntoPartitions() const;
+};
+
+QVector<Partition> KisParallelParticleRenderer::Private::splitIntoPartitions() const
+{
+    if (totalBounds.left() < -maxCoordinate || totalBounds.right() > maxCoordinate ||
+        totalBounds.top() < -maxCoordinate || totalBounds.bottom() > maxCoordinate) {
+
+        return QVector<Partition>();
+    }
+
+    int size = partitionSize;
+
+    int left = 0;
+    int top = 0;
+    int columns = 0;
+    int rows = 0;
+
+    do {
+        left = floorDiv(totalBounds.left(), size);
+        top = floorDiv(totalBounds.top(), size);
+        columns = floorDiv(totalBounds.right(), size) - left + 1;
+        rows = floorDiv(totalBounds.bottom(), size) - top + 1;
+
+        if (qint64(columns) * rows <= maxPartitions) break;
+
+        size *= 2;
+    } while (true);
+
+    QVector<Partition> grid(columns * rows);
+
+    for (int row = 0; row < rows; row++) {
+        for (int column = 0; column < columns; column++) {
+            grid[row * columns + column].rect =
+                QRect((left + column) * size, (top + row) * size, size, size);
+        }
+    }
+
+    for (int i = 0; i < particleBounds.size(); i++) {
+        const QRect &rc = particleBounds[i];
+        if (rc.isEmpty()) continue;
+
+        const int firstColumn = floorDiv(rc.left(), size) - left;
+        const int lastColumn = floorDiv(rc.right(), size) - left;
+        const int firstRow = floorDiv(rc.top(), size) - top;
+        const int lastRow = floorDiv(rc.bottom(), size) - top;
+
+        for (int row = firstRow; row <= lastRow; row++) {
+            for (int column = firstColumn; column <= lastColumn; column++) {
+                grid[row * columns + column].particles.append(i);
+            }
+        }
+    }
+
+    QVector<Partition> partitions;
+    for (auto it = grid.begin(); it != grid.end(); ++it) {
+        if (!it->particles.isEmpty()) {
+            partitions.append(*it);
+        }
+    }
+
+    return partitions;
+}
+
+KisParallelParticleRenderer::KisParallelParticleRenderer(int partitionSize)
+    : m_d(new Private)
+{
+    m_d->partitionSize = partitionSize;
+}
+
+KisParallelParticleRenderer::~KisParallelParticleRenderer()
+{
+}
+
+void KisParallelParticleRenderer::setPainterInitializer(PainterInitializer initializer)
+{
+    m_d->painterInitializer = initializer;
+}
+
+int KisParallelParticleRenderer::addParticle(const QRect &bounds)
+{
+    m_d->particleBounds.append(bounds);
+    m_d->totalBounds |= bounds;
+    return m_d->particleBounds.size() - 1;
+}
+
+int KisParallelParticleRenderer::numParticles() const
+{
+    return m_d->particleBounds.size();
+}
+
+void KisParallelParticleRenderer::render(KisPaintDeviceSP dst, const DrawFunction &drawFunction)
+{
+    const int numParticles = m_d->particleBounds.size();
+    if (!numParticles) return;
+
+    QVector<Partition> partitions;
+
+    if (numParticles >= minParticlesForParallelRendering &&
+        QThread::idealThreadCount() > 1) {
+
+        partitions = m_d->splitIntoPartitions();
+    }
+
+    if (partitions.size() < 2) {
+        Target target(dst, m_d->painterInitializer);
+        for (int i = 0; i < numParticles; i++) {
+            drawFunction(target, i);
+        }
+        clear();
+        return;
+    }
+
+    const PainterInitializer &painterInitializer = m_d->painterInitializer;
+    const QVector<QRect> &particleBounds = m_d->particleBounds;
+
+    QtConcurrent::blockingMap(partitions, [dst, painterInitializer, &particleBounds, &drawFunction] (Partition &partition) {
+        Q_FOREACH (int index, partition.particles) {
+            partition.dirtyRect |= particleBounds[index] & partition.rect;
+        }
+
+        partition.device = new KisPaintDevice(dst->colorSpace());
+        partition.device->setDefaultBounds(dst->defaultBounds());
+        partition.device->setDefaultPixel(dst->defaultPixel());
+
+        /**
+         * The particles may blend with what is already painted on the device.
+         * Only the existing tiles are copied, so the empty areas of the
+         * destination are not allocated.
+         */
+        KisPainter::copyAreaOptimized(partition.dirtyRect.topLeft(), dst, partition.device, partition.dirtyRect);
+
+        Target target(partition.device, painterInitializer, partition.dirtyRect);
+        Q_FOREACH (int index, partition.particles) {
+            drawFunction(target, index);
+        }
+    });
+
+    Q_FOREACH (const Partition &partition, partitions) {
+        KisPainter::copyAreaOptimized(partition.dirtyRect.topLeft(), partition.device, dst, partition.dirtyRect);
+    }
+
+    clear();
+}
+
+void KisParallelParticleRenderer::clear()
+{
+    m_d->particleBounds.clear();
+    m_d->totalBounds = QRect();
+}
@@ -0,0 +1,128 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISPARALLELPARTICLERENDERER_H
+#define KISPARALLELPARTICLERENDERER_H
+
+#include <QRect>
+#include <QScopedPointer>
+
+#include <functional>
+
+#include "kis_types.h"
+#include "kritapaintop_export.h"
+
+class KisPainter;
+class QPainterPath;
+
+/**
+ * Renders the particles of particle-style paintops (spray, hairy,
+ * particle, sketch) on several threads.
+ *
+ * The paintop generates its particles on the stroke thread, so that the
+ * sequence of random numbers stays the same, and registers every particle
+ * with the rect it may touch. On render() the area covered by the
+ * particles is split into square partitions. Every partition is drawn by
+ * a worker into a private device, with only the particles touching it,
+ * in the order they were added. The particles are clipped to the rect
+ * of the partition. The pixels of the partitions covered by the particles
+ * are then copied into the destination device in a single pass.
+ *
+ * A particle must be drawn with pixel-local operations only, that is, the
+ * new value of a pixel may depend on the previous value of this pixel
+ * only. Then the result is exactly the same as the one of drawing the
+ * particles one by one.
+ *
+ * If there are too few particles, they are drawn right into the destination
+ * device on the calling thread.
+ */
+class PAINTOP_EXPORT KisParallelParticleRenderer
+{
+public:
+    /**
+     * The device a particle is drawn on, with a painter and an accessor
+     * created on demand
+     *
+     * Only the pixels inside clipRect() are taken from the device, so the
+     * drawing methods of the target paint nothing outside of it. The
+     * particles drawn with the painter or the accessor directly are not
+     * clipped, which is fine for one-pixel lines and single pixels.
+     */
+    class PAINTOP_EXPORT Target
+    {
+    public:
+        Target(KisPaintDeviceSP device, const std::function<void(KisPainter*)> &painterInitializer,
+               const QRect &clipRect = QRect());
+        ~Target();
+
+        KisPaintDeviceSP device() const;
+        KisPainter* painter();
+        KisRandomAccessorSP accessor();
+
+        /**
+         * The rect the particles are clipped to. If the rect is null,
+         * the particles are drawn right on the destination device and
+         * nothing is clipped.
+         */
+        QRect clipRect() const;
+
+        /// \see KisPainter::fillPainterPath()
+        void fillPainterPath(const QPainterPath &path);
+
+        /// \see KisPainter::bitBlt()
+        void bitBlt(const QPoint &pos, KisPaintDeviceSP src, const QRect &srcRect);
+
+        /// \see KisPainter::bltFixed()
+        void bltFixed(const QPoint &pos, KisFixedPaintDeviceSP src, const QRect &srcRect);
+
+        /// \see KisPainter::drawLine()
+        void drawLine(const QPointF &start, const QPointF &end, qreal width, bool antialias);
+
+    private:
+        Target(const Target &rhs) = delete;
+
+        struct Private;
+        QScopedPointer<Private> m_d;
+    };
+
+    using PainterInitializer = std::function<void(KisPainter*)>;
+    using DrawFunction = std::function<void(Target&, int)>;
+
+public:
+    KisParallelParticleRenderer(int partitionSize = 128);
+    ~KisParallelParticleRenderer();
+
+    /**
+     * Sets up the painters of the targets, e.g. the fill style
+     * or the size of the mask image
+     */
+    void setPainterInitializer(PainterInitializer initializer);
+
+    /**
+     * Registers a particle that may change pixels inside \p bounds only
+     * and returns its index, which is passed to the draw function.
+     * A particle with empty bounds doesn't paint anything.
+     */
+    int addParticle(const QRect &bounds);
+
+    int numParticles() const;
+
+    /**
+     * Draws all the added particles on \p dst by calling \p drawFunction
+     * for each of them and removes the particles from the renderer
+     */
+    void render(KisPaintDeviceSP dst, const DrawFunction &drawFunction);
+
+    void clear();
+
+private:
+    KisParallelParticleRenderer(const KisParallelParticleRenderer &rhs) = delete;
+
+    struct Private;
+    QScopedPointer<Private> m_d;
+};
+
+#endif // KISPARALLELPARTICLERENDERER_H
@@ -18,6 +18,8 @@
 #include <kis_brush_registry.h>
 #include <KisUsageLogger.h>
 #include <KoResourceLoadResult.h>
+#include <KisBrushDabCache.h>
+#include <kis_debug.h>
 
 #include <QImage>
 #include <QPainter>
@@ -118,6 +120,17 @@ KisBrushBasedPaintOp::KisBrushBasedPaintOp(const KisPaintOpSettingsSP settings,
 KisBrushBasedPaintOp::~KisBrushBasedPaintOp()
 {
     delete m_dabCache;
+
+    if (m_brush->persistentDabCacheId()) {
+        const KisBrushDabCache::Statistics stats = KisBrushDabCache::instance()->statistics();
+
+        dbgPlugins << "Persistent dab cache at the end of stroke:"
+                   << "hit rate" << stats.hitRate()
+                   << "hits" << stats.hits
+                   << "misses" << stats.misses
+                   << "dabs" << stats.numDabs
+                   << "memory" << stats.memorySize / 1024 << "KiB";
+    }
 }
 
 QList<KoResourceLoadResult> KisBrushBasedPaintOp::prepareLinkedResources(const KisPaintOpSettingsSP settings, KisResourcesInterfaceSP resourcesInterface)
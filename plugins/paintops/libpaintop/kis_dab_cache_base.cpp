@@ -6,7 +6,11 @@
 
 #include "kis_dab_cache_base.h"
 
+#include <QtMath>
+
 #include <KoColor.h>
+#include <KoColorSpace.h>
+#include <kis_global.h>
 #include "kis_color_source.h"
 #include "kis_paint_device.h"
 #include "kis_brush.h"
@@ -66,6 +70,36 @@ struct KisDabCacheBase::SavedDabParameters {
                mirrorProperties.horizontalMirror == rhs.mirrorProperties.horizontalMirror &&
                mirrorProperties.verticalMirror == rhs.mirrorProperties.verticalMirror;
     }
+
+    /**
+     * Generates the key for the persistent dab cache. The parameters
+     * are quantized with the same tolerances compare() uses, except the
+     * size of the dab, which should match exactly, because the cached
+     * dab is not repositioned on fetching. The brush id and the color
+     * space are filled by the dab generation code.
+     */
+    KisBrushDabCache::Key persistentCacheKey(int precisionLevel) const {
+        const PrecisionValues &prec = precisionLevels[precisionLevel];
+
+        KisBrushDabCache::Key key;
+
+        key.color = QByteArray(reinterpret_cast<const char*>(color.data()),
+                               color.colorSpace()->pixelSize());
+        key.width = width;
+        key.height = height;
+        key.index = index;
+        key.angle = qRound(normalizeAngle(angle) / prec.angle);
+        key.ratio = qRound(ratio / prec.ratio);
+        key.subPixelX = qFloor(subPixelX / prec.subPixel);
+        key.subPixelY = qFloor(subPixelY / prec.subPixel);
+        key.softnessFactor = qRound(softnessFactor / prec.softnessFactor);
+        key.lightnessStrength = qRound(lightnessStrength / prec.lightnessStrength);
+        key.precisionLevel = precisionLevel;
+        key.horizontalMirror = mirrorProperties.horizontalMirror;
+        key.verticalMirror = mirrorProperties.verticalMirror;
+
+        return key;
+    }
 };
 
 struct KisDabCacheBase::Private {
@@ -283,6 +317,16 @@ void KisDabCacheBase::fetchDabGenerationInfo(bool hasDabInCache,
         m_d->lastSavedDabParameters = newParams;
     }
 
+    /**
+     * On the highest precision level the quantization steps are so small
+     * that the persistent cache would only waste memory on the dabs that
+     * never repeat
+     */
+    di->usePersistentCache = supportsCaching && di->solidColorFill && precisionLevel < 4;
+    if (di->usePersistentCache) {
+        di->persistentCacheKey = newParams.persistentCacheKey(precisionLevel);
+    }
+
     di->needsPostprocessing = needSeparateOriginal(resources->textureOption.data(), resources->sharpnessOption.data());
 }
 
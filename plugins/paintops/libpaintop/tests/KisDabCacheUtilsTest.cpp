@@ -0,0 +1,136 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#include "KisDabCacheUtilsTest.h"
+
+#include <KoColor.h>
+#include <KoColorSpace.h>
+#include <KoColorSpaceRegistry.h>
+
+#include <kis_paint_device.h>
+#include <kis_fixed_paint_device.h>
+#include <kis_gbr_brush.h>
+#include <KisBrushDabCache.h>
+
+#include <KisDabCacheUtils.h>
+
+namespace {
+
+KisGbrBrushSP createBrush(bool lightnessMap)
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+
+    // the tip is asymmetric, so that the mirroring is visible
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+    dev->fill(QRect(0, 0, 24, 32), KoColor(Qt::darkGray, cs));
+    dev->fill(QRect(24, 0, 8, 12), KoColor(Qt::red, cs));
+
+    KisGbrBrushSP brush(new KisGbrBrush(dev, 0, 0, 32, 32));
+
+    if (!lightnessMap) {
+        brush->makeMaskImage(false);
+    }
+
+    brush->enablePersistentDabCache();
+
+    return brush;
+}
+
+KisDabCacheUtils::DabGenerationInfo createGenerationInfo(const KoColor &color, bool mirror)
+{
+    KisDabCacheUtils::DabGenerationInfo di;
+
+    di.shape = KisDabShape(0.75, 1.0, 0.3);
+    di.subPixel = QPointF(0.25, 0.5);
+    di.paintColor = color;
+    di.info = KisPaintInformation(QPointF(100.0, 100.0), 0.5);
+    di.lightnessStrength = 0.7;
+    di.mirrorProperties.horizontalMirror = mirror;
+    di.mirrorProperties.verticalMirror = mirror;
+
+    di.usePersistentCache = true;
+    di.persistentCacheKey.color = QByteArray(reinterpret_cast<const char*>(color.data()),
+                                             color.colorSpace()->pixelSize());
+    di.persistentCacheKey.angle = 3;
+    di.persistentCacheKey.ratio = 10;
+    di.persistentCacheKey.lightnessStrength = 7;
+    di.persistentCacheKey.horizontalMirror = mirror;
+    di.persistentCacheKey.verticalMirror = mirror;
+
+    return di;
+}
+
+bool dabsEqual(KisFixedPaintDeviceSP lhs, KisFixedPaintDeviceSP rhs)
+{
+    return lhs->bounds() == rhs->bounds() &&
+        *lhs->colorSpace() == *rhs->colorSpace() &&
+        !memcmp(lhs->constData(), rhs->constData(),
+                lhs->bounds().width() * lhs->bounds().height() * lhs->pixelSize());
+}
+
+}
+
+void KisDabCacheUtilsTest::testPersistentCacheMatchesRendering_data()
+{
+    QTest::addColumn<bool>("lightnessMap");
+    QTest::addColumn<bool>("mirror");
+
+    QTest::newRow("mask") << false << false;
+    QTest::newRow("mask-mirrored") << false << true;
+    QTest::newRow("lightness") << true << false;
+    QTest::newRow("lightness-mirrored") << true << true;
+}
+
+void KisDabCacheUtilsTest::testPersistentCacheMatchesRendering()
+{
+    QFETCH(bool, lightnessMap);
+    QFETCH(bool, mirror);
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    const KoColor color(Qt::blue, cs);
+
+    KisBrushDabCache *cache = KisBrushDabCache::instance();
+    cache->clear();
+
+    KisDabCacheUtils::DabRenderingResources resources;
+    resources.brush = createBrush(lightnessMap);
+    QCOMPARE(resources.brush->brushApplication(), lightnessMap ? LIGHTNESSMAP : ALPHAMASK);
+    QVERIFY(resources.brush->persistentDabCacheId());
+
+    const KisDabCacheUtils::DabGenerationInfo di = createGenerationInfo(color, mirror);
+
+    // the first dab is rendered and saved into the cache...
+    KisFixedPaintDeviceSP renderedDab = new KisFixedPaintDevice(cs);
+    KisDabCacheUtils::generateDab(di, &resources, &renderedDab);
+    QCOMPARE(cache->statistics().misses, qint64(1));
+    QCOMPARE(cache->statistics().numDabs, 1);
+
+    // ...and the second one is fetched from it
+    KisFixedPaintDeviceSP cachedDab = new KisFixedPaintDevice(cs);
+    KisDabCacheUtils::generateDab(di, &resources, &cachedDab);
+    QCOMPARE(cache->statistics().hits, qint64(1));
+
+    KisDabCacheUtils::DabGenerationInfo uncachedDi = di;
+    uncachedDi.usePersistentCache = false;
+
+    KisFixedPaintDeviceSP freshDab = new KisFixedPaintDevice(cs);
+    KisDabCacheUtils::generateDab(uncachedDi, &resources, &freshDab);
+    QCOMPARE(cache->statistics().hits, qint64(1));
+    QCOMPARE(cache->statistics().misses, qint64(1));
+
+    QVERIFY(dabsEqual(renderedDab, freshDab));
+    QVERIFY(dabsEqual(cachedDab, freshDab));
+
+    // the dabs with the opposite mirroring are never mixed with these ones
+    KisFixedPaintDeviceSP oppositeDab = new KisFixedPaintDevice(cs);
+    KisDabCacheUtils::generateDab(createGenerationInfo(color, !mirror), &resources, &oppositeDab);
+    QCOMPARE(cache->statistics().misses, qint64(2));
+    QCOMPARE(cache->statistics().numDabs, 2);
+    QVERIFY(!dabsEqual(oppositeDab, freshDab));
+
+    cache->clear();
+}
+
+SIMPLE_TEST_MAIN(KisDabCacheUtilsTest)
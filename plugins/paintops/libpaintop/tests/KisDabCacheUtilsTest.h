@@ -0,0 +1,19 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#ifndef KISDABCACHEUTILSTEST_H
+#define KISDABCACHEUTILSTEST_H
+
+#include <simpletest.h>
+
+class KisDabCacheUtilsTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testPersistentCacheMatchesRendering_data();
+    void testPersistentCacheMatchesRendering();
+};
+
+#endif // KISDABCACHEUTILSTEST_H
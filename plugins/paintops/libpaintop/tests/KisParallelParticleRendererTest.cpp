@@ -0,0 +1,142 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#include "KisParallelParticleRendererTest.h"
+
+#include <QPainterPath>
+#include <QRandomGenerator>
+
+#include <KoColor.h>
+#include <KoColorSpaceRegistry.h>
+
+#include <kis_paint_device.h>
+#include <kis_painter.h>
+#include <kis_random_accessor_ng.h>
+#include <testutil.h>
+
+#include <KisParallelParticleRenderer.h>
+
+namespace {
+
+struct TestParticle {
+    QPainterPath path;
+    QPoint pixel;
+    KoColor color;
+    qreal opacity;
+};
+
+void drawTestPixel(KisRandomAccessorSP accessor, const TestParticle &particle)
+{
+    accessor->moveTo(particle.pixel.x(), particle.pixel.y());
+    memcpy(accessor->rawData(), particle.color.data(), particle.color.colorSpace()->pixelSize());
+}
+
+void drawTestParticle(KisPainter *painter, KisRandomAccessorSP accessor, const TestParticle &particle)
+{
+    painter->setPaintColor(particle.color);
+    painter->setOpacityF(particle.opacity);
+    painter->fillPainterPath(particle.path);
+
+    drawTestPixel(accessor, particle);
+}
+
+}
+
+void KisParallelParticleRendererTest::testSameAsSequentialRendering()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+
+    QRandomGenerator random(1);
+    QVector<TestParticle> particles;
+    KisParallelParticleRenderer renderer;
+
+    for (int i = 0; i < 2000; i++) {
+        TestParticle particle;
+
+        const QPointF center(random.bounded(1000.0), random.bounded(600.0));
+        const qreal radius = 1.0 + random.bounded(40.0);
+        particle.path.addEllipse(center, radius, 0.5 * radius);
+        particle.pixel = QPoint(random.bounded(1000), random.bounded(600));
+        particle.color = KoColor(QColor(random.bounded(256), random.bounded(256), random.bounded(256)), cs);
+        particle.opacity = random.bounded(1.0);
+
+        particles.append(particle);
+
+        const QRect bounds = particle.path.boundingRect().toAlignedRect().adjusted(-1, -1, 1, 1) |
+            QRect(particle.pixel, QSize(1, 1));
+        QCOMPARE(renderer.addParticle(bounds), i);
+    }
+
+    const auto initPainter = [] (KisPainter *painter) {
+        painter->setFillStyle(KisPainter::FillStyleForegroundColor);
+    };
+
+    KisPaintDeviceSP background = new KisPaintDevice(cs);
+    background->fill(QRect(100, 100, 500, 300), KoColor(Qt::red, cs));
+
+    KisPaintDeviceSP expected = new KisPaintDevice(*background);
+    {
+        KisPainter painter(expected);
+        initPainter(&painter);
+        KisRandomAccessorSP accessor = expected->createRandomAccessorNG();
+
+        Q_FOREACH (const TestParticle &particle, particles) {
+            drawTestParticle(&painter, accessor, particle);
+        }
+    }
+
+    KisPaintDeviceSP result = new KisPaintDevice(*background);
+    renderer.setPainterInitializer(initPainter);
+    renderer.render(result, [&particles] (KisParallelParticleRenderer::Target &target, int index) {
+        const TestParticle &particle = particles[index];
+
+        // the path is clipped to the partition
+        target.painter()->setPaintColor(particle.color);
+        target.painter()->setOpacityF(particle.opacity);
+        target.fillPainterPath(particle.path);
+
+        drawTestPixel(target.accessor(), particle);
+    });
+
+    QCOMPARE(renderer.numParticles(), 0);
+
+    QPoint errorPoint;
+    QVERIFY(TestUtil::comparePaintDevices(errorPoint, expected, result));
+}
+
+void KisParallelParticleRendererTest::testEmptyParticles()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+
+    KisParallelParticleRenderer renderer;
+
+    int numDrawn = 0;
+    renderer.render(dev, [&numDrawn] (KisParallelParticleRenderer::Target &, int) {
+        numDrawn++;
+    });
+    QCOMPARE(numDrawn, 0);
+
+    // the particles are spread over several partitions, some of them paint nothing
+    for (int i = 0; i < 100; i++) {
+        renderer.addParticle(i % 2 ? QRect() : QRect(i * 300, 0, 10, 10));
+    }
+
+    renderer.render(dev, [] (KisParallelParticleRenderer::Target &target, int index) {
+        if (index % 2) return;
+
+        KisRandomAccessorSP accessor = target.accessor();
+        accessor->moveTo(index * 300, 0);
+        memset(accessor->rawData(), 255, target.device()->pixelSize());
+    });
+
+    QCOMPARE(dev->exactBounds(), QRect(0, 0, 98 * 300 + 1, 1));
+
+    // only the tiles with the painted pixels are allocated
+    QCOMPARE(dev->extent(), QRect(0, 0, 460 * 64, 64));
+    QCOMPARE(renderer.numParticles(), 0);
+}
+
+SIMPLE_TEST_MAIN(KisParallelParticleRendererTest)
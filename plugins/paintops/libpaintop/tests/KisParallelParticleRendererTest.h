@@ -0,0 +1,19 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#ifndef KISPARALLELPARTICLERENDERERTEST_H
+#define KISPARALLELPARTICLERENDERERTEST_H
+
+#include <simpletest.h>
+
+class KisParallelParticleRendererTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testSameAsSequentialRendering();
+    void testEmptyParticles();
+};
+
+#endif // KISPARALLELPARTICLERENDERERTEST_H
@@ -11,6 +11,7 @@
 #include <KoColorSpaceMaths.h>
 #include <QtMath>
 #include <kis_algebra_2d.h>
+#include <kis_assert.h>
 #include <kis_cross_device_color_sampler.h>
 #include <kis_image.h>
 #include <kis_node.h>
@@ -19,9 +20,38 @@
 #include <qmath.h>
 #include <KoCompositeOpRegistry.h>
 #include <KoMixColorsOp.h>
+#include <QRegion>
+#include <algorithm>
+#include <KisRunnableStrokeJobData.h>
+#include <KisRunnableStrokeJobsInterface.h>
+#include <KisRunnableStrokeJobUtils.h>
+#include <tool/strokes/FreehandStrokeRunnableJobDataWithUpdate.h>
+#include <KisDabBandsUtils.h>
 
 using namespace std;
 
+namespace {
+/**
+ * The number of pixels the dabs of a batch may cover before the batch
+ * is rendered even if the paintop hasn't finished its stroke_to() call
+ * yet. It limits the memory taken by the buffers of the dabs.
+ */
+const qint64 maxPixelsInBatch = 1024 * 1024;
+
+/**
+ * The color sample window is aligned to the tiles grid and grown by
+ * this margin, so that the following requests of a moving dab are
+ * still covered by it
+ */
+const int colorSampleWindowMargin = 64;
+
+/**
+ * Too many pending updates of the window mean that the brush doesn't
+ * sample colors anymore; it is cheaper to drop the window then
+ */
+const int maxColorSampleWindowDirtyRects = 256;
+}
+
 void destroy_internal_surface_callback(MyPaintSurface *surface)
 {
     KisMyPaintSurface::MyPaintSurfaceInternal *ptr = static_cast<KisMyPaintSurface::MyPaintSurfaceInternal*>(surface);
@@ -33,11 +63,10 @@ KisMyPaintSurface::KisMyPaintSurface(KisPainter *painter, KisPaintDeviceSP paint
     , m_imageDevice(paintNode)
     , m_image(image)
     , m_precisePainterWrapper(painter->device())
-    , m_dab(m_precisePainterWrapper.createPreciseCompositionSourceDevice())
     , m_tempPainter(new KisPainter(m_precisePainterWrapper.overlay()))
     , m_backgroundPainter(new KisPainter(m_precisePainterWrapper.createPreciseCompositionSourceDevice()))
 {
-    m_blendDevice = KisFixedPaintDeviceSP(new KisFixedPaintDevice(m_precisePainterWrapper.overlayColorSpace()));
+    m_colorSampleWindow = KisFixedPaintDeviceSP(new KisFixedPaintDevice(m_precisePainterWrapper.overlayColorSpace()));
 
     m_backgroundPainter->setCompositeOpId(COMPOSITE_COPY);
     m_backgroundPainter->setOpacityToUnit();
@@ -53,14 +82,13 @@ KisMyPaintSurface::KisMyPaintSurface(KisPainter *painter, KisPaintDeviceSP paint
     m_surface->get_color = this->get_color;
     m_surface->destroy = destroy_internal_surface_callback;
     m_surface->bitDepth = m_precisePainterWrapper.overlayColorSpace()->channels()[0]->channelValueType();
-
-    // devices for mask information
-    static const KoColorSpace *maskCs = KoColorSpaceRegistry::instance()->alpha8();
-    m_maskDevice = KisFixedPaintDeviceSP(new KisFixedPaintDevice(maskCs));
 }
 
 KisMyPaintSurface::~KisMyPaintSurface()
 {
+    KIS_SAFE_ASSERT_RECOVER_NOOP(m_pendingJobs.isEmpty() && "endDabsBatch() hasn't been called");
+    qDeleteAll(m_pendingJobs);
+
     mypaint_surface_unref(m_surface);
 }
 
@@ -68,36 +96,27 @@ int KisMyPaintSurface::draw_dab(MyPaintSurface *self, float x, float y, float ra
                                 float color_b, float opaque, float hardness, float color_a,
                                 float aspect_ratio, float angle, float lock_alpha, float colorize) {
 
+    Q_UNUSED(lock_alpha);
     MyPaintSurfaceInternal *surface = static_cast<MyPaintSurfaceInternal*>(self);
 
-    if (surface->bitDepth == KoChannelInfo::UINT8) {
-        return surface->m_owner->drawDabImpl<quint8>(self, x, y, radius, color_r, color_g,
-                 color_b, opaque, hardness, color_a,
-                aspect_ratio, angle, lock_alpha,  colorize);
-    }
-    else if (surface->bitDepth == KoChannelInfo::UINT16) {
-        return surface->m_owner->drawDabImpl<quint16>(self, x, y, radius, color_r, color_g,
-                 color_b, opaque, hardness, color_a,
-                aspect_ratio, angle, lock_alpha,  colorize);
-    }
-#if defined HAVE_OPENEXR
-    else if (surface->bitDepth == KoChannelInfo::FLOAT16) {
-        return surface->m_owner->drawDabImpl<half>(self, x, y, radius, color_r, color_g,
-                 color_b, opaque, hardness, color_a,
-                aspect_ratio, angle, lock_alpha,  colorize);
-    }
-#endif
-    else {
-        return surface->m_owner->drawDabImpl<float>(self, x, y, radius, color_r, color_g,
-                 color_b, opaque, hardness, color_a,
-                aspect_ratio, angle, lock_alpha,  colorize);
-    }
+    return surface->m_owner->queueDab(x, y, radius, color_r, color_g,
+                                      color_b, opaque, hardness, color_a,
+                                      aspect_ratio, angle, colorize);
 }
 
 void KisMyPaintSurface::get_color(MyPaintSurface *self, float x, float y, float radius,
                             float * color_r, float * color_g, float * color_b, float * color_a) {
 
     MyPaintSurfaceInternal *surface = static_cast<MyPaintSurfaceInternal*>(self);
+
+    /**
+     * The sampled color must include all the dabs painted so far. The
+     * stroke would run the jobs only after the current one is finished,
+     * so they are executed right here.
+     */
+    surface->m_owner->flushDabs();
+    surface->m_owner->runPendingJobs();
+
     if (surface->bitDepth == KoChannelInfo::UINT8) {
         surface->m_owner->getColorImpl<quint8>(self, x, y, radius, color_r, color_g, color_b, color_a);
     }
@@ -115,16 +134,267 @@ void KisMyPaintSurface::get_color(MyPaintSurface *self, float x, float y, float
 }
 
 
+void KisMyPaintSurface::beginDabsBatch()
+{
+    m_isBatching = true;
+}
+
+void KisMyPaintSurface::endDabsBatch()
+{
+    flushDabs();
+
+    /**
+     * The jobs are added in one go, because the stroke puts every new
+     * portion of jobs in front of the previously added ones
+     */
+    if (!m_pendingJobs.isEmpty()) {
+        painter()->runnableStrokeJobsInterface()->addRunnableJobs(m_pendingJobs);
+        m_pendingJobs.clear();
+    }
+
+    m_isBatching = false;
+
+    /**
+     * Other painters of the stroke may write into the device before the
+     * next segment, so the color sample window cannot be trusted anymore
+     */
+    m_colorSampleWindowValid = false;
+    m_colorSampleWindowDirtyRects.clear();
+}
+
+int KisMyPaintSurface::queueDab(float x, float y, float radius, float color_r, float color_g,
+                                float color_b, float opaque, float hardness, float color_a,
+                                float aspect_ratio, float angle, float colorize)
+{
+    Dab dab;
+    dab.x = x;
+    dab.y = y;
+    dab.radius = radius;
+    dab.colorR = color_r;
+    dab.colorG = color_g;
+    dab.colorB = color_b;
+    dab.opaque = opaque;
+    dab.hardness = hardness;
+    dab.colorA = color_a;
+    dab.aspectRatio = aspect_ratio;
+    dab.angle = angle;
+    dab.colorize = colorize;
+
+    const QPoint pt = QPoint(x - radius - 1, y - radius - 1);
+    const QSize sz = QSize(2 * (radius+1), 2 * (radius+1));
+
+    dab.rect = QRect(pt, sz);
+    dab.mirroredRects = m_tempPainter->calculateAllMirroredRects(dab.rect);
+
+    m_pendingDabs.append(dab);
+    m_pendingDabsPixels += qint64(dab.rect.width()) * dab.rect.height();
+
+    if (!m_isBatching) {
+        flushDabs();
+        runPendingJobs();
+    } else if (m_pendingDabsPixels >= maxPixelsInBatch) {
+        flushDabs();
+    }
+
+    return 1;
+}
+
+void KisMyPaintSurface::flushDabs()
+{
+    if (m_pendingDabs.isEmpty()) return;
+
+    if (m_surface->bitDepth == KoChannelInfo::UINT8) {
+        addRenderingJobs<quint8>();
+    }
+    else if (m_surface->bitDepth == KoChannelInfo::UINT16) {
+        addRenderingJobs<quint16>();
+    }
+#if defined HAVE_OPENEXR
+    else if (m_surface->bitDepth == KoChannelInfo::FLOAT16) {
+        addRenderingJobs<half>();
+    }
+#endif
+    else {
+        addRenderingJobs<float>();
+    }
+
+    m_pendingDabs.clear();
+    m_pendingDabsPixels = 0;
+}
+
+void KisMyPaintSurface::runPendingJobs()
+{
+    Q_FOREACH (KisRunnableStrokeJobData *job, m_pendingJobs) {
+        job->run();
+    }
+
+    qDeleteAll(m_pendingJobs);
+    m_pendingJobs.clear();
+}
+
+template <typename channelType>
+void KisMyPaintSurface::addRenderingJobs()
+{
+    QSharedPointer<DabsBatch> batch(new DabsBatch());
+    batch->dabs = m_pendingDabs;
+
+    const int numDabs = batch->dabs.size();
+
+    auto dabsOverlap = [] (const Dab &lhs, const Dab &rhs) {
+        Q_FOREACH (const QRect &lhsRect, lhs.mirroredRects) {
+            Q_FOREACH (const QRect &rhsRect, rhs.mirroredRects) {
+                if (lhsRect.intersects(rhsRect)) return true;
+            }
+        }
+        return false;
+    };
+
+    /**
+     * Split the dabs into waves of dabs that don't overlap each other
+     * (mirrored copies included). A dab is put into the wave right after
+     * the last one having a dab overlapping it, so the overlapping dabs
+     * are still painted in the order libmypaint generated them, while
+     * the dabs of a single wave can be rendered in any order.
+     */
+    QVector<int> dabWave(numDabs, 0);
+    int numWaves = 0;
+
+    for (int i = 0; i < numDabs; i++) {
+        int wave = 0;
+        for (int j = 0; j < i; j++) {
+            if (dabWave[j] >= wave && dabsOverlap(batch->dabs[i], batch->dabs[j])) {
+                wave = dabWave[j] + 1;
+            }
+        }
+        dabWave[i] = wave;
+        numWaves = qMax(numWaves, wave + 1);
+    }
+
+    batch->dabDevices.resize(numDabs);
+    batch->maskDevices.resize(numDabs);
+
+    const bool eraser = painter()->compositeOpId() == COMPOSITE_ERASE;
+    KisPaintDeviceSP srcDevice = m_precisePainterWrapper.overlay();
+
+    for (int wave = 0; wave < numWaves; wave++) {
+        QVector<int> waveDabs;
+        qint64 wavePixels = 0;
+
+        for (int i = 0; i < numDabs; i++) {
+            if (dabWave[i] != wave) continue;
+
+            const QRect &rc = batch->dabs[i].rect;
+            waveDabs.append(i);
+            wavePixels += qint64(rc.width()) * rc.height();
+        }
+
+        auto prepareWave = [this, batch, waveDabs] () {
+            const KoColorSpace *maskCs = KoColorSpaceRegistry::instance()->alpha8();
+
+            Q_FOREACH (int i, waveDabs) {
+                const Dab &dab = batch->dabs[i];
+
+                m_precisePainterWrapper.readRects(dab.mirroredRects);
+
+                batch->dabDevices[i] = new KisFixedPaintDevice(m_precisePainterWrapper.overlayColorSpace());
+                batch->dabDevices[i]->setRect(dab.rect);
+                batch->dabDevices[i]->lazyGrowBufferWithoutInitialization();
+
+                batch->maskDevices[i] = new KisFixedPaintDevice(maskCs);
+                batch->maskDevices[i]->setRect(dab.rect);
+                batch->maskDevices[i]->lazyGrowBufferWithoutInitialization();
+            }
+        };
+
+        auto renderRows = [this, batch, srcDevice, eraser] (int i, int firstRow, int numRows) {
+            renderDabRows<channelType>(batch->dabs[i], srcDevice,
+                                       batch->dabDevices[i], batch->maskDevices[i],
+                                       firstRow, numRows, eraser);
+        };
+
+        auto blitWave = [this, batch, waveDabs] () {
+            Q_FOREACH (int i, waveDabs) {
+                const QRect &rc = batch->dabs[i].rect;
+
+                m_tempPainter->bltFixedWithFixedSelection(rc.x(), rc.y(), batch->dabDevices[i], batch->maskDevices[i], rc.width(), rc.height());
+                m_tempPainter->renderMirrorMask(rc, batch->dabDevices[i], batch->maskDevices[i]);
+                const QVector<QRect> dirtyRects = m_tempPainter->takeDirtyRegion();
+                m_precisePainterWrapper.writeRects(dirtyRects);
+                painter()->addDirtyRects(dirtyRects);
+
+                if (m_colorSampleWindowValid) {
+                    m_colorSampleWindowDirtyRects += dirtyRects;
+                }
+
+                // the buffers are not needed anymore
+                batch->dabDevices[i].clear();
+                batch->maskDevices[i].clear();
+            }
+
+            if (m_colorSampleWindowDirtyRects.size() > maxColorSampleWindowDirtyRects) {
+                m_colorSampleWindowValid = false;
+                m_colorSampleWindowDirtyRects.clear();
+            }
+        };
+
+        /**
+         * The wave is rendered by the stroke's runnable jobs: the dabs
+         * are prepared and blitted by sequential jobs, while their pixels
+         * are computed by concurrent jobs in bands of rows. The next
+         * stroke job is started only after all of them are finished.
+         * Small waves are rendered in a single job.
+         */
+        if (!KisDabBandsUtils::needsSplitting(wavePixels)) {
+            m_pendingJobs.append(new FreehandStrokeRunnableJobDataWithUpdate(
+                [prepareWave, renderRows, blitWave, batch, waveDabs] () {
+                    prepareWave();
+                    Q_FOREACH (int i, waveDabs) {
+                        renderRows(i, 0, batch->dabs[i].rect.height());
+                    }
+                    blitWave();
+                }, KisStrokeJobData::SEQUENTIAL));
+        } else {
+            KritaUtils::addJobSequential(m_pendingJobs, prepareWave);
+
+            Q_FOREACH (int i, waveDabs) {
+                const QRect &rc = batch->dabs[i].rect;
+
+                Q_FOREACH (const QRect &band, KisDabBandsUtils::splitIntoBands(rc)) {
+                    const int firstRow = band.y() - rc.y();
+                    const int numRows = band.height();
+
+                    KritaUtils::addJobConcurrent(m_pendingJobs,
+                        [renderRows, i, firstRow, numRows] () {
+                            renderRows(i, firstRow, numRows);
+                        });
+                }
+            }
+
+            m_pendingJobs.append(new FreehandStrokeRunnableJobDataWithUpdate(blitWave, KisStrokeJobData::SEQUENTIAL));
+        }
+    }
+}
+
 /*GIMP's draw_dab and get_color code*/
 template <typename channelType>
-int KisMyPaintSurface::drawDabImpl(MyPaintSurface *self, float x, float y, float radius, float color_r, float color_g,
-                                float color_b, float opaque, float hardness, float color_a,
-                                float aspect_ratio, float angle, float lock_alpha, float colorize) {
+void KisMyPaintSurface::renderDabRows(const Dab &dab, KisPaintDeviceSP srcDevice,
+                                      KisFixedPaintDeviceSP dabDevice, KisFixedPaintDeviceSP maskDevice,
+                                      int firstRow, int numRows, bool eraser)
+{
+    const float x = dab.x;
+    const float y = dab.y;
+    const float radius = dab.radius;
+    const float color_r = dab.colorR;
+    const float color_g = dab.colorG;
+    const float color_b = dab.colorB;
+    const float color_a = dab.colorA;
+    const float opaque = dab.opaque;
+    float hardness = dab.hardness;
+    float aspect_ratio = dab.aspectRatio;
+    float colorize = dab.colorize;
 
-    Q_UNUSED(self);
-    Q_UNUSED(lock_alpha);
     const float one_over_radius2 = 1.0f / (radius * radius);
-    const double angle_rad = kisDegreesToRadians(angle);
+    const double angle_rad = kisDegreesToRadians(dab.angle);
     const float cs = cos(angle_rad);
     const float sn = sin(angle_rad);
     float normal_mode;
@@ -144,135 +414,182 @@ int KisMyPaintSurface::drawDabImpl(MyPaintSurface *self, float x, float y, float
     normal_mode = opaque * (1.0f - colorize);
     colorize = opaque * colorize;
 
-    const QPoint pt = QPoint(x - radius - 1, y - radius - 1);
-    const QSize sz = QSize(2 * (radius+1), 2 * (radius+1));
-
-    const QRect dabRectAligned = QRect(pt, sz);
+    const QRect rowsRect(dab.rect.x(), dab.rect.y() + firstRow, dab.rect.width(), numRows);
     const QPointF center = QPointF(x, y);
 
     KisAlgebra2D::OuterCircle outer(center, radius);
-    m_precisePainterWrapper.readRects(m_tempPainter->calculateAllMirroredRects(dabRectAligned));
-    m_tempPainter->copyAreaOptimized(dabRectAligned.topLeft(), m_tempPainter->device(), m_dab, dabRectAligned);
-    KisSequentialIterator it(m_dab, dabRectAligned);
 
     quint8 maskUnitValue = KoColorSpaceMathsTraits<quint8>::unitValue; // because it's alpha8
 
     float unitValue = KoColorSpaceMathsTraits<channelType>::unitValue;
     float minValue = KoColorSpaceMathsTraits<channelType>::min;
-    bool eraser = painter()->compositeOpId() == COMPOSITE_ERASE;
 
+    const int pixelSize = dabDevice->pixelSize();
+    quint8 *pixelPointer = dabDevice->data() + firstRow * rowsRect.width() * pixelSize;
+    quint8 *maskPointer = maskDevice->data() + firstRow * rowsRect.width();
 
-    m_maskDevice->setRect(dabRectAligned);
-    m_maskDevice->lazyGrowBufferWithoutInitialization();
+    srcDevice->readBytes(pixelPointer, rowsRect);
 
+    for (int yp = rowsRect.top(); yp <= rowsRect.bottom(); yp++) {
+        for (int xp = rowsRect.left(); xp <= rowsRect.right(); xp++, pixelPointer += pixelSize, maskPointer++) {
 
-    // Dmitry says that going with the pointer should be in the same order
-    // as using the sequential iterator
-    quint8* maskPointer = m_maskDevice->data();
+            // first initialize to 0;
+            *maskPointer = 0;
 
+            QPoint pt(xp, yp);
 
-    while(it.nextPixel()) {
+            if(outer.fadeSq(pt) > 1.0f) {
+                continue;
+            }
 
-        // first initialize to 0;
-        *maskPointer = 0;
+            float rr, base_alpha, alpha, dst_alpha, r, g, b, a;
 
-        QPoint pt(it.x(), it.y());
+            if (radius < 3.0) {
+                rr = calculate_rr_antialiased (xp, yp, x, y, aspect_ratio, sn, cs, one_over_radius2, r_aa_start);
+            }
+            else {
+                rr = calculate_rr (xp, yp, x, y, aspect_ratio, sn, cs, one_over_radius2);
+            }
 
-        if(outer.fadeSq(pt) > 1.0f) {
-            maskPointer++;
-            continue;
-        }
+            base_alpha = calculate_alpha_for_rr (rr, hardness, segment1_slope, segment2_slope);
 
-        float rr, base_alpha, alpha, dst_alpha, r, g, b, a;
+            alpha = base_alpha * normal_mode;
 
-        if (radius < 3.0) {
-            rr = calculate_rr_antialiased (it.x(), it.y(), x, y, aspect_ratio, sn, cs, one_over_radius2, r_aa_start);
-        }
-        else {
-            rr = calculate_rr (it.x(), it.y(), x, y, aspect_ratio, sn, cs, one_over_radius2);
-        }
+            // set alpha to mask
+            if (alpha > minValue) {
+                *maskPointer = (quint8)(maskUnitValue);
+            }
 
-        base_alpha = calculate_alpha_for_rr (rr, hardness, segment1_slope, segment2_slope);
+            channelType* nativeArray = reinterpret_cast<channelType*>(pixelPointer);
 
-        m_tempPainter->selection();
-        alpha = base_alpha * normal_mode;
+            b = nativeArray[0]/unitValue;
+            g = nativeArray[1]/unitValue;
+            r = nativeArray[2]/unitValue;
+            dst_alpha = nativeArray[3]/unitValue;
 
-        // set alpha to mask
-        if (alpha > minValue) {
-            *maskPointer = (quint8)(maskUnitValue);
-        }
+            if (unitValue == 1.0f) {
+                swap(b, r);
+            }
 
-        channelType* nativeArray = reinterpret_cast<channelType*>(it.rawData());
+            a = alpha * (color_a - dst_alpha) + dst_alpha;
 
-        b = nativeArray[0]/unitValue;
-        g = nativeArray[1]/unitValue;
-        r = nativeArray[2]/unitValue;
-        dst_alpha = nativeArray[3]/unitValue;
+            if (eraser) {
+                alpha = 1 - (opaque*base_alpha);
+                a = dst_alpha * alpha ;
+            } else {
+                if (a > 0.0f) {
+                    float src_term = (alpha * color_a) / a;
+                    float dst_term = 1.0f - src_term;
+                    r = color_r * src_term + r * dst_term;
+                    g = color_g * src_term + g * dst_term;
+                    b = color_b * src_term + b * dst_term;
+                }
 
-        if (unitValue == 1.0f) {
-            swap(b, r);
-        }
+                if (colorize > 0.0f && base_alpha > 0.0f) {
 
-        a = alpha * (color_a - dst_alpha) + dst_alpha;
+                    alpha = base_alpha * colorize;
+                    a = alpha + dst_alpha - alpha * dst_alpha;
 
-        if (eraser) {
-            alpha = 1 - (opaque*base_alpha);
-            a = dst_alpha * alpha ;
-        } else {
-            if (a > 0.0f) {
-                float src_term = (alpha * color_a) / a;
-                float dst_term = 1.0f - src_term;
-                r = color_r * src_term + r * dst_term;
-                g = color_g * src_term + g * dst_term;
-                b = color_b * src_term + b * dst_term;
+                    if (a > 0.0f) {
+
+                        float pixel_h, pixel_s, pixel_l, out_h, out_s, out_l;
+                        float out_r = r, out_g = g, out_b = b;
+
+                        float src_term = alpha / a;
+                        float dst_term = 1.0f - src_term;
+
+                        RGBToHSL(color_r, color_g, color_b, &pixel_h, &pixel_s, &pixel_l);
+                        RGBToHSL(out_r, out_g, out_b, &out_h, &out_s, &out_l);
+
+                        out_h = pixel_h;
+                        out_s = pixel_s;
+
+                        HSLToRGB(out_h, out_s, out_l, &out_r, &out_g, &out_b);
+
+                        r = (float)out_r * src_term + r * dst_term;
+                        g = (float)out_g * src_term + g * dst_term;
+                        b = (float)out_b * src_term + b * dst_term;
+                    }
+                }
             }
 
-            if (colorize > 0.0f && base_alpha > 0.0f) {
+            if (unitValue == 1.0f) {
+                swap(b, r);
+            }
+            nativeArray[0] = KoColorSpaceMaths<float, channelType>::scaleToA(b);
+            nativeArray[1] = KoColorSpaceMaths<float, channelType>::scaleToA(g);
+            nativeArray[2] = KoColorSpaceMaths<float, channelType>::scaleToA(r);
+            nativeArray[3] = KoColorSpaceMaths<float, channelType>::scaleToA(a);
+        }
+    }
+}
 
-                alpha = base_alpha * colorize;
-                a = alpha + dst_alpha - alpha * dst_alpha;
+void KisMyPaintSurface::readColorSampleRect(const QRect &rc, quint8 *dstBytes)
+{
+    m_precisePainterWrapper.readRect(rc);
 
-                if (a > 0.0f) {
+    KisPaintDeviceSP activeDev = m_precisePainterWrapper.overlay();
+    if (!m_image && m_imageDevice) {
+        m_backgroundPainter->bitBlt(rc.topLeft(), m_imageDevice, rc);
+        activeDev = m_backgroundPainter->device();
+    }
 
-                    float pixel_h, pixel_s, pixel_l, out_h, out_s, out_l;
-                    float out_r = r, out_g = g, out_b = b;
+    activeDev->readBytes(dstBytes, rc);
+}
 
-                    float src_term = alpha / a;
-                    float dst_term = 1.0f - src_term;
+void KisMyPaintSurface::loadColorSampleWindow(const QRect &rc)
+{
+    const int tileSize = 64;
 
-                    RGBToHSL(color_r, color_g, color_b, &pixel_h, &pixel_s, &pixel_l);
-                    RGBToHSL(out_r, out_g, out_b, &out_h, &out_s, &out_l);
+    const int left = qFloor(qreal(rc.left()) / tileSize) * tileSize - colorSampleWindowMargin;
+    const int top = qFloor(qreal(rc.top()) / tileSize) * tileSize - colorSampleWindowMargin;
+    const int right = (qFloor(qreal(rc.right()) / tileSize) + 1) * tileSize + colorSampleWindowMargin;
+    const int bottom = (qFloor(qreal(rc.bottom()) / tileSize) + 1) * tileSize + colorSampleWindowMargin;
 
-                    out_h = pixel_h;
-                    out_s = pixel_s;
+    const QRect windowRect(left, top, right - left, bottom - top);
 
-                    HSLToRGB(out_h, out_s, out_l, &out_r, &out_g, &out_b);
+    m_colorSampleWindow->setRect(windowRect);
+    m_colorSampleWindow->lazyGrowBufferWithoutInitialization();
+    readColorSampleRect(windowRect, m_colorSampleWindow->data());
 
-                    r = (float)out_r * src_term + r * dst_term;
-                    g = (float)out_g * src_term + g * dst_term;
-                    b = (float)out_b * src_term + b * dst_term;
-                }
-            }
-        }
+    m_colorSampleWindowDirtyRects.clear();
+    m_colorSampleWindowValid = true;
+}
 
-        if (unitValue == 1.0f) {
-            swap(b, r);
-        }
-        nativeArray[0] = KoColorSpaceMaths<float, channelType>::scaleToA(b);
-        nativeArray[1] = KoColorSpaceMaths<float, channelType>::scaleToA(g);
-        nativeArray[2] = KoColorSpaceMaths<float, channelType>::scaleToA(r);
-        nativeArray[3] = KoColorSpaceMaths<float, channelType>::scaleToA(a);
+void KisMyPaintSurface::refreshColorSampleWindow()
+{
+    const QRect windowRect = m_colorSampleWindow->bounds();
+    const int pixelSize = m_colorSampleWindow->pixelSize();
 
-        maskPointer++;
+    // several dabs usually repaint the same area, read it only once
+    QRegion region;
+    Q_FOREACH (const QRect &rc, m_colorSampleWindowDirtyRects) {
+        region += rc & windowRect;
     }
+    m_colorSampleWindowDirtyRects.clear();
 
+    QVector<quint8> buffer;
 
-    m_tempPainter->bitBltWithFixedSelection(dabRectAligned.x(), dabRectAligned.y(), m_dab, m_maskDevice, dabRectAligned.x(), dabRectAligned.y(), dabRectAligned.x(), dabRectAligned.y(), dabRectAligned.width(), dabRectAligned.height());
-    m_tempPainter->renderMirrorMask(dabRectAligned, m_dab, dabRectAligned.x(), dabRectAligned.y(), m_maskDevice);
-    const QVector<QRect> dirtyRects = m_tempPainter->takeDirtyRegion();
-    m_precisePainterWrapper.writeRects(dirtyRects);
-    painter()->addDirtyRects(dirtyRects);
-    return 1;
+    for (auto it = region.begin(); it != region.end(); ++it) {
+        const QRect rc = *it;
+
+        buffer.resize(rc.width() * rc.height() * pixelSize);
+        readColorSampleRect(rc, buffer.data());
+
+        const int srcRowStride = rc.width() * pixelSize;
+        const int dstRowStride = windowRect.width() * pixelSize;
+
+        const quint8 *srcPtr = buffer.constData();
+        quint8 *dstPtr = m_colorSampleWindow->data() +
+            (rc.y() - windowRect.y()) * dstRowStride +
+            (rc.x() - windowRect.x()) * pixelSize;
+
+        for (int row = 0; row < rc.height(); row++) {
+            memcpy(dstPtr, srcPtr, srcRowStride);
+            srcPtr += srcRowStride;
+            dstPtr += dstRowStride;
+        }
+    }
 }
 
 template <typename channelType>
@@ -298,56 +615,58 @@ void KisMyPaintSurface::getColorImpl(MyPaintSurface *self, float x, float y, flo
     const float one_over_radius2 = 1.0f / (radius * radius);
     quint32 sum_weight = 0.0f;
 
-    m_precisePainterWrapper.readRect(dabRectAligned);
-    KisPaintDeviceSP activeDev = m_precisePainterWrapper.overlay();
-    if(m_image) {
-        //m_image->blockUpdates();
-        m_backgroundPainter->device()->clear();
-        m_backgroundPainter->bitBlt(dabRectAligned.topLeft(), activeDev, dabRectAligned);
-        activeDev = m_backgroundPainter->device();
-        //m_image->unblockUpdates();
-    } else if (m_imageDevice) {
-        m_backgroundPainter->bitBlt(dabRectAligned.topLeft(), m_imageDevice, dabRectAligned);
-        activeDev = m_backgroundPainter->device();
-    } else {
-        m_precisePainterWrapper.readRect(dabRectAligned);
+    if (!m_colorSampleWindowValid || !m_colorSampleWindow->bounds().contains(dabRectAligned)) {
+        loadColorSampleWindow(dabRectAligned);
+    } else if (!m_colorSampleWindowDirtyRects.isEmpty()) {
+        refreshColorSampleWindow();
     }
 
-    KisSequentialIterator it(activeDev, dabRectAligned);
-    QVector<float> surface_color_vec = {0,0,0,0};
+    const KoColorSpace *colorSpace = m_colorSampleWindow->colorSpace();
+    const QRect windowRect = m_colorSampleWindow->bounds();
+    const int pixelSize = colorSpace->pixelSize();
+
     float unitValue = KoColorSpaceMathsTraits<channelType>::unitValue;
     float maxValue = KoColorSpaceMathsTraits<channelType>::max;
 
-    quint32 size = dabRectAligned.width() * dabRectAligned.height();
-    m_blendDevice->setRect(dabRectAligned);
-    m_blendDevice->lazyGrowBufferWithoutInitialization();
+    m_colorSampleWeights.resize(dabRectAligned.width());
+    qint16* weights = m_colorSampleWeights.data();
 
+    /**
+     * The colors are accumulated row by row right from the window, the mixer
+     * sums up the weights of all the rows, so the result is the same as for
+     * mixing the whole rect at once.
+     */
+    QScopedPointer<KoMixColorsOp::Mixer> mixer(colorSpace->mixColorsOp()->createMixer());
 
-    qint16* weights = new qint16[size];
-    quint32 num_colors = 0;
-
-    activeDev->readBytes(m_blendDevice->data(), dabRectAligned);
+    for (int yp = dabRectAligned.top(); yp <= dabRectAligned.bottom(); yp++) {
+        int rowWeight = 0;
 
-    while(it.nextPixel()) {
+        for (int xp = dabRectAligned.left(); xp <= dabRectAligned.right(); xp++) {
+            QPointF pt(xp, yp);
 
-        QPointF pt(it.x(), it.y());
+            float rr = 0.0;
+            if(outer.fadeSq(pt) <= 1.0) {
+                /* pixel_weight == a standard dab with hardness = 0.5, aspect_ratio = 1.0, and angle = 0.0 */
+                float yy = (yp + 0.5f - y);
+                float xx = (xp + 0.5f - x);
 
-        float rr = 0.0;
-        if(outer.fadeSq(pt) <= 1.0) {
-            /* pixel_weight == a standard dab with hardness = 0.5, aspect_ratio = 1.0, and angle = 0.0 */
-            float yy = (it.y() + 0.5f - y);
-            float xx = (it.x() + 0.5f - x);
+                rr = qMax((yy * yy + xx * xx) * one_over_radius2, 0.0f);
+            }
 
-            rr = qMax((yy * yy + xx * xx) * one_over_radius2, 0.0f);
+            const int col = xp - dabRectAligned.left();
+            weights[col] = qRound((1.0f - rr) * 255);
+            rowWeight += weights[col];
         }
 
-        weights[num_colors] = qRound((1.0f - rr) * 255);
-        sum_weight += weights[num_colors];
-        num_colors += 1;
+        const quint8 *rowData = m_colorSampleWindow->data() +
+            ((yp - windowRect.y()) * windowRect.width() + (dabRectAligned.x() - windowRect.x())) * pixelSize;
+
+        mixer->accumulate(rowData, weights, rowWeight, dabRectAligned.width());
+        sum_weight += rowWeight;
     }
 
-    KoColor color = KoColor::createTransparent(activeDev->colorSpace());
-    activeDev->colorSpace()->mixColorsOp()->mixColors(m_blendDevice->data(), weights, size, color.data(), sum_weight);
+    KoColor color = KoColor::createTransparent(colorSpace);
+    mixer->computeMixedColor(color.data());
 
     if (sum_weight > 0.0f) {
         qreal r, g, b, a;
@@ -369,8 +688,6 @@ void KisMyPaintSurface::getColorImpl(MyPaintSurface *self, float x, float y, flo
             *color_a = CLAMP(a, 0.0f, 1.0f);
         }
     }
-
-    delete [] weights;
 }
 
 KisPainter* KisMyPaintSurface::painter() {
@@ -8,6 +8,7 @@
 #define KIS_MYPAINT_SURFACE_H
 
 #include <QObject>
+#include <QVector>
 
 #include <kis_paint_device.h>
 #include <kis_fixed_paint_device.h>
@@ -22,6 +23,8 @@
 #include <libmypaint/mypaint-brush.h>
 #include <libmypaint/mypaint-surface.h>
 
+class KisRunnableStrokeJobData;
+
 class KisMyPaintSurface
 {
 public:
@@ -48,10 +51,16 @@ public:
     static void get_color(MyPaintSurface *self, float x, float y, float radius,
                             float * color_r, float * color_g, float * color_b, float * color_a);
 
-    template <typename channelType>
-    int drawDabImpl(MyPaintSurface *self, float x, float y, float radius, float color_r, float color_g,
-                                    float color_b, float opaque, float hardness, float color_a,
-                                    float aspect_ratio, float angle, float lock_alpha, float colorize);
+    /**
+     * Starts collecting the dabs passed to draw_dab() instead of painting
+     * them one by one. The collected dabs are rendered by the stroke's
+     * runnable jobs, which are added when endDabsBatch() is called and run
+     * after the current stroke job. When libmypaint asks for a color via
+     * get_color(), the dabs collected so far are rendered right away on
+     * the calling thread. Outside a batch every dab is painted right away.
+     */
+    void beginDabsBatch();
+    void endDabsBatch();
 
     template <typename channelType>
     void getColorImpl(MyPaintSurface *self, float x, float y, float radius,
@@ -76,17 +85,77 @@ public:
 
     MyPaintSurface* surface();
 
+private:
+    struct Dab {
+        float x;
+        float y;
+        float radius;
+        float colorR;
+        float colorG;
+        float colorB;
+        float opaque;
+        float hardness;
+        float colorA;
+        float aspectRatio;
+        float angle;
+        float colorize;
+
+        QRect rect;
+        QVector<QRect> mirroredRects;
+    };
+
+    int queueDab(float x, float y, float radius, float color_r, float color_g,
+                 float color_b, float opaque, float hardness, float color_a,
+                 float aspect_ratio, float angle, float colorize);
+
+    struct DabsBatch {
+        QVector<Dab> dabs;
+        QVector<KisFixedPaintDeviceSP> dabDevices;
+        QVector<KisFixedPaintDeviceSP> maskDevices;
+    };
+
+    /// converts the queued dabs into the rendering jobs
+    void flushDabs();
+
+    /// executes the rendering jobs on the calling thread
+    void runPendingJobs();
+
+    template <typename channelType>
+    void addRenderingJobs();
+
+    template <typename channelType>
+    void renderDabRows(const Dab &dab, KisPaintDeviceSP srcDevice,
+                       KisFixedPaintDeviceSP dabDevice, KisFixedPaintDeviceSP maskDevice,
+                       int firstRow, int numRows, bool eraser);
+
+    void readColorSampleRect(const QRect &rc, quint8 *dstBytes);
+    void loadColorSampleWindow(const QRect &rc);
+    void refreshColorSampleWindow();
+
 private:
     KisPainter *m_painter;
     KisPaintDeviceSP m_imageDevice;
     MyPaintSurfaceInternal *m_surface;
     KisImageSP m_image;
     KisOverlayPaintDeviceWrapper m_precisePainterWrapper;
-    KisPaintDeviceSP m_dab;
     QScopedPointer<KisPainter> m_tempPainter;
     QScopedPointer<KisPainter> m_backgroundPainter;
-    KisFixedPaintDeviceSP m_blendDevice;
-    KisFixedPaintDeviceSP m_maskDevice;
+
+    bool m_isBatching {false};
+    QVector<Dab> m_pendingDabs;
+    qint64 m_pendingDabsPixels {0};
+    QVector<KisRunnableStrokeJobData*> m_pendingJobs;
+
+    /**
+     * A copy of the area around the last get_color() request. libmypaint
+     * samples the color at almost every dab of a smudging brush, so the
+     * requests are served from here and only the parts painted over since
+     * the window was loaded are re-read from the device.
+     */
+    KisFixedPaintDeviceSP m_colorSampleWindow;
+    bool m_colorSampleWindowValid {false};
+    QVector<QRect> m_colorSampleWindowDirtyRects;
+    QVector<qint16> m_colorSampleWeights;
 
 };
 
@@ -79,6 +79,58 @@ void KisMyPaintOpTest::testGetColor() {
     QVERIFY(qFuzzyCompare((float)qRound(a), 1.0L));
 }
 
+void KisMyPaintOpTest::testBatchedDabs() {
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+
+    auto paintDabs = [cs] (bool useBatches) {
+        KisPaintDeviceSP dst = new KisPaintDevice(cs);
+        dst->fill(QRect(0, 0, 600, 300), KoColor(Qt::white, cs));
+
+        KisPainter painter(dst);
+        QScopedPointer<KisMyPaintSurface> surface(new KisMyPaintSurface(&painter, dst));
+
+        if (useBatches) {
+            surface->beginDabsBatch();
+        }
+
+        // overlapping dabs of a stroke mixed with the distant ones
+        for (int i = 0; i < 100; i++) {
+            const float x = 50 + 5 * i;
+            const float y = (i % 3) ? 80 : 220;
+            const float radius = (i % 4) ? 12 : 40;
+
+            surface->draw_dab(surface->surface(), x, y, radius, 0.1f * (i % 10), 0.5f, 1, 0.8f, 0.6f, 1, 1.5f, 3 * i, 0, 0);
+
+            if (i % 25 == 24) {
+                float r, g, b, a;
+                surface->get_color(surface->surface(), x, y, radius, &r, &g, &b, &a);
+            }
+        }
+
+        if (useBatches) {
+            surface->endDabsBatch();
+        }
+
+        return dst;
+    };
+
+    KisPaintDeviceSP reference = paintDabs(false);
+    KisPaintDeviceSP batched = paintDabs(true);
+
+    const QRect rc = reference->exactBounds();
+    QCOMPARE(batched->exactBounds(), rc);
+
+    QImage referenceImage = reference->convertToQImage(0, rc.x(), rc.y(), rc.width(), rc.height());
+    QImage batchedImage = batched->convertToQImage(0, rc.x(), rc.y(), rc.width(), rc.height());
+
+    QPoint errpoint;
+    if (!TestUtil::compareQImages(errpoint, referenceImage, batchedImage)) {
+        batchedImage.save("mypaint_test_batched_dabs.png");
+        QFAIL(QString("Batched dabs differ from the sequential ones, first different pixel: %1,%2 \n").arg(errpoint.x()).arg(errpoint.y()).toLatin1());
+    }
+}
+
 void KisMyPaintOpTest::testLoading() {
 
     QScopedPointer<KisMyPaintPaintOpPreset> brush (new KisMyPaintPaintOpPreset(QString(FILES_DATA_DIR) + QDir::separator() + "basic.myb"));
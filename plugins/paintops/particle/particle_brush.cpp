@@ -14,6 +14,8 @@
 
 #include <kis_global.h>
 
+#include <QtMath>
+
 #include <math.h>
 
 const qreal TIME = 0.000030;
@@ -83,7 +85,6 @@ void ParticleBrush::paintParticle(KisRandomAccessorSP accWrite, const KoColorSpa
 
 void ParticleBrush::draw(KisPaintDeviceSP dab, const KoColor& color, const QPointF &pos)
 {
-    KisRandomAccessorSP accessor = dab->createRandomAccessorNG();
     const KoColorSpace * cs = dab->colorSpace();
 
     QRect boundingRect;
@@ -142,11 +143,17 @@ void ParticleBrush::draw(KisPaintDeviceSP dab, const KoColor& color, const QPoin
             bool inside = boundingRect.contains(m_particlePos[j].toPoint());
 
             if (boundingRect.isEmpty() || (inside && !nearInfinity)) {
-                paintParticle(accessor, cs, m_particlePos[j], color, m_properties->particleWeight, true);
+                m_paintedPos.append(m_particlePos[j]);
+                m_renderer.addParticle(QRect(qFloor(pointF.x()), qFloor(pointF.y()), 2, 2));
             }
 
         }//for j
     }//for i
+
+    m_renderer.render(dab, [this, cs, &color] (KisParallelParticleRenderer::Target &target, int index) {
+        paintParticle(target.accessor(), cs, m_paintedPos[index], color, m_properties->particleWeight, true);
+    });
+    m_paintedPos.clear();
 }
 
 
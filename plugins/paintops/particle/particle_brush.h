@@ -12,6 +12,8 @@
 #include "kis_debug.h"
 #include <QPointF>
 
+#include <KisParallelParticleRenderer.h>
+
 #include "KisParticleOpOptionData.h"
 
 
@@ -53,6 +55,10 @@ private:
     QVector<QPointF> m_particleNextPos;
     QVector<qreal> m_acceleration;
 
+    /// the positions of the particles painted by the current call to draw()
+    QVector<QPointF> m_paintedPos;
+    KisParallelParticleRenderer m_renderer;
+
     KisParticleOpOptionData * m_properties;
 };
 
@@ -10,6 +10,7 @@
 
 #include <cmath>
 #include <QRect>
+#include <QtMath>
 
 #include <KoColor.h>
 #include <KoColorSpace.h>
@@ -71,13 +72,11 @@ KisSketchPaintOp::KisSketchPaintOp(const KisPaintOpSettingsSP settings, KisPaint
     m_brush = m_brushOption.brush();
     m_dabCache = new KisDabCache(m_brush);
 
-    m_painter = 0;
     m_count = 0;
 }
 
 KisSketchPaintOp::~KisSketchPaintOp()
 {
-    delete m_painter;
     delete m_dabCache;
 }
 
@@ -87,23 +86,42 @@ QList<KoResourceLoadResult> KisSketchPaintOp::prepareLinkedResources(const KisPa
     return brushOption.prepareLinkedResources(settings, resourcesInterface);
 }
 
-void KisSketchPaintOp::drawConnection(const QPointF& start, const QPointF& end, double lineWidth)
+void KisSketchPaintOp::addConnection(const QPointF& start, const QPointF& end, double lineWidth)
+{
+    Connection connection;
+    connection.start = start;
+    connection.end = end;
+    connection.lineWidth = lineWidth;
+    connection.color = m_lineColor;
+    connection.opacity = m_lineOpacity;
+    m_connections.append(connection);
+
+    // the thick lines are expanded by half of the width plus
+    // a pixel of the antialiasing and a pixel of the subpixel offset
+    const int margin = qCeil(0.5 * lineWidth) + 3;
+    const QPoint p1(qFloor(start.x()), qFloor(start.y()));
+    const QPoint p2(qFloor(end.x()), qFloor(end.y()));
+
+    m_renderer.addParticle(QRect(p1, p2).normalized().adjusted(-margin, -margin, margin, margin));
+}
+
+void KisSketchPaintOp::drawConnection(KisParallelParticleRenderer::Target &target, const QPointF& start, const QPointF& end, double lineWidth)
 {
     //Both drawWuLine() and the drawDDALine produce nicer 1px lines than the drawLine()
     if (m_sketchProperties.antiAliasing) {
         if (lineWidth == 1.0) {
-            m_painter->drawWuLine(start, end);
+            target.painter()->drawWuLine(start, end);
         }
         else {
-            m_painter->drawLine(start, end, lineWidth, true);
+            target.drawLine(start, end, lineWidth, true);
         }
     }
     else {
         if (lineWidth == 1.0) {
-            m_painter->drawDDALine(start, end);
+            target.painter()->drawDDALine(start, end);
         }
         else {
-            m_painter->drawLine(start, end, lineWidth, false);
+            target.drawLine(start, end, lineWidth, false);
         }
     }
 }
@@ -141,8 +159,7 @@ void KisSketchPaintOp::doPaintLine(const KisPaintInformation &pi1, const KisPain
 
     if (!m_dab) {
         m_dab = source()->createCompositionSourceDevice();
-        m_painter = new KisPainter(m_dab);
-        m_painter->setPaintColor(painter()->paintColor());
+        m_lineColor = painter()->paintColor();
     }
     else {
         m_dab->clear();
@@ -165,7 +182,7 @@ void KisSketchPaintOp::doPaintLine(const KisPaintInformation &pi1, const KisPain
 
     // shaded: does not draw this line, chrome does, fur does
     if (m_sketchProperties.makeConnection) {
-        drawConnection(prevMouse, mousePosition, currentLineWidth);
+        addConnection(prevMouse, mousePosition, currentLineWidth);
     }
 
 
@@ -267,7 +284,7 @@ void KisSketchPaintOp::doPaintLine(const KisPaintInformation &pi1, const KisPain
                                     r2 * painterColor.greenF(),
                                     r3 * painterColor.blueF());
                 color.fromQColor(randomColor);
-                m_painter->setPaintColor(color);
+                m_lineColor = color;
             }
 
             // distance based opacity
@@ -282,13 +299,13 @@ void KisSketchPaintOp::doPaintLine(const KisPaintInformation &pi1, const KisPain
                 opacity *= randomSource->generateNormalized();
             }
 
-            m_painter->setOpacityF(opacity);
+            m_lineOpacity = opacity;
 
             if (m_sketchProperties.magnetify) {
-                drawConnection(mousePosition + offsetPt, m_points.at(i) - offsetPt, currentLineWidth);
+                addConnection(mousePosition + offsetPt, m_points.at(i) - offsetPt, currentLineWidth);
             }
             else {
-                drawConnection(mousePosition + offsetPt, mousePosition - offsetPt, currentLineWidth);
+                addConnection(mousePosition + offsetPt, mousePosition - offsetPt, currentLineWidth);
             }
 
 
@@ -296,6 +313,14 @@ void KisSketchPaintOp::doPaintLine(const KisPaintInformation &pi1, const KisPain
         }
     }// end of MAIN LOOP
 
+    m_renderer.render(m_dab, [this] (KisParallelParticleRenderer::Target &target, int index) {
+        const Connection &connection = m_connections[index];
+        target.painter()->setPaintColor(connection.color);
+        target.painter()->setOpacityF(connection.opacity);
+        drawConnection(target, connection.start, connection.end, connection.lineWidth);
+    });
+    m_connections.clear();
+
     m_count++;
 
     QRect rc = m_dab->extent();
@@ -15,11 +15,13 @@
 #include "kis_sketch_paintop_settings.h"
 
 #include "kis_painter.h"
+#include <KoColor.h>
 #include <kis_brush_option.h>
 #include <KisStandardOptions.h>
 #include "KisRotationOption.h"
 #include "KisOpacityOption.h"
 #include "KisAirbrushOptionData.h"
+#include <KisParallelParticleRenderer.h>
 
 class KisDabCache;
 
@@ -69,12 +71,26 @@ private:
 
     QVector<QPointF> m_points;
     int m_count {0};
-    KisPainter * m_painter {nullptr};
     KisBrushSP m_brush;
     KisDabCache *m_dabCache {nullptr};
 
+    /// a line generated by doPaintLine(), it is drawn by the particle renderer
+    struct Connection {
+        QPointF start;
+        QPointF end;
+        double lineWidth;
+        KoColor color;
+        qreal opacity;
+    };
+
+    KoColor m_lineColor;
+    qreal m_lineOpacity {OPACITY_OPAQUE_F};
+    QVector<Connection> m_connections;
+    KisParallelParticleRenderer m_renderer;
+
 private:
-    void drawConnection(const QPointF &start, const QPointF &end, double lineWidth);
+    void addConnection(const QPointF &start, const QPointF &end, double lineWidth);
+    void drawConnection(KisParallelParticleRenderer::Target &target, const QPointF &start, const QPointF &end, double lineWidth);
     void updateBrushMask(const KisPaintInformation& info, qreal scale, qreal rotation);
     void doPaintLine(const KisPaintInformation &pi1, const KisPaintInformation &pi2);
 };
@@ -38,13 +38,11 @@
 
 SprayBrush::SprayBrush()
 {
-    m_painter = nullptr;
     m_transfo = nullptr;
 }
 
 SprayBrush::~SprayBrush()
 {
-    delete m_painter;
     delete m_transfo;
 }
 
@@ -155,10 +153,12 @@ void SprayBrush::paintImpl(KisPaintDeviceSP dab, KisPaintDeviceSP source,
     const QSize effectiveSize = m_shapeProperties->effectiveSize(m_sprayOpOptionData->diameter, m_sprayOpOptionData->scale);
 
     // initializing painter
-    if (!m_painter) {
-        m_painter = new KisPainter(dab);
-        m_painter->setFillStyle(KisPainter::FillStyleForegroundColor);
-        m_painter->setMaskImageSize(effectiveSize.width(), effectiveSize.height());
+    if (!m_initialized) {
+        m_initialized = true;
+        m_renderer.setPainterInitializer([effectiveSize] (KisPainter *painter) {
+            painter->setFillStyle(KisPainter::FillStyleForegroundColor);
+            painter->setMaskImageSize(effectiveSize.width(), effectiveSize.height());
+        });
         m_dabPixelSize = dab->colorSpace()->pixelSize();
         if (m_colorProperties->useRandomHSV) {
             m_transfo = dab->colorSpace()->createColorTransformation("hsv_adjustment", QHash<QString, QVariant>());
@@ -168,13 +168,11 @@ void SprayBrush::paintImpl(KisPaintDeviceSP dab, KisPaintDeviceSP source,
         if (!m_brushQImage.isNull()) {
             m_brushQImage = m_brushQImage.scaled(effectiveSize);
         }
-        m_imageDevice = new KisPaintDevice(dab->colorSpace());
     }
 
 
     qreal x = info.pos().x();
     qreal y = info.pos().y();
-    KisRandomAccessorSP accessor = dab->createRandomAccessorNG();
 
     Q_ASSERT(color.colorSpace()->pixelSize() == dab->pixelSize());
     m_inkColor = color;
@@ -210,8 +208,7 @@ void SprayBrush::paintImpl(KisPaintDeviceSP dab, KisPaintDeviceSP source,
 
     bool shouldColor = true;
     if (m_colorProperties->fillBackground) {
-        m_painter->setPaintColor(bgColor);
-        paintCircle(m_painter, x, y, m_radius);
+        addPathParticle(circlePath(x, y, m_radius), bgColor);
     }
 
     QTransform m;
@@ -292,14 +289,12 @@ void SprayBrush::paintImpl(KisPaintDeviceSP dab, KisPaintDeviceSP source,
             if (m_colorProperties->useRandomOpacity) {
                 const qreal alpha = randomSource->generateNormalized();
                 m_inkColor.setOpacity(alpha);
-                m_painter->setOpacityF(alpha);
+                m_paintOpacity = alpha;
             }
 
             if (!m_colorProperties->colorPerParticle) {
                 shouldColor = false;
             }
-
-            m_painter->setPaintColor(m_inkColor);
         }
 
         qreal jitteredWidth = qMax(1.0 * additionalScale, effectiveSize.width() * particleScale * additionalScale);
@@ -311,30 +306,39 @@ void SprayBrush::paintImpl(KisPaintDeviceSP dab, KisPaintDeviceSP source,
             case 0:
             {
                 if (effectiveSize.width() == effectiveSize.height()){
-                    paintCircle(m_painter, nx + x, ny + y, jitteredWidth * 0.5);
+                    addPathParticle(circlePath(nx + x, ny + y, jitteredWidth * 0.5), m_inkColor);
                 }
                 else {
-                    paintEllipse(m_painter, nx + x, ny + y, jitteredWidth * 0.5 , jitteredHeight * 0.5, rotationZ);
+                    addPathParticle(ellipsePath(nx + x, ny + y, jitteredWidth * 0.5 , jitteredHeight * 0.5, rotationZ), m_inkColor);
                 }
                 break;
             }
             // rectangle
             case 1:
             {
-                paintRectangle(m_painter, nx + x, ny + y, qRound(jitteredWidth) , qRound(jitteredHeight), rotationZ);
+                addPathParticle(rectanglePath(nx + x, ny + y, qRound(jitteredWidth) , qRound(jitteredHeight), rotationZ), m_inkColor);
                 break;
             }
             // wu-particle
             case 2: {
-                paintParticle(accessor, m_inkColor, nx + x, ny + y);
+                Particle particle;
+                particle.type = Particle::WuParticle;
+                particle.color = m_inkColor;
+                particle.pos = QPointF(nx + x, ny + y);
+
+                m_particles.append(particle);
+                m_renderer.addParticle(QRect(int(particle.pos.x()), int(particle.pos.y()), 2, 2));
                 break;
             }
             // pixel
             case 3: {
-                ix = qRound(nx + x);
-                iy = qRound(ny + y);
-                accessor->moveTo(ix, iy);
-                memcpy(accessor->rawData(), m_inkColor.data(), m_dabPixelSize);
+                Particle particle;
+                particle.type = Particle::Pixel;
+                particle.color = m_inkColor;
+                particle.topLeft = QPoint(qRound(nx + x), qRound(ny + y));
+
+                m_particles.append(particle);
+                m_renderer.addParticle(QRect(particle.topLeft, QSize(1, 1)));
                 break;
             }
             case 4: {
@@ -348,8 +352,11 @@ void SprayBrush::paintImpl(KisPaintDeviceSP dab, KisPaintDeviceSP source,
                         m.scale(particleScale, particleScale);
                     }
                     m_transformed = m_brushQImage.transformed(m, Qt::SmoothTransformation);
-                    m_imageDevice->convertFromQImage(m_transformed, 0);
-                    KisRandomAccessorSP ac = m_imageDevice->createRandomAccessorNG();
+
+                    // every particle keeps its own device until it is drawn
+                    KisPaintDeviceSP imageDevice = new KisPaintDevice(dab->colorSpace());
+                    imageDevice->convertFromQImage(m_transformed, 0);
+                    KisRandomAccessorSP ac = imageDevice->createRandomAccessorNG();
                     QRect rc = m_transformed.rect();
 
                     if (m_colorProperties->useRandomHSV && m_transfo) {
@@ -364,8 +371,17 @@ void SprayBrush::paintImpl(KisPaintDeviceSP dab, KisPaintDeviceSP source,
 
                     ix = qRound(nx + x - rc.width() * 0.5);
                     iy = qRound(ny + y - rc.height() * 0.5);
-                    m_painter->bitBlt(QPoint(ix, iy), m_imageDevice, rc);
-                    m_imageDevice->clear();
+
+                    Particle particle;
+                    particle.type = Particle::Image;
+                    particle.color = m_inkColor;
+                    particle.opacity = m_paintOpacity;
+                    particle.topLeft = QPoint(ix, iy);
+                    particle.image = imageDevice;
+                    particle.imageRect = rc;
+
+                    m_particles.append(particle);
+                    m_renderer.addParticle(QRect(particle.topLeft, rc.size()));
                     break;
                 }
             }
@@ -388,23 +404,34 @@ void SprayBrush::paintImpl(KisPaintDeviceSP dab, KisPaintDeviceSP source,
 
             m_brush->prepareForSeqNo(info, m_dabSeqNo);
 
-            //KisFixedPaintDeviceSP dab;
+            KisFixedPaintDeviceSP fixedDab;
             if (m_brush->brushApplication() == IMAGESTAMP) {
-                m_fixedDab = m_brush->paintDevice(m_fixedDab->colorSpace(),
+                fixedDab = m_brush->paintDevice(m_fixedDab->colorSpace(),
                           shape, info, xFraction, yFraction);
 
                 if (m_colorProperties->useRandomHSV && m_transfo) {
-                    quint8 * dabPointer = m_fixedDab->data();
-                    int pixelCount = m_fixedDab->bounds().width() * m_fixedDab->bounds().height();
+                    quint8 * dabPointer = fixedDab->data();
+                    int pixelCount = fixedDab->bounds().width() * fixedDab->bounds().height();
                     m_transfo->transform(dabPointer, dabPointer, pixelCount);
                 }
 
             }
             else {
-                m_brush->mask(m_fixedDab, m_inkColor, shape,
+                // the dab cannot be shared between the particles, they are drawn later
+                fixedDab = new KisFixedPaintDevice(m_fixedDab->colorSpace());
+                m_brush->mask(fixedDab, m_inkColor, shape,
                               info, xFraction, yFraction);
             }
-            m_painter->bltFixed(QPoint(ix, iy), m_fixedDab, m_fixedDab->bounds());
+
+            Particle particle;
+            particle.type = Particle::FixedDab;
+            particle.color = m_inkColor;
+            particle.opacity = m_paintOpacity;
+            particle.topLeft = QPoint(ix, iy);
+            particle.fixedDab = fixedDab;
+
+            m_particles.append(particle);
+            m_renderer.addParticle(QRect(particle.topLeft, fixedDab->bounds().size()));
         }
         if (m_colorProperties->colorPerParticle){
             m_inkColor=color;//reset color//
@@ -412,9 +439,58 @@ void SprayBrush::paintImpl(KisPaintDeviceSP dab, KisPaintDeviceSP source,
     }
     // recover from jittering of color,
     // m_inkColor.opacity is recovered with every paint
+
+    m_renderer.render(dab, [this] (KisParallelParticleRenderer::Target &target, int index) {
+        drawParticle(target, m_particles[index]);
+    });
+    m_particles.clear();
 }
 
+void SprayBrush::addPathParticle(const QPainterPath &path, const KoColor &color)
+{
+    Particle particle;
+    particle.type = Particle::Path;
+    particle.color = color;
+    particle.opacity = m_paintOpacity;
+    particle.path = path;
+
+    m_particles.append(particle);
 
+    // KisPainter::fillPainterPath() expands the rect by one pixel for anti-aliasing
+    m_renderer.addParticle(path.boundingRect().toAlignedRect().adjusted(-1, -1, 1, 1));
+}
+
+void SprayBrush::drawParticle(KisParallelParticleRenderer::Target &target, const Particle &particle)
+{
+    switch (particle.type) {
+    case Particle::Path:
+        target.painter()->setPaintColor(particle.color);
+        target.painter()->setOpacityF(particle.opacity);
+        target.fillPainterPath(particle.path);
+        break;
+    case Particle::WuParticle: {
+        KisRandomAccessorSP accessor = target.accessor();
+        paintParticle(accessor, particle.color, particle.pos.x(), particle.pos.y());
+        break;
+    }
+    case Particle::Pixel: {
+        KisRandomAccessorSP accessor = target.accessor();
+        accessor->moveTo(particle.topLeft.x(), particle.topLeft.y());
+        memcpy(accessor->rawData(), particle.color.data(), m_dabPixelSize);
+        break;
+    }
+    case Particle::Image:
+        target.painter()->setPaintColor(particle.color);
+        target.painter()->setOpacityF(particle.opacity);
+        target.bitBlt(particle.topLeft, particle.image, particle.imageRect);
+        break;
+    case Particle::FixedDab:
+        target.painter()->setPaintColor(particle.color);
+        target.painter()->setOpacityF(particle.opacity);
+        target.bltFixed(particle.topLeft, particle.fixedDab, particle.fixedDab->bounds());
+        break;
+    }
+}
 
 void SprayBrush::paintParticle(KisRandomAccessorSP &writeAccessor, const KoColor &color, qreal rx, qreal ry)
 {
@@ -453,34 +529,32 @@ void SprayBrush::paintParticle(KisRandomAccessorSP &writeAccessor, const KoColor
     memcpy(writeAccessor->rawData(), pcolor.data(), m_dabPixelSize);
 }
 
-void SprayBrush::paintCircle(KisPainter* painter, qreal x, qreal y, qreal radius)
+QPainterPath SprayBrush::circlePath(qreal x, qreal y, qreal radius)
 {
     QPainterPath path;
     path.addEllipse(QPointF(x,y),radius,radius);
-    painter->fillPainterPath(path);
+    return path;
 }
 
 
-void SprayBrush::paintEllipse(KisPainter* painter, qreal x, qreal y, qreal a, qreal b, qreal angle)
+QPainterPath SprayBrush::ellipsePath(qreal x, qreal y, qreal a, qreal b, qreal angle)
 {
     QPainterPath path;
     path.addEllipse(QPointF(), a, b);
     QTransform t;
     t.translate(x, y);
     t.rotateRadians(angle);
-    path = t.map(path);
-    painter->fillPainterPath(path);
+    return t.map(path);
 }
 
-void SprayBrush::paintRectangle(KisPainter* painter, qreal x, qreal y, qreal width, qreal height, qreal angle)
+QPainterPath SprayBrush::rectanglePath(qreal x, qreal y, qreal width, qreal height, qreal angle)
 {
     QPainterPath path;
     path.addRect(QRectF(-0.5 * width, -0.5 * height, width, height));
     QTransform t;
     t.translate(x, y);
     t.rotateRadians(angle);
-    path = t.map(path);
-    painter->fillPainterPath(path);
+    return t.map(path);
 }
 
 
@@ -24,7 +24,10 @@
 
 
 #include <QImage>
+#include <QPainterPath>
+#include <QVector>
 #include <kis_brush.h>
+#include <KisParallelParticleRenderer.h>
 
 class KisPaintInformation;
 
@@ -51,6 +54,31 @@ public:
 
     void setFixedDab(KisFixedPaintDeviceSP dab);
 
+private:
+    /**
+     * A particle generated by paintImpl(), which is drawn
+     * later by the particle renderer
+     */
+    struct Particle {
+        enum Type {
+            Path,
+            WuParticle,
+            Pixel,
+            Image,
+            FixedDab
+        };
+
+        Type type {Path};
+        KoColor color;
+        qreal opacity {1.0};
+        QPointF pos;
+        QPoint topLeft;
+        QPainterPath path;
+        KisPaintDeviceSP image;
+        QRect imageRect;
+        KisFixedPaintDeviceSP fixedDab;
+    };
+
 private:
     int m_dabSeqNo {0};
     KoColor m_inkColor;
@@ -58,8 +86,10 @@ private:
     quint32 m_particlesCount {1};
     quint8 m_dabPixelSize {1};
 
-    KisPainter * m_painter {nullptr};
-    KisPaintDeviceSP m_imageDevice;
+    bool m_initialized {false};
+    qreal m_paintOpacity {1.0};
+    QVector<Particle> m_particles;
+    KisParallelParticleRenderer m_renderer;
     QImage m_brushQImage;
     QImage m_transformed;
 
@@ -100,9 +130,12 @@ private:
     qreal rotationAngle(KisRandomSourceSP randomSource);
     /// Paints Wu Particle
     void paintParticle(KisRandomAccessorSP &writeAccessor, const KoColor &color, qreal rx, qreal ry);
-    void paintCircle(KisPainter * painter, qreal x, qreal y, qreal radius);
-    void paintEllipse(KisPainter * painter, qreal x, qreal y, qreal a, qreal b, qreal angle);
-    void paintRectangle(KisPainter * painter, qreal x, qreal y, qreal width, qreal height, qreal angle);
+    QPainterPath circlePath(qreal x, qreal y, qreal radius);
+    QPainterPath ellipsePath(qreal x, qreal y, qreal a, qreal b, qreal angle);
+    QPainterPath rectanglePath(qreal x, qreal y, qreal width, qreal height, qreal angle);
+
+    void addPathParticle(const QPainterPath &path, const KoColor &color);
+    void drawParticle(KisParallelParticleRenderer::Target &target, const Particle &particle);
 
     void paintOutline(KisPaintDeviceSP dev, const KoColor& painterColor, qreal posX, qreal posY, qreal radius);
 
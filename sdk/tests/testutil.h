@@ -420,6 +420,95 @@ struct MaskParent
 
 }
 
+#include <KoColor.h>
+#include <kis_sequential_iterator.h>
+
+namespace TestUtil {
+
+/**
+ * Fills \p rc of \p dev with reproducible pseudo-random bytes. All the
+ * channels get the noise, including alpha, unless \p opaque is set.
+ */
+inline void fillWithNoise(KisPaintDeviceSP dev, const QRect &rc, quint32 seed = 1, bool opaque = false)
+{
+    const KoColorSpace *cs = dev->colorSpace();
+    const int pixelSize = cs->pixelSize();
+
+    KisSequentialIterator it(dev, rc);
+    while (it.nextPixel()) {
+        quint8 *dst = it.rawData();
+
+        for (int i = 0; i < pixelSize; i++) {
+            seed = seed * 1103515245 + 12345;
+            dst[i] = quint8(seed >> 16);
+        }
+
+        if (opaque) {
+            cs->setOpacity(dst, OPACITY_OPAQUE_U8, 1);
+        }
+    }
+}
+
+/**
+ * Splits \p rc into square cells of \p cellSize pixels, aligned to the
+ * origin of the device, and fills with noise every cell whose
+ * (column + row + \p phase) is a multiple of \p period. The other
+ * cells are left untouched.
+ */
+inline void fillCellsWithNoise(KisPaintDeviceSP dev, const QRect &rc,
+                               int cellSize, int period, int phase = 0,
+                               quint32 seed = 1, bool opaque = false)
+{
+    const int firstRow = rc.top() / cellSize;
+    const int lastRow = rc.bottom() / cellSize;
+    const int firstColumn = rc.left() / cellSize;
+    const int lastColumn = rc.right() / cellSize;
+
+    for (int row = firstRow; row <= lastRow; row++) {
+        for (int column = firstColumn; column <= lastColumn; column++) {
+            if ((column + row + phase) % period != 0) continue;
+
+            const QRect cell(column * cellSize, row * cellSize, cellSize, cellSize);
+            fillWithNoise(dev, cell & rc, seed++, opaque);
+        }
+    }
+}
+
+/**
+ * Creates an RGBA8 image with \p numLayers paint layers of \p layerSize
+ * pixels, shifted diagonally against each other. Every layer is a mix
+ * of flat areas and noise, so the savers get both long runs and
+ * incompressible data. The graph of the image is already refreshed.
+ */
+inline KisImageSP createNoiseImage(const QSize &imageSize, int numLayers, int layerSize)
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, imageSize.width(), imageSize.height(), cs, "noise image");
+
+    for (int i = 0; i < numLayers; i++) {
+        KisPaintLayerSP layer = new KisPaintLayer(image, QString("layer %1").arg(i), OPACITY_OPAQUE_U8);
+
+        const int offset = (i * 97) % qMax(1, imageSize.width() - layerSize);
+        const QRect rc(offset, offset, layerSize, layerSize);
+
+        KoColor color(cs);
+        for (int ch = 0; ch < 4; ch++) {
+            color.data()[ch] = quint8(i * 31 + ch * 64);
+        }
+
+        layer->paintDevice()->fill(rc, color);
+        fillCellsWithNoise(layer->paintDevice(), rc, 64, 3, i, i + 1);
+
+        image->addNode(layer, image->root());
+    }
+
+    image->initialRefreshGraph();
+
+    return image;
+}
+
+}
+
 namespace TestUtil {
 
 class MeasureAvgPortion